@@ -0,0 +1,39 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "atomic-ref-count.h"
+#include "fatal-error.h"
+
+namespace ns3 {
+
+bool AtomicRefCount::m_enabled = false;
+
+void
+AtomicRefCount::Enable (void)
+{
+#ifndef __GNUC__
+  NS_FATAL_ERROR ("AtomicRefCount needs the GCC atomic builtins");
+#endif
+  m_enabled = true;
+}
+
+void
+AtomicRefCount::Disable (void)
+{
+  m_enabled = false;
+}
+
+} // namespace ns3
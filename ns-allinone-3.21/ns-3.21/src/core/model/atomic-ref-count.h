@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ATOMIC_REF_COUNT_H
+#define ATOMIC_REF_COUNT_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup ptr
+ * \brief Switch of the atomic updates of the reference counts.
+ *
+ * The reference counts of SimpleRefCount and of the copy-on-write data
+ * of the packets are plain integers, as the events normally run in a
+ * single thread. A simulator implementation which runs the events of
+ * several nodes at once in different threads (see
+ * MultithreadedSimulatorImpl) enables the atomic updates for the time of
+ * its Run, so that the objects shared by the nodes, such as the packets
+ * handed over by a channel, may be referenced and released by any of the
+ * threads. The packet buffers then also skip their process-wide free
+ * lists and copy any shared data before they write to it.
+ *
+ * The atomic updates need the GCC atomic builtins.
+ */
+class AtomicRefCount
+{
+public:
+  /**
+   * \brief Update the counts atomically.
+   */
+  static void Enable (void);
+  /**
+   * \brief Update the counts with plain increments and decrements.
+   */
+  static void Disable (void);
+  /**
+   * \returns true if the counts are updated atomically
+   */
+  static bool IsEnabled (void)
+  {
+    return m_enabled;
+  }
+
+  /**
+   * \param count the count to increment
+   */
+  static void Increment (uint32_t &count)
+  {
+#ifdef __GNUC__
+    if (m_enabled)
+      {
+        __sync_fetch_and_add (&count, 1);
+        return;
+      }
+#endif
+    count++;
+  }
+  /**
+   * \param count the count to decrement
+   * \returns the decremented count
+   */
+  static uint32_t Decrement (uint32_t &count)
+  {
+#ifdef __GNUC__
+    if (m_enabled)
+      {
+        return __sync_sub_and_fetch (&count, 1);
+      }
+#endif
+    return --count;
+  }
+
+private:
+  static bool m_enabled;
+};
+
+} // namespace ns3
+
+#endif /* ATOMIC_REF_COUNT_H */
@@ -22,6 +22,7 @@
 #define CALENDAR_SCHEDULER_H
 
 #include "scheduler.h"
+#include "event-allocator.h"
 #include <stdint.h>
 #include <list>
 
@@ -72,7 +73,7 @@ private:
   Scheduler::Event DoRemoveNext (void);
   void DoInsert (const Event &ev);
 
-  typedef std::list<Scheduler::Event> Bucket;
+  typedef std::list<Scheduler::Event, EventContainerAllocator<Scheduler::Event> > Bucket;
   Bucket *m_buckets;
   // number of buckets in array
   uint32_t m_nBuckets;
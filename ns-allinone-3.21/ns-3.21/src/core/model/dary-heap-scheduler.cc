@@ -0,0 +1,236 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "dary-heap-scheduler.h"
+#include "event-impl.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DaryHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (DaryHeapScheduler);
+
+// the alignment of the keys
+static const uintptr_t CACHE_LINE = 64;
+
+TypeId
+DaryHeapScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DaryHeapScheduler")
+    .SetParent<Scheduler> ()
+    .AddConstructor<DaryHeapScheduler> ()
+    .AddAttribute ("Arity",
+                   "The number of children of a node of the heap, set before the first event.",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&DaryHeapScheduler::SetArity,
+                                         &DaryHeapScheduler::GetArity),
+                   MakeUintegerChecker<uint32_t> (2, 64))
+  ;
+  return tid;
+}
+
+DaryHeapScheduler::DaryHeapScheduler ()
+  : m_buffer (0),
+    m_keys (0),
+    m_size (0),
+    m_capacity (0),
+    m_arity (4)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DaryHeapScheduler::~DaryHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+  Free ();
+}
+
+void
+DaryHeapScheduler::Free (void)
+{
+  delete [] m_buffer;
+  m_buffer = 0;
+  m_keys = 0;
+  m_size = 0;
+  m_capacity = 0;
+}
+
+void
+DaryHeapScheduler::Grow (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t capacity = std::max (2 * m_capacity, m_arity * m_arity);
+  uint8_t *buffer = new uint8_t [(capacity + m_arity - 1) * sizeof (EventKey) + CACHE_LINE - 1];
+  uintptr_t aligned = (reinterpret_cast<uintptr_t> (buffer) + CACHE_LINE - 1) & ~(uintptr_t)(CACHE_LINE - 1);
+  EventKey *keys = reinterpret_cast<EventKey *> (aligned) + m_arity - 1;
+  std::copy (m_keys, m_keys + m_size, keys);
+  delete [] m_buffer;
+  m_buffer = buffer;
+  m_keys = keys;
+  m_capacity = capacity;
+}
+
+void
+DaryHeapScheduler::SetArity (uint32_t arity)
+{
+  NS_LOG_FUNCTION (this << arity);
+  NS_ASSERT_MSG (IsEmpty (), "DaryHeapScheduler::SetArity(): the heap is not empty");
+  // the padding before the root depends on the arity
+  Free ();
+  m_arity = arity;
+}
+
+uint32_t
+DaryHeapScheduler::GetArity (void) const
+{
+  return m_arity;
+}
+
+void
+DaryHeapScheduler::SiftUp (uint32_t hole, const EventKey &key, EventImpl *impl)
+{
+  while (hole > 0)
+    {
+      uint32_t parent = (hole - 1) / m_arity;
+      if (!(key < m_keys[parent]))
+        {
+          break;
+        }
+      m_keys[hole] = m_keys[parent];
+      m_impls[hole] = m_impls[parent];
+      hole = parent;
+    }
+  m_keys[hole] = key;
+  m_impls[hole] = impl;
+}
+
+void
+DaryHeapScheduler::SiftDown (uint32_t hole, const EventKey &key, EventImpl *impl)
+{
+  uint32_t size = m_size;
+  for (;;)
+    {
+      uint32_t first = hole * m_arity + 1;
+      if (first >= size)
+        {
+          break;
+        }
+      uint32_t last = std::min (first + m_arity, size);
+      uint32_t smallest = first;
+      for (uint32_t child = first + 1; child < last; child++)
+        {
+          if (m_keys[child] < m_keys[smallest])
+            {
+              smallest = child;
+            }
+        }
+      if (!(m_keys[smallest] < key))
+        {
+          break;
+        }
+      m_keys[hole] = m_keys[smallest];
+      m_impls[hole] = m_impls[smallest];
+      hole = smallest;
+    }
+  m_keys[hole] = key;
+  m_impls[hole] = impl;
+}
+
+void
+DaryHeapScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  if (m_size == m_capacity)
+    {
+      Grow ();
+    }
+  m_size++;
+  m_impls.push_back (ev.impl);
+  SiftUp (m_size - 1, ev.key, ev.impl);
+}
+
+bool
+DaryHeapScheduler::IsEmpty (void) const
+{
+  return m_size == 0;
+}
+
+Scheduler::Event
+DaryHeapScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event next;
+  next.impl = m_impls.front ();
+  next.key = m_keys[0];
+  return next;
+}
+
+Scheduler::Event
+DaryHeapScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event next = PeekNext ();
+  m_size--;
+  EventKey key = m_keys[m_size];
+  EventImpl *impl = m_impls.back ();
+  m_impls.pop_back ();
+  if (m_size > 0)
+    {
+      SiftDown (0, key, impl);
+    }
+  return next;
+}
+
+void
+DaryHeapScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  uint32_t uid = ev.key.m_uid;
+  for (uint32_t i = 0; i < m_size; i++)
+    {
+      if (uid == m_keys[i].m_uid)
+        {
+          NS_ASSERT (m_impls[i] == ev.impl);
+          m_size--;
+          EventKey key = m_keys[m_size];
+          EventImpl *impl = m_impls.back ();
+          m_impls.pop_back ();
+          if (i == m_size)
+            {
+              return;
+            }
+          // the last event fills the hole, which may be above or below its place
+          if (i > 0 && key < m_keys[(i - 1) / m_arity])
+            {
+              SiftUp (i, key, impl);
+            }
+          else
+            {
+              SiftDown (i, key, impl);
+            }
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+} // namespace ns3
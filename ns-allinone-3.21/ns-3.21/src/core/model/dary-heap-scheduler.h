@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DARY_HEAP_SCHEDULER_H
+#define DARY_HEAP_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a d-ary heap event scheduler
+ *
+ * An implicit heap where every node has Arity children, 4 by default.
+ * Compared to the binary HeapScheduler, the heap is half as deep, and
+ * the children compared at each level of a sift are adjacent in memory.
+ *
+ * The keys of the events are stored in their own array, apart from the
+ * EventImpl pointers, so that the sifts only read keys. The array starts
+ * on a 64 byte boundary and the root is preceded by Arity - 1 unused
+ * keys, so that the children of every node start on a multiple of Arity
+ * keys: the four 16 byte keys of the children of a 4-ary node fill
+ * exactly one cache line. With another power of two Arity, the children
+ * fill whole cache lines or share one. The sifts move a hole down or up
+ * the heap and write the sifted event once, at its final place, instead
+ * of swapping it at every level.
+ */
+class DaryHeapScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  DaryHeapScheduler ();
+  virtual ~DaryHeapScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+private:
+  void SetArity (uint32_t arity);
+  uint32_t GetArity (void) const;
+  void SiftUp (uint32_t hole, const EventKey &key, EventImpl *impl);
+  void SiftDown (uint32_t hole, const EventKey &key, EventImpl *impl);
+  void Grow (void);
+  void Free (void);
+
+  // the storage of m_keys, with room for the alignment
+  uint8_t *m_buffer;
+  // the heap, root first, Arity - 1 keys past a 64 byte boundary
+  EventKey *m_keys;
+  uint32_t m_size;
+  uint32_t m_capacity;
+  // the event of each key of m_keys
+  std::vector<EventImpl *> m_impls;
+  uint32_t m_arity;
+};
+
+} // namespace ns3
+
+#endif /* DARY_HEAP_SCHEDULER_H */
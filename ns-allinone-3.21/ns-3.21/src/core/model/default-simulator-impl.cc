@@ -61,10 +61,10 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_uid = 4;
   // before ::Run is entered, the m_currentUid will be zero
   m_currentUid = 0;
+  m_eventCount = 0;
   m_currentTs = 0;
   m_currentContext = 0xffffffff;
   m_unscheduledEvents = 0;
-  m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
 }
 
@@ -137,6 +137,7 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
+  m_eventCount++;
   next.impl->Invoke ();
   next.impl->Unref ();
 
@@ -152,22 +153,17 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+  if (m_eventsWithContext.IsEmpty ())
     {
       return;
     }
 
-  // swap queues
-  EventsWithContext eventsWithContext;
-  {
-    CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap(eventsWithContext);
-    m_eventsWithContextEmpty = true;
-  }
-  while (!eventsWithContext.empty ())
+  // take all the pending events at once
+  m_eventsWithContext.Drain (m_eventsWithContextBatch);
+  for (std::vector<EventWithContext>::const_iterator i = m_eventsWithContextBatch.begin ();
+       i != m_eventsWithContextBatch.end (); ++i)
     {
-       EventWithContext event = eventsWithContext.front ();
-       eventsWithContext.pop_front ();
+       const EventWithContext &event = *i;
        Scheduler::Event ev;
        ev.impl = event.event;
        ev.key.m_ts = m_currentTs + event.timestamp;
@@ -177,6 +173,7 @@ DefaultSimulatorImpl::ProcessEventsWithContext (void)
        m_unscheduledEvents++;
        m_events->Insert (ev);
     }
+  m_eventsWithContextBatch.clear ();
 }
 
 void
@@ -259,11 +256,7 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, E
       ev.context = context;
       ev.timestamp = time.GetTimeStep ();
       ev.event = event;
-      {
-        CriticalSection cs (m_eventsWithContextMutex);
-        m_eventsWithContext.push_back(ev);
-        m_eventsWithContextEmpty = false;
-      }
+      m_eventsWithContext.Push (ev);
     }
 }
 
@@ -404,4 +397,10 @@ DefaultSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+uint64_t
+DefaultSimulatorImpl::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
 } // namespace ns3
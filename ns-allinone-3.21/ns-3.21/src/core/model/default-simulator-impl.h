@@ -25,11 +25,12 @@
 #include "scheduler.h"
 #include "event-impl.h"
 #include "system-thread.h"
-#include "ns3/system-mutex.h"
+#include "mpsc-queue.h"
 
 #include "ptr.h"
 
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -62,6 +63,7 @@ public:
   virtual void SetScheduler (ObjectFactory schedulerFactory);
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
 
 private:
   virtual void DoDispose (void);
@@ -73,10 +75,9 @@ private:
     uint64_t timestamp;
     EventImpl *event;
   };
-  typedef std::list<struct EventWithContext> EventsWithContext;
-  EventsWithContext m_eventsWithContext;
-  bool m_eventsWithContextEmpty;
-  SystemMutex m_eventsWithContextMutex;
+  // events scheduled by the other threads, inserted by the main thread
+  MpscQueue<struct EventWithContext> m_eventsWithContext;
+  std::vector<struct EventWithContext> m_eventsWithContextBatch;
 
   typedef std::list<EventId> DestroyEvents;
   DestroyEvents m_destroyEvents;
@@ -87,6 +88,7 @@ private:
   uint32_t m_currentUid;
   uint64_t m_currentTs;
   uint32_t m_currentContext;
+  uint64_t m_eventCount;
   // number of events that have been inserted but not yet scheduled,
   // not counting the "destroy" events; this is used for validation
   int m_unscheduledEvents;
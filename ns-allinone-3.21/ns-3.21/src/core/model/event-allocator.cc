@@ -0,0 +1,353 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-config.h"
+#include "event-allocator.h"
+#include <cstring>
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+namespace ns3 {
+
+/// Size class granularity (bytes)
+static const std::size_t EVENT_ALLOCATOR_GRANULE = 16;
+/// Number of size classes, the largest being 256 bytes
+static const uint32_t EVENT_ALLOCATOR_CLASSES = 16;
+/// Largest block served from the pools (bytes)
+static const std::size_t EVENT_ALLOCATOR_MAX_SIZE = EVENT_ALLOCATOR_GRANULE * EVENT_ALLOCATOR_CLASSES;
+/// Blocks kept on a free list, per size class and thread
+static const uint32_t EVENT_ALLOCATOR_MAX_CACHED = 8192;
+
+/**
+ * \brief The free lists and the counters of a thread.
+ */
+struct EventAllocatorCache
+{
+  struct Block
+  {
+    Block *next;
+  };
+  Block *free[EVENT_ALLOCATOR_CLASSES];
+  uint32_t length[EVENT_ALLOCATOR_CLASSES];
+  EventAllocator::Stats stats;
+  EventAllocatorCache *prev;            //!< previous cache of the registry
+  EventAllocatorCache *next;            //!< next cache of the registry
+};
+
+bool EventAllocator::m_enabled = true;
+
+/*
+ * The counters of a cache are only incremented by its thread, but GetStats
+ * and ResetStats read and clear them from another one. They are accessed
+ * with relaxed atomic loads and stores: the increments stay plain
+ * instructions, without a locked read-modify-write, and the other threads
+ * never see a torn value.
+ */
+static inline uint64_t
+EventAllocatorLoad (const uint64_t &counter)
+{
+#if defined (__GNUC__) && defined (__ATOMIC_RELAXED)
+  return __atomic_load_n (&counter, __ATOMIC_RELAXED);
+#else
+  return counter;
+#endif
+}
+
+static inline void
+EventAllocatorStore (uint64_t &counter, uint64_t value)
+{
+#if defined (__GNUC__) && defined (__ATOMIC_RELAXED)
+  __atomic_store_n (&counter, value, __ATOMIC_RELAXED);
+#else
+  counter = value;
+#endif
+}
+
+static inline void
+EventAllocatorCount (uint64_t &counter)
+{
+  EventAllocatorStore (counter, EventAllocatorLoad (counter) + 1);
+}
+
+static void
+EventAllocatorAdd (EventAllocator::Stats &to, const EventAllocator::Stats &from)
+{
+  to.allocations += EventAllocatorLoad (from.allocations);
+  to.hits += EventAllocatorLoad (from.hits);
+  to.oversized += EventAllocatorLoad (from.oversized);
+}
+
+static void
+EventAllocatorClear (EventAllocator::Stats &stats)
+{
+  EventAllocatorStore (stats.allocations, 0);
+  EventAllocatorStore (stats.hits, 0);
+  EventAllocatorStore (stats.oversized, 0);
+}
+
+static void
+EventAllocatorRelease (EventAllocatorCache *cache)
+{
+  for (uint32_t c = 0; c < EVENT_ALLOCATOR_CLASSES; ++c)
+    {
+      while (cache->free[c] != 0)
+        {
+          EventAllocatorCache::Block *block = cache->free[c];
+          cache->free[c] = block->next;
+          ::operator delete (block);
+        }
+      cache->length[c] = 0;
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+
+static pthread_mutex_t g_eventAllocatorLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t g_eventAllocatorOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t g_eventAllocatorKey;
+/// The caches of the live threads
+static EventAllocatorCache *g_eventAllocatorCaches = 0;
+/// The counters of the exited threads
+static EventAllocator::Stats g_eventAllocatorExited;
+#ifdef __GNUC__
+/// The cache of the thread, without the pthread_getspecific call
+static __thread EventAllocatorCache *g_eventAllocatorThreadCache = 0;
+#endif
+
+static void
+EventAllocatorDestroyCache (void *data)
+{
+  EventAllocatorCache *cache = static_cast<EventAllocatorCache *> (data);
+#ifdef __GNUC__
+  g_eventAllocatorThreadCache = 0;
+#endif
+  pthread_mutex_lock (&g_eventAllocatorLock);
+  if (cache->prev != 0)
+    {
+      cache->prev->next = cache->next;
+    }
+  else
+    {
+      g_eventAllocatorCaches = cache->next;
+    }
+  if (cache->next != 0)
+    {
+      cache->next->prev = cache->prev;
+    }
+  EventAllocatorAdd (g_eventAllocatorExited, cache->stats);
+  pthread_mutex_unlock (&g_eventAllocatorLock);
+  EventAllocatorRelease (cache);
+  delete cache;
+}
+
+static void
+EventAllocatorCreateKey (void)
+{
+  pthread_key_create (&g_eventAllocatorKey, &EventAllocatorDestroyCache);
+}
+
+static EventAllocatorCache *
+EventAllocatorPeekCache (void)
+{
+#ifdef __GNUC__
+  if (g_eventAllocatorThreadCache != 0)
+    {
+      return g_eventAllocatorThreadCache;
+    }
+#endif
+  pthread_once (&g_eventAllocatorOnce, &EventAllocatorCreateKey);
+  return static_cast<EventAllocatorCache *> (pthread_getspecific (g_eventAllocatorKey));
+}
+
+static EventAllocatorCache *
+EventAllocatorGetCache (void)
+{
+  EventAllocatorCache *cache = EventAllocatorPeekCache ();
+  if (cache == 0)
+    {
+      cache = new EventAllocatorCache ();
+      pthread_mutex_lock (&g_eventAllocatorLock);
+      cache->next = g_eventAllocatorCaches;
+      if (cache->next != 0)
+        {
+          cache->next->prev = cache;
+        }
+      g_eventAllocatorCaches = cache;
+      pthread_mutex_unlock (&g_eventAllocatorLock);
+      pthread_setspecific (g_eventAllocatorKey, cache);
+#ifdef __GNUC__
+      g_eventAllocatorThreadCache = cache;
+#endif
+    }
+  return cache;
+}
+
+#else /* HAVE_PTHREAD_H */
+
+static EventAllocatorCache g_eventAllocatorCache;
+
+static EventAllocatorCache *
+EventAllocatorPeekCache (void)
+{
+  return &g_eventAllocatorCache;
+}
+
+static EventAllocatorCache *
+EventAllocatorGetCache (void)
+{
+  return &g_eventAllocatorCache;
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+/**
+ * \param size the size of a block of at most EVENT_ALLOCATOR_MAX_SIZE
+ * \returns the size class of the block
+ */
+static uint32_t
+EventAllocatorGetClass (std::size_t size)
+{
+  return size == 0 ? 0 : (size - 1) / EVENT_ALLOCATOR_GRANULE;
+}
+
+void *
+EventAllocator::Allocate (std::size_t size)
+{
+  if (size > EVENT_ALLOCATOR_MAX_SIZE)
+    {
+      if (m_enabled)
+        {
+          EventAllocatorCount (EventAllocatorGetCache ()->stats.oversized);
+        }
+      return ::operator new (size);
+    }
+  uint32_t c = EventAllocatorGetClass (size);
+  if (!m_enabled)
+    {
+      // the whole class, so that the block can be pooled if enabled later
+      return ::operator new ((c + 1) * EVENT_ALLOCATOR_GRANULE);
+    }
+  EventAllocatorCache *cache = EventAllocatorGetCache ();
+  EventAllocatorCount (cache->stats.allocations);
+  EventAllocatorCache::Block *block = cache->free[c];
+  if (block != 0)
+    {
+      cache->free[c] = block->next;
+      cache->length[c]--;
+      EventAllocatorCount (cache->stats.hits);
+      return block;
+    }
+  return ::operator new ((c + 1) * EVENT_ALLOCATOR_GRANULE);
+}
+
+void
+EventAllocator::Deallocate (void *block, std::size_t size)
+{
+  if (block == 0)
+    {
+      return;
+    }
+  if (!m_enabled || size > EVENT_ALLOCATOR_MAX_SIZE)
+    {
+      ::operator delete (block);
+      return;
+    }
+  uint32_t c = EventAllocatorGetClass (size);
+  EventAllocatorCache *cache = EventAllocatorGetCache ();
+  if (cache->length[c] >= EVENT_ALLOCATOR_MAX_CACHED)
+    {
+      ::operator delete (block);
+      return;
+    }
+  EventAllocatorCache::Block *free = static_cast<EventAllocatorCache::Block *> (block);
+  free->next = cache->free[c];
+  cache->free[c] = free;
+  cache->length[c]++;
+}
+
+void
+EventAllocator::Enable (void)
+{
+  m_enabled = true;
+}
+
+void
+EventAllocator::Disable (void)
+{
+  m_enabled = false;
+}
+
+void
+EventAllocator::Purge (void)
+{
+  EventAllocatorCache *cache = EventAllocatorPeekCache ();
+  if (cache != 0)
+    {
+      EventAllocatorRelease (cache);
+    }
+}
+
+EventAllocator::Stats
+EventAllocator::GetStats (void)
+{
+  Stats stats;
+  std::memset (&stats, 0, sizeof (stats));
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&g_eventAllocatorLock);
+  EventAllocatorAdd (stats, g_eventAllocatorExited);
+  for (EventAllocatorCache *cache = g_eventAllocatorCaches; cache != 0; cache = cache->next)
+    {
+      EventAllocatorAdd (stats, cache->stats);
+    }
+  pthread_mutex_unlock (&g_eventAllocatorLock);
+#else
+  EventAllocatorAdd (stats, g_eventAllocatorCache.stats);
+#endif
+  return stats;
+}
+
+void
+EventAllocator::ResetStats (void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&g_eventAllocatorLock);
+  EventAllocatorClear (g_eventAllocatorExited);
+  for (EventAllocatorCache *cache = g_eventAllocatorCaches; cache != 0; cache = cache->next)
+    {
+      EventAllocatorClear (cache->stats);
+    }
+  pthread_mutex_unlock (&g_eventAllocatorLock);
+#else
+  EventAllocatorClear (g_eventAllocatorCache.stats);
+#endif
+}
+
+void
+EventAllocator::PrintStats (std::ostream &os)
+{
+  Stats stats = GetStats ();
+  os << "Event pools: " << stats.allocations << " allocations, "
+     << stats.hits << " hits";
+  if (stats.allocations > 0)
+    {
+      os << " (" << 100.0 * stats.hits / stats.allocations << "%)";
+    }
+  os << ", " << stats.oversized << " oversized" << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_ALLOCATOR_H
+#define EVENT_ALLOCATOR_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <new>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief Size-class pools for the memory of the events.
+ *
+ * The EventImpl objects created by MakeEvent and the nodes of the event
+ * lists of the schedulers (see EventContainerAllocator) are allocated
+ * and released once per event. Instead of returning them to malloc, the
+ * blocks are kept on free lists of 16 byte size classes, up to 256
+ * bytes, and handed out again to the next allocation of their class.
+ *
+ * The free lists are per thread, so events scheduled by the other
+ * threads of the RealtimeSimulatorImpl need no lock; a block released by
+ * another thread than the one which allocated it simply moves to the
+ * free lists of the releasing thread. The cached blocks of a thread are
+ * released when it exits, or by Purge, which Simulator::Destroy calls.
+ *
+ * The pools are enabled by default; they are bypassed after Disable, or
+ * with the "EventPool" global value set to false (e.g. --EventPool=false
+ * on the command line). The global value is applied when the simulator
+ * implementation is created, only if it changed since it was last
+ * applied, so it does not override a later Enable or Disable.
+ */
+class EventAllocator
+{
+public:
+  /**
+   * \brief Allocation counters of the pools.
+   */
+  struct Stats
+  {
+    uint64_t allocations;   //!< allocations of at most the largest size class
+    uint64_t hits;          //!< allocations served from a free list
+    uint64_t oversized;     //!< allocations larger than the largest size class
+  };
+
+  /**
+   * \param size the size of the block
+   * \returns the block
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * \param block the block returned by Allocate
+   * \param size the size given to Allocate
+   */
+  static void Deallocate (void *block, std::size_t size);
+
+  /**
+   * \brief Serve the allocations from the pools.
+   */
+  static void Enable (void);
+  /**
+   * \brief Allocate and release directly with operator new and delete.
+   */
+  static void Disable (void);
+  /**
+   * \returns true if the pools are used
+   */
+  static bool IsEnabled (void)
+  {
+    return m_enabled;
+  }
+  /**
+   * \brief Release the blocks cached by the calling thread.
+   */
+  static void Purge (void);
+
+  /**
+   * \returns the counters of all the threads
+   *
+   * The counters of the threads which are still allocating may be a few
+   * events behind, but are never torn.
+   */
+  static Stats GetStats (void);
+  /**
+   * \brief Clear the counters.
+   *
+   * Only safe while the other threads do not allocate, e.g. before
+   * Simulator::Run or after it returns: a counter cleared while its thread
+   * increments it may get back its previous value.
+   */
+  static void ResetStats (void);
+  /**
+   * \param os the output stream
+   *
+   * Print the counters and the hit rate of the pools.
+   */
+  static void PrintStats (std::ostream &os);
+
+private:
+  static bool m_enabled;
+};
+
+/**
+ * \ingroup events
+ * \brief A standard allocator which takes its single element blocks
+ * from the EventAllocator pools.
+ *
+ * Used by the node based containers of the schedulers, whose nodes are
+ * allocated and released once per event.
+ */
+template <typename T>
+class EventContainerAllocator
+{
+public:
+  typedef T value_type;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind
+  {
+    typedef EventContainerAllocator<U> other;
+  };
+
+  EventContainerAllocator () {}
+  EventContainerAllocator (const EventContainerAllocator &) {}
+  template <typename U>
+  EventContainerAllocator (const EventContainerAllocator<U> &) {}
+
+  pointer address (reference x) const
+  {
+    return &x;
+  }
+  const_pointer address (const_reference x) const
+  {
+    return &x;
+  }
+  pointer allocate (size_type n, const void * = 0)
+  {
+    if (n == 1)
+      {
+        return static_cast<pointer> (EventAllocator::Allocate (sizeof (T)));
+      }
+    return static_cast<pointer> (::operator new (n * sizeof (T)));
+  }
+  void deallocate (pointer p, size_type n)
+  {
+    if (n == 1)
+      {
+        EventAllocator::Deallocate (p, sizeof (T));
+        return;
+      }
+    ::operator delete (p);
+  }
+  size_type max_size (void) const
+  {
+    return std::size_t (-1) / sizeof (T);
+  }
+  void construct (pointer p, const T &value)
+  {
+    new (static_cast<void *> (p)) T (value);
+  }
+  void destroy (pointer p)
+  {
+    p->~T ();
+  }
+};
+
+template <typename T, typename U>
+inline bool operator == (const EventContainerAllocator<T> &, const EventContainerAllocator<U> &)
+{
+  return true;
+}
+
+template <typename T, typename U>
+inline bool operator != (const EventContainerAllocator<T> &, const EventContainerAllocator<U> &)
+{
+  return false;
+}
+
+} // namespace ns3
+
+#endif /* EVENT_ALLOCATOR_H */
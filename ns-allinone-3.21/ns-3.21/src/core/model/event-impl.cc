@@ -19,6 +19,7 @@
  */
 
 #include "event-impl.h"
+#include "event-profiler.h"
 #include "log.h"
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
@@ -42,7 +43,17 @@ EventImpl::Invoke (void)
   NS_LOG_FUNCTION (this);
   if (!m_cancel)
     {
-      Notify ();
+      if (EventProfiler::IsEnabled ())
+        {
+          const void *target = GetTarget ();
+          uint64_t start = EventProfiler::Start ();
+          Notify ();
+          EventProfiler::Stop (this, target, start);
+        }
+      else
+        {
+          Notify ();
+        }
     }
 }
 
@@ -60,4 +71,10 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+const void *
+EventImpl::GetTarget (void) const
+{
+  return 0;
+}
+
 } // namespace ns3
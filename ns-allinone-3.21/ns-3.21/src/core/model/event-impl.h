@@ -22,6 +22,7 @@
 
 #include <stdint.h>
 #include "simple-ref-count.h"
+#include "event-allocator.h"
 
 namespace ns3 {
 
@@ -57,6 +58,31 @@ public:
    * Invoked by the simulation engine before calling Invoke.
    */
   bool IsCancelled (void);
+  /**
+   * \returns the value of the function pointer of the event, or zero
+   * if it has none. For a member function, it is an opaque value which
+   * is only an address for the non virtual functions of some ABIs.
+   *
+   * Only used by the EventProfiler to tell the events apart.
+   */
+  virtual const void * GetTarget (void) const;
+
+  /**
+   * \param size the size of the event
+   * \returns the memory of the event, taken from the EventAllocator pools
+   */
+  static void * operator new (std::size_t size)
+  {
+    return EventAllocator::Allocate (size);
+  }
+  /**
+   * \param block the memory of the event
+   * \param size the size of the event
+   */
+  static void operator delete (void *block, std::size_t size)
+  {
+    EventAllocator::Deallocate (block, size);
+  }
 
 protected:
   virtual void Notify (void) = 0;
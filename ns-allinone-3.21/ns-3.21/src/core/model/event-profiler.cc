@@ -0,0 +1,304 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-config.h"
+#include "event-profiler.h"
+#include "event-impl.h"
+#include "simulator.h"
+
+#include <map>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <typeinfo>
+#include <algorithm>
+#include <cxxabi.h>
+#include <time.h>
+#include <sys/time.h>
+#ifdef HAVE_DLFCN_H
+#include <dlfcn.h>
+#endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+// Note: no logging in this file, the functions below run around every
+// event while the profiler is enabled.
+
+namespace ns3 {
+
+bool EventProfiler::m_enabled = false;
+
+namespace {
+
+/**
+ * Totals of a target or a context.
+ */
+struct Totals
+{
+  Totals () : count (0), nanoseconds (0) {}
+  uint64_t count;
+  uint64_t nanoseconds;
+};
+
+/**
+ * A target is known by its address and the type of the event, the latter
+ * naming the target when the address is unknown or cannot be resolved.
+ */
+typedef std::pair<const void *, const char *> TargetKey;
+
+struct State
+{
+  std::map<TargetKey, Totals> targets;
+  std::map<uint32_t, Totals> contexts;
+};
+
+State *
+PeekState (void)
+{
+  static State state;
+  return &state;
+}
+
+#ifdef HAVE_PTHREAD_H
+/// Serializes the events run by the threads of the RealtimeSimulatorImpl
+pthread_mutex_t g_stateLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/**
+ * Holds the lock of the State for its lifetime.
+ */
+class StateLock
+{
+public:
+  StateLock ()
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock (&g_stateLock);
+#endif
+  }
+  ~StateLock ()
+  {
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock (&g_stateLock);
+#endif
+  }
+};
+
+std::string
+Demangle (const char *mangled)
+{
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, 0, 0, &status);
+  std::string name = (status == 0 && demangled != 0) ? demangled : mangled;
+  std::free (demangled);
+  return name;
+}
+
+std::string
+GetTargetName (const TargetKey &key)
+{
+#ifdef HAVE_DLFCN_H
+  Dl_info info;
+  if (key.first != 0 && dladdr (key.first, &info) != 0 && info.dli_sname != 0)
+    {
+      return Demangle (info.dli_sname);
+    }
+#endif
+  std::ostringstream oss;
+  oss << Demangle (key.second);
+  if (key.first != 0)
+    {
+      oss << " [" << key.first << "]";
+    }
+  return oss.str ();
+}
+
+std::string
+GetContextName (uint32_t context)
+{
+  if (context == 0xffffffff)
+    {
+      return "none";
+    }
+  std::ostringstream oss;
+  oss << context;
+  return oss.str ();
+}
+
+bool
+IsMoreExpensive (const EventProfiler::Entry &a, const EventProfiler::Entry &b)
+{
+  if (a.seconds != b.seconds)
+    {
+      return a.seconds > b.seconds;
+    }
+  return a.count > b.count;
+}
+
+EventProfiler::Entry
+MakeEntry (const std::string &name, const Totals &totals)
+{
+  EventProfiler::Entry entry;
+  entry.name = name;
+  entry.count = totals.count;
+  entry.seconds = totals.nanoseconds * 1e-9;
+  return entry;
+}
+
+void
+PrintTable (std::ostream &os, const std::vector<EventProfiler::Entry> &entries,
+            uint32_t rows, double seconds, const std::string &column)
+{
+  os << std::setw (12) << "time (s)" << std::setw (8) << "%"
+     << std::setw (12) << "events" << std::setw (12) << "mean (us)"
+     << "  " << column << std::endl;
+  for (uint32_t i = 0; i < entries.size () && (rows == 0 || i < rows); ++i)
+    {
+      const EventProfiler::Entry &entry = entries[i];
+      os << std::setw (12) << std::setprecision (6) << entry.seconds
+         << std::setw (8) << std::setprecision (1)
+         << (seconds > 0 ? 100.0 * entry.seconds / seconds : 0.0)
+         << std::setw (12) << entry.count
+         << std::setw (12) << std::setprecision (3)
+         << (entry.count > 0 ? 1e6 * entry.seconds / entry.count : 0.0)
+         << "  " << entry.name << std::endl;
+    }
+}
+
+} // anonymous namespace
+
+void
+EventProfiler::Enable (void)
+{
+  m_enabled = true;
+}
+
+void
+EventProfiler::Disable (void)
+{
+  m_enabled = false;
+}
+
+void
+EventProfiler::Reset (void)
+{
+  StateLock lock;
+  State *state = PeekState ();
+  state->targets.clear ();
+  state->contexts.clear ();
+}
+
+uint64_t
+EventProfiler::Start (void)
+{
+#if defined (CLOCK_MONOTONIC)
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  return tv.tv_sec * 1000000000ULL + tv.tv_usec * 1000ULL;
+#endif
+}
+
+void
+EventProfiler::Stop (const EventImpl *event, const void *target, uint64_t start)
+{
+  uint64_t elapsed = Start () - start;
+  uint32_t contextId = Simulator::GetContext ();
+  StateLock lock;
+  State *state = PeekState ();
+
+  Totals &totals = state->targets[TargetKey (target, typeid (*event).name ())];
+  totals.count++;
+  totals.nanoseconds += elapsed;
+
+  Totals &context = state->contexts[contextId];
+  context.count++;
+  context.nanoseconds += elapsed;
+}
+
+std::vector<EventProfiler::Entry>
+EventProfiler::GetTargets (void)
+{
+  StateLock lock;
+  State *state = PeekState ();
+  // Different keys may resolve to the same name, e.g. the thunks of a
+  // virtual function, so the totals are merged by name.
+  std::map<std::string, Totals> named;
+  for (std::map<TargetKey, Totals>::const_iterator i = state->targets.begin ();
+       i != state->targets.end (); ++i)
+    {
+      Totals &totals = named[GetTargetName (i->first)];
+      totals.count += i->second.count;
+      totals.nanoseconds += i->second.nanoseconds;
+    }
+  std::vector<Entry> entries;
+  for (std::map<std::string, Totals>::const_iterator i = named.begin (); i != named.end (); ++i)
+    {
+      entries.push_back (MakeEntry (i->first, i->second));
+    }
+  std::sort (entries.begin (), entries.end (), IsMoreExpensive);
+  return entries;
+}
+
+std::vector<EventProfiler::Entry>
+EventProfiler::GetContexts (void)
+{
+  StateLock lock;
+  State *state = PeekState ();
+  std::vector<Entry> entries;
+  for (std::map<uint32_t, Totals>::const_iterator i = state->contexts.begin ();
+       i != state->contexts.end (); ++i)
+    {
+      entries.push_back (MakeEntry (GetContextName (i->first), i->second));
+    }
+  std::sort (entries.begin (), entries.end (), IsMoreExpensive);
+  return entries;
+}
+
+void
+EventProfiler::Print (std::ostream &os, uint32_t maxContexts)
+{
+  std::vector<Entry> targets = GetTargets ();
+  std::vector<Entry> contexts = GetContexts ();
+  uint64_t count = 0;
+  double seconds = 0;
+  for (uint32_t i = 0; i < targets.size (); ++i)
+    {
+      count += targets[i].count;
+      seconds += targets[i].seconds;
+    }
+
+  std::ios_base::fmtflags flags = os.flags ();
+  std::streamsize precision = os.precision ();
+  os << std::fixed;
+  os << "Event profile: " << count << " events, " << std::setprecision (6) << seconds
+     << " s of wall clock time" << std::endl;
+  PrintTable (os, targets, 0, seconds, "target");
+  os << std::endl;
+  if (maxContexts > 0 && contexts.size () > maxContexts)
+    {
+      os << "Most expensive " << maxContexts << " of " << contexts.size () << " contexts" << std::endl;
+    }
+  PrintTable (os, contexts, maxContexts, seconds, "context");
+  os.flags (flags);
+  os.precision (precision);
+}
+
+} // namespace ns3
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup events
+ * \brief Attribute the wall clock time of the events to their target
+ * and to their node context.
+ *
+ * While enabled, EventImpl::Invoke measures every event it runs and
+ * accounts it to the function the event invokes and to the context the
+ * event was scheduled with. The function is told apart by the type of
+ * the event and the value of its function pointer (EventImpl::GetTarget);
+ * it is named from the symbol tables of the loaded libraries when that
+ * value resolves to a symbol, and from the type of the event otherwise.
+ *
+ * The counters are shared by all the threads under a lock, as the
+ * RealtimeSimulatorImpl runs the events scheduled by other threads.
+ *
+ * The profiler is enabled with Enable, or with the "EventProfiler"
+ * global value (e.g. --EventProfiler=true on the command line) when the
+ * simulator implementation is created. Simulator::Destroy prints the
+ * report to std::clog, resets the counters and disables the profiler.
+ */
+class EventProfiler
+{
+public:
+  /**
+   * \brief Execution totals of a target or a context.
+   */
+  struct Entry
+  {
+    std::string name;   //!< name of the target or of the context
+    uint64_t count;     //!< events executed
+    double seconds;     //!< wall clock time spent in the events
+  };
+
+  /**
+   * \brief Start accounting the events.
+   */
+  static void Enable (void);
+  /**
+   * \brief Stop accounting the events. The counters are kept.
+   */
+  static void Disable (void);
+  /**
+   * \returns true if the events are accounted
+   */
+  static bool IsEnabled (void)
+  {
+    return m_enabled;
+  }
+  /**
+   * \brief Clear the counters.
+   */
+  static void Reset (void);
+
+  /**
+   * \returns the totals per event target, the most expensive first
+   */
+  static std::vector<Entry> GetTargets (void);
+  /**
+   * \returns the totals per context, the most expensive first
+   */
+  static std::vector<Entry> GetContexts (void);
+  /**
+   * \param os the output stream
+   * \param maxContexts the number of contexts to list, 0 for all
+   *
+   * Print the totals per target and those of the most expensive contexts.
+   */
+  static void Print (std::ostream &os, uint32_t maxContexts = 20);
+
+  /**
+   * \returns the wall clock time in nanoseconds
+   *
+   * Called by EventImpl::Invoke before running an event.
+   */
+  static uint64_t Start (void);
+  /**
+   * \param event the event that has run
+   * \param target the EventImpl::GetTarget of the event, taken before
+   *        running it as the event may delete its object
+   * \param start the value Start returned before running it
+   *
+   * Called by EventImpl::Invoke after running an event.
+   */
+  static void Stop (const EventImpl *event, const void *target, uint64_t start);
+
+private:
+  static bool m_enabled;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -143,10 +143,10 @@ HeapScheduler::IsEmpty (void) const
 }
 
 void
-HeapScheduler::BottomUp (void)
+HeapScheduler::BottomUp (uint32_t start)
 {
-  NS_LOG_FUNCTION (this);
-  uint32_t index = Last ();
+  NS_LOG_FUNCTION (this << start);
+  uint32_t index = start;
   while (!IsRoot (index)
          && IsLessStrictly (index, Parent (index)))
     {
@@ -196,7 +196,7 @@ HeapScheduler::Insert (const Event &ev)
 {
   NS_LOG_FUNCTION (this << &ev);
   m_heap.push_back (ev);
-  BottomUp ();
+  BottomUp (Last ());
 }
 
 Scheduler::Event
@@ -229,6 +229,11 @@ HeapScheduler::Remove (const Event &ev)
           NS_ASSERT (m_heap[i].impl == ev.impl);
           Exch (i, Last ());
           m_heap.pop_back ();
+          // the last event may be earlier than the parent of the removed one
+          if (i < m_heap.size ())
+            {
+              BottomUp (i);
+            }
           TopDown (i);
           return;
         }
@@ -0,0 +1,289 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+namespace {
+
+// a bucket with more events is spread on a child rung rather than sorted
+const uint32_t THRESHOLD = 50;
+const uint32_t MAX_RUNGS = 8;
+
+// order of m_bottom, the next event last
+bool
+IsLater (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return b.key < a.key;
+}
+
+} // anonymous namespace
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topStart (0),
+    m_topMin (0),
+    m_topMax (0),
+    m_rungs (MAX_RUNGS),
+    m_nRungs (0),
+    m_size (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+LadderScheduler::GetCurrentStart (const Rung &rung) const
+{
+  if (rung.current == rung.buckets.size ())
+    {
+      return rung.end;
+    }
+  return rung.start + rung.current * rung.width;
+}
+
+uint32_t
+LadderScheduler::GetBucket (const Rung &rung, uint64_t ts) const
+{
+  uint64_t bucket = (ts - rung.start) / rung.width;
+  return std::min<uint64_t> (bucket, rung.buckets.size () - 1);
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  if (m_size == 0)
+    {
+      // start over with everything in m_top
+      m_nRungs = 0;
+      m_topStart = 0;
+    }
+  m_size++;
+
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      if (m_top.empty ())
+        {
+          m_topMin = ts;
+          m_topMax = ts;
+        }
+      else
+        {
+          m_topMin = std::min (m_topMin, ts);
+          m_topMax = std::max (m_topMax, ts);
+        }
+      m_top.push_back (ev);
+      return;
+    }
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      Rung &rung = m_rungs[i];
+      if (ts >= GetCurrentStart (rung))
+        {
+          rung.buckets[GetBucket (rung, ts)].push_back (ev);
+          rung.count++;
+          return;
+        }
+    }
+  m_bottom.insert (std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, IsLater), ev);
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  // moving the events down the ladder does not change the content of the queue
+  const_cast<LadderScheduler *> (this)->Refill ();
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Refill ();
+  Scheduler::Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  m_size--;
+  NS_LOG_LOGIC ("remove ts=" << ev.key.m_ts << ", key=" << ev.key.m_uid);
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  Bucket *bucket = Find (ev);
+  for (Bucket::iterator i = bucket->begin (); i != bucket->end (); ++i)
+    {
+      if (i->key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (ev.impl == i->impl);
+          // only m_bottom is sorted
+          bucket->erase (i);
+          m_size--;
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+LadderScheduler::Bucket *
+LadderScheduler::Find (const Event &ev)
+{
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      return &m_top;
+    }
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      Rung &rung = m_rungs[i];
+      if (ts >= GetCurrentStart (rung))
+        {
+          rung.count--;
+          return &rung.buckets[GetBucket (rung, ts)];
+        }
+    }
+  return &m_bottom;
+}
+
+void
+LadderScheduler::Refill (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (m_bottom.empty ())
+    {
+      if (m_nRungs == 0)
+        {
+          NS_ASSERT (!m_top.empty ());
+          SpawnFromTop ();
+          continue;
+        }
+      Rung &rung = m_rungs[m_nRungs - 1];
+      if (rung.count == 0)
+        {
+          m_nRungs--;
+          continue;
+        }
+      while (rung.buckets[rung.current].empty ())
+        {
+          rung.current++;
+        }
+      Bucket &bucket = rung.buckets[rung.current];
+      rung.current++;
+      rung.count -= bucket.size ();
+      if (bucket.size () <= THRESHOLD || m_nRungs == MAX_RUNGS
+          || !Spawn (bucket, GetCurrentStart (rung)))
+        {
+          ToBottom (bucket);
+        }
+    }
+}
+
+void
+LadderScheduler::SpawnFromTop (void)
+{
+  NS_LOG_FUNCTION (this << m_top.size () << m_topMin << m_topMax);
+  Rung &rung = m_rungs[0];
+  m_nRungs = 1;
+  uint64_t width = std::max<uint64_t> ((m_topMax - m_topMin) / m_top.size (), 1);
+  uint64_t end = m_topMin + ((m_topMax - m_topMin) / width + 1) * width;
+  Fill (rung, m_topMin, m_topMax, end, m_top);
+  m_topStart = end;
+}
+
+bool
+LadderScheduler::Spawn (Bucket &bucket, uint64_t end)
+{
+  uint64_t min = bucket.front ().key.m_ts;
+  uint64_t max = min;
+  for (Bucket::const_iterator i = bucket.begin (); i != bucket.end (); ++i)
+    {
+      min = std::min (min, i->key.m_ts);
+      max = std::max (max, i->key.m_ts);
+    }
+  if (min == max)
+    {
+      return false;
+    }
+  NS_LOG_LOGIC ("spawn rung " << m_nRungs << " for " << bucket.size () << " events");
+  Rung &rung = m_rungs[m_nRungs];
+  m_nRungs++;
+  Fill (rung, min, max, end, bucket);
+  return true;
+}
+
+void
+LadderScheduler::Fill (Rung &rung, uint64_t min, uint64_t max, uint64_t end, Bucket &events)
+{
+  rung.width = std::max<uint64_t> ((max - min) / events.size (), 1);
+  rung.start = min;
+  rung.end = end;
+  rung.current = 0;
+  rung.count = events.size ();
+  // the events of an emptied rung have all been moved down
+  rung.buckets.resize ((max - min) / rung.width + 1);
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      rung.buckets[GetBucket (rung, i->key.m_ts)].push_back (*i);
+    }
+  events.clear ();
+}
+
+void
+LadderScheduler::ToBottom (Bucket &bucket)
+{
+  NS_LOG_LOGIC ("sort " << bucket.size () << " events");
+  std::sort (bucket.begin (), bucket.end (), IsLater);
+  // m_bottom is empty: keep its capacity in the bucket for the next events
+  m_bottom.swap (bucket);
+}
+
+} // namespace ns3
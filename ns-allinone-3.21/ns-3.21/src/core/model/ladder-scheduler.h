@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue of "Ladder Queue: An
+ * O(1) Priority Queue Structure for Large-Scale Discrete Event Simulation"
+ * by Tang, Goh and Thng (ACM TOMACS, 2005). The events are kept in three
+ * tiers:
+ *  - Top, an unsorted list of the events later than every bucket of the
+ *    ladder, with the range of their timestamps;
+ *  - the ladder, up to eight rungs of unsorted buckets. The first rung is
+ *    built from Top when the ladder is empty, with a bucket width chosen
+ *    from the number of events and their timestamp range. When the next
+ *    bucket of a rung holds too many events, it is not sorted but spread
+ *    on a child rung of narrower buckets, sized for these events;
+ *  - Bottom, the sorted events of the bucket being consumed.
+ *
+ * Only the small buckets that reach Bottom are ever sorted, so each event
+ * costs O(1) amortized whatever the distribution of the timestamps. A
+ * bucket whose events all have the same timestamp, as after a broadcast
+ * on a channel of constant delay, goes to Bottom whatever its size, since
+ * no rung can spread it.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  LadderScheduler ();
+  virtual ~LadderScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+private:
+  typedef std::vector<Scheduler::Event> Bucket;
+  struct Rung
+  {
+    std::vector<Bucket> buckets;
+    // timestamp at the start of the first bucket
+    uint64_t start;
+    // duration of a bucket, the last one extends to end
+    uint64_t width;
+    // timestamp at the end of the last bucket
+    uint64_t end;
+    // index of the first bucket not yet moved down
+    uint32_t current;
+    // number of events in the buckets
+    uint32_t count;
+  };
+
+  void Refill (void);
+  void SpawnFromTop (void);
+  bool Spawn (Bucket &bucket, uint64_t end);
+  void Fill (Rung &rung, uint64_t min, uint64_t max, uint64_t end, Bucket &events);
+  void ToBottom (Bucket &bucket);
+  inline uint64_t GetCurrentStart (const Rung &rung) const;
+  inline uint32_t GetBucket (const Rung &rung, uint64_t ts) const;
+  Bucket * Find (const Event &ev);
+
+  Bucket m_top;
+  // events at or after this timestamp go to m_top
+  uint64_t m_topStart;
+  uint64_t m_topMin;
+  uint64_t m_topMax;
+  // rungs in use, from the widest to the narrowest
+  std::vector<Rung> m_rungs;
+  uint32_t m_nRungs;
+  // sorted, the next event last
+  Bucket m_bottom;
+  // number of events in queue
+  uint32_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
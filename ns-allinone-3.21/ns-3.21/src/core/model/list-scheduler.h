@@ -22,6 +22,7 @@
 #define LIST_SCHEDULER_H
 
 #include "scheduler.h"
+#include "event-allocator.h"
 #include <list>
 #include <utility>
 #include <stdint.h>
@@ -52,8 +53,8 @@ public:
   virtual void Remove (const Event &ev);
 
 private:
-  typedef std::list<Event> Events;
-  typedef std::list<Event>::iterator EventsI;
+  typedef std::list<Event, EventContainerAllocator<Event> > Events;
+  typedef Events::iterator EventsI;
   Events m_events;
 };
 
@@ -21,6 +21,10 @@ public:
     virtual ~EventFunctionImpl0 ()
     {
     }
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 protected:
     virtual void Notify (void)
     {
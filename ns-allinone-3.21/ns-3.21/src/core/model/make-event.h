@@ -58,6 +58,7 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5
 
 #include "event-impl.h"
 #include "type-traits.h"
+#include <cstring>
 
 namespace ns3 {
 
@@ -73,6 +74,22 @@ struct EventMemberImplObjTraits<T *>
   }
 };
 
+/**
+ * \returns the leading bytes of the function pointer f, zero padded
+ *
+ * Only used to tell the events apart in the EventProfiler reports: the
+ * representation of f is copied, never interpreted. It is the address
+ * of the function for a plain function pointer; for a member function
+ * pointer it depends on the ABI.
+ */
+template <typename F>
+const void * EventImplTarget (F f)
+{
+  const void *target = 0;
+  std::memcpy (&target, &f, sizeof (f) < sizeof (target) ? sizeof (f) : sizeof (target));
+  return target;
+}
+
 template <typename MEM, typename OBJ>
 EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
 {
@@ -88,6 +105,11 @@ public:
     virtual ~EventMemberImpl0 ()
     {
     }
+public:
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 private:
     virtual void Notify (void)
     {
@@ -118,6 +140,11 @@ protected:
     virtual ~EventMemberImpl1 ()
     {
     }
+public:
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 private:
     virtual void Notify (void)
     {
@@ -149,6 +176,11 @@ protected:
     virtual ~EventMemberImpl2 ()
     {
     }
+public:
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 private:
     virtual void Notify (void)
     {
@@ -182,6 +214,11 @@ protected:
     virtual ~EventMemberImpl3 ()
     {
     }
+public:
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 private:
     virtual void Notify (void)
     {
@@ -217,6 +254,11 @@ protected:
     virtual ~EventMemberImpl4 ()
     {
     }
+public:
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 private:
     virtual void Notify (void)
     {
@@ -255,6 +297,11 @@ protected:
     virtual ~EventMemberImpl5 ()
     {
     }
+public:
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 private:
     virtual void Notify (void)
     {
@@ -289,6 +336,11 @@ protected:
     virtual ~EventFunctionImpl1 ()
     {
     }
+public:
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 private:
     virtual void Notify (void)
     {
@@ -319,6 +371,11 @@ protected:
     virtual ~EventFunctionImpl2 ()
     {
     }
+public:
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 private:
     virtual void Notify (void)
     {
@@ -352,6 +409,11 @@ protected:
     virtual ~EventFunctionImpl3 ()
     {
     }
+public:
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 private:
     virtual void Notify (void)
     {
@@ -387,6 +449,11 @@ protected:
     virtual ~EventFunctionImpl4 ()
     {
     }
+public:
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 private:
     virtual void Notify (void)
     {
@@ -424,6 +491,11 @@ protected:
     virtual ~EventFunctionImpl5 ()
     {
     }
+public:
+    virtual const void * GetTarget (void) const
+    {
+      return EventImplTarget (m_function);
+    }
 private:
     virtual void Notify (void)
     {
@@ -22,6 +22,7 @@
 #define MAP_SCHEDULER_H
 
 #include "scheduler.h"
+#include "event-allocator.h"
 #include <stdint.h>
 #include <map>
 #include <utility>
@@ -49,9 +50,10 @@ public:
   virtual Event RemoveNext (void);
   virtual void Remove (const Event &ev);
 private:
-  typedef std::map<Scheduler::EventKey, EventImpl*> EventMap;
-  typedef std::map<Scheduler::EventKey, EventImpl*>::iterator EventMapI;
-  typedef std::map<Scheduler::EventKey, EventImpl*>::const_iterator EventMapCI;
+  typedef std::map<Scheduler::EventKey, EventImpl*, std::less<Scheduler::EventKey>,
+                   EventContainerAllocator<std::pair<const Scheduler::EventKey, EventImpl*> > > EventMap;
+  typedef EventMap::iterator EventMapI;
+  typedef EventMap::const_iterator EventMapCI;
 
 
   EventMap m_list;
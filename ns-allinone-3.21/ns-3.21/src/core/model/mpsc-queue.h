@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <stdint.h>
+#include <vector>
+#include "system-mutex.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Lock-free multi-producer single-consumer queue.
+ *
+ * Any thread may Push items; a single thread takes them all at once with
+ * Drain, in the order they were pushed. The pending items form a linked
+ * stack: Push links its node to the head with a compare-and-swap and Drain
+ * detaches the whole stack with an atomic exchange, then reverses it. As
+ * nodes are never popped one by one there is no ABA problem, and neither
+ * side ever blocks the other.
+ *
+ * This is how the simulator implementations receive the events scheduled
+ * by the threads of the emulation devices (see
+ * Simulator::ScheduleWithContext). Compilers without the GCC atomic
+ * builtins fall back to a SystemMutex.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+  MpscQueue ();
+  ~MpscQueue ();
+
+  /**
+   * \param item the item to append, copied
+   * \returns true if the queue was empty, i.e., if the consumer may need
+   *          to be woken up
+   *
+   * Safe to call from any thread.
+   */
+  bool Push (const T &item);
+  /**
+   * \returns true if no item is pending
+   *
+   * A cheap hint for the consumer to skip Drain: an item pushed
+   * concurrently may not be seen yet.
+   */
+  bool IsEmpty (void) const;
+  /**
+   * \param items the vector the pending items are appended to, oldest first
+   * \returns the number of items appended
+   *
+   * Must only be called by the consumer thread.
+   */
+  uint32_t Drain (std::vector<T> &items);
+
+private:
+  struct Node
+  {
+    T item;
+    Node *next;
+  };
+
+  MpscQueue (const MpscQueue &);
+  MpscQueue & operator = (const MpscQueue &);
+
+  Node * volatile m_head; //!< the last pushed node
+#ifndef __GNUC__
+  SystemMutex m_mutex;
+#endif
+};
+
+} // namespace ns3
+
+namespace ns3 {
+
+template <typename T>
+MpscQueue<T>::MpscQueue ()
+  : m_head (0)
+{
+}
+
+template <typename T>
+MpscQueue<T>::~MpscQueue ()
+{
+  Node *node = m_head;
+  while (node != 0)
+    {
+      Node *next = node->next;
+      delete node;
+      node = next;
+    }
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Push (const T &item)
+{
+  Node *node = new Node;
+  node->item = item;
+#ifdef __GNUC__
+  Node *head;
+  do
+    {
+      head = m_head;
+      node->next = head;
+    }
+  while (!__sync_bool_compare_and_swap (&m_head, head, node));
+  return head == 0;
+#else
+  CriticalSection cs (m_mutex);
+  node->next = m_head;
+  m_head = node;
+  return node->next == 0;
+#endif
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty (void) const
+{
+  return m_head == 0;
+}
+
+template <typename T>
+uint32_t
+MpscQueue<T>::Drain (std::vector<T> &items)
+{
+  if (m_head == 0)
+    {
+      return 0;
+    }
+#ifdef __GNUC__
+  Node *node = __sync_lock_test_and_set (&m_head, (Node *)0);
+#else
+  Node *node;
+  {
+    CriticalSection cs (m_mutex);
+    node = m_head;
+    m_head = 0;
+  }
+#endif
+  // the stack holds the newest item first
+  Node *reversed = 0;
+  uint32_t n = 0;
+  while (node != 0)
+    {
+      Node *next = node->next;
+      node->next = reversed;
+      reversed = node;
+      node = next;
+      n++;
+    }
+  while (reversed != 0)
+    {
+      Node *next = reversed->next;
+      items.push_back (reversed->item);
+      delete reversed;
+      reversed = next;
+    }
+  return n;
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
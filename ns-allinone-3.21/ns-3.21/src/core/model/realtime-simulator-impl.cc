@@ -34,6 +34,9 @@
 
 
 #include <cmath>
+#include <algorithm>
+#include <time.h>
+#include <sys/time.h>
 
 // Note:  Logging in this file is largely avoided due to the
 // number of calls that are made to these functions and the possibility
@@ -80,6 +83,7 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
   m_uid = 4; 
   // before ::Run is entered, the m_currentUid will be zero
   m_currentUid = 0;
+  m_eventCount = 0;
   m_currentTs = 0;
   m_currentContext = 0xffffffff;
   m_unscheduledEvents = 0;
@@ -201,6 +205,15 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
 
       { 
         CriticalSection cs (m_mutex);
+        //
+        // This resets the synchronizer so that any future event will cause it
+        // to interrupt the wait below.  It must come before we take the events
+        // the other threads have scheduled: one scheduled after that will
+        // signal the synchronizer again.
+        //
+        m_synchronizer->SetCondition (false);
+        ProcessEventsWithContext ();
+
         //
         // Since we are in realtime mode, the time to delay has got to be the 
         // difference between the current realtime and the timestamp of the next 
@@ -246,10 +259,9 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
         // We've figured out how long we need to delay in order to pace the 
         // simulation time with the real time.  We're going to sleep, but need
         // to work with the synchronizer to make sure we're awakened if something 
-        // external happens (like a packet is received).  This next line resets
-        // the synchronizer so that any future event will cause it to interrupt.
+        // external happens (like a packet is received), which is why we reset
+        // it above.
         //
-        m_synchronizer->SetCondition (false);
       }
 
       //
@@ -319,6 +331,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
     // event we're working on won't be on the list and so subsequent operations won't
     // mess with us.
     //
+    ProcessEventsWithContext ();
     NS_ASSERT_MSG (m_events->IsEmpty () == false, 
                    "RealtimeSimulatorImpl::ProcessOneEvent(): event queue is empty");
     next = m_events->RemoveNext ();
@@ -342,6 +355,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
+    m_eventCount++;
 
     // 
     // We're about to run the event and we've done our best to synchronize this
@@ -410,6 +424,76 @@ RealtimeSimulatorImpl::NextTs (void) const
   return ev.key.m_ts;
 }
 
+//
+// A wall clock which only needs to be compared with itself, read by the other
+// threads to tell the main thread when they scheduled an event.
+//
+static uint64_t
+MonotonicNanoseconds (void)
+{
+#if defined (CLOCK_MONOTONIC)
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  return tv.tv_sec * 1000000000ULL + tv.tv_usec * 1000ULL;
+#endif
+}
+
+//
+// Inserts the events scheduled by the other threads.  Should be called from the
+// main thread with critical section locked.
+//
+void
+RealtimeSimulatorImpl::ProcessEventsWithContext (void)
+{
+  if (m_eventsWithContext.IsEmpty ())
+    {
+      return;
+    }
+
+  //
+  // The other threads do not read the realtime clock, which belongs to the
+  // main thread; the time they scheduled an event at is the realtime now,
+  // less the wall clock time elapsed since they pushed it.
+  //
+  uint64_t realtime = 0;
+  uint64_t wallNow = 0;
+  if (m_running)
+    {
+      realtime = m_synchronizer->GetCurrentRealtime ();
+      wallNow = MonotonicNanoseconds ();
+    }
+
+  m_eventsWithContext.Drain (m_eventsWithContextBatch);
+  for (std::vector<EventWithContext>::const_iterator i = m_eventsWithContextBatch.begin ();
+       i != m_eventsWithContextBatch.end (); ++i)
+    {
+      uint64_t scheduled = m_currentTs;
+      if (m_running)
+        {
+          uint64_t age = wallNow > i->pushed ? NanoSeconds (wallNow - i->pushed).GetTimeStep () : 0;
+          scheduled = realtime > age ? realtime - age : 0;
+        }
+
+      //
+      // An event executed since the event was scheduled may have moved
+      // m_currentTs past it.
+      //
+      Scheduler::Event ev;
+      ev.impl = i->event;
+      ev.key.m_ts = std::max (scheduled + i->delay, m_currentTs);
+      ev.key.m_context = i->context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
+  m_eventsWithContextBatch.clear ();
+}
+
 void
 RealtimeSimulatorImpl::Run (void)
 {
@@ -435,6 +519,7 @@ RealtimeSimulatorImpl::Run (void)
       {
         CriticalSection cs (m_mutex);
 
+        ProcessEventsWithContext ();
         if (!m_events->IsEmpty ())
           {
             process = true;
@@ -536,23 +621,31 @@ RealtimeSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time,
 {
   NS_LOG_FUNCTION (this << context << time << impl);
 
+  if (!SystemThread::Equals (m_main))
+    {
+      //
+      // The event is handed to the main thread without the critical
+      // section.  It is stamped there: from the realtime clock if the
+      // simulator is running, less the time the event waited in the queue,
+      // or from m_currentTs, where it stopped, otherwise.  Only the first
+      // event of a batch needs to wake the main thread up, it takes all the
+      // pending ones at once.
+      // 
+      EventWithContext ev;
+      ev.context = context;
+      ev.delay = time.GetTimeStep ();
+      ev.pushed = MonotonicNanoseconds ();
+      ev.event = impl;
+      if (m_eventsWithContext.Push (ev))
+        {
+          m_synchronizer->Signal ();
+        }
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
-    uint64_t ts;
-
-    if (SystemThread::Equals (m_main))
-      {
-        ts = m_currentTs + time.GetTimeStep ();
-      }
-    else
-      {
-        //
-        // If the simulator is running, we're pacing and have a meaningful 
-        // realtime clock.  If we're not, then m_currentTs is where we stopped.
-        // 
-        ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
-        ts += time.GetTimeStep ();
-      }
+    uint64_t ts = m_currentTs + time.GetTimeStep ();
 
     NS_ASSERT_MSG (ts >= m_currentTs, "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
     Scheduler::Event ev;
@@ -813,6 +906,12 @@ RealtimeSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+uint64_t
+RealtimeSimulatorImpl::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
 void 
 RealtimeSimulatorImpl::SetSynchronizationMode (enum SynchronizationMode mode)
 {
@@ -30,8 +30,10 @@
 #include "assert.h"
 #include "log.h"
 #include "system-mutex.h"
+#include "mpsc-queue.h"
 
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -73,6 +75,7 @@ public:
   virtual void SetScheduler (ObjectFactory schedulerFactory);
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
 
   void ScheduleRealtimeWithContext (uint32_t context, Time const &time, EventImpl *event);
   void ScheduleRealtime (Time const &time, EventImpl *event);
@@ -91,6 +94,7 @@ private:
   bool Realtime (void) const;
   uint64_t NextTs (void) const;
   void ProcessOneEvent (void);
+  void ProcessEventsWithContext (void);
   virtual void DoDispose (void);
 
   typedef std::list<EventId> DestroyEvents;
@@ -105,9 +109,20 @@ private:
   uint32_t m_currentUid;
   uint64_t m_currentTs;
   uint32_t m_currentContext;
+  uint64_t m_eventCount;
 
   mutable SystemMutex m_mutex;
 
+  struct EventWithContext {
+    uint32_t context;
+    uint64_t delay;       //!< delay of the event (time steps)
+    uint64_t pushed;      //!< monotonic wall clock (ns) when it was scheduled
+    EventImpl *event;
+  };
+  // events scheduled by the other threads, inserted by the main thread
+  MpscQueue<struct EventWithContext> m_eventsWithContext;
+  std::vector<struct EventWithContext> m_eventsWithContextBatch;
+
   Ptr<Synchronizer> m_synchronizer;
 
   /**
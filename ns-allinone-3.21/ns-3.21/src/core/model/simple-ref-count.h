@@ -25,6 +25,7 @@
 #include "empty.h"
 #include "default-deleter.h"
 #include "assert.h"
+#include "atomic-ref-count.h"
 #include <stdint.h>
 #include <limits>
 
@@ -59,6 +60,8 @@ namespace ns3 {
  *      it manages exist anymore.
  *
  * Interesting users of this class include ns3::Object as well as ns3::Packet.
+ *
+ * The count is updated atomically while AtomicRefCount is enabled.
  */
 template <typename T, typename PARENT = empty, typename DELETER = DefaultDeleter<T> >
 class SimpleRefCount : public PARENT
@@ -92,7 +95,7 @@ public:
   inline void Ref (void) const
   {
     NS_ASSERT (m_count < std::numeric_limits<uint32_t>::max());
-    m_count++;
+    AtomicRefCount::Increment (m_count);
   }
   /**
    * Decrement the reference count. This method should not be called
@@ -102,8 +105,7 @@ public:
    */
   inline void Unref (void) const
   {
-    m_count--;
-    if (m_count == 0)
+    if (AtomicRefCount::Decrement (m_count) == 0)
       {
         DELETER::Delete (static_cast<T*> (const_cast<SimpleRefCount *> (this)));
       }
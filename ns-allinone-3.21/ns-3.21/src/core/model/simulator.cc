@@ -23,9 +23,12 @@
 #include "scheduler.h"
 #include "map-scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
+#include "event-allocator.h"
 
 #include "ptr.h"
 #include "string.h"
+#include "boolean.h"
 #include "object-factory.h"
 #include "global-value.h"
 #include "assert.h"
@@ -55,6 +58,20 @@ static GlobalValue g_schedTypeImpl = GlobalValue ("SchedulerType",
                                                   TypeIdValue (MapScheduler::GetTypeId ()),
                                                   MakeTypeIdChecker ());
 
+static GlobalValue g_eventProfiler = GlobalValue ("EventProfiler",
+                                                  "Account the wall clock time of the events to their target "
+                                                  "and context, and print the report at Simulator::Destroy",
+                                                  BooleanValue (false),
+                                                  MakeBooleanChecker ());
+
+static GlobalValue g_eventPool = GlobalValue ("EventPool",
+                                             "Allocate the events from the size-class pools of the EventAllocator",
+                                             BooleanValue (true),
+                                             MakeBooleanChecker ());
+
+/// The "EventPool" value last applied to the EventAllocator
+static bool g_eventPoolApplied = true;
+
 static void
 TimePrinter (std::ostream &os)
 {
@@ -103,6 +120,29 @@ static SimulatorImpl * GetImpl (void)
         factory.SetTypeId (s.Get ());
         (*pimpl)->SetScheduler (factory);
       }
+      {
+        BooleanValue b;
+        g_eventProfiler.GetValue (b);
+        if (b.Get ())
+          {
+            EventProfiler::Enable ();
+          }
+        // only a change of the global value is applied, so that it does
+        // not override EventAllocator::Enable and Disable
+        g_eventPool.GetValue (b);
+        if (b.Get () != g_eventPoolApplied)
+          {
+            g_eventPoolApplied = b.Get ();
+            if (g_eventPoolApplied)
+              {
+                EventAllocator::Enable ();
+              }
+            else
+              {
+                EventAllocator::Disable ();
+              }
+          }
+      }
 
 //
 // Note: we call LogSetTimePrinter _after_ creating the implementation
@@ -137,6 +177,13 @@ Simulator::Destroy (void)
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Print (std::clog);
+      EventProfiler::Disable ();
+    }
+  EventProfiler::Reset ();
+  EventAllocator::Purge ();
 }
 
 void
@@ -302,6 +349,12 @@ Simulator::GetContext (void)
   return GetImpl ()->GetContext ();
 }
 
+uint64_t
+Simulator::GetEventCount (void)
+{
+  return GetImpl ()->GetEventCount ();
+}
+
 uint32_t
 Simulator::GetSystemId (void)
 {
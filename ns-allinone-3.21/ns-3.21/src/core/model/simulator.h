@@ -749,6 +749,11 @@ public:
    */
   static uint32_t GetContext (void);
 
+  /**
+   * \returns the number of events executed since the simulation started
+   */
+  static uint64_t GetEventCount (void);
+
   /**
    * \param time delay until the event expires
    * \param event the event to schedule
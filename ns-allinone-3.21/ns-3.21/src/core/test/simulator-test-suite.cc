@@ -17,12 +17,24 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include "ns3/core-config.h"
 #include "ns3/test.h"
 #include "ns3/simulator.h"
+#include "ns3/event-profiler.h"
+#include "ns3/event-allocator.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/dary-heap-scheduler.h"
+#include "ns3/uinteger.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+#include <set>
+#include <sstream>
+#include <iostream>
 
 using namespace ns3;
 
@@ -459,6 +471,285 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SimulatorEventProfilerTestCase : public TestCase
+{
+public:
+  SimulatorEventProfilerTestCase ();
+  virtual void DoRun (void);
+  void Fast (void);
+  virtual void Slow (int a);
+  const EventProfiler::Entry * Find (const std::vector<EventProfiler::Entry> &entries,
+                                     const std::string &name);
+};
+
+SimulatorEventProfilerTestCase::SimulatorEventProfilerTestCase ()
+  : TestCase ("Check that the EventProfiler accounts the events to their target and context")
+{
+}
+
+void
+SimulatorEventProfilerTestCase::Fast (void)
+{
+}
+
+void
+SimulatorEventProfilerTestCase::Slow (int a)
+{
+}
+
+static void
+EventProfilerFunction (void)
+{
+}
+
+const EventProfiler::Entry *
+SimulatorEventProfilerTestCase::Find (const std::vector<EventProfiler::Entry> &entries,
+                                      const std::string &name)
+{
+  for (uint32_t i = 0; i < entries.size (); ++i)
+    {
+      if (entries[i].name.find (name) != std::string::npos)
+        {
+          return &entries[i];
+        }
+    }
+  return 0;
+}
+
+void
+SimulatorEventProfilerTestCase::DoRun (void)
+{
+  EventProfiler::Reset ();
+  EventProfiler::Enable ();
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Simulator::ScheduleWithContext (7, MicroSeconds (i), &SimulatorEventProfilerTestCase::Fast, this);
+    }
+  Simulator::Schedule (MicroSeconds (1), &SimulatorEventProfilerTestCase::Slow, this, 1);
+  EventId cancelled = Simulator::Schedule (MicroSeconds (2), &SimulatorEventProfilerTestCase::Slow, this, 2);
+  Simulator::Schedule (MicroSeconds (3), &SimulatorEventProfilerTestCase::Slow, this, 3);
+  Simulator::Schedule (MicroSeconds (4), &EventProfilerFunction);
+  Simulator::Cancel (cancelled);
+  Simulator::Run ();
+  EventProfiler::Disable ();
+  Simulator::Schedule (MicroSeconds (5), &EventProfilerFunction);
+  Simulator::Run ();
+
+  std::vector<EventProfiler::Entry> targets = EventProfiler::GetTargets ();
+  NS_TEST_ASSERT_MSG_EQ (targets.size (), 3, "The targets were not told apart");
+  uint64_t counts[4] = { 0, 0, 0, 0 };
+  for (uint32_t i = 0; i < targets.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_LT (targets[i].count, 4, "Too many events for " << targets[i].name);
+      counts[targets[i].count]++;
+      if (i > 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ ((targets[i - 1].seconds >= targets[i].seconds), true, "Targets not sorted");
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (counts[1], 1, "Wrong count of the function");
+  NS_TEST_EXPECT_MSG_EQ (counts[2], 1, "Wrong count of the virtual member function");
+  NS_TEST_EXPECT_MSG_EQ (counts[3], 1, "Wrong count of the member function");
+#ifdef HAVE_DLFCN_H
+  // the virtual member function is only told apart by its event type,
+  // its vtable is not looked up
+  const EventProfiler::Entry *fast = Find (targets, "SimulatorEventProfilerTestCase::Fast");
+  NS_TEST_ASSERT_MSG_NE (fast, 0, "Member function not named");
+  NS_TEST_EXPECT_MSG_EQ (fast->count, 3, "Wrong count of the member function");
+#endif
+
+  std::vector<EventProfiler::Entry> contexts = EventProfiler::GetContexts ();
+  const EventProfiler::Entry *context = Find (contexts, "7");
+  NS_TEST_ASSERT_MSG_NE (context, 0, "Context not accounted");
+  NS_TEST_EXPECT_MSG_EQ (context->count, 3, "Wrong count of the context");
+
+  EventProfiler::Reset ();
+  NS_TEST_EXPECT_MSG_EQ (EventProfiler::GetTargets ().size (), 0, "Counters not reset");
+
+  EventProfiler::Enable ();
+  Simulator::Schedule (MicroSeconds (6), &EventProfilerFunction);
+  Simulator::Run ();
+  std::ostringstream report;
+  std::streambuf *clog = std::clog.rdbuf (report.rdbuf ());
+  Simulator::Destroy ();
+  std::clog.rdbuf (clog);
+  NS_TEST_EXPECT_MSG_EQ (EventProfiler::IsEnabled (), false, "Profiler still enabled after Destroy");
+  NS_TEST_EXPECT_MSG_EQ (EventProfiler::GetTargets ().size (), 0, "Counters not reset by Destroy");
+}
+
+class SimulatorEventPoolTestCase : public TestCase
+{
+public:
+  SimulatorEventPoolTestCase ();
+  virtual void DoRun (void);
+  void Chain (uint32_t n);
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase ()
+  : TestCase ("Check that the events are allocated from the EventAllocator pools")
+{
+}
+
+void
+SimulatorEventPoolTestCase::Chain (uint32_t n)
+{
+  if (n > 0)
+    {
+      Simulator::Schedule (MicroSeconds (1), &SimulatorEventPoolTestCase::Chain, this, n - 1);
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+static void
+EventPoolThread (void)
+{
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      EventAllocator::Deallocate (EventAllocator::Allocate (24), 24);
+    }
+}
+#endif
+
+void
+SimulatorEventPoolTestCase::DoRun (void)
+{
+  EventAllocator::Enable ();
+  EventAllocator::Purge ();
+  EventAllocator::ResetStats ();
+
+  void *block = EventAllocator::Allocate (40);
+  EventAllocator::Deallocate (block, 40);
+  NS_TEST_EXPECT_MSG_EQ (EventAllocator::Allocate (33), block, "Block of the same size class not reused");
+  EventAllocator::Deallocate (block, 33);
+  EventAllocator::Deallocate (EventAllocator::Allocate (1000), 1000);
+  EventAllocator::Stats stats = EventAllocator::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.allocations, 2, "Wrong number of allocations");
+  NS_TEST_EXPECT_MSG_EQ (stats.hits, 1, "Wrong number of hits");
+  NS_TEST_EXPECT_MSG_EQ (stats.oversized, 1, "Wrong number of oversized allocations");
+
+  // a disabled pool releases the pooled block it is given
+  EventAllocator::Disable ();
+  EventAllocator::Deallocate (EventAllocator::Allocate (40), 40);
+  EventAllocator::Enable ();
+  NS_TEST_EXPECT_MSG_EQ (EventAllocator::GetStats ().allocations, 2, "Allocations counted while disabled");
+
+  // the unchanged global value does not override Disable
+  Simulator::Destroy ();
+  EventAllocator::Disable ();
+  Simulator::Schedule (MicroSeconds (1), &SimulatorEventPoolTestCase::Chain, this, 1);
+  NS_TEST_EXPECT_MSG_EQ (EventAllocator::IsEnabled (), false, "EventPool global value overrode Disable");
+  Simulator::Destroy ();
+  EventAllocator::Enable ();
+
+  // every event and scheduler node but the first ones come from the pools
+  EventAllocator::ResetStats ();
+  Simulator::Schedule (MicroSeconds (1), &SimulatorEventPoolTestCase::Chain, this, 1000);
+  Simulator::Run ();
+  stats = EventAllocator::GetStats ();
+  NS_TEST_EXPECT_MSG_GT (stats.allocations, 1000, "Events not allocated from the pools");
+  NS_TEST_EXPECT_MSG_GT (stats.hits + 10, stats.allocations, "Too many pool misses");
+
+#ifdef HAVE_PTHREAD_H
+  // the counters of a thread outlive it
+  EventAllocator::ResetStats ();
+  Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&EventPoolThread));
+  thread->Start ();
+  thread->Join ();
+  stats = EventAllocator::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.allocations, 10, "Thread allocations lost");
+  NS_TEST_EXPECT_MSG_EQ (stats.hits, 9, "Thread hits lost");
+#endif
+
+  Simulator::Destroy ();
+}
+
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  uint32_t Random (void);
+
+  ObjectFactory m_schedulerFactory;
+  uint32_t m_state;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that " + schedulerFactory.GetTypeId ().GetName () + " orders bursts of events"),
+    m_schedulerFactory (schedulerFactory),
+    m_state (1)
+{
+}
+
+uint32_t
+SchedulerOrderTestCase::Random (void)
+{
+  m_state = m_state * 1103515245 + 12345;
+  return m_state >> 8;
+}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  std::set<Scheduler::EventKey> expected;
+  uint64_t now = 0;
+  uint32_t uid = 0;
+  bool ordered = true;
+
+  for (uint32_t step = 0; step < 5000; step++)
+    {
+      uint32_t op = Random () % 10;
+      if (op < 5 || expected.empty ())
+        {
+          // single events spread widely, or the same-time fan-out of a broadcast
+          uint32_t n = op == 0 ? 1 + Random () % 200 : 1;
+          uint64_t ts = now + (op == 1 ? 0 : Random () % (op < 3 ? 100 : 1000000));
+          for (uint32_t i = 0; i < n; i++)
+            {
+              Scheduler::Event ev;
+              ev.impl = 0;
+              ev.key.m_ts = ts;
+              ev.key.m_uid = uid++;
+              ev.key.m_context = 0;
+              scheduler->Insert (ev);
+              expected.insert (ev.key);
+            }
+        }
+      else if (op < 9)
+        {
+          Scheduler::Event next = scheduler->PeekNext ();
+          Scheduler::Event ev = scheduler->RemoveNext ();
+          ordered &= next.key.m_uid == ev.key.m_uid && ev.key.m_uid == expected.begin ()->m_uid;
+          expected.erase (expected.begin ());
+          now = ev.key.m_ts;
+        }
+      else
+        {
+          Scheduler::EventKey key = *expected.begin ();
+          key.m_ts = now + Random () % 1000000;
+          std::set<Scheduler::EventKey>::iterator i = expected.lower_bound (key);
+          if (i == expected.end ())
+            {
+              --i;
+            }
+          Scheduler::Event ev;
+          ev.impl = 0;
+          ev.key = *i;
+          scheduler->Remove (ev);
+          expected.erase (i);
+        }
+    }
+  while (!expected.empty ())
+    {
+      Scheduler::Event ev = scheduler->RemoveNext ();
+      ordered &= ev.key.m_uid == expected.begin ()->m_uid;
+      expected.erase (expected.begin ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (ordered, true, "Events removed out of order");
+  NS_TEST_EXPECT_MSG_EQ (scheduler->IsEmpty (), true, "Events left in the scheduler");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +766,26 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (DaryHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    // the population of this test is too large for the ListScheduler
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (DaryHeapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.Set ("Arity", UintegerValue (3));
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.Set ("Arity", UintegerValue (8));
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorEventProfilerTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorEventPoolTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
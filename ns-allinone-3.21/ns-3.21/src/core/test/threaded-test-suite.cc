@@ -23,13 +23,17 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/dary-heap-scheduler.h"
 #include "ns3/config.h"
 #include "ns3/string.h"
 #include "ns3/system-thread.h"
+#include "ns3/mpsc-queue.h"
 
 #include <ctime>
 #include <list>
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -225,12 +229,82 @@ ThreadedSimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_a, m_d, "Bad scheduling");
 }
 
+static const uint32_t MPSC_PRODUCERS = 4;
+static const uint32_t MPSC_ITEMS = 20000;
+
+class MpscQueueTestCase : public TestCase
+{
+public:
+  MpscQueueTestCase ();
+  static void Produce (std::pair<MpscQueueTestCase *, uint32_t> context);
+  virtual void DoRun (void);
+
+  MpscQueue<std::pair<uint32_t, uint32_t> > m_queue;
+};
+
+MpscQueueTestCase::MpscQueueTestCase ()
+  : TestCase ("Check that the items pushed concurrently are all drained, in order")
+{
+}
+
+void
+MpscQueueTestCase::Produce (std::pair<MpscQueueTestCase *, uint32_t> context)
+{
+  for (uint32_t i = 0; i < MPSC_ITEMS; ++i)
+    {
+      context.first->m_queue.Push (std::make_pair (context.second, i));
+    }
+}
+
+void
+MpscQueueTestCase::DoRun (void)
+{
+  std::vector<std::pair<uint32_t, uint32_t> > items;
+  NS_TEST_EXPECT_MSG_EQ (m_queue.Drain (items), 0, "Empty queue drained items");
+  NS_TEST_EXPECT_MSG_EQ (m_queue.Push (std::make_pair (MPSC_PRODUCERS, 0u)), true, "First push not reported");
+  NS_TEST_EXPECT_MSG_EQ (m_queue.Push (std::make_pair (MPSC_PRODUCERS, 1u)), false, "Second push reported");
+  NS_TEST_EXPECT_MSG_EQ (m_queue.Drain (items), 2, "Pushed items lost");
+  NS_TEST_EXPECT_MSG_EQ (items[1].second, 1, "Items drained out of order");
+  NS_TEST_EXPECT_MSG_EQ (m_queue.IsEmpty (), true, "Drained queue not empty");
+  items.clear ();
+
+  std::list<Ptr<SystemThread> > threads;
+  for (uint32_t p = 0; p < MPSC_PRODUCERS; ++p)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&MpscQueueTestCase::Produce,
+                                                                  std::make_pair (this, p))));
+      threads.back ()->Start ();
+    }
+  // drain while the producers are running
+  std::vector<uint32_t> next (MPSC_PRODUCERS, 0);
+  uint32_t total = 0;
+  bool ordered = true;
+  while (total < MPSC_PRODUCERS * MPSC_ITEMS)
+    {
+      total += m_queue.Drain (items);
+      for (uint32_t i = 0; i < items.size (); ++i)
+        {
+          ordered &= items[i].second == next[items[i].first]++;
+        }
+      items.clear ();
+    }
+  for (std::list<Ptr<SystemThread> >::iterator it = threads.begin (); it != threads.end (); ++it)
+    {
+      (*it)->Join ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (ordered, true, "Items of a producer drained out of order");
+  NS_TEST_EXPECT_MSG_EQ (total, MPSC_PRODUCERS * MPSC_ITEMS, "Wrong number of items drained");
+  NS_TEST_EXPECT_MSG_EQ (m_queue.IsEmpty (), true, "Items left in the queue");
+}
+
 class ThreadedSimulatorTestSuite : public TestSuite
 {
 public:
   ThreadedSimulatorTestSuite ()
     : TestSuite ("threaded-simulator")
   {
+    AddTestCase (new MpscQueueTestCase, TestCase::QUICK);
+
     std::string simulatorTypes[] = {
 #ifdef HAVE_RT
       "ns3::RealtimeSimulatorImpl",
@@ -241,7 +315,9 @@ public:
       "ns3::ListScheduler",
       "ns3::HeapScheduler",
       "ns3::MapScheduler",
-      "ns3::CalendarScheduler"
+      "ns3::CalendarScheduler",
+      "ns3::LadderScheduler",
+      "ns3::DaryHeapScheduler"
     };
     unsigned int threadcounts[] = {
       0,
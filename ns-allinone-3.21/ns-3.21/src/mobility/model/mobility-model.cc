@@ -98,6 +98,12 @@ MobilityModel::NotifyCourseChange (void) const
   m_courseChangeTrace (this);
 }
 
+bool
+MobilityModel::HasCourseChangeListeners (void) const
+{
+  return !m_courseChangeTrace.IsEmpty ();
+}
+
 int64_t
 MobilityModel::AssignStreams (int64_t start)
 {
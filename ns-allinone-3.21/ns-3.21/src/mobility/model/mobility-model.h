@@ -81,6 +81,12 @@ protected:
    * position changes to notify course change listeners.
    */
   void NotifyCourseChange (void) const;
+  /**
+   * \return true if at least one sink is connected to the CourseChange
+   * trace source, so that subclasses can skip the bookkeeping of course
+   * changes nobody listens to.
+   */
+  bool HasCourseChangeListeners (void) const;
 private:
   /**
    * \return the current position.
@@ -0,0 +1,765 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/atomic-ref-count.h"
+#include "ns3/event-profiler.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <limits>
+#include <sched.h>
+
+#ifndef __GNUC__
+#error "MultithreadedSimulatorImpl needs the GCC atomic builtins and thread-local storage"
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+/// No pending event, no lookahead limit
+static const uint64_t MULTITHREADED_NEVER = std::numeric_limits<uint64_t>::max ();
+/// Barrier polls before a waiting thread starts to yield its processor
+static const uint32_t MULTITHREADED_SPINS = 1000;
+
+/// The partition run by the thread, 0 outside of MultithreadedSimulatorImpl::Run
+static __thread void *g_multithreadedPartition = 0;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  m_lookAhead = MULTITHREADED_NEVER;
+  m_running = false;
+  m_stop = false;
+  m_barrierCount = 0;
+  m_barrierSense = false;
+  m_partitions.push_back (CreatePartition (0));
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Partition *partition = *i;
+      while (partition->events != 0 && !partition->events->IsEmpty ())
+        {
+          Scheduler::Event next = partition->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      delete partition;
+    }
+  m_partitions.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::CreatePartition (uint32_t id)
+{
+  Partition *partition = new Partition ();
+  partition->impl = this;
+  partition->id = id;
+  if (m_schedulerFactory.GetTypeId ().GetUid () != 0)
+    {
+      partition->events = m_schedulerFactory.Create<Scheduler> ();
+    }
+  // uids are allocated from 4, as in the DefaultSimulatorImpl
+  partition->uid = 4;
+  partition->currentUid = 0;
+  partition->currentTs = 0;
+  partition->currentContext = 0xffffffff;
+  partition->eventCount = 0;
+  partition->nextTs = MULTITHREADED_NEVER;
+  partition->windowEnd = MULTITHREADED_NEVER;
+  partition->sense = false;
+  return partition;
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ASSERT_MSG (!m_running, "The scheduler can not be changed during the run");
+  m_schedulerFactory = schedulerFactory;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Partition *partition = *i;
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if (partition->events != 0)
+        {
+          while (!partition->events->IsEmpty ())
+            {
+              scheduler->Insert (partition->events->RemoveNext ());
+            }
+        }
+      partition->events = scheduler;
+    }
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetCurrentPartition (void) const
+{
+  void *partition = g_multithreadedPartition;
+  if (partition != 0)
+    {
+      return static_cast<Partition *> (partition);
+    }
+  NS_ASSERT_MSG (!m_running, "Simulator called by a thread which does not run a partition");
+  return m_partitions[0];
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context == 0xffffffff || m_partitions.size () == 1)
+    {
+      return m_partitions[0];
+    }
+  NS_ASSERT_MSG (context < m_partitionOfNode.size (),
+                 "Node " << context << " was created after Simulator::Run");
+  return m_partitions[m_partitionOfNode[context]];
+}
+
+uint32_t
+MultithreadedSimulatorImpl::AllocateUid (Partition *partition)
+{
+  uint32_t uid = partition->uid;
+  partition->uid += m_partitions.size ();
+  return uid;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::Insert (Partition *partition, EventImpl *event, uint64_t ts, uint32_t context)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = AllocateUid (partition);
+  partition->events->Insert (ev);
+  return ev.key.m_uid;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return GetCurrentPartition ()->id;
+}
+
+void
+MultithreadedSimulatorImpl::SplitPartitions (void)
+{
+  NS_LOG_FUNCTION (this);
+  Partition *first = m_partitions[0];
+  uint32_t n = 1;
+  m_partitionOfNode.assign (NodeList::GetNNodes (), 0);
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      uint32_t systemId = (*i)->GetSystemId ();
+      m_partitionOfNode[(*i)->GetId ()] = systemId;
+      n = std::max (n, systemId + 1);
+    }
+  if (n == 1)
+    {
+      return;
+    }
+
+  for (uint32_t id = 1; id < n; ++id)
+    {
+      Partition *partition = CreatePartition (id);
+      partition->currentTs = first->currentTs;
+      partition->currentUid = first->currentUid;
+      partition->uid = first->uid + id;
+      m_partitions.push_back (partition);
+    }
+
+  std::vector<Scheduler::Event> events;
+  while (!first->events->IsEmpty ())
+    {
+      events.push_back (first->events->RemoveNext ());
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      GetPartition (i->key.m_context)->events->Insert (*i);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::MergePartitions (void)
+{
+  NS_LOG_FUNCTION (this);
+  Partition *first = m_partitions[0];
+  for (uint32_t id = 1; id < m_partitions.size (); ++id)
+    {
+      Partition *partition = m_partitions[id];
+      ProcessMailbox (partition);
+      while (!partition->events->IsEmpty ())
+        {
+          first->events->Insert (partition->events->RemoveNext ());
+        }
+      first->currentTs = std::max (first->currentTs, partition->currentTs);
+      first->uid = std::max (first->uid, partition->uid);
+      first->eventCount += partition->eventCount;
+      delete partition;
+    }
+  m_partitions.resize (1);
+}
+
+void
+MultithreadedSimulatorImpl::CalculateLookAhead (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_lookAhead = MULTITHREADED_NEVER;
+  for (ChannelList::Iterator i = ChannelList::Begin (); i != ChannelList::End (); ++i)
+    {
+      Ptr<Channel> channel = *i;
+      bool remote = false;
+      Partition *partition = 0;
+      for (uint32_t j = 0; j < channel->GetNDevices () && !remote; ++j)
+        {
+          Ptr<Node> node = channel->GetDevice (j)->GetNode ();
+          if (node == 0)
+            {
+              continue;
+            }
+          Partition *other = GetPartition (node->GetId ());
+          remote = partition != 0 && other != partition;
+          partition = other;
+        }
+      if (!remote)
+        {
+          continue;
+        }
+      Time delay;
+      if (!IsPartitionSafe (channel, delay))
+        {
+          NS_FATAL_ERROR ("Channel " << channel->GetId () << " (" << channel->GetInstanceTypeId ().GetName ()
+                          << ") can not span several partitions, its nodes need the same system id");
+        }
+      NS_ASSERT (!delay.IsNegative ());
+      m_lookAhead = std::min (m_lookAhead, static_cast<uint64_t> (delay.GetTimeStep ()));
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsPartitionSafe (Ptr<Channel> channel, Time &delay)
+{
+  // looked up by name, the mpi module does not depend on the modules of
+  // the channels; the YansWifiChannel only reads the remote receivers by
+  // scheduled events with a MinimumDelay
+  static const struct
+  {
+    const char *name;
+    const char *delay;
+    bool positive;
+  } channels[] = {
+    { "ns3::PointToPointChannel", "Delay", false },
+    { "ns3::V2vBroadcastChannel", "Delay", false },
+    { "ns3::YansWifiChannel", "MinimumDelay", true },
+  };
+  TypeId tid = channel->GetInstanceTypeId ();
+  for (uint32_t i = 0; i < sizeof (channels) / sizeof (channels[0]); ++i)
+    {
+      TypeId safe;
+      if (TypeId::LookupByNameFailSafe (channels[i].name, &safe) && (tid == safe || tid.IsChildOf (safe)))
+        {
+          TimeValue value;
+          if (!channel->GetAttributeFailSafe (channels[i].delay, value))
+            {
+              return false;
+            }
+          delay = value.Get ();
+          return !channels[i].positive || delay.IsStrictlyPositive ();
+        }
+    }
+  return false;
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookAhead (void) const
+{
+  if (m_lookAhead == MULTITHREADED_NEVER)
+    {
+      return GetMaximumSimulationTime ();
+    }
+  return TimeStep (m_lookAhead);
+}
+
+void
+MultithreadedSimulatorImpl::Barrier (Partition *partition)
+{
+  // sense-reversing barrier: the last thread to arrive resets the count
+  // and flips the shared sense the others are waiting for
+  partition->sense = !partition->sense;
+  if (__sync_sub_and_fetch (&m_barrierCount, 1) == 0)
+    {
+      m_barrierCount = m_partitions.size ();
+      __sync_synchronize ();
+      m_barrierSense = partition->sense;
+      return;
+    }
+  uint32_t spins = 0;
+  while (m_barrierSense != partition->sense)
+    {
+      if (++spins > MULTITHREADED_SPINS)
+        {
+          sched_yield ();
+        }
+    }
+  __sync_synchronize ();
+}
+
+bool
+MultithreadedSimulatorImpl::MailboxLess (const MailboxEvent &a, const MailboxEvent &b)
+{
+  if (a.event.key.m_ts != b.event.key.m_ts)
+    {
+      return a.event.key.m_ts < b.event.key.m_ts;
+    }
+  if (a.sourceTs != b.sourceTs)
+    {
+      return a.sourceTs < b.sourceTs;
+    }
+  if (a.source != b.source)
+    {
+      return a.source < b.source;
+    }
+  return a.sourceUid < b.sourceUid;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessMailbox (Partition *partition)
+{
+  if (partition->mailbox.IsEmpty ())
+    {
+      return;
+    }
+  partition->mailbox.Drain (partition->batch);
+  std::sort (partition->batch.begin (), partition->batch.end (), &MultithreadedSimulatorImpl::MailboxLess);
+  for (std::vector<MailboxEvent>::const_iterator i = partition->batch.begin ();
+       i != partition->batch.end (); ++i)
+    {
+      const Scheduler::Event &ev = i->event;
+      NS_ASSERT (ev.key.m_ts >= partition->currentTs);
+      Insert (partition, ev.impl, ev.key.m_ts, ev.key.m_context);
+    }
+  partition->batch.clear ();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (Partition *partition)
+{
+  Scheduler::Event next = partition->events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= partition->currentTs);
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  partition->currentTs = next.key.m_ts;
+  partition->currentContext = next.key.m_context;
+  partition->currentUid = next.key.m_uid;
+  partition->eventCount++;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::RunWorker (Partition *partition)
+{
+  partition->impl->RunPartition (partition);
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (Partition *partition)
+{
+  g_multithreadedPartition = partition;
+  for (;;)
+    {
+      // the events sent by the other partitions during the last window
+      ProcessMailbox (partition);
+      partition->nextTs = partition->events->IsEmpty () ? MULTITHREADED_NEVER
+        : partition->events->PeekNext ().key.m_ts;
+      // the stop requests are only written while the events run, so the
+      // partitions all see them at the same window boundary
+      bool stop = m_stop;
+      uint64_t stopTs = m_stopTs.empty () ? MULTITHREADED_NEVER : *m_stopTs.begin ();
+      Barrier (partition);
+
+      // every thread takes the same decision from the same values
+      uint64_t minTs = MULTITHREADED_NEVER;
+      for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          minTs = std::min (minTs, (*i)->nextTs);
+        }
+      if (stop || minTs >= stopTs || minTs == MULTITHREADED_NEVER)
+        {
+          break;
+        }
+      uint64_t windowEnd;
+      if (m_lookAhead == 0)
+        {
+          windowEnd = minTs + 1;
+        }
+      else if (m_lookAhead >= MULTITHREADED_NEVER - minTs)
+        {
+          windowEnd = MULTITHREADED_NEVER;
+        }
+      else
+        {
+          windowEnd = minTs + m_lookAhead;
+        }
+      partition->windowEnd = std::min (windowEnd, stopTs);
+
+      // a single partition stops right after the event calling Stop (), as
+      // the DefaultSimulatorImpl, the others finish the window
+      bool single = m_partitions.size () == 1;
+      while ((!single || !m_stop) && !partition->events->IsEmpty ()
+             && partition->events->PeekNext ().key.m_ts < partition->windowEnd)
+        {
+          ProcessOneEvent (partition);
+        }
+      // all the events sent during the window are in the mailboxes
+      Barrier (partition);
+    }
+  g_multithreadedPartition = 0;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (!m_running, "Simulator::Run is not reentrant");
+  SplitPartitions ();
+  CalculateLookAhead ();
+  uint32_t n = m_partitions.size ();
+  NS_LOG_INFO ("Running " << n << " partitions with a lookahead of " << GetLookAhead ());
+  if (n > 1)
+    {
+      if (EventProfiler::IsEnabled ())
+        {
+          NS_FATAL_ERROR ("The EventProfiler can not account the events of several threads");
+        }
+      AtomicRefCount::Enable ();
+    }
+
+  m_stop = false;
+  m_barrierCount = n;
+  m_barrierSense = false;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      (*i)->sense = false;
+    }
+  m_running = true;
+  for (uint32_t id = 1; id < n; ++id)
+    {
+      Partition *partition = m_partitions[id];
+      partition->thread = Create<SystemThread> (MakeBoundCallback (&MultithreadedSimulatorImpl::RunWorker, partition));
+      partition->thread->Start ();
+    }
+  RunPartition (m_partitions[0]);
+  for (uint32_t id = 1; id < n; ++id)
+    {
+      m_partitions[id]->thread->Join ();
+      m_partitions[id]->thread = 0;
+    }
+  m_running = false;
+  if (n > 1)
+    {
+      AtomicRefCount::Disable ();
+    }
+
+  MergePartitions ();
+  Partition *first = m_partitions[0];
+  if (!m_stop && !m_stopTs.empty ())
+    {
+      uint64_t stopTs = *m_stopTs.begin ();
+      if (first->events->IsEmpty () || first->events->PeekNext ().key.m_ts >= stopTs)
+        {
+          // stopped by Stop (Time), at its time as the DefaultSimulatorImpl
+          first->currentTs = std::max (first->currentTs, stopTs);
+          m_stopTs.erase (m_stopTs.begin ());
+          m_stop = true;
+        }
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      if (!(*i)->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  // several partitions may stop in the same window
+  (void) __sync_lock_test_and_set (&m_stop, true);
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &time)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep ());
+  NS_ASSERT (!time.IsNegative ());
+  Partition *partition = GetCurrentPartition ();
+  uint64_t ts = partition->currentTs + time.GetTimeStep ();
+  if (m_running && m_partitions.size () == 1)
+    {
+      // the window of a single partition is only bounded by the stop time
+      partition->windowEnd = std::min (partition->windowEnd, ts);
+    }
+  // the other partitions may have run their events up to the end of the window
+  NS_ASSERT_MSG (!m_running || m_partitions.size () == 1 || ts >= partition->windowEnd,
+                 "Simulator::Stop (" << time << ") inside the window of the other partitions,"
+                 " the lookahead is " << GetLookAhead ());
+  CriticalSection cs (m_mutex);
+  m_stopTs.insert (ts);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep () << event);
+  Partition *partition = GetCurrentPartition ();
+  Time tAbsolute = time + TimeStep (partition->currentTs);
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (partition->currentTs));
+  uint64_t ts = tAbsolute.GetTimeStep ();
+  uint32_t uid = Insert (partition, event, ts, partition->currentContext);
+  return EventId (event, ts, partition->currentContext, uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << time.GetTimeStep () << event);
+  Partition *partition = GetCurrentPartition ();
+  Time tAbsolute = time + TimeStep (partition->currentTs);
+  uint64_t ts = tAbsolute.GetTimeStep ();
+  Partition *target = m_running ? GetPartition (context) : partition;
+  if (target == partition)
+    {
+      Insert (partition, event, ts, context);
+      return;
+    }
+  // the partitions may have run their events up to the end of the window,
+  // which only holds the current timestamp without lookahead
+  NS_ASSERT_MSG (ts >= partition->windowEnd
+                 || (m_lookAhead == 0 && ts + 1 >= partition->windowEnd),
+                 "Event for node " << context << " at " << tAbsolute
+                 << " inside the window of the other partitions, the lookahead is "
+                 << GetLookAhead ());
+  MailboxEvent ev;
+  ev.event.impl = event;
+  ev.event.key.m_ts = ts;
+  ev.event.key.m_context = context;
+  ev.event.key.m_uid = 0;
+  ev.sourceTs = partition->currentTs;
+  ev.source = partition->id;
+  ev.sourceUid = AllocateUid (partition);
+  target->mailbox.Push (ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  Partition *partition = GetCurrentPartition ();
+  uint32_t uid = Insert (partition, event, partition->currentTs, partition->currentContext);
+  return EventId (event, partition->currentTs, partition->currentContext, uid);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), GetCurrentPartition ()->currentTs, 0xffffffff, 2);
+  CriticalSection cs (m_mutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrentPartition ()->currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  return TimeStep (id.GetTs () - GetCurrentPartition ()->currentTs);
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_mutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition *partition = GetCurrentPartition ();
+  NS_ASSERT_MSG (!m_running || GetPartition (id.GetContext ()) == partition,
+                 "Event of node " << id.GetContext () << " removed by another partition");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &ev) const
+{
+  if (ev.GetUid () == 2)
+    {
+      if (ev.PeekEventImpl () == 0 ||
+          ev.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (const_cast<SystemMutex &> (m_mutex));
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == ev)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  const Partition *partition = GetCurrentPartition ();
+  if (ev.PeekEventImpl () == 0 ||
+      ev.GetTs () < partition->currentTs ||
+      (ev.GetTs () == partition->currentTs &&
+       ev.GetUid () <= partition->currentUid) ||
+      ev.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  return false;
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrentPartition ()->currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount (void) const
+{
+  uint64_t count = 0;
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      count += (*i)->eventCount;
+    }
+  return count;
+}
+
+} // namespace ns3
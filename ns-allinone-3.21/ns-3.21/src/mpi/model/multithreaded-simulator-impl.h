@@ -0,0 +1,247 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/mpsc-queue.h"
+#include "ns3/ptr.h"
+#include "ns3/channel.h"
+
+#include <list>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Conservative parallel simulator running the nodes in several
+ * threads of a single process.
+ *
+ * The nodes are partitioned by their system id, like the ranks of the
+ * DistributedSimulatorImpl, but all the partitions live in the same
+ * process and no MPI is needed: each partition has its own event list and
+ * clock and is run by its own thread, partition 0 by the thread which
+ * calls Simulator::Run.
+ *
+ * The partitions advance by granted time windows. At the start of a
+ * window all the threads meet at a barrier and the window ends one
+ * lookahead after the earliest pending event of all the partitions; each
+ * partition then runs its events of the window without any further
+ * synchronization. The lookahead is the smallest delay of the channels
+ * whose devices are in different partitions, so an event
+ * scheduled by ScheduleWithContext on a node of another
+ * partition can not fall inside the window: it is pushed on the lock-free
+ * mailbox of that partition (see MpscQueue) and inserted in its event
+ * list at the next barrier. With a null lookahead a window only holds the
+ * events of the earliest timestamp.
+ *
+ * The model code of a partition must only touch the objects of its own
+ * nodes, those of the other partitions being reached through scheduled
+ * events. The channels which work that way may connect several
+ * partitions:
+ *
+ * - the PointToPointChannel and PointToPointRemoteChannel, whose delay is
+ *   their Delay attribute;
+ * - the V2vBroadcastChannel, which hands a frame to the nodes of each
+ *   partition by an event scheduled its Delay attribute after the
+ *   transmission;
+ * - the YansWifiChannel with a positive MinimumDelay attribute, the
+ *   smallest propagation delay, after which an event on each receiver
+ *   computes the reception from the position of the sender; its
+ *   propagation models must neither draw random numbers nor keep a state.
+ *
+ * The run stops with a fatal error if any other channel connects several
+ * partitions. The reference counts are
+ * updated atomically during the run (see AtomicRefCount), so the packets
+ * and the other objects handed over by these events can be shared. An
+ * EventId may only be cancelled, removed or checked by the partition which
+ * scheduled it; the events without a node context run in partition 0;
+ * the nodes must all exist before Simulator::Run; and
+ * Simulator::ScheduleWithContext may not be called by other threads than
+ * those of the partitions, e.g. those of the emulation devices.
+ *
+ * Simulator::Stop (Time) stops all the partitions before the given time.
+ * With several partitions, a call during the run must not stop them
+ * inside the current window, which the other partitions may already have
+ * run: the delay must be at least the lookahead. Simulator::Stop () stops
+ * the partitions at the end of the current window, so the other events of
+ * the window still run. Without any channel between the partitions the
+ * window is not bounded, and only Simulator::Stop (Time) called before
+ * Simulator::Run stops the run before its last event.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  static TypeId GetTypeId (void);
+
+  MultithreadedSimulatorImpl ();
+  ~MultithreadedSimulatorImpl ();
+
+  // inherited from SimulatorImpl
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &time);
+  virtual EventId Schedule (Time const &time, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &ev);
+  virtual void Cancel (const EventId &ev);
+  virtual bool IsExpired (const EventId &ev) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+  /**
+   * \returns the lookahead of the last run
+   */
+  Time GetLookAhead (void) const;
+
+private:
+  /**
+   * \brief An event scheduled on the nodes of a partition by another one.
+   */
+  struct MailboxEvent
+  {
+    Scheduler::Event event;
+    uint64_t sourceTs;          //!< time the event was scheduled at
+    uint32_t source;            //!< id of the sending partition
+    uint32_t sourceUid;         //!< uid allocated by the sending partition
+  };
+  /**
+   * \brief The nodes of a system id, with their events and clock.
+   */
+  struct Partition
+  {
+    MultithreadedSimulatorImpl *impl;
+    uint32_t id;
+    Ptr<Scheduler> events;
+    // events scheduled on the nodes of this partition by the other ones
+    MpscQueue<MailboxEvent> mailbox;
+    std::vector<MailboxEvent> batch;
+    uint32_t uid;
+    uint32_t currentUid;
+    uint64_t currentTs;
+    uint32_t currentContext;
+    uint64_t eventCount;
+    uint64_t nextTs;            //!< earliest event, published at the barrier
+    uint64_t windowEnd;         //!< end of the current window (excluded)
+    bool sense;                 //!< barrier phase of the thread
+    Ptr<SystemThread> thread;
+  };
+
+  virtual void DoDispose (void);
+  Partition *CreatePartition (uint32_t id);
+  /**
+   * \returns the partition of the calling thread, partition 0 outside
+   *          of the run
+   */
+  Partition *GetCurrentPartition (void) const;
+  /**
+   * \param context the context of an event
+   * \returns the partition of the node of this context
+   */
+  Partition *GetPartition (uint32_t context) const;
+  /**
+   * \returns the next uid of the partition
+   *
+   * The uids of the partitions are interleaved, so that their events
+   * keep unique keys when they are merged back after the run.
+   */
+  uint32_t AllocateUid (Partition *partition);
+  /**
+   * \returns the uid of the event inserted in the partition
+   */
+  uint32_t Insert (Partition *partition, EventImpl *event, uint64_t ts, uint32_t context);
+  /**
+   * \brief Create one partition per system id and move the events of
+   * their nodes to them.
+   */
+  void SplitPartitions (void);
+  /**
+   * \brief Move the remaining events back to partition 0.
+   */
+  void MergePartitions (void);
+  /**
+   * \brief Set the lookahead from the channels spanning the partitions.
+   *
+   * Stops with a fatal error if one of these channels can not be shared.
+   */
+  void CalculateLookAhead (void);
+  /**
+   * \param channel a channel connecting nodes of several partitions
+   * \param delay the smallest delay of the events the channel schedules on
+   *        the remote devices
+   * \returns true if the channel only reaches the remote devices by
+   *          scheduled events
+   */
+  static bool IsPartitionSafe (Ptr<Channel> channel, Time &delay);
+  void Barrier (Partition *partition);
+  /**
+   * \brief The loop of the windows of a partition.
+   */
+  void RunPartition (Partition *partition);
+  static void RunWorker (Partition *partition);
+  void ProcessOneEvent (Partition *partition);
+  /**
+   * \brief Insert the events sent by the other partitions.
+   *
+   * The events are pushed in the mailbox in the order the threads run,
+   * so they are sorted by their timestamp, the time they were scheduled
+   * at, the sending partition and their uid in the sending partition
+   * before they get their uids. The order of the events of the same
+   * timestamp is then the same from run to run and, unless they were also
+   * scheduled at the same time, that of the DefaultSimulatorImpl.
+   */
+  void ProcessMailbox (Partition *partition);
+  static bool MailboxLess (const MailboxEvent &a, const MailboxEvent &b);
+
+  ObjectFactory m_schedulerFactory;
+  std::vector<Partition *> m_partitions;
+  std::vector<uint32_t> m_partitionOfNode;
+  uint64_t m_lookAhead;
+  bool m_running;
+  bool m_stop;
+  // timestamps of the pending Stop (Time) calls
+  std::set<uint64_t> m_stopTs;
+
+  uint32_t m_barrierCount;
+  volatile bool m_barrierSense;
+
+  typedef std::list<EventId> DestroyEvents;
+  DestroyEvents m_destroyEvents;
+  // protects m_destroyEvents and m_stopTs during the run
+  SystemMutex m_mutex;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
@@ -99,7 +99,13 @@ Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
+  if (AtomicRefCount::IsEnabled () || IS_UNINITIALIZED (g_freeList))
+    {
+      // the free list is not shared by the threads, and is only created
+      // by Create outside of their run
+      Buffer::Deallocate (data);
+      return;
+    }
   g_maxSize = std::max (g_maxSize, data->m_size);
   /* feed into free list */
   if (data->m_size < g_maxSize ||
@@ -119,6 +125,10 @@ Buffer::Data *
 Buffer::Create (uint32_t dataSize)
 {
   NS_LOG_FUNCTION (dataSize);
+  if (AtomicRefCount::IsEnabled ())
+    {
+      return Buffer::Allocate (dataSize);
+    }
   /* try to find a buffer correctly sized. */
   if (IS_UNINITIALIZED (g_freeList))
     {
@@ -262,15 +272,18 @@ Buffer::operator = (Buffer const&o)
   if (m_data != o.m_data) 
     {
       // not assignment to self.
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (AtomicRefCount::Decrement (m_data->m_count) == 0)
         {
           Recycle (m_data);
         }
       m_data = o.m_data;
-      m_data->m_count++;
+      AtomicRefCount::Increment (m_data->m_count);
+    }
+  // shared by the threads of a multithreaded run, left as it is then
+  if (!AtomicRefCount::IsEnabled ())
+    {
+      g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
     }
-  g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
   m_maxZeroAreaStart = o.m_maxZeroAreaStart;
   m_zeroAreaStart = o.m_zeroAreaStart;
   m_zeroAreaEnd = o.m_zeroAreaEnd;
@@ -284,9 +297,11 @@ Buffer::~Buffer ()
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
-  g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (!AtomicRefCount::IsEnabled ())
+    {
+      g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
+    }
+  if (AtomicRefCount::Decrement (m_data->m_count) == 0)
     {
       Recycle (m_data);
     }
@@ -311,7 +326,8 @@ Buffer::AddAtStart (uint32_t start)
   NS_LOG_FUNCTION (this << start);
   bool dirty;
   NS_ASSERT (CheckInternalState ());
-  bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
+  bool isDirty = m_data->m_count > 1 &&
+    (m_start > m_data->m_dirtyStart || AtomicRefCount::IsEnabled ());
   if (m_start >= start && !isDirty)
     {
       /* enough space in the buffer and not dirty. 
@@ -330,8 +346,7 @@ Buffer::AddAtStart (uint32_t start)
       uint32_t newSize = GetInternalSize () + start;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data + start, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0)
+      if (AtomicRefCount::Decrement (m_data->m_count) == 0)
         {
           Buffer::Recycle (m_data);
         }
@@ -362,7 +377,8 @@ Buffer::AddAtEnd (uint32_t end)
   NS_LOG_FUNCTION (this << end);
   bool dirty;
   NS_ASSERT (CheckInternalState ());
-  bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
+  bool isDirty = m_data->m_count > 1 &&
+    (m_end < m_data->m_dirtyEnd || AtomicRefCount::IsEnabled ());
   if (GetInternalEnd () + end <= m_data->m_size && !isDirty)
     {
       /* enough space in buffer and not dirty
@@ -383,8 +399,7 @@ Buffer::AddAtEnd (uint32_t end)
       uint32_t newSize = GetInternalSize () + end;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (AtomicRefCount::Decrement (m_data->m_count) == 0)
         {
           Buffer::Recycle (m_data);
         }
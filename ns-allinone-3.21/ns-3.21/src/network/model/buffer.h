@@ -24,6 +24,7 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
+#include "ns3/atomic-ref-count.h"
 
 #define BUFFER_FREE_LIST 1
 
@@ -1062,7 +1063,7 @@ Buffer::Buffer (Buffer const&o)
     m_start (o.m_start),
     m_end (o.m_end)
 {
-  m_data->m_count++;
+  AtomicRefCount::Increment (m_data->m_count);
   NS_ASSERT (CheckInternalState ());
 }
 
@@ -19,6 +19,7 @@
  */
 #include "byte-tag-list.h"
 #include "ns3/log.h"
+#include "ns3/atomic-ref-count.h"
 #include <vector>
 #include <cstring>
 
@@ -149,7 +150,7 @@ ByteTagList::ByteTagList (const ByteTagList &o)
   NS_LOG_FUNCTION (this << &o);
   if (m_data != 0)
     {
-      m_data->count++;
+      AtomicRefCount::Increment (m_data->count);
     }
 }
 ByteTagList &
@@ -165,7 +166,7 @@ ByteTagList::operator = (const ByteTagList &o)
   m_used = o.m_used;
   if (m_data != 0)
     {
-      m_data->count++;
+      AtomicRefCount::Increment (m_data->count);
     }
   return *this;
 }
@@ -189,7 +190,8 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
       m_used = 0;
     } 
   else if (m_data->size < spaceNeeded ||
-           (m_data->count != 1 && m_data->dirty != m_used))
+           (m_data->count != 1 &&
+            (m_data->dirty != m_used || AtomicRefCount::IsEnabled ())))
     {
       struct ByteTagListData *newData = Allocate (spaceNeeded);
       std::memcpy (&newData->data, &m_data->data, m_used);
@@ -358,7 +360,8 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  while (!g_freeList.empty ())
+  // the free list is not shared by the threads
+  while (!AtomicRefCount::IsEnabled () && !g_freeList.empty ())
     {
       struct ByteTagListData *data = g_freeList.back ();
       g_freeList.pop_back ();
@@ -389,10 +392,10 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
       return;
     }
   g_maxSize = std::max (g_maxSize, data->size);
-  data->count--;
-  if (data->count == 0)
+  if (AtomicRefCount::Decrement (data->count) == 0)
     {
-      if (g_freeList.size () > FREE_LIST_SIZE ||
+      if (AtomicRefCount::IsEnabled () ||
+          g_freeList.size () > FREE_LIST_SIZE ||
           data->size < g_maxSize)
         {
           uint8_t *buffer = (uint8_t *)data;
@@ -427,8 +430,7 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
     {
       return;
     }
-  data->count--;
-  if (data->count == 0)
+  if (AtomicRefCount::Decrement (data->count) == 0)
     {
       uint8_t *buffer = (uint8_t *)data;
       delete [] buffer;
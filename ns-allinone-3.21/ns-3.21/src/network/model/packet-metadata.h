@@ -25,6 +25,7 @@
 #include <limits>
 #include "ns3/callback.h"
 #include "ns3/assert.h"
+#include "ns3/atomic-ref-count.h"
 #include "ns3/type-id.h"
 #include "buffer.h"
 
@@ -709,7 +710,7 @@ PacketMetadata::PacketMetadata (PacketMetadata const &o)
 {
   NS_ASSERT (m_data != 0);
   NS_ASSERT (m_data->m_count < std::numeric_limits<uint32_t>::max());
-  m_data->m_count++;
+  AtomicRefCount::Increment (m_data->m_count);
 }
 PacketMetadata &
 PacketMetadata::operator = (PacketMetadata const& o)
@@ -718,14 +719,13 @@ PacketMetadata::operator = (PacketMetadata const& o)
     {
       // not self assignment
       NS_ASSERT (m_data != 0);
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (AtomicRefCount::Decrement (m_data->m_count) == 0)
         {
           PacketMetadata::Recycle (m_data);
         }
       m_data = o.m_data;
       NS_ASSERT (m_data != 0);
-      m_data->m_count++;
+      AtomicRefCount::Increment (m_data->m_count);
     }
   m_head = o.m_head;
   m_tail = o.m_tail;
@@ -736,8 +736,7 @@ PacketMetadata::operator = (PacketMetadata const& o)
 PacketMetadata::~PacketMetadata ()
 {
   NS_ASSERT (m_data != 0);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (AtomicRefCount::Decrement (m_data->m_count) == 0)
     {
       PacketMetadata::Recycle (m_data);
     }
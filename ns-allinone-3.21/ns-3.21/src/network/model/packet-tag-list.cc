@@ -34,6 +34,19 @@ NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
 namespace ns3 {
 
+void
+PacketTagList::Unmerge (struct PacketTagList::TagData * cur)
+{
+  if (AtomicRefCount::Decrement (cur->count) == 0)
+    {
+      if (cur->next != 0)
+        {
+          AtomicRefCount::Decrement (cur->next->count);
+        }
+      delete cur;
+    }
+}
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -102,8 +115,10 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
     }
 
   // At this point cur is a merge, but untested for tid
+  // (the other lists may release the merges meanwhile if the packets
+  // are shared by several threads, see Unmerge)
   NS_ASSERT (cur != 0);
-  NS_ASSERT (cur->count > 1);
+  NS_ASSERT (cur->count > 1 || AtomicRefCount::IsEnabled ());
 
   /*
      Walk the remainder of the list, copying, until we find tid
@@ -131,14 +146,14 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
   while ( /* cur && */ cur->tid != tid)
     {
       NS_ASSERT (cur != 0);
-      NS_ASSERT (cur->count > 1);
-      cur->count--;                       // unmerge cur
+      NS_ASSERT (cur->count > 1 || AtomicRefCount::IsEnabled ());
       struct TagData * copy = new struct TagData ();
       copy->tid = cur->tid;
       copy->count = 1;
       memcpy (copy->data, cur->data, TagData::MAX_SIZE);
       copy->next = cur->next;             // merge into tail
-      copy->next->count++;                // mark new merge
+      AtomicRefCount::Increment (copy->next->count); // mark new merge
+      Unmerge (cur);
       *prevNext = copy;                   // point prior list at copy
       prevNext = &copy->next;             // advance
       cur      =  copy->next;
@@ -146,7 +161,7 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
   // Sanity check:
   NS_ASSERT (cur != 0);                 // cur should be non-zero
   NS_ASSERT (cur->tid == tid);          // cur->tid should be tid
-  NS_ASSERT (cur->count > 1);           // cur should be a merge
+  NS_ASSERT (cur->count > 1 || AtomicRefCount::IsEnabled ()); // cur should be a merge
 
   // link around tid, removing it from our list
   found = (this->*Writer)(tag, false, cur, prevNext);
@@ -182,13 +197,13 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
   else
     {
       // cur is always a merge at this point
-      // unmerge cur, since we linked around it already
-      cur->count--;
       if (cur->next != 0)
         {
           // there's a next, so make it a merge
-          cur->next->count++;
+          AtomicRefCount::Increment (cur->next->count);
         }
+      // unmerge cur, since we linked around it already
+      Unmerge (cur);
     }
   return found;
 }
@@ -224,7 +239,6 @@ PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
     {
       // cur is always a merge at this point
       // need to copy, replace, and link past cur
-      cur->count--;                     // unmerge cur
       struct TagData * copy = new struct TagData ();
       copy->tid = tag.GetInstanceTypeId ();
       copy->count = 1;
@@ -233,8 +247,9 @@ PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
       copy->next = cur->next;           // merge into tail
       if (copy->next != 0)
         {
-          copy->next->count++;          // mark new merge
+          AtomicRefCount::Increment (copy->next->count); // mark new merge
         }
+      Unmerge (cur);                    // unmerge cur
       *prevNext = copy;                 // point prior list at copy
     }
   return found;
@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include <ostream>
 #include "ns3/type-id.h"
+#include "ns3/atomic-ref-count.h"
 
 namespace ns3 {
 
@@ -286,6 +287,17 @@ private:
    * \returns True, since tag value will definitely be replaced.
    */
   bool ReplaceWriter (Tag & tag, bool preMerge, struct TagData * cur, struct TagData ** prevNext);
+  /**
+   * Drop the link of this list to a merge it has just linked past.
+   *
+   * The merge is normally still linked by another list, unless that
+   * list was released meanwhile by another thread (see AtomicRefCount),
+   * in which case it is deleted.
+   *
+   * \param [in] cur Pointer to the merge, whose next node is already
+   *          linked by this list.
+   */
+  static void Unmerge (struct TagData * cur);
 
   /**
    * Pointer to first \ref TagData on the list
@@ -311,7 +323,7 @@ PacketTagList::PacketTagList (PacketTagList const &o)
 {
   if (m_next != 0)
     {
-      m_next->count++;
+      AtomicRefCount::Increment (m_next->count);
     }
 }
 
@@ -327,7 +339,7 @@ PacketTagList::operator = (PacketTagList const &o)
   m_next = o.m_next;
   if (m_next != 0) 
     {
-      m_next->count++;
+      AtomicRefCount::Increment (m_next->count);
     }
   return *this;
 }
@@ -343,8 +355,7 @@ PacketTagList::RemoveAll (void)
   struct TagData *prev = 0;
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
-      cur->count--;
-      if (cur->count > 0) 
+      if (AtomicRefCount::Decrement (cur->count) > 0)
         {
           break;
         }
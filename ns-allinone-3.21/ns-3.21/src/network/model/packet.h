@@ -671,6 +671,12 @@ private:
 
   uint32_t Deserialize (uint8_t const*buffer, uint32_t size);
 
+  /**
+   * \returns the next value of the global counter of packets Uid,
+   *          atomically while AtomicRefCount is enabled
+   */
+  static uint32_t AllocateUid (void);
+
   Buffer m_buffer;                //!< the packet buffer (it's actual contents)
   ByteTagList m_byteTagList;      //!< the ByteTag list
   PacketTagList m_packetTagList;  //!< the packet's Tag list
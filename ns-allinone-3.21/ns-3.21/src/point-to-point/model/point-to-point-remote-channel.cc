@@ -62,17 +62,21 @@ PointToPointRemoteChannel::TransmitStart (
 
   IsInitialized ();
 
-  uint32_t wire = src == GetSource (0) ? 0 : 1;
-  Ptr<PointToPointNetDevice> dst = GetDestination (wire);
-
 #ifdef NS3_MPI
-  // Calculate the rxTime (absolute)
-  Time rxTime = Simulator::Now () + txTime + GetDelay ();
-  MpiInterface::SendPacket (p, rxTime, dst->GetNode ()->GetId (), dst->GetIfIndex ());
-#else
-  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
+  if (MpiInterface::IsEnabled ())
+    {
+      uint32_t wire = src == GetSource (0) ? 0 : 1;
+      Ptr<PointToPointNetDevice> dst = GetDestination (wire);
+
+      // Calculate the rxTime (absolute)
+      Time rxTime = Simulator::Now () + txTime + GetDelay ();
+      MpiInterface::SendPacket (p, rxTime, dst->GetNode ()->GetId (), dst->GetIfIndex ());
+      return true;
+    }
 #endif
-  return true;
+  // both ends are in this process, e.g. in two partitions of the
+  // MultithreadedSimulatorImpl: deliver as a local channel
+  return PointToPointChannel::TransmitStart (p, src, txTime);
 }
 
 } // namespace ns3
@@ -20,7 +20,9 @@
 
 // This object connects two point-to-point net devices where at least one
 // is not local to this simulator object.  It simply over-rides the transmit
-// method and uses an MPI Send operation instead.
+// method and uses an MPI Send operation instead. Without MPI, both devices
+// are in this process and the packets are delivered as by the
+// PointToPointChannel.
 
 #ifndef POINT_TO_POINT_REMOTE_CHANNEL_H
 #define POINT_TO_POINT_REMOTE_CHANNEL_H
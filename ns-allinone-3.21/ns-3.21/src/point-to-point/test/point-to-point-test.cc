@@ -3,6 +3,14 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/string.h"
+#include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -56,6 +64,148 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 //-----------------------------------------------------------------------------
+/**
+ * Run a ring of point-to-point links, one node per system id, with the
+ * MultithreadedSimulatorImpl and compare the receptions of every node,
+ * in their order, with those of the DefaultSimulatorImpl. The ring is
+ * stopped by a Simulator::Stop (Time) called before the run, then by one
+ * called by a node during the run.
+ */
+class PointToPointMultithreadedTest : public TestCase
+{
+public:
+  PointToPointMultithreadedTest ();
+
+  virtual void DoRun (void);
+
+private:
+  typedef std::vector<std::pair<int64_t, uint32_t> > Receptions;
+
+  void RunRing (std::string simulatorType, bool stopDuringRun);
+  void CompareRing (bool stopDuringRun);
+  void Send (Ptr<NetDevice> device, uint32_t size);
+  void StopAfter (Time delay);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  // receptions of every node, each only written by the thread of its node
+  std::vector<Receptions> m_receptions;
+  Time m_end;
+};
+
+PointToPointMultithreadedTest::PointToPointMultithreadedTest ()
+  : TestCase ("PointToPointMultithreaded")
+{
+}
+
+void
+PointToPointMultithreadedTest::Send (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+}
+
+void
+PointToPointMultithreadedTest::StopAfter (Time delay)
+{
+  Simulator::Stop (delay);
+}
+
+bool
+PointToPointMultithreadedTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                        uint16_t protocol, const Address &from)
+{
+  Ptr<Node> node = device->GetNode ();
+  m_receptions[node->GetId ()].push_back (std::make_pair (Simulator::Now ().GetTimeStep (), packet->GetSize ()));
+  if (packet->GetSize () > 60)
+    {
+      // forward around the ring
+      Ptr<NetDevice> next = node->GetDevice (device->GetIfIndex () == 0 ? 1 : 0);
+      Send (next, packet->GetSize () - 10);
+    }
+  return true;
+}
+
+void
+PointToPointMultithreadedTest::RunRing (std::string simulatorType, bool stopDuringRun)
+{
+  const uint32_t n = 4;
+  ObjectFactory factory;
+  factory.SetTypeId (simulatorType);
+  Simulator::SetImplementation (factory.Create<SimulatorImpl> ());
+
+  NodeContainer nodes;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      nodes.Add (CreateObject<Node> (i));
+    }
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      p2p.Install (nodes.Get (i), nodes.Get ((i + 1) % n));
+    }
+
+  m_receptions.assign (n, Receptions ());
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Ptr<Node> node = nodes.Get (i);
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          Ptr<NetDevice> device = node->GetDevice (j);
+          device->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedTest::Receive, this));
+          for (uint32_t k = 0; k < 20; ++k)
+            {
+              Simulator::ScheduleWithContext (node->GetId (), Seconds (1.0) + MicroSeconds (1500 * k + 100 * i),
+                                              &PointToPointMultithreadedTest::Send, this, device, 100 + 20 * k + i);
+            }
+        }
+    }
+
+  Simulator::Stop (Seconds (1.1));
+  if (stopDuringRun)
+    {
+      // in the middle of the traffic, at least one lookahead later
+      Simulator::ScheduleWithContext (2, Seconds (1.02), &PointToPointMultithreadedTest::StopAfter,
+                                      this, MilliSeconds (5));
+    }
+  Simulator::Run ();
+  m_end = Simulator::Now ();
+  Simulator::Destroy ();
+}
+
+void
+PointToPointMultithreadedTest::CompareRing (bool stopDuringRun)
+{
+  RunRing ("ns3::DefaultSimulatorImpl", stopDuringRun);
+  std::vector<Receptions> expected = m_receptions;
+  Time expectedEnd = m_end;
+  RunRing ("ns3::MultithreadedSimulatorImpl", stopDuringRun);
+
+  NS_TEST_ASSERT_MSG_EQ (m_end, expectedEnd, "Stopped at another time");
+  Time stop = stopDuringRun ? MilliSeconds (1025) : MilliSeconds (1100);
+  NS_TEST_ASSERT_MSG_EQ (m_end, stop, "Stopped at another time");
+  for (uint32_t i = 0; i < expected.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_GT (expected[i].size (), 0, "No traffic");
+      NS_TEST_ASSERT_MSG_EQ (m_receptions[i].size (), expected[i].size (), "Receptions of node " << i);
+      NS_TEST_ASSERT_MSG_EQ ((m_receptions[i] == expected[i]), true, "Receptions of node " << i);
+    }
+}
+
+void
+PointToPointMultithreadedTest::DoRun (void)
+{
+  TypeId tid;
+  if (!TypeId::LookupByNameFailSafe ("ns3::MultithreadedSimulatorImpl", &tid))
+    {
+      // built without threading
+      return;
+    }
+
+  CompareRing (false);
+  CompareRing (true);
+}
+//-----------------------------------------------------------------------------
 class PointToPointTestSuite : public TestSuite
 {
 public:
@@ -66,6 +216,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointMultithreadedTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite;
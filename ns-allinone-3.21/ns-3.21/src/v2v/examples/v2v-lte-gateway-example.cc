@@ -0,0 +1,331 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/lte-module.h"
+
+#include "ns3/v2v-broadcast-helper.h"
+#include "ns3/v2v-novel-algorithm-helper.h"
+#include "ns3/v2v-cluster-gateway-helper.h"
+#include "ns3/v2v-channel-scheduler-helper.h"
+
+
+using namespace ns3;
+using namespace std;
+NS_LOG_COMPONENT_DEFINE("V2vLteGatewayExample");
+
+static const uint32_t SCH_NUMBERS[] = {172, 174, 176, 180, 182, 184};    /// IEEE 1609.4 service channels
+
+/**
+ * Uplink resources granted by the eNB scheduler. The UlScheduling trace
+ * reports the MCS and the transport block size of every grant, so the
+ * resource blocks are the smallest allocation of that MCS carrying the
+ * transport block.
+ */
+struct UplinkUsage {
+    Ptr<LteAmc> amc;
+    uint64_t grants;
+    uint64_t resourceBlocks;
+    uint64_t bytes;
+};
+
+static void ulScheduling(UplinkUsage *usage, uint32_t frameNo, uint32_t subframeNo,
+                         uint16_t rnti, uint8_t mcs, uint16_t tbSize){
+
+    int nprb = 1;
+    while (nprb < 110 && usage->amc->GetTbSizeFromMcs(mcs, nprb)/8 < tbSize) {
+        nprb ++;
+    }
+    usage->grants ++;
+    usage->resourceBlocks += nprb;
+    usage->bytes += tbSize;
+}
+
+void printGatewayStatistics(ApplicationContainer gatewayApps, Ptr<V2vUplinkServer> server,
+                            UplinkUsage *usage, double duration){
+
+    uint64_t generated = 0;
+    uint64_t relayed = 0;
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    for (uint32_t u = 0; u < gatewayApps.GetN(); ++u) {
+        Ptr<V2vClusterGateway> gateway = gatewayApps.Get(u)->GetObject<V2vClusterGateway>();
+        generated += gateway->GetGeneratedReports();
+        relayed += gateway->GetRelayedReports();
+        packets += gateway->GetUplinkPackets();
+        bytes += gateway->GetUplinkBytes();
+    }
+
+    NS_LOG_UNCOND("Generated reports: " << generated);
+    NS_LOG_UNCOND("Reports relayed over WAVE: " << relayed);
+    NS_LOG_UNCOND("Uplink packets: " << packets << " (" << bytes << " bytes)");
+    NS_LOG_UNCOND("Reports received by the server: " << server->GetReceivedReports()
+                  << " in " << server->GetReceivedPackets() << " packets");
+    NS_LOG_UNCOND("Mean report latency: " << server->GetLatency().GetMean());
+    NS_LOG_UNCOND("95th percentile report latency: " << server->GetLatency().GetQuantile(0.95));
+    NS_LOG_UNCOND("Uplink grants: " << usage->grants
+                  << " (" << usage->grants/duration << " per second)");
+    NS_LOG_UNCOND("Uplink resource blocks: " << usage->resourceBlocks
+                  << " (" << usage->resourceBlocks/duration << " per second)");
+    NS_LOG_UNCOND("Uplink transport block bytes: " << usage->bytes);
+}
+
+void printChannelStatistics(NodeContainer ueNodes){
+
+    std::map<uint32_t, uint64_t> sent;
+    std::map<uint32_t, uint64_t> queued;
+    std::map<uint32_t, uint64_t> dropped;
+    for (uint32_t u = 0; u < ueNodes.GetN(); ++u) {
+        Ptr<V2vChannelScheduler> scheduler = ueNodes.Get(u)->GetObject<V2vChannelScheduler>();
+        std::vector<uint32_t> channels = scheduler->GetSchs();
+        channels.insert(channels.begin(), V2vChannelScheduler::CCH);
+        for (uint32_t c = 0; c < channels.size(); ++c) {
+            sent[channels[c]] += scheduler->GetSent(channels[c]);
+            queued[channels[c]] += scheduler->GetQueued(channels[c]);
+            dropped[channels[c]] += scheduler->GetDropped(channels[c]);
+        }
+    }
+    for (std::map<uint32_t, uint64_t>::iterator it = sent.begin(); it != sent.end(); ++it) {
+        NS_LOG_UNCOND("Channel " << it->first << ": " << it->second << " packets sent, "
+                      << queued[it->first] << " waited for their interval, " << dropped[it->first] << " dropped");
+    }
+}
+
+int main(int argc, char *argv[]) {
+
+    /*--------------------- Logging System Configuration -------------------*/
+    LogLevel logLevel = (LogLevel) (LOG_PREFIX_ALL | LOG_LEVEL_WARN);
+    LogComponentEnable("V2vLteGatewayExample", logLevel);
+    LogComponentEnable("V2vClusterGateway", logLevel);
+
+    NS_LOG_UNCOND("/--------------------------------------------------------------------------\\");
+    NS_LOG_UNCOND(" - Cluster head LTE gateway [Example] -> Aggregated uplink of the clusters");
+    NS_LOG_UNCOND("\\--------------------------------------------------------------------------/");
+    /*----------------------------------------------------------------------*/
+
+    /*---------------------- Simulation Default Values ---------------------*/
+    uint16_t numberOfUes = 20;
+
+    double minimumTdmaSlot = 0.01;         /// Time difference between 2 transmissions
+    double simTime = 60.0;
+    double trainingPeriod = 20.0;
+
+    bool aggregation = true;
+    double reportInterval = 1.0;
+    uint32_t reportSize = 200;
+    double aggregationInterval = 1.0;
+    double compressionRatio = 0.5;
+
+    uint32_t serviceChannels = 0;
+    std::string channelAccess ("Continuous");
+    /*----------------------------------------------------------------------*/
+
+    /*-------------------- Command Line Argument Values --------------------*/
+    CommandLine cmd;
+    cmd.AddValue("ueNumber", "Number of UE", numberOfUes);
+    cmd.AddValue("simTime", "Simulation Time in Seconds", simTime);
+    cmd.AddValue("training", "Training period of Time", trainingPeriod);
+    cmd.AddValue("aggregation", "Aggregate the cluster reports at the cluster head", aggregation);
+    cmd.AddValue("reportInterval", "Period of the vehicle reports in Seconds", reportInterval);
+    cmd.AddValue("reportSize", "Size of a vehicle report in bytes", reportSize);
+    cmd.AddValue("aggregationInterval", "Period of the cluster head uplink in Seconds", aggregationInterval);
+    cmd.AddValue("compressionRatio", "Compressed to raw size ratio of the aggregated reports", compressionRatio);
+    cmd.AddValue("serviceChannels", "Service channels of the member reports, 0 to share the control channel", serviceChannels);
+    cmd.AddValue("channelAccess", "Continuous or Alternating CCH/SCH access of the vehicles", channelAccess);
+    cmd.Parse(argc, argv);
+
+    if(numberOfUes == 0 || simTime <= trainingPeriod || trainingPeriod < 0){
+        std::cout << "Invalid number of UEs, simulation time or training period";
+        return 0;
+    }
+    if(serviceChannels > sizeof(SCH_NUMBERS)/sizeof(SCH_NUMBERS[0])){
+        std::cout << "At most 6 service channels";
+        return 0;
+    }
+    if(channelAccess != "Continuous" && channelAccess != "Alternating"){
+        std::cout << "Invalid channel access. Continuous/Alternating are supported options.";
+        return 0;
+    }
+    /*----------------------------------------------------------------------*/
+
+    /*------------------------- Create UEs-EnodeBs -------------------------*/
+    // Node 0 stands for "no cluster head" in the clustering clients
+    NodeContainer dummyNode;
+    dummyNode.Create(1);
+
+    Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+    Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
+    lteHelper->SetEpcHelper (epcHelper);
+    Ptr<Node> pgw = epcHelper->GetPgwNode ();
+
+    NodeContainer remoteHostContainer;
+    remoteHostContainer.Create(1);
+    Ptr<Node> remoteHost = remoteHostContainer.Get (0);
+    NodeContainer enbNodes;
+    enbNodes.Create(1);
+    NodeContainer ueNodes;
+    ueNodes.Create(numberOfUes);
+    /*----------------------------------------------------------------------*/
+
+    /*------------------------- Highway and eNodeB -------------------------*/
+    // Two lanes of vehicles within the coverage of a single eNodeB
+    double length = 100.0*numberOfUes;
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantVelocityMobilityModel");
+    mobility.Install(ueNodes);
+    for (uint32_t u = 0; u < ueNodes.GetN(); ++u) {
+        double direction = u % 2 == 0 ? 1.0 : -1.0;
+        Ptr<ConstantVelocityMobilityModel> model = ueNodes.Get(u)->GetObject<ConstantVelocityMobilityModel>();
+        model->SetPosition(Vector(random->GetValue(0.0, length), 4.0*(u % 2), 0.0));
+        model->SetVelocity(Vector(direction*random->GetValue(25.0, 35.0), 0.0, 0.0));
+    }
+
+    Ptr<ListPositionAllocator> enbPosition = CreateObject<ListPositionAllocator> ();
+    enbPosition->Add (Vector(length/2, 50.0, 30.0));
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(enbPosition);
+    mobility.Install(enbNodes);
+    /*----------------------------------------------------------------------*/
+
+    /*------------------------ Core network and LTE ------------------------*/
+    InternetStackHelper internet;
+    internet.Install(remoteHostContainer);
+    internet.Install(ueNodes);
+
+    PointToPointHelper p2ph;
+    p2ph.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Gb/s")));
+    p2ph.SetDeviceAttribute ("Mtu", UintegerValue (1500));
+    p2ph.SetChannelAttribute ("Delay", TimeValue (Seconds (0.010)));
+    NetDeviceContainer internetDevices = p2ph.Install (pgw, remoteHost);
+    Ipv4AddressHelper ipv4h;
+    ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+    Ipv4InterfaceContainer internetIpIfaces = ipv4h.Assign (internetDevices);
+    Ipv4Address remoteHostAddr = internetIpIfaces.GetAddress (1);
+
+    Ipv4StaticRoutingHelper ipv4RoutingHelper;
+    Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ());
+    remoteHostStaticRouting->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.0.0.0"), 1);
+
+    NetDeviceContainer enbLteDevs = lteHelper->InstallEnbDevice (enbNodes);
+    NetDeviceContainer ueLteDevs = lteHelper->InstallUeDevice (ueNodes);
+    epcHelper->AssignUeIpv4Address (ueLteDevs);
+    for (uint32_t u = 0; u < ueNodes.GetN (); ++u) {
+        Ptr<Ipv4StaticRouting> ueStaticRouting = ipv4RoutingHelper.GetStaticRouting (ueNodes.Get (u)->GetObject<Ipv4> ());
+        ueStaticRouting->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+    }
+    lteHelper->Attach (ueLteDevs, enbLteDevs.Get (0));
+    /*----------------------------------------------------------------------*/
+
+    /*-------------------------- Setup WAVE nodes --------------------------*/
+    // "High" transmission range of the examples, without PHY/MAC contention
+    V2vBroadcastHelper broadcast;
+    broadcast.SetChannelAttribute ("ReceptionModel", StringValue ("LogDistance"));
+    broadcast.SetChannelAttribute ("TxPower", DoubleValue(32));
+    broadcast.SetChannelAttribute ("TxGain", DoubleValue(12));
+    broadcast.SetChannelAttribute ("RxGain", DoubleValue(12));
+    broadcast.SetChannelAttribute ("RxSensitivity", DoubleValue(-71.8));
+    broadcast.SetChannelAttribute ("DataRate", DataRateValue(DataRate ("6Mbps")));
+    NetDeviceContainer waveDevices = broadcast.Install (ueNodes);
+
+    ipv4h.SetBase ("10.1.0.0", "255.255.0.0");
+    ipv4h.Assign (waveDevices);
+    // The limited broadcast would also leave through the LTE device
+    Ipv4Address waveBroadcast ("10.1.255.255");
+
+    // One more medium and subnet per service channel, the first one being the CCH
+    if(serviceChannels > 0){
+        V2vChannelSchedulerHelper schedulerHelper;
+        schedulerHelper.SetSchedulerAttribute ("AccessMode", StringValue (channelAccess));
+        schedulerHelper.AddChannel (V2vChannelScheduler::CCH, waveDevices);
+        for (uint32_t c = 0; c < serviceChannels; ++c) {
+            NetDeviceContainer schDevices = broadcast.Install (ueNodes);
+            std::ostringstream subnet;
+            subnet << "10." << c + 2 << ".0.0";
+            ipv4h.SetBase (subnet.str ().c_str (), "255.255.0.0");
+            ipv4h.Assign (schDevices);
+            schedulerHelper.AddChannel (SCH_NUMBERS[c], schDevices);
+        }
+        schedulerHelper.Install (ueNodes);
+    }
+
+    uint16_t controlPort = 3999;
+    uint16_t reportPort = 5000;
+    uint16_t uplinkPort = 6000;
+    ApplicationContainer controlApps;
+    for (uint32_t u = 0; u < ueNodes.GetN(); ++u) {
+        Ptr<MobilityModel> mobilityModel = ueNodes.Get(u)->GetObject<MobilityModel>();
+        V2vNovelAlgorithmHelper ueClient("ns3::UdpSocketFactory", Address(InetSocketAddress(waveBroadcast, controlPort)),
+                "ns3::UdpSocketFactory",InetSocketAddress(Ipv4Address::GetAny(), controlPort), mobilityModel);
+        ueClient.SetAttribute ("TrainingPeriod", DoubleValue(trainingPeriod));
+        ueClient.SetAttribute ("MaxUes", UintegerValue(numberOfUes));
+        ueClient.SetAttribute ("MinimumTdmaSlot", DoubleValue(minimumTdmaSlot));
+        ueClient.SetAttribute ("VehicleTdmaSlot", DoubleValue((u+1)*minimumTdmaSlot));
+        ueClient.SetAttribute ("ClusterTimeMetric", DoubleValue(1.0));
+        controlApps.Add(ueClient.Install(ueNodes.Get(u)));
+    }
+    controlApps.Start (Seconds(0.));
+    controlApps.Stop (Seconds(simTime-0.1));
+    /*----------------------------------------------------------------------*/
+
+    /*------------------------- Cluster gateways ---------------------------*/
+    V2vUplinkServerHelper serverHelper (uplinkPort);
+    ApplicationContainer serverApps = serverHelper.Install (remoteHostContainer);
+    serverApps.Start (Seconds(0.));
+
+    V2vClusterGatewayHelper gatewayHelper (Address(InetSocketAddress(waveBroadcast, reportPort)),
+                                           Address(InetSocketAddress(remoteHostAddr, uplinkPort)));
+    gatewayHelper.SetAttribute ("Aggregation", BooleanValue(aggregation));
+    gatewayHelper.SetAttribute ("ReportInterval", TimeValue(Seconds(reportInterval)));
+    gatewayHelper.SetAttribute ("ReportSize", UintegerValue(reportSize));
+    gatewayHelper.SetAttribute ("AggregationInterval", TimeValue(Seconds(aggregationInterval)));
+    gatewayHelper.SetAttribute ("CompressionRatio", DoubleValue(compressionRatio));
+    ApplicationContainer gatewayApps = gatewayHelper.Install (controlApps);
+    gatewayApps.Start (Seconds(trainingPeriod));
+    gatewayApps.Stop (Seconds(simTime-0.5));
+
+    UplinkUsage usage;
+    usage.amc = CreateObject<LteAmc> ();
+    usage.grants = 0;
+    usage.resourceBlocks = 0;
+    usage.bytes = 0;
+    Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/LteEnbMac/UlScheduling",
+                                   MakeBoundCallback (&ulScheduling, &usage));
+    /*----------------------------------------------------------------------*/
+
+    Simulator::Schedule(Seconds(simTime), printGatewayStatistics, gatewayApps,
+                        serverApps.Get(0)->GetObject<V2vUplinkServer>(), &usage, simTime - trainingPeriod);
+    if(serviceChannels > 0){
+        Simulator::Schedule(Seconds(simTime), printChannelStatistics, ueNodes);
+    }
+
+    /*---------------------- Simulation Stopping Time ----------------------*/
+    Simulator::Stop(Seconds(simTime));
+    /*----------------------------------------------------------------------*/
+
+    /*--------------------------- Simulation Run ---------------------------*/
+    Simulator::Run();
+    Simulator::Destroy();
+    /*----------------------------------------------------------------------*/
+
+    return EXIT_SUCCESS;
+}
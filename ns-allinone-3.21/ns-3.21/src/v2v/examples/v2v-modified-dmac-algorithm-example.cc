@@ -33,6 +33,9 @@
 
 #include "ns3/v2v-mobility-model.h"
 #include "ns3/v2v-modified-dmac-algorithm-helper.h"
+#include "ns3/v2v-cluster-registry.h"
+#include "ns3/v2v-broadcast-helper.h"
+#include "ns3/v2v-cluster-snapshot-helper.h"
 
 
 #define SIMULATION_TIME_FORMAT(s) Seconds(s)
@@ -107,72 +110,49 @@ void printNumberofMessages(NodeContainer ueNodes, double simTime, double trainin
     NS_LOG_UNCOND("Average Number of messages Per Second: " << (sum/ueNodes.GetN ()) / (simTime-trainingPeriod));
 }
 
-void calculateClustersNumber(NodeContainer ueNodes, Ptr<FileAggregator> aggregator, std::string datasetContext, double trainingPeriod){
+void calculateClustersNumber(Ptr<FileAggregator> aggregator, std::string datasetContext, double trainingPeriod, double samplingInterval){
 
     // aggregator must be turned on
     aggregator->Enable ();
 
-    uint64_t sum = 0;
-    for (uint32_t u = 0; u < ueNodes.GetN(); ++u) {
-
-        Ptr<Application> temp = ueNodes.Get(u)->GetApplication (0);
-        Ptr<V2vModifiedDMACAlgorithmClient> tmp = temp->GetObject<V2vModifiedDMACAlgorithmClient>();
+    uint64_t sum = V2vClusterRegistry::Get ()->GetNodes (V2vClusterSap::CH);
 
-        if(tmp->GetRole() == V2vClusterSap::CH){
-            sum ++;
-        }
-    }
-
-    aggregator->Write2d (datasetContext, Simulator::Now ().GetSeconds () - trainingPeriod , sum);
+    aggregator->Write2d (datasetContext, Simulator::Now ().GetSeconds () - trainingPeriod, sum);
 
     // Disable logging of data for the aggregator.
     aggregator->Disable ();
 
-    Simulator::Schedule(Seconds(1.0),&calculateClustersNumber, ueNodes, aggregator, datasetContext, trainingPeriod);
+    Simulator::Schedule(Seconds(samplingInterval),&calculateClustersNumber, aggregator, datasetContext, trainingPeriod, samplingInterval);
 }
 
-void calculateNumberofMessagesPerSecond(NodeContainer ueNodes, Ptr<FileAggregator> aggregator, std::string datasetContext, double trainingPeriod){
+void calculateNumberofMessagesPerSecond(Ptr<FileAggregator> aggregator, std::string datasetContext, double trainingPeriod, double samplingInterval){
 
     // aggregator must be turned on
     aggregator->Enable ();
 
-    double sum = 0.0;
-    for (uint32_t u = 0; u < ueNodes.GetN(); ++u) {
-
-        Ptr<Application> temp = ueNodes.Get(u)->GetApplication (0);
-        Ptr<V2vModifiedDMACAlgorithmClient> tmp = temp->GetObject<V2vModifiedDMACAlgorithmClient>();
-
-        sum += tmp->GetNumberOfMessagesPerSecond();
-    }
+    double sum = V2vClusterRegistry::Get ()->GetNumberOfMessagesPerSecond () / samplingInterval;
 
     aggregator->Write2d (datasetContext, Simulator::Now ().GetSeconds () - trainingPeriod, sum);
 
     // Disable logging of data for the aggregator.
     aggregator->Disable ();
 
-    Simulator::Schedule(Seconds(1.0),&calculateNumberofMessagesPerSecond, ueNodes, aggregator, datasetContext, trainingPeriod);
+    Simulator::Schedule(Seconds(samplingInterval),&calculateNumberofMessagesPerSecond, aggregator, datasetContext, trainingPeriod, samplingInterval);
 }
 
-void calculateClusterChangesPerSecond(NodeContainer ueNodes, Ptr<FileAggregator> aggregator, std::string datasetContext, double trainingPeriod){
+void calculateClusterChangesPerSecond(Ptr<FileAggregator> aggregator, std::string datasetContext, double trainingPeriod, double samplingInterval){
 
     // aggregator must be turned on
     aggregator->Enable ();
 
-    double sum = 0.0;
-    for (uint32_t u = 0; u < ueNodes.GetN(); ++u) {
-
-        Ptr<Application> temp = ueNodes.Get(u)->GetApplication (0);
-        Ptr<V2vModifiedDMACAlgorithmClient> tmp = temp->GetObject<V2vModifiedDMACAlgorithmClient>();
-
-        sum += tmp->GetClusterChangesPerSecond();
-    }
+    double sum = V2vClusterRegistry::Get ()->GetClusterChangesPerSecond () / samplingInterval;
 
     aggregator->Write2d (datasetContext, Simulator::Now ().GetSeconds () - trainingPeriod, sum);
 
     // Disable logging of data for the aggregator.
     aggregator->Disable ();
 
-    Simulator::Schedule(Seconds(1.0),&calculateClusterChangesPerSecond, ueNodes, aggregator, datasetContext, trainingPeriod);
+    Simulator::Schedule(Seconds(samplingInterval),&calculateClusterChangesPerSecond, aggregator, datasetContext, trainingPeriod, samplingInterval);
 }
 
 void printChDuration(NodeContainer ueNodes){
@@ -268,6 +248,23 @@ void printMaxCmDuration(NodeContainer ueNodes){
 }
 
 
+void printDurationPercentiles(NodeContainer ueNodes){
+
+    V2vStatisticsAccumulator chDuration;
+    V2vStatisticsAccumulator cmDuration;
+    for (uint32_t u = 0; u < ueNodes.GetN(); ++u) {
+
+        Ptr<Application> temp = ueNodes.Get(u)->GetApplication (0);
+        Ptr<V2vModifiedDMACAlgorithmClient> tmp = temp->GetObject<V2vModifiedDMACAlgorithmClient>();
+        chDuration.Merge(tmp->GetChDurationStatistics());
+        cmDuration.Merge(tmp->GetCmDurationStatistics());
+    }
+    NS_LOG_UNCOND("Median CH duration is: " << chDuration.GetQuantile(0.5));
+    NS_LOG_UNCOND("95th percentile CH duration is: " << chDuration.GetQuantile(0.95));
+    NS_LOG_UNCOND("Median CM duration is: " << cmDuration.GetQuantile(0.5));
+    NS_LOG_UNCOND("95th percentile CM duration is: " << cmDuration.GetQuantile(0.95));
+}
+
 int main(int argc, char *argv[]) {
 
     /*--------------------- Logging System Configuration -------------------*/
@@ -295,11 +292,16 @@ int main(int argc, char *argv[]) {
 
     double simTime = 750.0;
     double trainingPeriod = 80.0;
+    double samplingInterval = 1.0;         /// Period of the cluster census samples
 
     std::string traceFile;
     std::string logFile;
+    std::string saveSnapshot;
+    std::string loadSnapshot;
+    double snapshotTime = -1.0;           /// Time of the saved snapshot, the training period if negative
     std::string range;
     std::string scenario;
+    std::string channelType ("Wifi");
     double gain;
     double power;
     /*----------------------------------------------------------------------*/
@@ -322,10 +324,15 @@ int main(int argc, char *argv[]) {
     cmd.AddValue("ueNumber", "Number of UE", numberOfUes);
     cmd.AddValue("simTime", "Simulation Time in Seconds", simTime);
     cmd.AddValue("range", "Transmission range of the vehicles", range);
+    cmd.AddValue("channel", "Wifi for the 802.11p stack, Abstract for the fast broadcast channel", channelType);
     cmd.AddValue("training", "Training period of Time", trainingPeriod);
+    cmd.AddValue("samplingInterval", "Period of the cluster census samples in Seconds", samplingInterval);
 
     cmd.AddValue ("traceFile", "Ns3 movement trace file", traceFile);
     cmd.AddValue ("logFile", "Log file", logFile);
+    cmd.AddValue ("saveSnapshot", "File the clustering state is saved to at snapshotTime", saveSnapshot);
+    cmd.AddValue ("snapshotTime", "Time of the saved snapshot, the training period by default", snapshotTime);
+    cmd.AddValue ("loadSnapshot", "Clustering snapshot to start from instead of the training period", loadSnapshot);
     cmd.Parse(argc, argv);
 
     NS_LOG_INFO("");
@@ -349,6 +356,11 @@ int main(int argc, char *argv[]) {
         return 0;
       }
 
+    if(samplingInterval <= 0){
+        std::cout << "Sampling interval must be positive";
+        return 0;
+    }
+
     if(strcasecmp ((char*)range.c_str (), "High") == 0){
         NS_LOG_INFO("High transimssion range set.");
         power = 32;
@@ -369,6 +381,12 @@ int main(int argc, char *argv[]) {
         return 0;
     }
 
+    bool abstractChannel = strcasecmp ((char*)channelType.c_str (), "Abstract") == 0;
+    if(!abstractChannel && strcasecmp ((char*)channelType.c_str (), "Wifi") != 0){
+        std::cout << "Invalid channel. Wifi/Abstract are supported options.";
+        return 0;
+    }
+
     if(traceFile.find ("Scenario1") != string::npos){
         scenario = "Scenario1";
     }
@@ -424,29 +442,43 @@ int main(int argc, char *argv[]) {
 
 
     /*-------------------------- Setup Wifi nodes --------------------------*/
-    // The below set of helpers will help us to put together the wifi NICs we want
-    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
-    Ptr<YansWifiChannel> channel = wifiChannel.Create ();
-
+    NetDeviceContainer wifiDevices;
     YansWifiPhyHelper wifiPhy =  YansWifiPhyHelper::Default ();
-    wifiPhy.SetChannel (channel);
-    wifiPhy.SetPcapDataLinkType (YansWifiPhyHelper::DLT_IEEE802_11);
-    wifiPhy.Set ("TxPowerStart", DoubleValue(power));
-    wifiPhy.Set ("TxPowerEnd", DoubleValue(power));
-    wifiPhy.Set ("TxPowerLevels", UintegerValue(1));
-    wifiPhy.Set ("TxGain", DoubleValue(gain));
-    wifiPhy.Set ("RxGain", DoubleValue(gain));
-    wifiPhy.Set ("EnergyDetectionThreshold", DoubleValue(-71.8));
-    wifiPhy.Set ("CcaMode1Threshold", DoubleValue(-74.8));
-
-    NqosWaveMacHelper wifi80211pMac = NqosWaveMacHelper::Default ();
-    Wifi80211pHelper wifi80211p = Wifi80211pHelper::Default ();
-    //wifi80211p.EnableLogComponents ();
-
-    wifi80211p.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
-                                      "DataMode",StringValue (phyMode),
-                                      "ControlMode",StringValue (phyMode));
-    NetDeviceContainer wifiDevices = wifi80211p.Install (wifiPhy, wifi80211pMac, ueNodes);
+    if(abstractChannel){
+        // Same link budget as the Wifi setup, without PHY/MAC contention
+        V2vBroadcastHelper broadcast;
+        broadcast.SetChannelAttribute ("ReceptionModel", StringValue ("LogDistance"));
+        broadcast.SetChannelAttribute ("TxPower", DoubleValue(power));
+        broadcast.SetChannelAttribute ("TxGain", DoubleValue(gain));
+        broadcast.SetChannelAttribute ("RxGain", DoubleValue(gain));
+        broadcast.SetChannelAttribute ("RxSensitivity", DoubleValue(-71.8));
+        broadcast.SetChannelAttribute ("DataRate", DataRateValue(DataRate ("6Mbps")));
+        wifiDevices = broadcast.Install (ueNodes);
+    }
+    else{
+        // The below set of helpers will help us to put together the wifi NICs we want
+        YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+        Ptr<YansWifiChannel> channel = wifiChannel.Create ();
+
+        wifiPhy.SetChannel (channel);
+        wifiPhy.SetPcapDataLinkType (YansWifiPhyHelper::DLT_IEEE802_11);
+        wifiPhy.Set ("TxPowerStart", DoubleValue(power));
+        wifiPhy.Set ("TxPowerEnd", DoubleValue(power));
+        wifiPhy.Set ("TxPowerLevels", UintegerValue(1));
+        wifiPhy.Set ("TxGain", DoubleValue(gain));
+        wifiPhy.Set ("RxGain", DoubleValue(gain));
+        wifiPhy.Set ("EnergyDetectionThreshold", DoubleValue(-71.8));
+        wifiPhy.Set ("CcaMode1Threshold", DoubleValue(-74.8));
+
+        NqosWaveMacHelper wifi80211pMac = NqosWaveMacHelper::Default ();
+        Wifi80211pHelper wifi80211p = Wifi80211pHelper::Default ();
+        //wifi80211p.EnableLogComponents ();
+
+        wifi80211p.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                          "DataMode",StringValue (phyMode),
+                                          "ControlMode",StringValue (phyMode));
+        wifiDevices = wifi80211p.Install (wifiPhy, wifi80211pMac, ueNodes);
+    }
 
     NS_LOG_INFO ("Assign IP Addresses.");
     ipv4h.SetBase ("10.1.0.0", "255.255.0.0");
@@ -481,9 +513,20 @@ int main(int argc, char *argv[]) {
     controlApps.Start (Seconds(0.));
     controlApps.Stop (Seconds(simTime-0.1));
 
-    AsciiTraceHelper ascii;
-    wifiPhy.EnableAsciiAll(ascii.CreateFileStream ("src/v2v/examples/output/socket-options-ipv4.txt"));
-    wifiPhy.EnablePcapAll ("src/v2v/examples/output/socket.pcap", false);
+    V2vClusterSnapshotHelper snapshotHelper;
+    if(!loadSnapshot.empty ()){
+        Time resumeTime = snapshotHelper.Restore (controlApps, loadSnapshot);
+        NS_LOG_INFO("|---"<< " Resuming from snapshot at -> " << resumeTime.GetSeconds () <<" ---|\n");
+    }
+    if(!saveSnapshot.empty ()){
+        snapshotHelper.Save (controlApps, Seconds (snapshotTime < 0 ? trainingPeriod : snapshotTime), saveSnapshot);
+    }
+
+    if(!abstractChannel){
+        AsciiTraceHelper ascii;
+        wifiPhy.EnableAsciiAll(ascii.CreateFileStream ("src/v2v/examples/output/socket-options-ipv4.txt"));
+        wifiPhy.EnablePcapAll ("src/v2v/examples/output/socket.pcap", false);
+    }
     /*----------------------------------------------------------------------*/
 
     string numberofClustersFile       = "NumberOfClusters[" + exampleName + scenario + range + "].txt";
@@ -496,17 +539,17 @@ int main(int argc, char *argv[]) {
     Simulator::Schedule(Seconds(simTime), printFormationDelay, ueNodes);
     Simulator::Schedule(Seconds(simTime), printClusterChanges, ueNodes);
     Simulator::Schedule(Seconds(simTime), printNumberofMessages, ueNodes, simTime, trainingPeriod);
-    Simulator::Schedule(Seconds(trainingPeriod), calculateClustersNumber, ueNodes, aggregator1, datasetContext, trainingPeriod);
+    Simulator::Schedule(Seconds(trainingPeriod), calculateClustersNumber, aggregator1, datasetContext, trainingPeriod, samplingInterval);
 
     string numberofMessagesPerSecondFile       = "NumberOfMessagesPerSecond[" + exampleName + scenario + range + "].txt";
     Ptr<FileAggregator> aggregator2 = CreateObject<FileAggregator> (numberofMessagesPerSecondFile, FileAggregator::FORMATTED);
     aggregator2->Set2dFormat ("%.3e\t%.0f");
-    Simulator::Schedule(Seconds(trainingPeriod), calculateNumberofMessagesPerSecond, ueNodes, aggregator2, datasetContext, trainingPeriod);
+    Simulator::Schedule(Seconds(trainingPeriod), calculateNumberofMessagesPerSecond, aggregator2, datasetContext, trainingPeriod, samplingInterval);
 
     string clusterChangesPerSecondFile       = "ClusterChangesPerSecond[" + exampleName + scenario + range + "].txt";
     Ptr<FileAggregator> aggregator3 = CreateObject<FileAggregator> (clusterChangesPerSecondFile, FileAggregator::FORMATTED);
     aggregator3->Set2dFormat ("%.3e\t%.0f");
-    Simulator::Schedule(Seconds(trainingPeriod), calculateClusterChangesPerSecond, ueNodes, aggregator3, datasetContext, trainingPeriod);
+    Simulator::Schedule(Seconds(trainingPeriod), calculateClusterChangesPerSecond, aggregator3, datasetContext, trainingPeriod, samplingInterval);
 
     Simulator::Schedule(Seconds(simTime), printChDuration, ueNodes);
     Simulator::Schedule(Seconds(simTime), printCmDuration, ueNodes);
@@ -514,6 +557,7 @@ int main(int argc, char *argv[]) {
     Simulator::Schedule(Seconds(simTime), printMaxChDuration, ueNodes);
     Simulator::Schedule(Seconds(simTime), printMinCmDuration, ueNodes);
     Simulator::Schedule(Seconds(simTime), printMaxCmDuration, ueNodes);
+    Simulator::Schedule(Seconds(simTime), printDurationPercentiles, ueNodes);
 
     /*---------------------- Simulation Stopping Time ----------------------*/
     Simulator::Stop(SIMULATION_TIME_FORMAT(simTime));
@@ -0,0 +1,439 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wave-mac-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/wifi-80211p-helper.h"
+#include "ns3/v2v-cluster-registry.h"
+#include "ns3/v2v-slot-allocator.h"
+#include "ns3/v2v-broadcast-helper.h"
+#include "ns3/v2v-fcd-mobility-feed.h"
+#include "ns3/v2v-novel-algorithm-helper.h"
+#include "ns3/v2v-affinity-algorithm-helper.h"
+#include "ns3/v2v-modified-dmac-algorithm-helper.h"
+
+
+using namespace ns3;
+using namespace std;
+NS_LOG_COMPONENT_DEFINE("V2vScalabilityBenchmark");
+
+static const double HIGHWAY_SPACING = 60.0;         /// Mean gap between vehicles of a lane (m)
+static const uint32_t HIGHWAY_LANES = 3;            /// Lanes per direction
+static const double GRID_BLOCK = 200.0;             /// Side of a Manhattan block (m)
+static const double GRID_SPACING = 60.0;           /// Mean street length per vehicle (m)
+static const uint32_t TDMA_FRAME = 100;             /// Largest MaxUes accepted by the clients
+
+static std::vector<std::string> splitList(std::string list){
+
+    std::vector<std::string> items;
+    std::istringstream iss(list);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        if(!item.empty()){
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/**
+ * Two directions of HIGHWAY_LANES lanes along x; the road grows with the
+ * fleet so that the density, and so the neighbors per vehicle, stays the
+ * same for every fleet size.
+ */
+static void installHighway(NodeContainer ueNodes){
+
+    uint32_t lanes = 2*HIGHWAY_LANES;
+    double length = std::ceil((double)ueNodes.GetN()/lanes)*HIGHWAY_SPACING;
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantVelocityMobilityModel");
+    mobility.Install(ueNodes);
+    for (uint32_t u = 0; u < ueNodes.GetN(); ++u) {
+        uint32_t lane = u % lanes;
+        double direction = lane < HIGHWAY_LANES ? 1.0 : -1.0;
+        Ptr<ConstantVelocityMobilityModel> model = ueNodes.Get(u)->GetObject<ConstantVelocityMobilityModel>();
+        model->SetPosition(Vector(random->GetValue(0.0, length), 4.0*lane, 0.0));
+        model->SetVelocity(Vector(direction*random->GetValue(25.0, 35.0), 0.0, 0.0));
+    }
+}
+
+/**
+ * Square Manhattan grid of GRID_BLOCK blocks, sized for GRID_SPACING of
+ * street per vehicle; every vehicle drives straight along its street.
+ */
+static void installGrid(NodeContainer ueNodes){
+
+    // 2 k (k-1) blocks of street for k streets per axis
+    double blocks = ueNodes.GetN()*GRID_SPACING/GRID_BLOCK/2.0;
+    uint32_t streets = (uint32_t)std::ceil((1.0 + std::sqrt(1.0 + 4.0*blocks))/2.0);
+    if(streets < 2){
+        streets = 2;
+    }
+    double side = (streets - 1)*GRID_BLOCK;
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantVelocityMobilityModel");
+    mobility.Install(ueNodes);
+    for (uint32_t u = 0; u < ueNodes.GetN(); ++u) {
+        double street = random->GetInteger(0, streets - 1)*GRID_BLOCK;
+        double along = random->GetValue(0.0, side);
+        double speed = random->GetValue(10.0, 15.0)*(random->GetValue() < 0.5 ? -1.0 : 1.0);
+        Ptr<ConstantVelocityMobilityModel> model = ueNodes.Get(u)->GetObject<ConstantVelocityMobilityModel>();
+        if(u % 2 == 0){
+            model->SetPosition(Vector(along, street, 0.0));
+            model->SetVelocity(Vector(speed, 0.0, 0.0));
+        }
+        else{
+            model->SetPosition(Vector(street, along, 0.0));
+            model->SetVelocity(Vector(0.0, speed, 0.0));
+        }
+    }
+}
+
+/**
+ * Vehicles of a SUMO FCD stream, read while the simulation runs: the
+ * fleet is the pool of nodes the vehicles on the road take, the others
+ * being parked away from the road.
+ */
+static Ptr<V2vFcdMobilityFeed> installTrace(NodeContainer ueNodes, std::string fcdSource){
+
+    Ptr<V2vFcdMobilityFeed> feed = CreateObject<V2vFcdMobilityFeed>();
+    feed->SetAttribute("Source", StringValue(fcdSource));
+    feed->Install(ueNodes);
+    NS_ABORT_MSG_IF (!feed->Start(), "Could not open the FCD stream " << fcdSource);
+    return feed;
+}
+
+static NetDeviceContainer installDevices(NodeContainer ueNodes, bool abstractChannel){
+
+    // "High" transmission range of the examples
+    double power = 32;
+    double gain = 12;
+
+    if(abstractChannel){
+        V2vBroadcastHelper broadcast;
+        broadcast.SetChannelAttribute ("ReceptionModel", StringValue ("LogDistance"));
+        broadcast.SetChannelAttribute ("TxPower", DoubleValue(power));
+        broadcast.SetChannelAttribute ("TxGain", DoubleValue(gain));
+        broadcast.SetChannelAttribute ("RxGain", DoubleValue(gain));
+        broadcast.SetChannelAttribute ("RxSensitivity", DoubleValue(-71.8));
+        broadcast.SetChannelAttribute ("DataRate", DataRateValue(DataRate ("6Mbps")));
+        return broadcast.Install (ueNodes);
+    }
+
+    std::string phyMode ("OfdmRate6MbpsBW10MHz");
+    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+    YansWifiPhyHelper wifiPhy =  YansWifiPhyHelper::Default ();
+    wifiPhy.SetChannel (wifiChannel.Create ());
+    wifiPhy.Set ("TxPowerStart", DoubleValue(power));
+    wifiPhy.Set ("TxPowerEnd", DoubleValue(power));
+    wifiPhy.Set ("TxPowerLevels", UintegerValue(1));
+    wifiPhy.Set ("TxGain", DoubleValue(gain));
+    wifiPhy.Set ("RxGain", DoubleValue(gain));
+    wifiPhy.Set ("EnergyDetectionThreshold", DoubleValue(-71.8));
+    wifiPhy.Set ("CcaMode1Threshold", DoubleValue(-74.8));
+
+    NqosWaveMacHelper wifi80211pMac = NqosWaveMacHelper::Default ();
+    Wifi80211pHelper wifi80211p = Wifi80211pHelper::Default ();
+    wifi80211p.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                      "DataMode",StringValue (phyMode),
+                                      "ControlMode",StringValue (phyMode));
+    return wifi80211p.Install (wifiPhy, wifi80211pMac, ueNodes);
+}
+
+/**
+ * Fixed slots: vehicle u gets the slot u+1 of a frame of at most
+ * TDMA_FRAME slots. Hashed slots: every vehicle hashes its id into a
+ * TDMA_FRAME slots frame and moves when it hears a beacon in its slot.
+ */
+template <typename Helper>
+static void setTdmaSlot(Helper &ueClient, bool hashedSlots, uint32_t frame, uint32_t slot, double minimumTdmaSlot){
+
+    ueClient.SetAttribute ("MinimumTdmaSlot", DoubleValue(minimumTdmaSlot));
+    if(hashedSlots){
+        ueClient.SetAttribute ("SlotAllocation", EnumValue(V2vSlotAllocator::HASHED));
+        ueClient.SetAttribute ("FrameSlots", UintegerValue(TDMA_FRAME));
+    }
+    else{
+        ueClient.SetAttribute ("MaxUes", UintegerValue(frame));
+        ueClient.SetAttribute ("VehicleTdmaSlot", DoubleValue(slot*minimumTdmaSlot));
+    }
+}
+
+/**
+ * The clients accept at most TDMA_FRAME fixed slots, so larger fleets reuse
+ * the slots of the frame; the vehicles sharing a slot are far apart on
+ * average since the slots follow the node order, not the position.
+ */
+static void installClients(NodeContainer ueNodes, std::string algorithm, double trainingPeriod, bool hashedSlots){
+
+    uint16_t controlPort = 3999;
+    uint32_t frame = std::min(ueNodes.GetN(), TDMA_FRAME);
+    Address peer = Address(InetSocketAddress(Ipv4Address::GetBroadcast(), controlPort));
+    Address local = InetSocketAddress(Ipv4Address::GetAny(), controlPort);
+
+    for (uint32_t u = 0; u < ueNodes.GetN(); ++u) {
+        Ptr<MobilityModel> mobilityModel = ueNodes.Get(u)->GetObject<MobilityModel>();
+        uint32_t slot = u % frame + 1;
+
+        if(algorithm == "novel"){
+            double minimumTdmaSlot = 0.01;
+            V2vNovelAlgorithmHelper ueClient("ns3::UdpSocketFactory", peer, "ns3::UdpSocketFactory", local, mobilityModel);
+            ueClient.SetAttribute ("TrainingPeriod", DoubleValue(trainingPeriod));
+            setTdmaSlot(ueClient, hashedSlots, frame, slot, minimumTdmaSlot);
+            ueClient.SetAttribute ("ClusterTimeMetric", DoubleValue(1.0));
+            ueClient.Install(ueNodes.Get(u));
+        }
+        else if(algorithm == "affinity"){
+            double minimumTdmaSlot = 0.001;
+            V2vAffinityAlgorithmHelper ueClient("ns3::UdpSocketFactory", peer, "ns3::UdpSocketFactory", local, mobilityModel);
+            ueClient.SetAttribute ("TrainingPeriod", DoubleValue(trainingPeriod));
+            ueClient.SetAttribute ("SelfSimilarity", DoubleValue(-150.0));
+            ueClient.SetAttribute ("CI", UintegerValue(10));
+            ueClient.SetAttribute ("Tf", DoubleValue(1.0));
+            ueClient.SetAttribute ("Lamda", DoubleValue(0.5));
+            setTdmaSlot(ueClient, hashedSlots, frame, slot, minimumTdmaSlot);
+            ueClient.Install(ueNodes.Get(u));
+        }
+        else{
+            double minimumTdmaSlot = 0.001;
+            double beats = 1.0;
+            V2vModifiedDMACAlgorithmHelper ueClient("ns3::UdpSocketFactory", peer, "ns3::UdpSocketFactory", local, mobilityModel);
+            ueClient.SetAttribute ("TrainingPeriod", DoubleValue(trainingPeriod));
+            ueClient.SetAttribute ("TTL", UintegerValue(1));
+            ueClient.SetAttribute ("Beats", DoubleValue(beats));
+            ueClient.SetAttribute ("Range", DoubleValue(200.0));
+            ueClient.SetAttribute ("Freshness", DoubleValue(10*beats));
+            setTdmaSlot(ueClient, hashedSlots, frame, slot, minimumTdmaSlot);
+            ueClient.Install(ueNodes.Get(u));
+        }
+    }
+}
+
+/**
+ * Run one benchmark point and return its result row. Called in a child
+ * process so that the peak RSS and the simulator state are its own.
+ */
+static std::string runBenchmark(std::string algorithm, std::string topology, uint32_t vehicles,
+        double simTime, double trainingPeriod, bool abstractChannel, bool hashedSlots, std::string fcdSource){
+
+    SystemWallClockMs setupClock;
+    setupClock.Start();
+
+    NodeContainer dummyNode;
+    dummyNode.Create(1);
+    NodeContainer ueNodes;
+    ueNodes.Create(vehicles);
+    Ptr<V2vFcdMobilityFeed> feed;
+    if(topology == "highway"){
+        installHighway(ueNodes);
+    }
+    else if(topology == "trace"){
+        feed = installTrace(ueNodes, fcdSource);
+    }
+    else{
+        installGrid(ueNodes);
+    }
+
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(ueNodes);
+
+    NetDeviceContainer devices = installDevices(ueNodes, abstractChannel);
+    Ipv4AddressHelper ipv4h;
+    ipv4h.SetBase ("10.0.0.0", "255.0.0.0");
+    ipv4h.Assign (devices);
+
+    installClients(ueNodes, algorithm, trainingPeriod, hashedSlots);
+    int64_t setupMs = setupClock.End();
+
+    Simulator::Stop(Seconds(simTime));
+    SystemWallClockMs runClock;
+    runClock.Start();
+    Simulator::Run();
+    int64_t runMs = runClock.End();
+
+    uint64_t events = Simulator::GetEventCount();
+    uint64_t messages = V2vClusterRegistry::Get()->GetNumberOfMessages();
+    Simulator::Destroy();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    double runSeconds = runMs/1000.0;
+    double activeTime = simTime - trainingPeriod;
+    std::ostringstream row;
+    row << algorithm << "\t" << topology << "\t" << (abstractChannel ? "Abstract" : "Wifi") << "\t"
+        << (hashedSlots ? "Hashed" : "Fixed") << "\t"
+        << vehicles << "\t" << simTime << "\t"
+        << setupMs/1000.0 << "\t" << runSeconds << "\t" << events << "\t"
+        << (runSeconds > 0 ? events/runSeconds : 0.0) << "\t"
+        << usage.ru_maxrss << "\t"
+        << (activeTime > 0 ? messages/(double)vehicles/activeTime : 0.0) << "\n";
+    return row.str();
+}
+
+int main(int argc, char *argv[]) {
+
+    /*--------------------- Logging System Configuration -------------------*/
+    LogLevel logLevel = (LogLevel) (LOG_PREFIX_ALL | LOG_LEVEL_WARN);
+    LogComponentEnable("V2vScalabilityBenchmark", logLevel);
+    /*----------------------------------------------------------------------*/
+
+    /*---------------------- Simulation Default Values ---------------------*/
+    std::string algorithms ("novel,affinity,modified-dmac");
+    std::string topologies ("highway,grid");
+    std::string vehicles ("100,1000,10000");
+    std::string channelType ("Abstract");
+    std::string slotAllocation ("Fixed");
+    std::string resultsFile;
+    std::string fcdSource;
+
+    double simTime = 30.0;
+    double trainingPeriod = 5.0;
+    /*----------------------------------------------------------------------*/
+
+
+    /*-------------------- Command Line Argument Values --------------------*/
+    CommandLine cmd;
+    cmd.AddValue("algorithms", "Comma separated list of novel/affinity/modified-dmac", algorithms);
+    cmd.AddValue("topologies", "Comma separated list of highway/grid/trace", topologies);
+    cmd.AddValue("vehicles", "Comma separated list of fleet sizes", vehicles);
+    cmd.AddValue("channel", "Wifi for the 802.11p stack, Abstract for the fast broadcast channel", channelType);
+    cmd.AddValue("slots", "Fixed for the per vehicle TDMA offsets, Hashed for the hashed slot allocation", slotAllocation);
+    cmd.AddValue("simTime", "Simulated time of every run in Seconds", simTime);
+    cmd.AddValue("training", "Training period of Time", trainingPeriod);
+    cmd.AddValue("resultsFile", "Append the result rows to this file as well", resultsFile);
+    cmd.AddValue("fcdSource", "SUMO FCD stream of the trace topology: a file, a named pipe, - or tcp:host:port", fcdSource);
+    cmd.Parse(argc, argv);
+    /*----------------------------------------------------------------------*/
+
+    bool abstractChannel = strcasecmp ((char*)channelType.c_str (), "Abstract") == 0;
+    if(!abstractChannel && strcasecmp ((char*)channelType.c_str (), "Wifi") != 0){
+        std::cout << "Invalid channel. Wifi/Abstract are supported options.";
+        return EXIT_FAILURE;
+    }
+    bool hashedSlots = strcasecmp ((char*)slotAllocation.c_str (), "Hashed") == 0;
+    if(!hashedSlots && strcasecmp ((char*)slotAllocation.c_str (), "Fixed") != 0){
+        std::cout << "Invalid slot allocation. Fixed/Hashed are supported options.";
+        return EXIT_FAILURE;
+    }
+    if(trainingPeriod < 0 || simTime <= trainingPeriod){
+        std::cout << "Simulation time must exceed a non negative training period";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> algorithmList = splitList(algorithms);
+    std::vector<std::string> topologyList = splitList(topologies);
+    std::vector<std::string> vehicleList = splitList(vehicles);
+    for (uint32_t a = 0; a < algorithmList.size(); ++a) {
+        if(algorithmList[a] != "novel" && algorithmList[a] != "affinity" && algorithmList[a] != "modified-dmac"){
+            std::cout << "Invalid algorithm " << algorithmList[a];
+            return EXIT_FAILURE;
+        }
+    }
+    for (uint32_t t = 0; t < topologyList.size(); ++t) {
+        if(topologyList[t] != "highway" && topologyList[t] != "grid" && topologyList[t] != "trace"){
+            std::cout << "Invalid topology " << topologyList[t];
+            return EXIT_FAILURE;
+        }
+        if(topologyList[t] == "trace" && fcdSource.empty()){
+            std::cout << "The trace topology needs an fcdSource";
+            return EXIT_FAILURE;
+        }
+    }
+
+    /*---------------------------- Benchmark Run ---------------------------*/
+    std::string header = "# algorithm\ttopology\tchannel\tslots\tvehicles\tsimTime\tsetupSeconds\trunSeconds\t"
+                         "events\teventsPerSecond\tpeakRssKb\tmessagesPerVehiclePerSecond";
+    std::cout << header << std::endl;
+
+    uint32_t failed = 0;
+    for (uint32_t a = 0; a < algorithmList.size(); ++a) {
+        for (uint32_t t = 0; t < topologyList.size(); ++t) {
+            for (uint32_t v = 0; v < vehicleList.size(); ++v) {
+                uint32_t fleet = atoi(vehicleList[v].c_str());
+                if(fleet == 0){
+                    continue;
+                }
+
+                // each point in its own process, reporting through a pipe
+                int fds[2];
+                NS_ABORT_MSG_IF (pipe(fds) != 0, "Could not create a pipe");
+                pid_t pid = fork();
+                if(pid == 0){
+                    // the clients report on stdout and stderr
+                    close(fds[0]);
+                    int null = open("/dev/null", O_WRONLY);
+                    dup2(null, STDOUT_FILENO);
+                    dup2(null, STDERR_FILENO);
+                    close(null);
+                    std::string row = runBenchmark(algorithmList[a], topologyList[t], fleet, simTime, trainingPeriod, abstractChannel, hashedSlots, fcdSource);
+                    _exit(write(fds[1], row.c_str(), row.size()) == (ssize_t)row.size() ? 0 : 1);
+                }
+                close(fds[1]);
+
+                std::string row;
+                char buffer[256];
+                ssize_t n;
+                while((n = read(fds[0], buffer, sizeof(buffer))) > 0){
+                    row.append(buffer, n);
+                }
+                close(fds[0]);
+
+                int status = 0;
+                waitpid(pid, &status, 0);
+                if(pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || row.empty()){
+                    NS_LOG_WARN("Benchmark " << algorithmList[a] << " " << topologyList[t] << " " << fleet << " failed");
+                    failed++;
+                    continue;
+                }
+
+                std::cout << row << std::flush;
+                if(!resultsFile.empty()){
+                    bool exists = access(resultsFile.c_str(), F_OK) == 0;
+                    std::ofstream results(resultsFile.c_str(), std::ios::app);
+                    if(!exists){
+                        results << header << "\n";
+                    }
+                    results << row;
+                }
+            }
+        }
+    }
+    /*----------------------------------------------------------------------*/
+
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
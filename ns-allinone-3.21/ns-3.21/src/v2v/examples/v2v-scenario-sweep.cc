@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include <sstream>
+#include "ns3/core-module.h"
+#include "ns3/v2v-sweep-helper.h"
+
+
+using namespace ns3;
+using namespace std;
+NS_LOG_COMPONENT_DEFINE("V2vScenarioSweep");
+
+static std::vector<std::string> splitList(std::string list){
+
+    std::vector<std::string> items;
+    std::istringstream iss(list);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        if(!item.empty()){
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+int main(int argc, char *argv[]) {
+
+    /*--------------------- Logging System Configuration -------------------*/
+    LogLevel logLevel = (LogLevel) (LOG_PREFIX_ALL | LOG_LEVEL_WARN);
+    LogComponentEnable("V2vScenarioSweep", logLevel);
+    LogComponentEnable("V2vSweepHelper", logLevel);
+
+    NS_LOG_UNCOND("/--------------------------------------------------------------------------\\");
+    NS_LOG_UNCOND(" - V2v scenario sweep -> Parallel replications of the clustering examples");
+    NS_LOG_UNCOND("\\--------------------------------------------------------------------------/");
+    /*----------------------------------------------------------------------*/
+
+    /*---------------------- Simulation Default Values ---------------------*/
+    std::string algorithms ("novel,affinity,modified-dmac");
+    std::string scenarios ("Scenario1,Scenario2,Scenario3");
+    std::string ranges ("High,Medium,Low");
+    std::string sumoDirectory ("../sumo-0.23.0/NS3-Example");
+    std::string outputDirectory ("v2v-sweep");
+
+    uint16_t numberOfUes = 10;
+    uint32_t firstRun = 1;
+    uint32_t runs = 5;
+    uint32_t jobs = 0;
+    bool validate = false;
+
+    double simTime = 750.0;
+    double trainingPeriod = 80.0;
+    /*----------------------------------------------------------------------*/
+
+
+    /*-------------------- Command Line Argument Values --------------------*/
+    CommandLine cmd;
+    cmd.AddValue("algorithms", "Comma separated list of novel/affinity/modified-dmac", algorithms);
+    cmd.AddValue("scenarios", "Comma separated list of scenarios under sumoDirectory", scenarios);
+    cmd.AddValue("ranges", "Comma separated list of High/Medium/Low", ranges);
+    cmd.AddValue("sumoDirectory", "Directory holding <scenario>/output/mobility.tcl", sumoDirectory);
+    cmd.AddValue("outputDirectory", "Directory of the per-run outputs and merged results", outputDirectory);
+    cmd.AddValue("ueNumber", "Number of UE", numberOfUes);
+    cmd.AddValue("firstRun", "RngRun of the first replication", firstRun);
+    cmd.AddValue("runs", "Number of replications per grid point", runs);
+    cmd.AddValue("jobs", "Concurrent replications, 0 for all the cores", jobs);
+    cmd.AddValue("validate", "Also run every algorithm over the abstract channel and report the divergence", validate);
+    cmd.AddValue("simTime", "Simulation Time in Seconds", simTime);
+    cmd.AddValue("training", "Training period of Time", trainingPeriod);
+    cmd.Parse(argc, argv);
+    /*----------------------------------------------------------------------*/
+
+
+    /*------------------------- Parameter Grid Setup -----------------------*/
+    // The examples are built next to this program with the same name suffix (e.g. -debug)
+    std::string self = SystemPath::Split(argv[0]).back();
+    std::string suffix = self.substr(self.find("v2v-scenario-sweep") + std::string("v2v-scenario-sweep").size());
+    std::string prefix = self.substr(0, self.find("v2v-scenario-sweep"));
+
+    V2vSweepHelper sweep;
+    std::vector<std::string> items = splitList(algorithms);
+    for (uint32_t i = 0; i < items.size(); ++i) {
+        std::string program = SystemPath::Append(SystemPath::FindSelfDirectory(),
+                prefix + "v2v-" + items[i] + "-algorithm-example" + suffix);
+        sweep.AddAlgorithm(items[i], program);
+        if (validate) {
+            sweep.AddAlgorithm(items[i] + "-abstract", program, "--channel=Abstract");
+            sweep.AddComparison(items[i], items[i] + "-abstract");
+        }
+    }
+    items = splitList(scenarios);
+    for (uint32_t i = 0; i < items.size(); ++i) {
+        sweep.AddScenario(items[i], sumoDirectory + "/" + items[i] + "/output/mobility.tcl", numberOfUes);
+    }
+    items = splitList(ranges);
+    for (uint32_t i = 0; i < items.size(); ++i) {
+        sweep.AddRange(items[i]);
+    }
+
+    std::ostringstream oss;
+    oss << simTime;
+    sweep.SetArgument("simTime", oss.str());
+    oss.str("");
+    oss << trainingPeriod;
+    sweep.SetArgument("training", oss.str());
+
+    sweep.SetRuns(firstRun, runs);
+    sweep.SetJobs(jobs);
+    sweep.SetOutputDirectory(outputDirectory);
+    /*----------------------------------------------------------------------*/
+
+
+    /*----------------------------- Sweep Run ------------------------------*/
+    uint32_t failed = sweep.Run();
+    NS_LOG_UNCOND("Failed replications: " << failed);
+    NS_LOG_UNCOND("Results written to: " << sweep.GetResultsFile());
+    if (validate) {
+        NS_LOG_UNCOND("Channel divergence written to: " << sweep.GetDivergenceFile());
+    }
+    /*----------------------------------------------------------------------*/
+
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,68 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include "ns3/mac48-address.h"
+#include "ns3/v2v-broadcast-net-device.h"
+#include "ns3/v2v-broadcast-helper.h"
+
+
+namespace ns3 {
+
+V2vBroadcastHelper::V2vBroadcastHelper ()
+{
+  m_channelFactory.SetTypeId ("ns3::V2vBroadcastChannel");
+  m_deviceFactory.SetTypeId ("ns3::V2vBroadcastNetDevice");
+}
+
+void
+V2vBroadcastHelper::SetChannelAttribute (std::string name, const AttributeValue &value)
+{
+  m_channelFactory.Set (name, value);
+}
+
+void
+V2vBroadcastHelper::SetDeviceAttribute (std::string name, const AttributeValue &value)
+{
+  m_deviceFactory.Set (name, value);
+}
+
+NetDeviceContainer
+V2vBroadcastHelper::Install (NodeContainer c) const
+{
+  return Install (c, m_channelFactory.Create<V2vBroadcastChannel> ());
+}
+
+NetDeviceContainer
+V2vBroadcastHelper::Install (NodeContainer c, Ptr<V2vBroadcastChannel> channel) const
+{
+  NetDeviceContainer devices;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<V2vBroadcastNetDevice> device = m_deviceFactory.Create<V2vBroadcastNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      (*i)->AddDevice (device);
+      device->SetChannel (channel);
+      devices.Add (device);
+    }
+
+  return devices;
+}
+
+} // namespace ns3
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_BROADCAST_HELPER_H
+#define V2V_BROADCAST_HELPER_H
+
+#include <string>
+#include "ns3/attribute.h"
+#include "ns3/object-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/v2v-broadcast-channel.h"
+
+namespace ns3 {
+
+/**
+ * \brief A helper to attach ns3::V2vBroadcastNetDevice devices to a
+ * shared ns3::V2vBroadcastChannel, in place of the Wifi80211pHelper
+ * stack, for fast clustering studies.
+ */
+class V2vBroadcastHelper {
+public:
+
+    V2vBroadcastHelper ();
+
+    /**
+     * \param name the name of the channel attribute to set
+     * \param value the value of the channel attribute to set
+     */
+    void SetChannelAttribute (std::string name, const AttributeValue &value);
+
+    /**
+     * \param name the name of the device attribute to set
+     * \param value the value of the device attribute to set
+     */
+    void SetDeviceAttribute (std::string name, const AttributeValue &value);
+
+    /**
+     * Create a channel and install a device on each node of the input
+     * container, all attached to this channel.
+     *
+     * \param c the nodes, each with a MobilityModel
+     * \returns the installed devices
+     */
+    NetDeviceContainer Install (NodeContainer c) const;
+
+    /**
+     * \param c the nodes, each with a MobilityModel
+     * \param channel the channel to attach the devices to
+     * \returns the installed devices
+     */
+    NetDeviceContainer Install (NodeContainer c, Ptr<V2vBroadcastChannel> channel) const;
+
+private:
+
+    ObjectFactory m_channelFactory;
+    ObjectFactory m_deviceFactory;
+};
+
+} // namespace ns3
+
+#endif // V2V_BROADCAST_HELPER_H
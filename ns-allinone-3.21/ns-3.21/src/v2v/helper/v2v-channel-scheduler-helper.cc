@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include "ns3/node.h"
+#include "ns3/abort.h"
+#include "ns3/v2v-channel-coordinator.h"
+#include "ns3/v2v-channel-scheduler-helper.h"
+
+
+namespace ns3 {
+
+V2vChannelSchedulerHelper::V2vChannelSchedulerHelper ()
+{
+  m_schedulerFactory.SetTypeId ("ns3::V2vChannelScheduler");
+  m_coordinatorFactory.SetTypeId ("ns3::V2vChannelCoordinator");
+}
+
+void
+V2vChannelSchedulerHelper::SetSchedulerAttribute (std::string name, const AttributeValue &value)
+{
+  m_schedulerFactory.Set (name, value);
+}
+
+void
+V2vChannelSchedulerHelper::SetCoordinatorAttribute (std::string name, const AttributeValue &value)
+{
+  m_coordinatorFactory.Set (name, value);
+}
+
+void
+V2vChannelSchedulerHelper::AddChannel (uint32_t channelNumber, NetDeviceContainer devices)
+{
+  m_channels[channelNumber] = devices;
+}
+
+void
+V2vChannelSchedulerHelper::Install (NodeContainer c) const
+{
+  Ptr<V2vChannelCoordinator> coordinator = m_coordinatorFactory.Create<V2vChannelCoordinator> ();
+  NS_ABORT_MSG_UNLESS (coordinator->IsValidConfig (), "V2vChannelSchedulerHelper: guard interval longer than a channel interval");
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<V2vChannelScheduler> scheduler = m_schedulerFactory.Create<V2vChannelScheduler> ();
+      scheduler->SetCoordinator (coordinator);
+      for (std::map<uint32_t, NetDeviceContainer>::const_iterator it = m_channels.begin (); it != m_channels.end (); ++it)
+        {
+          for (NetDeviceContainer::Iterator d = it->second.Begin (); d != it->second.End (); ++d)
+            {
+              if ((*d)->GetNode () == *i)
+                {
+                  scheduler->AddChannel (it->first, *d);
+                  break;
+                }
+            }
+        }
+      (*i)->AggregateObject (scheduler);
+    }
+}
+
+} // namespace ns3
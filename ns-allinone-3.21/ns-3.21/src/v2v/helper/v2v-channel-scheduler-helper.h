@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_CHANNEL_SCHEDULER_HELPER_H
+#define V2V_CHANNEL_SCHEDULER_HELPER_H
+
+#include <map>
+#include <string>
+#include "ns3/attribute.h"
+#include "ns3/object-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/v2v-channel-scheduler.h"
+
+namespace ns3 {
+
+/**
+ * \brief A helper to aggregate an ns3::V2vChannelScheduler to each
+ * vehicle, over one device per WAVE channel.
+ *
+ * The devices of each channel are installed beforehand, e.g. with one
+ * V2vBroadcastHelper::Install or one YansWifiChannel per channel number,
+ * and given their own IPv4 subnet.
+ */
+class V2vChannelSchedulerHelper {
+public:
+
+    V2vChannelSchedulerHelper ();
+
+    /**
+     * \param name the name of the scheduler attribute to set
+     * \param value the value of the scheduler attribute to set
+     */
+    void SetSchedulerAttribute (std::string name, const AttributeValue &value);
+
+    /**
+     * \param name the name of the coordinator attribute to set
+     * \param value the value of the coordinator attribute to set
+     */
+    void SetCoordinatorAttribute (std::string name, const AttributeValue &value);
+
+    /**
+     * \param channelNumber V2vChannelScheduler::CCH or a service channel number
+     * \param devices the devices of the vehicles on this channel
+     */
+    void AddChannel (uint32_t channelNumber, NetDeviceContainer devices);
+
+    /**
+     * Aggregate a scheduler to each node of the input container, with
+     * the devices of the node on the added channels. The schedulers
+     * share one coordinator.
+     *
+     * \param c the nodes
+     */
+    void Install (NodeContainer c) const;
+
+private:
+
+    ObjectFactory m_schedulerFactory;
+    ObjectFactory m_coordinatorFactory;
+    std::map<uint32_t, NetDeviceContainer> m_channels;
+};
+
+} // namespace ns3
+
+#endif // V2V_CHANNEL_SCHEDULER_HELPER_H
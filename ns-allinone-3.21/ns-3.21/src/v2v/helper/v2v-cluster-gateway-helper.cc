@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/uinteger.h"
+#include "ns3/v2v-novel-algorithm-client.h"
+#include "ns3/v2v-affinity-algorithm-client.h"
+#include "ns3/v2v-modified-dmac-algorithm-client.h"
+#include "ns3/v2v-cluster-gateway-helper.h"
+
+
+namespace ns3 {
+
+static V2vClusterSap::NovelNodeDegree
+GetAffinityRole (Ptr<V2vAffinityAlgorithmClient> client)
+{
+  // the affinity client has no standalone state
+  return client->GetRole () ? V2vClusterSap::CH : V2vClusterSap::CM;
+}
+
+V2vClusterGatewayHelper::V2vClusterGatewayHelper (Address waveAddress, Address uplinkAddress)
+{
+  m_factory.SetTypeId ("ns3::V2vClusterGateway");
+  m_factory.Set ("WaveAddress", AddressValue (waveAddress));
+  m_factory.Set ("UplinkAddress", AddressValue (uplinkAddress));
+}
+
+void
+V2vClusterGatewayHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+ApplicationContainer
+V2vClusterGatewayHelper::Install (NodeContainer c) const
+{
+  ApplicationContainer apps;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<V2vClusterGateway> app = m_factory.Create<V2vClusterGateway> ();
+      (*i)->AddApplication (app);
+      apps.Add (app);
+    }
+
+  return apps;
+}
+
+ApplicationContainer
+V2vClusterGatewayHelper::Install (ApplicationContainer clients) const
+{
+  ApplicationContainer apps;
+  for (ApplicationContainer::Iterator i = clients.Begin (); i != clients.End (); ++i)
+    {
+      Ptr<V2vClusterGateway> app = m_factory.Create<V2vClusterGateway> ();
+      if (Ptr<V2vNovelAlgorithmClient> novel = DynamicCast<V2vNovelAlgorithmClient> (*i))
+        {
+          app->SetClusterCallbacks (MakeCallback (&V2vNovelAlgorithmClient::GetRole, novel),
+                                    MakeCallback (&V2vNovelAlgorithmClient::GetClusterId, novel));
+        }
+      else if (Ptr<V2vAffinityAlgorithmClient> affinity = DynamicCast<V2vAffinityAlgorithmClient> (*i))
+        {
+          app->SetClusterCallbacks (MakeBoundCallback (&GetAffinityRole, affinity),
+                                    MakeCallback (&V2vAffinityAlgorithmClient::GetClusterId, affinity));
+        }
+      else if (Ptr<V2vModifiedDMACAlgorithmClient> dmac = DynamicCast<V2vModifiedDMACAlgorithmClient> (*i))
+        {
+          app->SetClusterCallbacks (MakeCallback (&V2vModifiedDMACAlgorithmClient::GetRole, dmac),
+                                    MakeCallback (&V2vModifiedDMACAlgorithmClient::GetClusterId, dmac));
+        }
+      else
+        {
+          NS_FATAL_ERROR ("V2vClusterGatewayHelper: unsupported clustering client " << (*i)->GetInstanceTypeId ().GetName ());
+        }
+      (*i)->GetNode ()->AddApplication (app);
+      apps.Add (app);
+    }
+
+  return apps;
+}
+
+V2vUplinkServerHelper::V2vUplinkServerHelper (uint16_t port)
+{
+  m_factory.SetTypeId ("ns3::V2vUplinkServer");
+  m_factory.Set ("Port", UintegerValue (port));
+}
+
+void
+V2vUplinkServerHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+ApplicationContainer
+V2vUplinkServerHelper::Install (NodeContainer c) const
+{
+  ApplicationContainer apps;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<V2vUplinkServer> app = m_factory.Create<V2vUplinkServer> ();
+      (*i)->AddApplication (app);
+      apps.Add (app);
+    }
+
+  return apps;
+}
+
+} // namespace ns3
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef V2V_CLUSTER_GATEWAY_HELPER_H
+#define V2V_CLUSTER_GATEWAY_HELPER_H
+
+#include <string>
+#include "ns3/address.h"
+#include "ns3/attribute.h"
+#include "ns3/object-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/application-container.h"
+#include "ns3/v2v-cluster-gateway.h"
+#include "ns3/v2v-uplink-server.h"
+
+namespace ns3 {
+
+/**
+ * \brief A helper to install an ns3::V2vClusterGateway next to the
+ * clustering client of each vehicle.
+ */
+class V2vClusterGatewayHelper {
+public:
+
+    /**
+     * \param waveAddress the broadcast address and port of the member reports
+     * \param uplinkAddress the address and port of the ns3::V2vUplinkServer
+     */
+    V2vClusterGatewayHelper (Address waveAddress, Address uplinkAddress);
+
+    /**
+     * \param name the name of the application attribute to set
+     * \param value the value of the application attribute to set
+     */
+    void SetAttribute (std::string name, const AttributeValue &value);
+
+    /**
+     * Install a standalone gateway on each node of the input container.
+     *
+     * \param c the nodes
+     * \returns the installed applications
+     */
+    ApplicationContainer Install (NodeContainer c) const;
+
+    /**
+     * Install a gateway on the node of each clustering client, following
+     * the role and the cluster head of the client. The Novel, Affinity
+     * and Modified DMAC clients are supported.
+     *
+     * \param clients the clustering clients
+     * \returns the installed applications
+     */
+    ApplicationContainer Install (ApplicationContainer clients) const;
+
+private:
+
+    ObjectFactory m_factory;
+};
+
+/**
+ * \brief A helper to install an ns3::V2vUplinkServer.
+ */
+class V2vUplinkServerHelper {
+public:
+
+    /**
+     * \param port the port the server listens to
+     */
+    V2vUplinkServerHelper (uint16_t port);
+
+    /**
+     * \param name the name of the application attribute to set
+     * \param value the value of the application attribute to set
+     */
+    void SetAttribute (std::string name, const AttributeValue &value);
+
+    /**
+     * \param c the nodes
+     * \returns the installed applications
+     */
+    ApplicationContainer Install (NodeContainer c) const;
+
+private:
+
+    ObjectFactory m_factory;
+};
+
+} // namespace ns3
+
+#endif // V2V_CLUSTER_GATEWAY_HELPER_H
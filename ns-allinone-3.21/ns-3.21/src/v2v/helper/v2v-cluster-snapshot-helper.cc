@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include <map>
+#include <fstream>
+#include <sstream>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/v2v-mobility-model.h"
+#include "ns3/v2v-cluster-snapshot.h"
+#include "ns3/v2v-cluster-registry.h"
+#include "ns3/v2v-novel-algorithm-client.h"
+#include "ns3/v2v-affinity-algorithm-client.h"
+#include "ns3/v2v-modified-dmac-algorithm-client.h"
+#include "ns3/v2v-cluster-snapshot-helper.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vClusterSnapshotHelper");
+
+namespace ns3 {
+
+static const std::string SNAPSHOT_MAGIC = "v2v-snapshot";
+static const uint32_t SNAPSHOT_VERSION = 2;
+
+/**
+ * The record of a node in a snapshot file.
+ */
+struct V2vNodeSnapshot
+{
+  std::string type;         //!< TypeId name of the client
+  Vector position;
+  Vector velocity;
+  Time legEnd;              //!< end of the current leg of a V2vMobilityModel
+  std::string state;        //!< record written by the client
+};
+
+static void
+RestoreMobility (Ptr<MobilityModel> mobility, Vector position, Vector velocity, Time legEnd)
+{
+  // trace driven models, and random ones drawing the same legs, are
+  // already where the snapshot left them; only the others are moved
+  if (CalculateDistance (mobility->GetPosition (), position) < 1e-6
+      && CalculateDistance (mobility->GetVelocity (), velocity) < 1e-6)
+    {
+      return;
+    }
+
+  Ptr<V2vMobilityModel> v2v = DynamicCast<V2vMobilityModel> (mobility);
+  if (v2v)
+    {
+      v2v->SetLeg (position, velocity, legEnd);
+      return;
+    }
+  Ptr<ConstantVelocityMobilityModel> constant = DynamicCast<ConstantVelocityMobilityModel> (mobility);
+  if (!constant && CalculateDistance (velocity, Vector ()) > 0)
+    {
+      NS_FATAL_ERROR ("V2vClusterSnapshotHelper: cannot restore the velocity of a "
+                      << mobility->GetInstanceTypeId ().GetName ());
+    }
+  mobility->SetPosition (position);
+  if (constant)
+    {
+      constant->SetVelocity (velocity);
+    }
+}
+
+V2vClusterSnapshotHelper::V2vClusterSnapshotHelper ()
+{
+}
+
+void
+V2vClusterSnapshotHelper::Save (ApplicationContainer clients, Time at, std::string fileName) const
+{
+  NS_ASSERT (at >= Simulator::Now ());
+  Simulator::Schedule (at - Simulator::Now (), &V2vClusterSnapshotHelper::Write, clients, fileName);
+}
+
+void
+V2vClusterSnapshotHelper::Write (ApplicationContainer clients, std::string fileName)
+{
+  NS_LOG_FUNCTION (fileName);
+
+  std::ofstream os (fileName.c_str ());
+  if (!os.is_open ())
+    {
+      NS_FATAL_ERROR ("V2vClusterSnapshotHelper: cannot write " << fileName);
+    }
+
+  os << SNAPSHOT_MAGIC << " " << SNAPSHOT_VERSION << "\n";
+  V2vSnapshotWriter writer (os);
+  writer.Write ("time", Simulator::Now ());
+  V2vClusterRegistry::Get ()->SaveState (writer);
+  writer.Write ("nodes", clients.GetN ());
+
+  for (ApplicationContainer::Iterator i = clients.Begin (); i != clients.End (); ++i)
+    {
+      Ptr<Node> node = (*i)->GetNode ();
+      Ptr<MobilityModel> mobility = node->GetObject<MobilityModel> ();
+      os << "node " << node->GetId () << " " << (*i)->GetInstanceTypeId ().GetName () << "\n";
+      writer.Write ("position", mobility ? mobility->GetPosition () : Vector ());
+      writer.Write ("velocity", mobility ? mobility->GetVelocity () : Vector ());
+      Ptr<V2vMobilityModel> v2v = DynamicCast<V2vMobilityModel> (mobility);
+      writer.Write ("legEnd", v2v ? v2v->GetLegEnd () : Time::Max ());
+
+      if (Ptr<V2vNovelAlgorithmClient> novel = DynamicCast<V2vNovelAlgorithmClient> (*i))
+        {
+          novel->SaveState (writer);
+        }
+      else if (Ptr<V2vAffinityAlgorithmClient> affinity = DynamicCast<V2vAffinityAlgorithmClient> (*i))
+        {
+          affinity->SaveState (writer);
+        }
+      else if (Ptr<V2vModifiedDMACAlgorithmClient> dmac = DynamicCast<V2vModifiedDMACAlgorithmClient> (*i))
+        {
+          dmac->SaveState (writer);
+        }
+      else
+        {
+          NS_FATAL_ERROR ("V2vClusterSnapshotHelper: unsupported clustering client " << (*i)->GetInstanceTypeId ().GetName ());
+        }
+      os << "end\n";
+    }
+
+  if (!os.good ())
+    {
+      NS_FATAL_ERROR ("V2vClusterSnapshotHelper: cannot write " << fileName);
+    }
+}
+
+Time
+V2vClusterSnapshotHelper::Restore (ApplicationContainer clients, std::string fileName) const
+{
+  NS_LOG_FUNCTION (this << fileName);
+
+  std::ifstream is (fileName.c_str ());
+  if (!is.is_open ())
+    {
+      NS_FATAL_ERROR ("V2vClusterSnapshotHelper: cannot read " << fileName);
+    }
+
+  std::string magic;
+  uint32_t version = 0;
+  is >> magic >> version;
+  if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION)
+    {
+      NS_FATAL_ERROR ("V2vClusterSnapshotHelper: " << fileName << " is not a version "
+                      << SNAPSHOT_VERSION << " clustering snapshot");
+    }
+
+  V2vSnapshotReader reader (is);
+  Time at;
+  uint32_t nodes;
+  reader.Read ("time", at);
+  V2vClusterRegistry::Get ()->LoadState (reader);
+  reader.Read ("nodes", nodes);
+
+  std::map<uint32_t, V2vNodeSnapshot> records;
+  for (uint32_t n = 0; n < nodes; ++n)
+    {
+      std::string tag;
+      uint32_t id;
+      V2vNodeSnapshot record;
+      if (!(is >> tag >> id >> record.type) || tag != "node")
+        {
+          NS_FATAL_ERROR ("V2vClusterSnapshotHelper: malformed node record in " << fileName);
+        }
+      reader.Read ("position", record.position);
+      reader.Read ("velocity", record.velocity);
+      reader.Read ("legEnd", record.legEnd);
+
+      std::string line;
+      std::ostringstream state;
+      while (std::getline (is, line) && line != "end")
+        {
+          state << line << "\n";
+        }
+      record.state = state.str ();
+      records[id] = record;
+    }
+
+  for (ApplicationContainer::Iterator i = clients.Begin (); i != clients.End (); ++i)
+    {
+      Ptr<Node> node = (*i)->GetNode ();
+      std::map<uint32_t, V2vNodeSnapshot>::const_iterator record = records.find (node->GetId ());
+      if (record == records.end () || record->second.type != (*i)->GetInstanceTypeId ().GetName ())
+        {
+          NS_FATAL_ERROR ("V2vClusterSnapshotHelper: no " << (*i)->GetInstanceTypeId ().GetName ()
+                          << " record of node " << node->GetId () << " in " << fileName);
+        }
+
+      if (Ptr<V2vNovelAlgorithmClient> novel = DynamicCast<V2vNovelAlgorithmClient> (*i))
+        {
+          novel->SetSnapshot (record->second.state);
+        }
+      else if (Ptr<V2vAffinityAlgorithmClient> affinity = DynamicCast<V2vAffinityAlgorithmClient> (*i))
+        {
+          affinity->SetSnapshot (record->second.state);
+        }
+      else if (Ptr<V2vModifiedDMACAlgorithmClient> dmac = DynamicCast<V2vModifiedDMACAlgorithmClient> (*i))
+        {
+          dmac->SetSnapshot (record->second.state);
+        }
+      else
+        {
+          NS_FATAL_ERROR ("V2vClusterSnapshotHelper: unsupported clustering client " << (*i)->GetInstanceTypeId ().GetName ());
+        }
+      (*i)->SetStartTime (at);
+
+      // the clients only schedule their start when their node is
+      // initialized, by the first events of the run; this event, scheduled
+      // before the run, has a smaller uid and so runs first at time at
+      Ptr<MobilityModel> mobility = node->GetObject<MobilityModel> ();
+      if (mobility)
+        {
+          Simulator::Schedule (at - Simulator::Now (), &RestoreMobility, mobility,
+                               record->second.position, record->second.velocity, record->second.legEnd);
+        }
+    }
+
+  return at;
+}
+
+} // namespace ns3
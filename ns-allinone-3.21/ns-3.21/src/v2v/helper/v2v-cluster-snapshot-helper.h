@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_CLUSTER_SNAPSHOT_HELPER_H
+#define V2V_CLUSTER_SNAPSHOT_HELPER_H
+
+#include <string>
+#include "ns3/nstime.h"
+#include "ns3/application-container.h"
+
+namespace ns3 {
+
+/**
+ * \brief A helper to save the clustering state of a scenario at a given
+ * simulated time and to warm-start later runs of it from that snapshot.
+ *
+ * The snapshot holds, for every clustering client, its state machine,
+ * role, neighbor and cluster tables, counters, metrics and the delay left
+ * on its pending events, the position and velocity of its node (and the
+ * end of the current leg of a V2vMobilityModel), and the counters of the
+ * V2vClusterRegistry. The Novel, Affinity and Modified
+ * DMAC clients are supported.
+ *
+ * A restored run keeps the simulation clock: the clients start at the
+ * snapshot time instead of going through the training period, so there
+ * is nothing but mobility to simulate before it. The nodes, client types
+ * and mobility of the restored run must match the saved one; the
+ * attributes of the clients may differ, which is what a sweep of the
+ * post-formation behavior needs. Packets in flight, the MAC and PHY
+ * state and the random variable streams are not part of the snapshot,
+ * so a restored run is a statistically equivalent continuation rather
+ * than a bit-exact one.
+ */
+class V2vClusterSnapshotHelper {
+public:
+
+    V2vClusterSnapshotHelper ();
+
+    /**
+     * Schedule the snapshot of the clients; call before Simulator::Run.
+     *
+     * \param clients the clustering clients
+     * \param at the simulated time of the snapshot
+     * \param fileName the file the snapshot is written to
+     */
+    void Save (ApplicationContainer clients, Time at, std::string fileName) const;
+
+    /**
+     * Warm-start the clients from a snapshot; call before Simulator::Run
+     * and after setting the start time of the clients, which is replaced
+     * by the snapshot time.
+     *
+     * \param clients the clustering clients
+     * \param fileName the file written by Save
+     * \returns the simulated time of the snapshot
+     */
+    Time Restore (ApplicationContainer clients, std::string fileName) const;
+
+    /**
+     * Write the snapshot of the clients now.
+     *
+     * \param clients the clustering clients
+     * \param fileName the file the snapshot is written to
+     */
+    static void Write (ApplicationContainer clients, std::string fileName);
+};
+
+} // namespace ns3
+
+#endif // V2V_CLUSTER_SNAPSHOT_HELPER_H
@@ -0,0 +1,479 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include <list>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/system-path.h"
+#include "ns3/v2v-sweep-helper.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vSweepHelper");
+
+namespace ns3 {
+
+static const char *RUN_LOG_FILE = "run.log";       //!< stdout/stderr of a replication
+static const char *RUN_DONE_FILE = "run.done";     //!< written once a replication has succeeded
+
+/**
+ * Running mean and variance (Welford) of one merged quantity.
+ */
+struct V2vSweepAccumulator{
+    uint32_t n;
+    double mean;
+    double m2;
+
+    V2vSweepAccumulator():
+        n(0),
+        mean(0.0),
+        m2(0.0){}
+
+    void Add (double value){
+        n++;
+        double delta = value - mean;
+        mean += delta / n;
+        m2 += delta * (value - mean);
+    }
+
+    double GetStddev (void) const {
+        return n > 1 ? std::sqrt (m2 / (n - 1)) : 0.0;
+    }
+};
+
+typedef std::map<std::string, std::map<double, V2vSweepAccumulator> > V2vSweepSeries;    //!< metric -> time -> value
+typedef std::map<std::string, V2vSweepAccumulator> V2vSweepScalars;                     //!< name -> value
+
+/**
+ * Parse a "name: value" or "name is: value" summary line printed by the
+ * examples. The per node reports are indented and are skipped.
+ */
+static bool
+ParseScalarLine (const std::string &line, std::string &name, double &value){
+    if(line.empty () || !isalpha (line[0])){
+        return false;
+    }
+    std::string::size_type colon = line.find (':');
+    if(colon == std::string::npos){
+        return false;
+    }
+    const char *begin = line.c_str () + colon + 1;
+    char *end;
+    value = strtod (begin, &end);
+    if(end == begin || value != value){
+        return false;
+    }
+    while(*end == ' ' || *end == '\t' || *end == '\r'){
+        end++;
+    }
+    if(*end != '\0'){
+        return false;
+    }
+    name = line.substr (0, colon);
+    if(name.size () > 3 && name.compare (name.size () - 3, 3, " is") == 0){
+        name.erase (name.size () - 3);
+    }
+    return true;
+}
+
+/**
+ * Accumulate the scalar lines of run.log and the FileAggregator series of
+ * every replication directory.
+ */
+static void
+MergeRuns (const std::vector<std::string> &directories, V2vSweepSeries &series, V2vSweepScalars &scalars){
+    for(uint32_t i = 0; i < directories.size (); ++i){
+        const std::string &directory = directories[i];
+
+        std::ifstream log (SystemPath::Append (directory, RUN_LOG_FILE).c_str ());
+        std::string line;
+        while(std::getline (log, line)){
+            std::string name;
+            double value;
+            if(ParseScalarLine (line, name, value)){
+                scalars[name].Add (value);
+            }
+        }
+
+        // FileAggregator series: one "time value" pair per line
+        std::list<std::string> files = SystemPath::ReadFiles (directory);
+        for(std::list<std::string>::const_iterator it = files.begin (); it != files.end (); ++it){
+            if(it->size () < 4 || it->compare (it->size () - 4, 4, ".txt") != 0){
+                continue;
+            }
+            std::string metric = it->substr (0, it->find ('['));
+            std::ifstream file (SystemPath::Append (directory, *it).c_str ());
+            double time, value;
+            while(file >> time >> value){
+                series[metric][time].Add (value);
+            }
+        }
+    }
+}
+
+/**
+ * Relative distance of two means, 0 when both are 0.
+ */
+static double
+RelativeDifference (double reference, double candidate){
+    double scale = std::max (std::fabs (reference), std::fabs (candidate));
+    return scale > 0 ? std::fabs (candidate - reference) / scale : 0.0;
+}
+
+V2vSweepHelper::V2vSweepHelper ():
+    m_firstRun(1),
+    m_runs(1),
+    m_jobs(0),
+    m_outputDirectory("v2v-sweep"){
+}
+
+void
+V2vSweepHelper::AddAlgorithm (std::string name, std::string program, std::string arguments){
+    Algorithm algorithm;
+    algorithm.name = name;
+    algorithm.program = MakeAbsolute (program);
+    std::istringstream iss (arguments);
+    std::string argument;
+    while(iss >> argument){
+        algorithm.arguments.push_back (argument);
+    }
+    m_algorithms.push_back (algorithm);
+}
+
+void
+V2vSweepHelper::AddComparison (std::string reference, std::string candidate){
+    m_comparisons.push_back (std::make_pair (reference, candidate));
+}
+
+void
+V2vSweepHelper::AddScenario (std::string name, std::string traceFile, uint16_t ueNumber){
+    Scenario scenario;
+    scenario.name = name;
+    scenario.traceFile = MakeAbsolute (traceFile);
+    scenario.ueNumber = ueNumber;
+    m_scenarios.push_back (scenario);
+}
+
+void
+V2vSweepHelper::AddRange (std::string range){
+    m_ranges.push_back (range);
+}
+
+void
+V2vSweepHelper::SetRuns (uint32_t firstRun, uint32_t runs){
+    m_firstRun = firstRun;
+    m_runs = runs;
+}
+
+void
+V2vSweepHelper::SetArgument (std::string name, std::string value){
+    m_arguments[name] = value;
+}
+
+void
+V2vSweepHelper::SetJobs (uint32_t jobs){
+    m_jobs = jobs;
+}
+
+void
+V2vSweepHelper::SetOutputDirectory (std::string directory){
+    m_outputDirectory = MakeAbsolute (directory);
+}
+
+std::string
+V2vSweepHelper::GetRunDirectory (std::string algorithm, std::string scenario,
+                                 std::string range, uint32_t run) const {
+    std::ostringstream oss;
+    oss << "run-" << run;
+    std::string directory = SystemPath::Append (m_outputDirectory, algorithm);
+    directory = SystemPath::Append (directory, scenario);
+    directory = SystemPath::Append (directory, range);
+    return SystemPath::Append (directory, oss.str ());
+}
+
+std::string
+V2vSweepHelper::GetResultsFile (void) const {
+    return SystemPath::Append (m_outputDirectory, "sweep-results.txt");
+}
+
+std::string
+V2vSweepHelper::GetDivergenceFile (void) const {
+    return SystemPath::Append (m_outputDirectory, "sweep-divergence.txt");
+}
+
+std::vector<std::string>
+V2vSweepHelper::GetRunDirectories (std::string algorithm, std::string scenario, std::string range) const {
+    std::vector<std::string> directories;
+    for(uint32_t run = m_firstRun; run < m_firstRun + m_runs; ++run){
+        std::string directory = GetRunDirectory (algorithm, scenario, range, run);
+        // the failed or interrupted replications leave partial outputs
+        if(access (SystemPath::Append (directory, RUN_DONE_FILE).c_str (), F_OK) == 0){
+            directories.push_back (directory);
+        }
+    }
+    return directories;
+}
+
+std::vector<V2vSweepHelper::Job>
+V2vSweepHelper::CreateJobs (void) const {
+    std::vector<Job> jobs;
+    for(uint32_t a = 0; a < m_algorithms.size (); ++a){
+        for(uint32_t s = 0; s < m_scenarios.size (); ++s){
+            for(uint32_t r = 0; r < m_ranges.size (); ++r){
+                for(uint32_t run = m_firstRun; run < m_firstRun + m_runs; ++run){
+                    Job job;
+                    job.algorithm = m_algorithms[a].name;
+                    job.program = m_algorithms[a].program;
+                    job.arguments = m_algorithms[a].arguments;
+                    job.scenario = m_scenarios[s];
+                    job.range = m_ranges[r];
+                    job.run = run;
+                    jobs.push_back (job);
+                }
+            }
+        }
+    }
+    return jobs;
+}
+
+int
+V2vSweepHelper::Launch (const Job &job) const {
+
+    std::string directory = GetRunDirectory (job.algorithm, job.scenario.name, job.range, job.run);
+    // the examples trace into src/v2v/examples/output relative to their working directory
+    SystemPath::MakeDirectories (SystemPath::Append (directory, "src/v2v/examples/output"));
+    unlink (SystemPath::Append (directory, RUN_DONE_FILE).c_str ());
+
+    std::vector<std::string> args;
+    args.push_back (job.program);
+    std::ostringstream oss;
+    oss << "--ueNumber=" << job.scenario.ueNumber;
+    args.push_back (oss.str ());
+    args.push_back ("--traceFile=" + job.scenario.traceFile);
+    args.push_back ("--range=" + job.range);
+    args.push_back ("--logFile=" + SystemPath::Append (directory, "mobility.log"));
+    oss.str ("");
+    oss << "--RngRun=" << job.run;
+    args.push_back (oss.str ());
+    for(std::map<std::string, std::string>::const_iterator it = m_arguments.begin (); it != m_arguments.end (); ++it){
+        args.push_back ("--" + it->first + "=" + it->second);
+    }
+    args.insert (args.end (), job.arguments.begin (), job.arguments.end ());
+
+    std::vector<char *> argv;
+    for(uint32_t i = 0; i < args.size (); ++i){
+        argv.push_back (const_cast<char *> (args[i].c_str ()));
+    }
+    argv.push_back (0);
+
+    pid_t pid = fork ();
+    if(pid == 0){
+        if(chdir (directory.c_str ()) != 0){
+            _exit (126);
+        }
+        int fd = open (RUN_LOG_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(fd >= 0){
+            dup2 (fd, STDOUT_FILENO);
+            dup2 (fd, STDERR_FILENO);
+            close (fd);
+        }
+        execv (argv[0], &argv[0]);
+        _exit (127);
+    }
+    NS_LOG_INFO ("Started " << job.algorithm << " " << job.scenario.name << " " << job.range
+                 << " run " << job.run << " as pid " << pid);
+    return pid;
+}
+
+uint32_t
+V2vSweepHelper::Run (void){
+
+    std::vector<Job> jobs = CreateJobs ();
+    uint32_t limit = m_jobs;
+    if(limit == 0){
+        long cpus = sysconf (_SC_NPROCESSORS_ONLN);
+        limit = cpus > 0 ? cpus : 1;
+    }
+    NS_LOG_INFO ("Running " << jobs.size () << " replications, " << limit << " at a time");
+
+    std::map<int, uint32_t> running;
+    uint32_t next = 0;
+    uint32_t failed = 0;
+    while(next < jobs.size () || !running.empty ()){
+        while(next < jobs.size () && running.size () < limit){
+            int pid = Launch (jobs[next]);
+            if(pid < 0){
+                NS_LOG_WARN ("Could not start replication " << next);
+                failed++;
+            }
+            else{
+                running[pid] = next;
+            }
+            next++;
+        }
+        if(running.empty ()){
+            continue;
+        }
+
+        int status;
+        int pid = waitpid (-1, &status, 0);
+        NS_ABORT_MSG_IF (pid < 0, "waitpid failed with " << running.size () << " replications running");
+        std::map<int, uint32_t>::iterator it = running.find (pid);
+        if(it == running.end ()){
+            continue;
+        }
+        const Job &job = jobs[it->second];
+        std::string directory = GetRunDirectory (job.algorithm, job.scenario.name, job.range, job.run);
+        if(!WIFEXITED (status) || WEXITSTATUS (status) != 0){
+            NS_LOG_WARN ("Replication " << job.algorithm << " " << job.scenario.name << " " << job.range
+                         << " run " << job.run << " failed, see "
+                         << SystemPath::Append (directory, RUN_LOG_FILE));
+            failed++;
+        }
+        else{
+            std::ofstream done (SystemPath::Append (directory, RUN_DONE_FILE).c_str ());
+        }
+        running.erase (it);
+    }
+
+    Merge ();
+    return failed;
+}
+
+void
+V2vSweepHelper::Merge (void) const {
+
+    std::ofstream results (GetResultsFile ().c_str ());
+    NS_ABORT_MSG_UNLESS (results.is_open (), "Could not open " << GetResultsFile ());
+    results << "# algorithm\tscenario\trange\tmetric\ttime\tmean\tci95\truns\n";
+
+    for(uint32_t a = 0; a < m_algorithms.size (); ++a){
+        for(uint32_t s = 0; s < m_scenarios.size (); ++s){
+            for(uint32_t r = 0; r < m_ranges.size (); ++r){
+
+                V2vSweepSeries series;
+                V2vSweepScalars scalars;
+                MergeRuns (GetRunDirectories (m_algorithms[a].name, m_scenarios[s].name, m_ranges[r]), series, scalars);
+
+                std::string prefix = m_algorithms[a].name + "\t" + m_scenarios[s].name + "\t" + m_ranges[r] + "\t";
+                for(V2vSweepScalars::const_iterator it = scalars.begin (); it != scalars.end (); ++it){
+                    const V2vSweepAccumulator &acc = it->second;
+                    results << prefix << it->first << "\t-\t" << acc.mean << "\t"
+                            << GetConfidenceInterval (acc.GetStddev (), acc.n) << "\t" << acc.n << "\n";
+                }
+                for(V2vSweepSeries::const_iterator it = series.begin (); it != series.end (); ++it){
+                    for(std::map<double, V2vSweepAccumulator>::const_iterator p = it->second.begin (); p != it->second.end (); ++p){
+                        const V2vSweepAccumulator &acc = p->second;
+                        results << prefix << it->first << "\t" << p->first << "\t" << acc.mean << "\t"
+                                << GetConfidenceInterval (acc.GetStddev (), acc.n) << "\t" << acc.n << "\n";
+                    }
+                }
+            }
+        }
+    }
+
+    if(!m_comparisons.empty ()){
+        WriteDivergence ();
+    }
+}
+
+void
+V2vSweepHelper::WriteDivergence (void) const {
+
+    std::ofstream report (GetDivergenceFile ().c_str ());
+    NS_ABORT_MSG_UNLESS (report.is_open (), "Could not open " << GetDivergenceFile ());
+    // series are compared on their average over the common sample times
+    report << "# reference\tcandidate\tscenario\trange\tmetric\treferenceMean\tcandidateMean\trelativeDifference\n";
+
+    for(uint32_t c = 0; c < m_comparisons.size (); ++c){
+        const std::string &reference = m_comparisons[c].first;
+        const std::string &candidate = m_comparisons[c].second;
+        for(uint32_t s = 0; s < m_scenarios.size (); ++s){
+            for(uint32_t r = 0; r < m_ranges.size (); ++r){
+
+                V2vSweepSeries referenceSeries, candidateSeries;
+                V2vSweepScalars referenceScalars, candidateScalars;
+                MergeRuns (GetRunDirectories (reference, m_scenarios[s].name, m_ranges[r]), referenceSeries, referenceScalars);
+                MergeRuns (GetRunDirectories (candidate, m_scenarios[s].name, m_ranges[r]), candidateSeries, candidateScalars);
+
+                std::string prefix = reference + "\t" + candidate + "\t" + m_scenarios[s].name + "\t" + m_ranges[r] + "\t";
+                for(V2vSweepScalars::const_iterator it = referenceScalars.begin (); it != referenceScalars.end (); ++it){
+                    V2vSweepScalars::const_iterator other = candidateScalars.find (it->first);
+                    if(other == candidateScalars.end ()){
+                        continue;
+                    }
+                    report << prefix << it->first << "\t" << it->second.mean << "\t" << other->second.mean << "\t"
+                           << RelativeDifference (it->second.mean, other->second.mean) << "\n";
+                }
+                for(V2vSweepSeries::const_iterator it = referenceSeries.begin (); it != referenceSeries.end (); ++it){
+                    V2vSweepSeries::const_iterator other = candidateSeries.find (it->first);
+                    if(other == candidateSeries.end ()){
+                        continue;
+                    }
+                    V2vSweepAccumulator referenceMean, candidateMean;
+                    for(std::map<double, V2vSweepAccumulator>::const_iterator p = it->second.begin (); p != it->second.end (); ++p){
+                        std::map<double, V2vSweepAccumulator>::const_iterator q = other->second.find (p->first);
+                        if(q != other->second.end ()){
+                            referenceMean.Add (p->second.mean);
+                            candidateMean.Add (q->second.mean);
+                        }
+                    }
+                    report << prefix << it->first << "\t" << referenceMean.mean << "\t" << candidateMean.mean << "\t"
+                           << RelativeDifference (referenceMean.mean, candidateMean.mean) << "\n";
+                }
+            }
+        }
+    }
+}
+
+double
+V2vSweepHelper::GetConfidenceInterval (double stddev, uint32_t n){
+    // two-sided 95% Student t quantiles for 1..30 degrees of freedom
+    static const double t95[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if(n < 2){
+        return 0.0;
+    }
+    double t = (n - 1 <= 30) ? t95[n - 2] : 1.960;
+    return t * stddev / std::sqrt ((double)n);
+}
+
+std::string
+V2vSweepHelper::MakeAbsolute (std::string path){
+    if(path.empty () || path[0] == '/'){
+        return path;
+    }
+    char cwd[4096];
+    NS_ABORT_MSG_IF (getcwd (cwd, sizeof (cwd)) == 0, "Could not get the working directory");
+    return SystemPath::Append (cwd, path);
+}
+
+} // namespace ns3
@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_SWEEP_HELPER_H
+#define V2V_SWEEP_HELPER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vSweepHelper
+ * \brief Run the v2v examples over a parameter grid and merge their results.
+ *
+ * The grid is algorithms x scenarios x ranges x runs. Every point is an
+ * independent replication executed as a separate process, with its own
+ * RngRun, in its own directory (the examples write fixed file names
+ * relative to the working directory). Up to SetJobs () processes run at
+ * the same time.
+ *
+ * Once all the replications are done, the FileAggregator series and the
+ * scalar "name: value" lines printed by each run are merged over the runs
+ * of every (algorithm, scenario, range) point into a single table with
+ * the mean and the 95% confidence interval half-width. Only the runs
+ * which exited successfully, marked by a run.done file in their
+ * directory, are merged.
+ */
+class V2vSweepHelper {
+public:
+
+    V2vSweepHelper ();
+
+    /**
+     * \param name the algorithm name used in the results
+     * \param program the example executable running the algorithm
+     * \param arguments extra space separated --name=value arguments of
+     * this algorithm only
+     */
+    void AddAlgorithm (std::string name, std::string program, std::string arguments = "");
+
+    /**
+     * \brief Report how far the merged metrics of an algorithm are from
+     * those of a reference algorithm, e.g. the same client over the
+     * abstract broadcast channel against the 802.11p stack.
+     * \param reference the name of the reference algorithm
+     * \param candidate the name of the compared algorithm
+     */
+    void AddComparison (std::string reference, std::string candidate);
+
+    /**
+     * \param name the scenario name used in the results
+     * \param traceFile the ns2 mobility trace of the scenario
+     * \param ueNumber the number of vehicles in the trace
+     */
+    void AddScenario (std::string name, std::string traceFile, uint16_t ueNumber);
+
+    /**
+     * \param range the transmission range (High/Medium/Low)
+     */
+    void AddRange (std::string range);
+
+    /**
+     * \param firstRun the RngRun of the first replication
+     * \param runs the number of replications per grid point
+     */
+    void SetRuns (uint32_t firstRun, uint32_t runs);
+
+    /**
+     * \brief Pass --name=value to every replication.
+     */
+    void SetArgument (std::string name, std::string value);
+
+    /**
+     * \param jobs the maximum number of concurrent replications, 0 for
+     * the number of online processors
+     */
+    void SetJobs (uint32_t jobs);
+
+    /**
+     * \param directory the root of the per-run directories and results
+     */
+    void SetOutputDirectory (std::string directory);
+
+    /**
+     * \return the directory of a replication
+     */
+    std::string GetRunDirectory (std::string algorithm, std::string scenario,
+                                 std::string range, uint32_t run) const;
+
+    /**
+     * \return the consolidated results file
+     */
+    std::string GetResultsFile (void) const;
+
+    /**
+     * \return the divergence report of the comparisons
+     */
+    std::string GetDivergenceFile (void) const;
+
+    /**
+     * \brief Execute all the replications and merge their results.
+     * \return the number of replications that failed
+     */
+    uint32_t Run (void);
+
+    /**
+     * \brief Merge the results of the successful replications found on
+     * disk and write the divergence report of the comparisons, if any.
+     */
+    void Merge (void) const;
+
+    /**
+     * \param stddev the sample standard deviation
+     * \param n the number of samples
+     * \return the half-width of the 95% confidence interval of the mean
+     */
+    static double GetConfidenceInterval (double stddev, uint32_t n);
+
+private:
+
+    struct Scenario{
+        std::string name;
+        std::string traceFile;
+        uint16_t ueNumber;
+    };
+
+    struct Algorithm{
+        std::string name;
+        std::string program;
+        std::vector<std::string> arguments;
+    };
+
+    struct Job{
+        std::string algorithm;
+        std::string program;
+        std::vector<std::string> arguments;
+        Scenario scenario;
+        std::string range;
+        uint32_t run;
+    };
+
+    std::vector<Job> CreateJobs (void) const;
+    int Launch (const Job &job) const;
+    static std::string MakeAbsolute (std::string path);
+
+    std::vector<std::string> GetRunDirectories (std::string algorithm, std::string scenario, std::string range) const;
+    void WriteDivergence (void) const;
+
+    std::vector<Algorithm> m_algorithms;
+    std::vector<std::pair<std::string, std::string> > m_comparisons;   //!< reference, candidate
+    std::vector<Scenario> m_scenarios;
+    std::vector<std::string> m_ranges;
+    std::map<std::string, std::string> m_arguments;
+    uint32_t m_firstRun;
+    uint32_t m_runs;
+    uint32_t m_jobs;
+    std::string m_outputDirectory;
+};
+
+} // namespace ns3
+
+#endif // V2V_SWEEP_HELPER_H
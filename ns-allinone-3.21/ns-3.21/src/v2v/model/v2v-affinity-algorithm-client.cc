@@ -18,6 +18,7 @@
  * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
  */
 
+#include <sstream>
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/nstime.h"
@@ -26,6 +27,7 @@
 #include "ns3/packet.h"
 #include "ns3/address.h"
 #include "ns3/pointer.h"
+#include "ns3/enum.h"
 #include "ns3/uinteger.h"
 #include "ns3/simulator.h"
 #include "ns3/udp-socket.h"
@@ -36,6 +38,7 @@
 #include "ns3/inet6-socket-address.h"
 #include "ns3/packet-socket-address.h"
 #include "ns3/trace-source-accessor.h"
+#include "v2v-cluster-registry.h"
 #include "v2v-affinity-algorithm-client.h"
 
 #include "ns3/random-variable.h"
@@ -107,6 +110,26 @@ TypeId V2vAffinityAlgorithmClient::GetTypeId(void) {
                     "The maximun size of hehicles permitted", UintegerValue(100),
                     MakeUintegerAccessor(&V2vAffinityAlgorithmClient::m_maxUes),
                     MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("NeighborRange",
+                    "Radius (m) around the node of the neighbors used by the CH election, served by a spatial grid; at least the radio range, 0 for every neighbor",
+                    DoubleValue(1000.0),
+                    MakeDoubleAccessor(&V2vAffinityAlgorithmClient::m_neighborRange),
+                    MakeDoubleChecker<double>(0.0))
+            .AddAttribute("NeighborGridCellSize",
+                    "Side (m) of a spatial grid cell of the neighbor table; 0 for NeighborRange",
+                    DoubleValue(0.0),
+                    MakeDoubleAccessor(&V2vAffinityAlgorithmClient::m_gridCellSize),
+                    MakeDoubleChecker<double>(0.0))
+            .AddAttribute("SlotAllocation",
+                    "How the TDMA offset of the node is chosen: VehicleTdmaSlot, or a hashed slot moved on collisions",
+                    EnumValue(V2vSlotAllocator::FIXED),
+                    MakeEnumAccessor(&V2vAffinityAlgorithmClient::m_slotScheme),
+                    MakeEnumChecker(V2vSlotAllocator::FIXED, "Fixed",
+                                    V2vSlotAllocator::HASHED, "Hashed"))
+            .AddAttribute("FrameSlots",
+                    "Number of MinimumTdmaSlot slots of the TDMA frame of the hashed scheme", UintegerValue(100),
+                    MakeUintegerAccessor(&V2vAffinityAlgorithmClient::m_frameSlots),
+                    MakeUintegerChecker<uint32_t>(1))
             .AddAttribute ("Interval",
                     "The time to wait between packets", TimeValue (Seconds (1.0)),
                     MakeTimeAccessor (&V2vAffinityAlgorithmClient::m_interval),
@@ -141,13 +164,22 @@ V2vAffinityAlgorithmClient::V2vAffinityAlgorithmClient () {
     m_clusterChanges = 0;
     m_numberOfMessages = 0;
     m_clusterChangesPerSec = 0;
+    m_registered = false;
+    m_registeredRole = V2vClusterSap::STANDALONE;
 
     m_sentCounter = 0;
     m_receivedCounter = 0;
 
     m_tf = 0.0;
-    m_neighborMap.clear ();
+    m_neighborMap.Clear ();
+    m_neighborExpiry.Clear ();
     m_sendEvent = EventId ();
+
+    for(uint32_t type = 0; type < V2vClusterSap::MESSAGE_TYPES; ++type){
+        m_messageHandlers[type] = 0;
+    }
+    m_messageHandlers[V2vClusterSap::AFFINITY_HELLO_MESSAGE] = &V2vAffinityAlgorithmClient::HandleHello;
+    m_messageHandlers[V2vClusterSap::AFFINITY_RESP_AVAIL_MESSAGE] = &V2vAffinityAlgorithmClient::HandleRespAvail;
 }
 
 V2vAffinityAlgorithmClient::~V2vAffinityAlgorithmClient () {
@@ -160,38 +192,21 @@ V2vAffinityAlgorithmClient::~V2vAffinityAlgorithmClient () {
     m_receivedCounter = 0;
 
     m_tf = 0.0;
-    m_neighborMap.clear ();
+    m_neighborMap.Clear ();
+    m_neighborExpiry.Clear ();
     m_sendEvent.Cancel ();
 }
 
 double
 V2vAffinityAlgorithmClient::GetClusterMembers(void){
 
-    if(m_clusterMembers.size () > 0){
-
-        double s = 0.0;
-        for(std::vector<uint64_t>::iterator it = m_clusterMembers.begin (); it != m_clusterMembers.end (); ++it){
-            s += (*it);
-        }
-        return s/m_clusterMembers.size ();
-    }
-
-    return 0;
+    return m_clusterMembers.GetMean ();
 }
 
 double
 V2vAffinityAlgorithmClient::GetFormationDelay (){
 
-    if(m_formationDelayVector.size () > 0){
-
-        uint64_t sumDelay = 0;
-        for(std::vector<uint64_t>::iterator it = m_formationDelayVector.begin (); it != m_formationDelayVector.end (); ++it){
-            sumDelay += *it;
-        }
-        return TimeStep (sumDelay/m_formationDelayVector.size ()).GetSeconds ();
-    }
-
-    return 0;
+    return m_formationDelay.GetMean ();
 }
 
 uint64_t
@@ -212,6 +227,11 @@ V2vAffinityAlgorithmClient::GetRole (void){
     return false;
 }
 
+uint64_t
+V2vAffinityAlgorithmClient::GetClusterId (void){
+    return m_currentInfo.CHindex;
+}
+
 uint64_t
 V2vAffinityAlgorithmClient::GetNumberOfMessagesPerSecond (void){
     uint64_t tmp = m_numberOfMessagesPerSec;
@@ -233,19 +253,10 @@ V2vAffinityAlgorithmClient::GetChDuration (void){
     if(m_chDurationBoolean){
         m_chDurationBoolean = false;
         m_stopChDuration = Simulator::Now ().GetTimeStep ();
-        m_chDurationVector.push_back (m_stopChDuration - m_startChDuration);
-    }
-
-    if(m_chDurationVector.size () > 0){
-
-        uint64_t sumDuration = 0;
-        for(std::vector<uint64_t>::iterator it = m_chDurationVector.begin (); it != m_chDurationVector.end (); ++it){
-            sumDuration += *it;
-        }
-        return TimeStep (sumDuration/m_chDurationVector.size ()).GetSeconds ();
+        m_chDuration.Add (TimeStep (m_stopChDuration - m_startChDuration).GetSeconds ());
     }
 
-    return 0;
+    return m_chDuration.GetMean ();
 }
 
 double
@@ -254,67 +265,171 @@ V2vAffinityAlgorithmClient::GetCmDuration (void){
     if(m_cmDurationBoolean){
         m_cmDurationBoolean = false;
         m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-        m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
-    }
-
-    if(m_cmDurationVector.size () > 0){
-
-        uint64_t sumDuration = 0;
-        for(std::vector<uint64_t>::iterator it = m_cmDurationVector.begin (); it != m_cmDurationVector.end (); ++it){
-            sumDuration += *it;
-        }
-        return TimeStep (sumDuration/m_cmDurationVector.size ()).GetSeconds ();
+        m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
     }
 
-    return 0;
+    return m_cmDuration.GetMean ();
 }
 
 double
 V2vAffinityAlgorithmClient::GetMinChDuration (void){
 
-    uint64_t min = Simulator::Now ().GetTimeStep ();
-    for(std::vector<uint64_t>::iterator it = m_chDurationVector.begin (); it != m_chDurationVector.end (); ++it){
-        if((*it) < min){
-            min = *it;
-        }
+    if(m_chDuration.GetCount () == 0){
+        return Simulator::Now ().GetSeconds ();
     }
-    return TimeStep (min).GetSeconds ();
+    return m_chDuration.GetMin ();
 }
 
 double
 V2vAffinityAlgorithmClient::GetMaxChDuration (void){
 
-    uint64_t max = 0;
-    for(std::vector<uint64_t>::iterator it = m_chDurationVector.begin (); it != m_chDurationVector.end (); ++it){
-        if((*it) > max){
-            max = *it;
-        }
-    }
-    return TimeStep (max).GetSeconds ();
+    return m_chDuration.GetMax ();
 }
 
 double
 V2vAffinityAlgorithmClient::GetMinCmDuration (void){
 
-    uint64_t min = Simulator::Now ().GetTimeStep ();
-    for(std::vector<uint64_t>::iterator it = m_cmDurationVector.begin (); it != m_cmDurationVector.end (); ++it){
-        if((*it) < min){
-            min = *it;
-        }
+    if(m_cmDuration.GetCount () == 0){
+        return Simulator::Now ().GetSeconds ();
     }
-    return TimeStep (min).GetSeconds ();
+    return m_cmDuration.GetMin ();
 }
 
 double
 V2vAffinityAlgorithmClient::GetMaxCmDuration (void){
 
-    uint64_t max = 0;
-    for(std::vector<uint64_t>::iterator it = m_cmDurationVector.begin (); it != m_cmDurationVector.end (); ++it){
-        if((*it) > max){
-            max = *it;
-        }
+    return m_cmDuration.GetMax ();
+}
+
+const V2vStatisticsAccumulator &
+V2vAffinityAlgorithmClient::GetFormationDelayStatistics (void) const {
+    return m_formationDelay;
+}
+
+const V2vStatisticsAccumulator &
+V2vAffinityAlgorithmClient::GetClusterMembersStatistics (void) const {
+    return m_clusterMembers;
+}
+
+const V2vStatisticsAccumulator &
+V2vAffinityAlgorithmClient::GetChDurationStatistics (void) const {
+    return m_chDuration;
+}
+
+const V2vStatisticsAccumulator &
+V2vAffinityAlgorithmClient::GetCmDurationStatistics (void) const {
+    return m_cmDuration;
+}
+
+const V2vSlotAllocator &
+V2vAffinityAlgorithmClient::GetSlotAllocator (void) const {
+    return m_slots;
+}
+
+void
+V2vAffinityAlgorithmClient::SendControl (Ptr<Socket> socket, Ptr<Packet> packet){
+    if(m_scheduler != 0){
+        m_scheduler->Send (socket, packet, V2vChannelScheduler::CCH);
+    }
+    else{
+        socket->Send (packet);
+    }
+}
+
+double
+V2vAffinityAlgorithmClient::GetTdmaOffset (void) const {
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        return m_slots.GetOffset ().GetSeconds ();
+    }
+    return m_vehicleTdmaSlot;
+}
+
+uint32_t
+V2vAffinityAlgorithmClient::GetTdmaFrameSlots (void) const {
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        return m_slots.GetFrameSlots ();
+    }
+    return m_maxUes;
+}
+
+void
+V2vAffinityAlgorithmClient::SaveState (V2vSnapshotWriter &writer) const {
+
+    writer.Write ("nodeState", (uint32_t) m_nodeState);
+    writer.Write ("currentInfo", m_currentInfo);
+    writer.WriteTable ("neighborMap", m_neighborMap, &m_neighborExpiry);
+    writer.Write ("previousIndex", m_previousIndex);
+
+    writer.Write ("sentCounter", m_sentCounter);
+    writer.Write ("receivedCounter", m_receivedCounter);
+    writer.Write ("formationDelayBoolean", m_formationDelayBoolean);
+    writer.Write ("startFormationDelay", m_startFormationDelay);
+    writer.Write ("stopFormationDelay", m_stopFormationDelay);
+    writer.Write ("formationDelay", m_formationDelay);
+    writer.Write ("clusterMembers", m_clusterMembers);
+    writer.Write ("clusterChanges", m_clusterChanges);
+    writer.Write ("numberOfMessages", m_numberOfMessages);
+    writer.Write ("numberOfMessagesPerSec", m_numberOfMessagesPerSec);
+    writer.Write ("clusterChangesPerSec", m_clusterChangesPerSec);
+    writer.Write ("chDurationBoolean", m_chDurationBoolean);
+    writer.Write ("startChDuration", m_startChDuration);
+    writer.Write ("stopChDuration", m_stopChDuration);
+    writer.Write ("chDuration", m_chDuration);
+    writer.Write ("cmDurationBoolean", m_cmDurationBoolean);
+    writer.Write ("startCmDuration", m_startCmDuration);
+    writer.Write ("stopCmDuration", m_stopCmDuration);
+    writer.Write ("cmDuration", m_cmDuration);
+    m_slots.SaveState (writer);
+
+    writer.WriteEvent ("sendEvent", m_sendEvent);
+    writer.WriteEvent ("acquireEvent", m_acquireEvent);
+}
+
+void
+V2vAffinityAlgorithmClient::SetSnapshot (const std::string &record){
+    m_snapshot = record;
+}
+
+void
+V2vAffinityAlgorithmClient::LoadState (V2vSnapshotReader &reader){
+    NS_LOG_FUNCTION (this);
+
+    uint32_t nodeState;
+    reader.Read ("nodeState", nodeState);
+    m_nodeState = (V2vClusterSap::AffinityNodeState) nodeState;
+    reader.Read ("currentInfo", m_currentInfo);
+    reader.ReadTable ("neighborMap", m_neighborMap, &m_neighborExpiry);
+    reader.Read ("previousIndex", m_previousIndex);
+
+    reader.Read ("sentCounter", m_sentCounter);
+    reader.Read ("receivedCounter", m_receivedCounter);
+    reader.Read ("formationDelayBoolean", m_formationDelayBoolean);
+    reader.Read ("startFormationDelay", m_startFormationDelay);
+    reader.Read ("stopFormationDelay", m_stopFormationDelay);
+    reader.Read ("formationDelay", m_formationDelay);
+    reader.Read ("clusterMembers", m_clusterMembers);
+    reader.Read ("clusterChanges", m_clusterChanges);
+    reader.Read ("numberOfMessages", m_numberOfMessages);
+    reader.Read ("numberOfMessagesPerSec", m_numberOfMessagesPerSec);
+    reader.Read ("clusterChangesPerSec", m_clusterChangesPerSec);
+    reader.Read ("chDurationBoolean", m_chDurationBoolean);
+    reader.Read ("startChDuration", m_startChDuration);
+    reader.Read ("stopChDuration", m_stopChDuration);
+    reader.Read ("chDuration", m_chDuration);
+    reader.Read ("cmDurationBoolean", m_cmDurationBoolean);
+    reader.Read ("startCmDuration", m_startCmDuration);
+    reader.Read ("stopCmDuration", m_stopCmDuration);
+    reader.Read ("cmDuration", m_cmDuration);
+    m_slots.LoadState (reader);
+
+    Time delay = reader.ReadEvent ("sendEvent");
+    if(!delay.IsNegative ()){
+        ScheduleTransmit (delay);
+    }
+    delay = reader.ReadEvent ("acquireEvent");
+    if(!delay.IsNegative ()){
+        m_acquireEvent = Simulator::Schedule (delay, &V2vAffinityAlgorithmClient::AcquireMobilityInfo, this);
     }
-    return TimeStep (max).GetSeconds ();
 }
 
 void
@@ -347,11 +462,26 @@ V2vAffinityAlgorithmClient::DoDispose (void) {
 
     m_socket = 0;
     m_socketListening = 0;
+    m_scheduler = 0;
+
+    if(m_registered){
+        V2vClusterRegistry::Get ()->Unregister (m_registeredRole);
+        m_registered = false;
+    }
 
     // chain up
     Application::DoDispose();
 }
 
+void
+V2vAffinityAlgorithmClient::UpdateRegistryRole (void){
+    V2vClusterSap::NovelNodeDegree role = GetRole () ? V2vClusterSap::CH : V2vClusterSap::CM;
+    if(m_registered && role != m_registeredRole){
+        V2vClusterRegistry::Get ()->NotifyRoleChange (m_registeredRole, role);
+        m_registeredRole = role;
+    }
+}
+
 void
 V2vAffinityAlgorithmClient::StartApplication (void)
 {
@@ -375,15 +505,39 @@ V2vAffinityAlgorithmClient::StartApplication (void)
                 MakeCallback(&V2vAffinityAlgorithmClient::ConnectionFailed, this));
     }
 
-    if(m_maxUes > 100){
+    //!< Control messages go on the CCH only
+    m_scheduler = GetNode ()->GetObject<V2vChannelScheduler> ();
+    if(m_scheduler != 0 && !m_scheduler->BindToChannel (m_socket, V2vChannelScheduler::CCH)){
+        NS_FATAL_ERROR("Error: V2vChannelScheduler without a CCH device.");
+    }
+
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        m_slots.Start (GetNode ()->GetId (), m_frameSlots, Seconds (m_minimumTdmaSlot));
+    }
+    else if(m_maxUes > 100){
         NS_FATAL_ERROR("Error: Maximum number of ues is 100.");
     }
 
     StartListeningLocal();
+    m_neighborMap.SetCellSize (m_gridCellSize > 0 ? m_gridCellSize : m_neighborRange);
+
+    bool resume = !m_snapshot.empty ();
+    if(resume){
+        std::istringstream record (m_snapshot);
+        V2vSnapshotReader reader (record);
+        LoadState (reader);
+        m_snapshot.clear ();
+    }
 
-    ChangeState (m_nodeState);
-    Simulator::Schedule(Seconds(m_trainingPeriod), &V2vAffinityAlgorithmClient::AcquireMobilityInfo, this);
-    ScheduleTransmit (Seconds (m_trainingPeriod + m_vehicleTdmaSlot));
+    m_registeredRole = GetRole () ? V2vClusterSap::CH : V2vClusterSap::CM;
+    m_registered = true;
+    V2vClusterRegistry::Get ()->Register (m_registeredRole);
+
+    if(!resume){
+        ChangeState (m_nodeState);
+        m_acquireEvent = Simulator::Schedule(Seconds(m_trainingPeriod), &V2vAffinityAlgorithmClient::AcquireMobilityInfo, this);
+        ScheduleTransmit (Seconds (m_trainingPeriod + GetTdmaOffset ()));
+    }
 
 }
 
@@ -472,45 +626,60 @@ V2vAffinityAlgorithmClient::HandleRead (Ptr<Socket> socket) {
             break;
         }
 
-        Ptr<Packet> p = packet->Copy ();
-        PacketMetadata::ItemIterator metadataIterator = p->BeginItem();
-        PacketMetadata::Item item;
-        while (metadataIterator.HasNext()){
-            item = metadataIterator.Next();
+        V2vClusterTypeHeader typeHeader;
+        packet->RemoveHeader (typeHeader);
 
-            if(item.tid.GetName() == "ns3::V2vAffinityHelloHeader"){
-                V2vAffinityHelloHeader helloHeader;
-                p->RemoveHeader (helloHeader);
-
-                NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Received Hello message from: " << helloHeader.GetHelloInfo ().id);
-                if(IsSameDirection (helloHeader.GetHelloInfo ().velocity)){
-                    m_neighborMap[helloHeader.GetHelloInfo().id] = CreateNeighbor(helloHeader.GetTs (), helloHeader.GetHelloInfo ());
-                }
-            }
-            else if(item.tid.GetName() == "ns3::V2vAffinityRespAvailHeader"){
-                V2vAffinityRespAvailHeader respAvailHeader;
-                p->RemoveHeader (respAvailHeader);
-
-                NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " From:" << respAvailHeader.GetRespAvailInfo ().id << " Received RespAvail at time: " << respAvailHeader.GetTs() << " respMap size is: " << respAvailHeader.GetRespAvailList().size());
-                std::map<uint64_t, V2vClusterSap::AffinityNeighbors>::iterator found = m_neighborMap.find (respAvailHeader.GetRespAvailInfo ().id);
-                if(found != m_neighborMap.end ()){
-                    std::list<V2vClusterSap::AffinitySubStructure> listCopy = respAvailHeader.GetRespAvailList();
-                    for (std::list<V2vClusterSap::AffinitySubStructure>::iterator tmp = listCopy.begin(); tmp != listCopy.end(); ++tmp) {
-                        NS_LOG_DEBUG("tmp->id:" << tmp->id << " - tmp->resp:" << tmp->resp << " - tmp->avail:" << tmp->avail);
-                        if(tmp->id == m_currentInfo.id){
-                            found->second.responsibilityReceived = tmp->resp;
-                            found->second.availabilityReceived = tmp->avail;
-                        }
-                    }
-                    found->second.CHcnvg = respAvailHeader.GetRespAvailInfo ().CHcnvg;
-                }
-            }
-            m_rxTrace(p, from);
+        MessageHandler handler = 0;
+        if(typeHeader.IsValid ()){
+            handler = m_messageHandlers[typeHeader.GetType ()];
+        }
+        if(handler != 0){
+            (this->*handler) (packet, from);
+        }
+        else{
+            NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " Dropped message of unknown type: " << typeHeader.GetType ());
         }
+        m_rxTrace(packet, from);
         m_receivedCounter ++;
     }
 }
 
+void
+V2vAffinityAlgorithmClient::HandleHello (Ptr<Packet> packet, const Address &from) {
+    NS_LOG_FUNCTION (this << packet << from);
+    V2vAffinityHelloHeader helloHeader;
+    packet->RemoveHeader (helloHeader);
+
+    NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Received Hello message from: " << helloHeader.GetHelloInfo ().id);
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        m_slots.NotifyReceived (helloHeader.GetHelloInfo ().id, helloHeader.GetTs ());
+    }
+    if(IsSameDirection (helloHeader.GetHelloInfo ().velocity)){
+        V2vClusterSap::AffinityHello hello = helloHeader.GetHelloInfo ();
+        m_neighborMap.Insert (hello.id, hello.position, hello.velocity, CreateNeighbor(helloHeader.GetTs (), hello));
+        m_neighborExpiry.Schedule (hello.id, helloHeader.GetTs () + Seconds (1.5));
+    }
+}
+
+void
+V2vAffinityAlgorithmClient::HandleRespAvail (Ptr<Packet> packet, const Address &from) {
+    NS_LOG_FUNCTION (this << packet << from);
+    V2vAffinityRespAvailHeader respAvailHeader;
+    packet->RemoveHeader (respAvailHeader);
+
+    NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " From:" << respAvailHeader.GetRespAvailInfo ().id << " Received RespAvail at time: " << respAvailHeader.GetTs() << " respMap size is: " << respAvailHeader.GetRespAvailList().size());
+    V2vClusterSap::AffinityNeighbors *found = m_neighborMap.Find (respAvailHeader.GetRespAvailInfo ().id);
+    if(found != 0){
+        const V2vClusterSap::AffinitySubStructure *entry = respAvailHeader.FindRespAvail (m_currentInfo.id);
+        if(entry != 0){
+            NS_LOG_DEBUG("entry->id:" << entry->id << " - entry->resp:" << entry->resp << " - entry->avail:" << entry->avail);
+            found->responsibilityReceived = entry->resp;
+            found->availabilityReceived = entry->avail;
+        }
+        found->CHcnvg = respAvailHeader.GetRespAvailInfo ().CHcnvg;
+    }
+}
+
 void
 V2vAffinityAlgorithmClient::HandleAccept (Ptr<Socket> s, const Address& from) {
     NS_LOG_FUNCTION (this << s << from);
@@ -547,16 +716,21 @@ V2vAffinityAlgorithmClient::Send (void) {
 
         Ptr<Packet> packet = Create<Packet>(0);
         packet->AddHeader (helloHeader);
-        m_socket->Send (packet);
+        packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::AFFINITY_HELLO_MESSAGE));
+        SendControl (m_socket, packet);
         m_txTrace(packet);
         m_sentCounter ++;
 
         m_numberOfMessages ++;
         m_numberOfMessagesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
         NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends Hello Message at : " << helloHeader.GetTs ().GetSeconds ());
+        if(m_slotScheme == V2vSlotAllocator::HASHED){
+            m_slots.NotifySent (helloHeader.GetTs ());
+        }
         ChangeState (m_nodeState);
-        ScheduleTransmit (Seconds(m_maxUes*m_minimumTdmaSlot));
+        ScheduleTransmit (Seconds(GetTdmaFrameSlots ()*m_minimumTdmaSlot));
 
         break;
     }
@@ -573,17 +747,19 @@ V2vAffinityAlgorithmClient::Send (void) {
 
         Ptr<Packet> packet = Create<Packet>(0);
         packet->AddHeader (respAvailHeader);
-        m_socket->Send (packet);
+        packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::AFFINITY_RESP_AVAIL_MESSAGE));
+        SendControl (m_socket, packet);
         m_txTrace(packet);
         m_sentCounter ++;
 
         m_numberOfMessages ++;
         m_numberOfMessagesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
         NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends TM Message at : " << respAvailHeader.GetTs ().GetSeconds ());
 
         ChangeState (m_nodeState);
-        ScheduleTransmit (Seconds(m_maxUes*m_minimumTdmaSlot));
+        ScheduleTransmit (Seconds(GetTdmaFrameSlots ()*m_minimumTdmaSlot));
 
         break;
     }
@@ -605,7 +781,7 @@ V2vAffinityAlgorithmClient::Send (void) {
         double elapsed = Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ();
 
         ChangeState (m_nodeState);
-        ScheduleTransmit (Seconds(m_interval.GetSeconds () - elapsed + m_vehicleTdmaSlot));
+        ScheduleTransmit (Seconds(m_interval.GetSeconds () - elapsed + GetTdmaOffset ()));
         break;
     }
     default:
@@ -626,6 +802,7 @@ V2vAffinityAlgorithmClient::AcquireMobilityInfo (void){
     //!< Acquire current mobility stats
     m_currentInfo.selfSim = m_selfSimilarity;
     m_currentInfo.id = this->GetNode ()->GetId ();
+    UpdateRegistryRole ();
     m_currentInfo.position = m_mobilityModel->GetPosition();
     m_currentInfo.velocity = m_mobilityModel->GetVelocity();
     m_currentInfo.direction = Vector(0.0, 0.0, 0.0);//m_currentInfo.direction = m_mobilityModel->GetDirection();
@@ -649,61 +826,40 @@ V2vAffinityAlgorithmClient::CreateRespAvailInfo(void){
     V2vClusterSap::AffinityRespAvail respAvailStruct;
     respAvailStruct.id = m_currentInfo.id;
     respAvailStruct.CHcnvg = IsConverged();
-    respAvailStruct.neighboursNumber = m_neighborMap.size ();
+    respAvailStruct.neighboursNumber = m_neighborMap.GetSize ();
 
     return respAvailStruct;
 }
 
-std::list<V2vClusterSap::AffinitySubStructure>
+std::vector<V2vClusterSap::AffinitySubStructure>
 V2vAffinityAlgorithmClient::CreateRespAvailList(void){
 
-    // find self responsibility - self availability
-    double sumAvail = 0.0;
-    double maxResp = -1e100;
-    for(std::map<uint64_t, V2vClusterSap::AffinityNeighbors>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it) {
-        V2vClusterSap::AffinityNeighbors value = it->second;
-        if((value.similarity + value.availabilityReceived) > maxResp){
-            maxResp = value.similarity + value.availabilityReceived;
-        }
-        sumAvail += std::max (0.0, value.responsibilityReceived);
+    m_propagation.Clear ();
+    for(V2vNeighborTable<V2vClusterSap::AffinityNeighbors>::ConstIterator it = m_neighborMap.Begin(); it != m_neighborMap.End(); ++it) {
+        const V2vClusterSap::AffinityNeighbors &value = it->value;
+        m_propagation.Add (value.similarity, value.availabilityReceived, value.responsibilityReceived,
+                           value.responsibilitySent, value.availabilitySent);
     }
-    m_currentInfo.selfResp = ((1-m_lamda)*(m_selfSimilarity - maxResp)) + (m_lamda*m_currentInfo.selfResp);
-    m_currentInfo.selfAvail = ((1-m_lamda)*(sumAvail)) + (m_lamda*m_currentInfo.selfAvail);
-    NS_LOG_DEBUG("Self responsibility is:" << m_currentInfo.selfResp << " - Self availaility is:" << m_currentInfo.selfAvail);
-
-
-    std::list<V2vClusterSap::AffinitySubStructure> respAvailList;
-    std::map<uint64_t, V2vClusterSap::AffinityNeighbors> neighbourMap2 = m_neighborMap;
-    for(std::map<uint64_t, V2vClusterSap::AffinityNeighbors>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it) {
 
-        V2vClusterSap::AffinityNeighbors value = it->second;
+    // find self and each neighbour responsibility - availability
+    m_propagation.Update (m_lamda, m_selfSimilarity, m_currentInfo.selfResp, m_currentInfo.selfAvail);
+    NS_LOG_DEBUG("Self responsibility is:" << m_currentInfo.selfResp << " - Self availaility is:" << m_currentInfo.selfAvail);
 
-        // find each neighbour responsibility - availability
-        sumAvail = 0.0;
-        maxResp = -1e100;
-        for(std::map<uint64_t, V2vClusterSap::AffinityNeighbors>::iterator it2 = neighbourMap2.begin(); it2 != neighbourMap2.end(); ++it2) {
-            V2vClusterSap::AffinityNeighbors value2 = it2->second;
-            if(it->first != it2->first){
-                if((value2.similarity + value2.availabilityReceived) > maxResp){
-                    maxResp = value2.similarity + value2.availabilityReceived;
-                }
-                sumAvail += std::max (0.0, value2.responsibilityReceived);
-            }
-        }
-        if((value.similarity + value.availabilityReceived) > maxResp){
-            maxResp = value.similarity + value.availabilityReceived;
-        }
+    std::vector<V2vClusterSap::AffinitySubStructure> respAvailList;
+    respAvailList.reserve (m_neighborMap.GetSize ());
+    uint32_t index = 0;
+    for(V2vNeighborTable<V2vClusterSap::AffinityNeighbors>::Iterator it = m_neighborMap.Begin(); it != m_neighborMap.End(); ++it, ++index) {
 
-        it->second.responsibilitySent = ((1-m_lamda)*(value.similarity - maxResp)) + (m_lamda*value.responsibilitySent);
-        NS_LOG_DEBUG("it->second.responsibilitySent for neighbor:" << it->first << " is: " << it->second.responsibilitySent);
+        it->value.responsibilitySent = m_propagation.GetResponsibilitySent (index);
+        NS_LOG_DEBUG("it->value.responsibilitySent for neighbor:" << it->id << " is: " << it->value.responsibilitySent);
 
-        it->second.availabilitySent = (1-m_lamda)*std::min (0.0, value.responsibilityReceived + sumAvail) + (m_lamda*value.availabilitySent);
-        NS_LOG_DEBUG("it->second.it->second.availabilitySent for neighbor:" << it->first << " is: " << it->second.availabilitySent);
+        it->value.availabilitySent = m_propagation.GetAvailabilitySent (index);
+        NS_LOG_DEBUG("it->value.it->value.availabilitySent for neighbor:" << it->id << " is: " << it->value.availabilitySent);
 
         V2vClusterSap::AffinitySubStructure tmp;
-        tmp.id = it->first;
-        tmp.resp = it->second.responsibilitySent;
-        tmp.avail = it->second.availabilitySent;
+        tmp.id = it->id;
+        tmp.resp = it->value.responsibilitySent;
+        tmp.avail = it->value.availabilitySent;
         respAvailList.push_back (tmp);
     }
 
@@ -769,7 +925,7 @@ V2vAffinityAlgorithmClient::IsConverged(void){
 
         m_stopFormationDelay = Simulator::Now ().GetTimeStep ();
         m_formationDelayBoolean = false;
-        m_formationDelayVector.push_back (m_stopFormationDelay - m_startFormationDelay);
+        m_formationDelay.Add (TimeStep (m_stopFormationDelay - m_startFormationDelay).GetSeconds ());
     }
     else{
         m_currentInfo.CHcnvg = false;
@@ -778,6 +934,36 @@ V2vAffinityAlgorithmClient::IsConverged(void){
     return m_currentInfo.CHcnvg;
 }
 
+const std::vector<uint32_t>&
+V2vAffinityAlgorithmClient::CollectNeighbors (void){
+    if(m_neighborRange > 0){
+        m_neighborMap.FindInRange (m_currentInfo.position, m_neighborRange, m_neighborScan);
+        return m_neighborScan;
+    }
+    return m_neighborMap.GetIdOrder ();
+}
+
+uint64_t
+V2vAffinityAlgorithmClient::FindBestNeighbor (const V2vNeighborTable<V2vClusterSap::AffinityNeighbors> &table,
+                                              const std::vector<uint32_t> &scan, bool converged){
+    double maxSim = -1e100;
+    uint64_t bestNeighbour = 0;
+    for(uint32_t i = 0; i < scan.size (); ++i){
+        const V2vNeighborTable<V2vClusterSap::AffinityNeighbors>::Entry &entry = table.GetEntry (scan[i]);
+        const V2vClusterSap::AffinityNeighbors &node = entry.value;
+        if(converged && !node.CHcnvg){
+            continue;
+        }
+        //!< The scan is not in id order, a tie keeps the lowest id
+        double sim = node.responsibilitySent+node.availabilityReceived;
+        if(sim > maxSim || (sim == maxSim && bestNeighbour != 0 && entry.id < bestNeighbour)){
+            maxSim = sim;
+            bestNeighbour = entry.id;
+        }
+    }
+    return bestNeighbour;
+}
+
 void
 V2vAffinityAlgorithmClient::CIMaintenanceTasks(void){
 
@@ -785,38 +971,32 @@ V2vAffinityAlgorithmClient::CIMaintenanceTasks(void){
 
     if(m_currentInfo.CHcnvg){
         m_currentInfo.CHindex = m_currentInfo.id;
+        UpdateRegistryRole ();
     }
     else{
-        double maxSim = -1e100;
-        uint64_t bestNeighbour = 0;
-        for(std::map<uint64_t, V2vClusterSap::AffinityNeighbors>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it){
-            V2vClusterSap::AffinityNeighbors node = it->second;
-            if(node.CHcnvg){
-                if(node.responsibilitySent+node.availabilityReceived > maxSim){
-                    maxSim = node.responsibilitySent+node.availabilityReceived;
-                    bestNeighbour = it->first;
-                }
-            }
-        }
+        uint64_t bestNeighbour = FindBestNeighbor (m_neighborMap, CollectNeighbors (), true);
 
         // if not neighbours available for CH, turn on myself
         if(bestNeighbour == 0){
             m_currentInfo.CHindex = m_currentInfo.id;
+            UpdateRegistryRole ();
         }
         else{
             m_currentInfo.CHindex = bestNeighbour;
+            UpdateRegistryRole ();
         }
     }
 
     if(previousIndex != m_currentInfo.CHindex){
         m_clusterChanges ++;
         m_clusterChangesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyClusterChange ();
 
         if(m_currentInfo.id != m_currentInfo.CHindex){
             if(m_chDurationBoolean){
                 m_chDurationBoolean = false;
                 m_stopChDuration = Simulator::Now ().GetTimeStep ();
-                m_chDurationVector.push_back (m_stopChDuration - m_startChDuration);
+                m_chDuration.Add (TimeStep (m_stopChDuration - m_startChDuration).GetSeconds ());
             }
 
             if(m_cmDurationBoolean == false){
@@ -828,7 +1008,7 @@ V2vAffinityAlgorithmClient::CIMaintenanceTasks(void){
             if(m_cmDurationBoolean){
                 m_cmDurationBoolean = false;
                 m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-                m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
+                m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
             }
 
             if(m_chDurationBoolean == false){
@@ -846,36 +1026,30 @@ V2vAffinityAlgorithmClient::PeriodicMaintenanceTasks(void){
 
     if(m_currentInfo.CHindex == m_currentInfo.id){
         uint64_t sum = 0;
-        for(std::map<uint64_t, V2vClusterSap::AffinityNeighbors>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it){
-            V2vClusterSap::AffinityNeighbors value = it->second;
+        const std::vector<uint32_t> &scan = CollectNeighbors ();
+        for(uint32_t i = 0; i < scan.size (); ++i){
+            const V2vClusterSap::AffinityNeighbors &value = m_neighborMap.GetEntry (scan[i]).value;
             if(value.CHindex == m_currentInfo.id){
                 sum ++;
             }
         }
-        m_clusterMembers.push_back (sum+1);
+        m_clusterMembers.Add (sum+1);
     }
 
     if(m_currentInfo.CHindex != 0){
 
         if(m_currentInfo.CHindex != m_currentInfo.id){
-            std::map<uint64_t, V2vClusterSap::AffinityNeighbors>::iterator found = m_neighborMap.find (m_currentInfo.CHindex);
-            if(found == m_neighborMap.end ()){
-
-                double maxSim = -1e100;
-                uint64_t bestNeighbour = 0;
-                for(std::map<uint64_t, V2vClusterSap::AffinityNeighbors>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it){
-                    V2vClusterSap::AffinityNeighbors node = it->second;
-                    if(node.responsibilitySent+node.availabilityReceived > maxSim){
-                        maxSim = node.responsibilitySent+node.availabilityReceived;
-                        bestNeighbour = it->first;
-                    }
-                }
+            if(!m_neighborMap.Contains (m_currentInfo.CHindex)){
+
+                uint64_t bestNeighbour = FindBestNeighbor (m_neighborMap, CollectNeighbors (), false);
 
                 if(bestNeighbour == 0){
                     m_currentInfo.CHindex = m_currentInfo.id;
+                    UpdateRegistryRole ();
                 }
                 else{
                     m_currentInfo.CHindex = bestNeighbour;
+                    UpdateRegistryRole ();
                 }
             }
         }
@@ -884,12 +1058,13 @@ V2vAffinityAlgorithmClient::PeriodicMaintenanceTasks(void){
     if(previousIndex != m_currentInfo.CHindex){
         m_clusterChanges ++;
         m_clusterChangesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyClusterChange ();
 
         if(m_currentInfo.id != m_currentInfo.CHindex){
             if(m_chDurationBoolean){
                 m_chDurationBoolean = false;
                 m_stopChDuration = Simulator::Now ().GetTimeStep ();
-                m_chDurationVector.push_back (m_stopChDuration - m_startChDuration);
+                m_chDuration.Add (TimeStep (m_stopChDuration - m_startChDuration).GetSeconds ());
             }
 
             if(m_cmDurationBoolean == false){
@@ -901,7 +1076,7 @@ V2vAffinityAlgorithmClient::PeriodicMaintenanceTasks(void){
             if(m_cmDurationBoolean){
                 m_cmDurationBoolean = false;
                 m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-                m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
+                m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
             }
 
             if(m_chDurationBoolean == false){
@@ -915,16 +1090,25 @@ V2vAffinityAlgorithmClient::PeriodicMaintenanceTasks(void){
 void
 V2vAffinityAlgorithmClient::PurgeNeighbours (void) {
 
-    for(std::map<uint64_t, V2vClusterSap::AffinityNeighbors>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end();){
-
-        V2vClusterSap::AffinityNeighbors node = it->second;
-        if(Simulator::Now ().GetSeconds () - node.tExpire.GetSeconds () > 1.5){
-            m_neighborMap.erase (it++);
+    m_expired.clear ();
+    m_neighborExpiry.Advance (Simulator::Now (), m_expired);
+    for(uint32_t i = 0; i < m_expired.size ();){
+        const V2vClusterSap::AffinityNeighbors *node = m_neighborMap.Find (m_expired[i]);
+        if(Simulator::Now ().GetSeconds () - node->tExpire.GetSeconds () > 1.5){
+            ++i;
         }
         else{
-            ++it;
+            //!< Exactly 1.5s old, expires at the next purge
+            m_neighborExpiry.Schedule (m_expired[i], Simulator::Now () + TimeStep (1));
+            m_expired[i] = m_expired.back ();
+            m_expired.pop_back ();
         }
     }
+
+    m_neighborMap.SortForErase (m_expired);
+    for(uint32_t i = 0; i < m_expired.size (); ++i){
+        m_neighborMap.Erase (m_expired[i]);
+    }
 }
 
 void
@@ -963,10 +1147,10 @@ V2vAffinityAlgorithmClient::StatusReport (void){
                    << " SelfAvailability is: " << m_currentInfo.selfAvail << "\n");
 
     NS_LOG_UNCOND("----------------------------  Neighbors Info  ---------------------------------");
-    NS_LOG_UNCOND("NeighborMap size:" << m_neighborMap.size ());
-    for(std::map<uint64_t, V2vClusterSap::AffinityNeighbors>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it){
-        uint64_t id = it->first;
-        V2vClusterSap::AffinityNeighbors node = it->second;
+    NS_LOG_UNCOND("NeighborMap size:" << m_neighborMap.GetSize ());
+    for(V2vNeighborTable<V2vClusterSap::AffinityNeighbors>::ConstIterator it = m_neighborMap.Begin(); it != m_neighborMap.End(); ++it){
+        uint64_t id = it->id;
+        const V2vClusterSap::AffinityNeighbors &node = it->value;
         NS_LOG_UNCOND(" * key: " << id
                 << " tExpire:" << node.tExpire.GetSeconds ()
                 << " CHcvng:" << node.CHcnvg
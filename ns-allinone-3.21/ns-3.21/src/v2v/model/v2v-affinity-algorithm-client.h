@@ -31,6 +31,13 @@
 #include "ns3/mobility-module.h"
 #include "ns3/v2v-cluster-sap.h"
 #include "ns3/v2v-cluster-header.h"
+#include "ns3/v2v-neighbor-table.h"
+#include "ns3/v2v-timer-wheel.h"
+#include "ns3/v2v-statistics-accumulator.h"
+#include "ns3/v2v-cluster-snapshot.h"
+#include "ns3/v2v-slot-allocator.h"
+#include "ns3/v2v-channel-scheduler.h"
+#include "ns3/v2v-affinity-propagation.h"
 
 namespace ns3 {
 
@@ -90,6 +97,12 @@ public:
      */
     bool GetRole(void);
 
+    /**
+     * @brief GetClusterId
+     * @return the node id of the cluster head of the node, 0 when it has none
+     */
+    uint64_t GetClusterId(void);
+
     /**
      * @brief GetNumberOfMessagesPerSecond
      * @return
@@ -138,6 +151,61 @@ public:
      */
     double GetMaxCmDuration(void);
 
+    /**
+     * @brief GetFormationDelayStatistics
+     * @return the cluster formation delay samples [s], with percentiles
+     */
+    const V2vStatisticsAccumulator &GetFormationDelayStatistics(void) const;
+
+    /**
+     * @brief GetClusterMembersStatistics
+     * @return the cluster size samples, with percentiles
+     */
+    const V2vStatisticsAccumulator &GetClusterMembersStatistics(void) const;
+
+    /**
+     * @brief GetChDurationStatistics
+     * @return the cluster head duration samples [s], with percentiles
+     */
+    const V2vStatisticsAccumulator &GetChDurationStatistics(void) const;
+
+    /**
+     * @brief GetCmDurationStatistics
+     * @return the cluster member duration samples [s], with percentiles
+     */
+    const V2vStatisticsAccumulator &GetCmDurationStatistics(void) const;
+
+    /**
+     * @brief GetSlotAllocator
+     * @return the slot reservation of the hashed TDMA scheme, with its
+     * collision and move counters
+     */
+    const V2vSlotAllocator &GetSlotAllocator(void) const;
+
+    /**
+     * @brief Write the clustering state of the client to a snapshot
+     * @param writer the snapshot record of the node
+     */
+    void SaveState (V2vSnapshotWriter &writer) const;
+
+    /**
+     * @brief Resume from a snapshot when the application starts, in place
+     * of a new training period
+     * @param record the record written by SaveState
+     */
+    void SetSnapshot (const std::string &record);
+
+    /**
+     * @brief The neighbor of highest responsibility sent plus availability
+     * received, the lowest id on a tie as the former std::map scan
+     * @param table the neighbor table
+     * @param scan the storage indexes of the neighbors to consider
+     * @param converged only consider the neighbors which converged
+     * @return the id of the best neighbor, 0 if none
+     */
+    static uint64_t FindBestNeighbor (const V2vNeighborTable<V2vClusterSap::AffinityNeighbors> &table,
+                                      const std::vector<uint32_t> &scan, bool converged);
+
 
 protected:
     virtual void DoDispose (void);
@@ -147,6 +215,11 @@ private:
     virtual void StartApplication (void);    // Called at time specified by Start
     virtual void StopApplication (void);     // Called at time specified by Stop
 
+    /**
+     * \brief Report the current role to V2vClusterRegistry if it changed
+     */
+    void UpdateRegistryRole (void);
+
     void StartListeningLocal (void);	// Called from StartApplication()
     void StopListeningLocal (void);	// Called from StopApplication()
 
@@ -157,11 +230,31 @@ private:
 
 
     //!< Receive locally
+    /**
+     * \brief Handler of a received message, selected by its V2vClusterTypeHeader
+     */
+    typedef void (V2vAffinityAlgorithmClient::*MessageHandler) (Ptr<Packet> packet, const Address &from);
+
     /**
      * \brief Handle a packet received by the application
      * \param socket the receiving socket
      */
     void HandleRead (Ptr<Socket> socket);
+
+    /**
+     * \brief Handle a received V2vAffinityHelloHeader
+     * \param packet the packet, without its V2vClusterTypeHeader
+     * \param from the sender address
+     */
+    void HandleHello (Ptr<Packet> packet, const Address &from);
+
+    /**
+     * \brief Handle a received V2vAffinityRespAvailHeader
+     * \param packet the packet, without its V2vClusterTypeHeader
+     * \param from the sender address
+     */
+    void HandleRespAvail (Ptr<Packet> packet, const Address &from);
+
     /**
      * \brief Handle an incoming connection
      * \param socket the incoming connection socket
@@ -225,9 +318,9 @@ private:
 
     /**
      * @brief CreateRespAvailList
-     * @return an AffinitySubStructure list of elements
+     * @return an AffinitySubStructure array of elements
      */
-    std::list<V2vClusterSap::AffinitySubStructure> CreateRespAvailList(void);
+    std::vector<V2vClusterSap::AffinitySubStructure> CreateRespAvailList(void);
 
     /**
      * @brief CreateNeighbor
@@ -271,10 +364,45 @@ private:
     void ChangeState (V2vClusterSap::AffinityNodeState currentState);
 
     /**
-     * @brief MaintenanceTasks
+     * @brief Remove the neighbors not heard for 1.5s, visiting only the
+     * entries whose expiry time has passed
      */
     void PurgeNeighbours (void);
 
+    /**
+     * @brief Send a control message, on the CCH when the node has a
+     * V2vChannelScheduler
+     * @param socket the socket of the message
+     * @param packet the message
+     */
+    void SendControl (Ptr<Socket> socket, Ptr<Packet> packet);
+
+    /**
+     * @brief GetTdmaOffset
+     * @return the offset of the node in the TDMA frame [s], VehicleTdmaSlot
+     * or the offset of the hashed slot
+     */
+    double GetTdmaOffset (void) const;
+
+    /**
+     * @brief GetTdmaFrameSlots
+     * @return the number of slots of the TDMA frame, MaxUes or FrameSlots
+     */
+    uint32_t GetTdmaFrameSlots (void) const;
+
+    /**
+     * @brief Restore the state written by SaveState and schedule the
+     * pending events again
+     * @param reader the snapshot record of the node
+     */
+    void LoadState (V2vSnapshotReader &reader);
+
+    /**
+     * @brief The neighbors within m_neighborRange (all of them if 0)
+     * @return their storage indexes in m_neighborMap
+     */
+    const std::vector<uint32_t>& CollectNeighbors (void);
+
     /**
      * @brief CIMaintenanceTasks
      */
@@ -285,6 +413,8 @@ private:
      */
     void PeriodicMaintenanceTasks(void);
 
+    /* Message dispatch */
+    MessageHandler m_messageHandlers[V2vClusterSap::MESSAGE_TYPES];   //!< handlers indexed by message type
 
     /* Receive Socket */
     TypeId m_tidListening;          		//!< Protocol TypeId
@@ -296,6 +426,7 @@ private:
     TypeId m_tid;          					//!< Type of the socket used
     Address m_peer;        	 				//!< Peer address
     EventId m_sendEvent;    				//!< Event id of pending "send packet" event
+    EventId m_acquireEvent;                 //!< Event id of pending "acquire mobility info" event
     Ptr<Socket> m_socket;       			//!< Associated socket
     uint32_t m_sentCounter; 				//!< Counter for sent packets
 
@@ -304,6 +435,10 @@ private:
     uint32_t m_maxUes;                      //!< maximun number of ues
     double m_minimumTdmaSlot;               //!< the minimum tdma slot
     double m_vehicleTdmaSlot;               //!< the timeslot for the node to schedule transmission
+    V2vSlotAllocator::Scheme m_slotScheme;  //!< fixed or hashed TDMA offsets
+    uint32_t m_frameSlots;                  //!< slots of a frame of the hashed scheme
+    V2vSlotAllocator m_slots;               //!< slot reservation of the hashed scheme
+    Ptr<V2vChannelScheduler> m_scheduler;   //!< channel access of the node, 0 for a single channel
     double m_trainingPeriod;
 
     /* Clustering Params */
@@ -311,10 +446,19 @@ private:
     double m_lamda;
     uint32_t m_CIperiod;
     double m_selfSimilarity;
+    bool m_registered;                      //!< registered in V2vClusterRegistry
+    V2vClusterSap::NovelNodeDegree m_registeredRole; //!< role last reported to V2vClusterRegistry
+    std::string m_snapshot;                 //!< snapshot record to resume from
     Ptr<MobilityModel> m_mobilityModel;
     V2vClusterSap::AffinityNodeState m_nodeState;
     V2vClusterSap::AffinityCurrentInfo m_currentInfo;
-    std::map<uint64_t, V2vClusterSap::AffinityNeighbors> m_neighborMap; //!< Neighbor Map
+    V2vNeighborTable<V2vClusterSap::AffinityNeighbors> m_neighborMap; //!< Neighbor Map
+    double m_neighborRange;                 //!< radius of the neighbor scans, 0 for all
+    double m_gridCellSize;                  //!< side of a neighbor grid cell, 0 for m_neighborRange
+    std::vector<uint32_t> m_neighborScan;   //!< scratch buffer of the neighbor scans
+    V2vTimerWheel m_neighborExpiry;         //!< expiry time of each m_neighborMap entry
+    std::vector<uint64_t> m_expired;        //!< scratch buffer of the expired neighbors
+    V2vAffinityPropagation m_propagation;   //!< Responsibility/availability kernel
 
     /* Traces */
     TracedCallback<Ptr<const Packet> > m_txTrace;
@@ -324,10 +468,10 @@ private:
     bool m_formationDelayBoolean;
     uint64_t m_startFormationDelay;
     uint64_t m_stopFormationDelay;
-    std::vector<uint64_t> m_formationDelayVector;
+    V2vStatisticsAccumulator m_formationDelay;
 
     /* Average Number of members per cluster */
-    std::vector<uint64_t> m_clusterMembers;
+    V2vStatisticsAccumulator m_clusterMembers;
 
     /* Number of Cluster Changes */
     uint64_t m_clusterChanges;
@@ -345,13 +489,13 @@ private:
     bool m_chDurationBoolean;
     uint64_t m_startChDuration;
     uint64_t m_stopChDuration;
-    std::vector<uint64_t> m_chDurationVector;
+    V2vStatisticsAccumulator m_chDuration;
 
     /* Cluster Member duration metrics */
     bool m_cmDurationBoolean;
     uint64_t m_startCmDuration;
     uint64_t m_stopCmDuration;
-    std::vector<uint64_t> m_cmDurationVector;
+    V2vStatisticsAccumulator m_cmDuration;
 
     uint64_t m_previousIndex;
 
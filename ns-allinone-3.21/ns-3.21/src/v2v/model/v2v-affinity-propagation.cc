@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include <algorithm>
+#include "ns3/assert.h"
+#include "v2v-affinity-propagation.h"
+
+namespace ns3 {
+
+V2vAffinityPropagation::V2vAffinityPropagation (){
+}
+
+void
+V2vAffinityPropagation::Clear (void){
+    m_similarity.clear ();
+    m_availabilityReceived.clear ();
+    m_responsibilityReceived.clear ();
+    m_responsibilitySent.clear ();
+    m_availabilitySent.clear ();
+    m_positiveResponsibility.clear ();
+}
+
+uint32_t
+V2vAffinityPropagation::GetSize (void) const {
+    return m_similarity.size ();
+}
+
+uint32_t
+V2vAffinityPropagation::Add (double similarity, double availabilityReceived, double responsibilityReceived,
+                             double responsibilitySent, double availabilitySent){
+    m_similarity.push_back (similarity);
+    m_availabilityReceived.push_back (availabilityReceived);
+    m_responsibilityReceived.push_back (responsibilityReceived);
+    m_responsibilitySent.push_back (responsibilitySent);
+    m_availabilitySent.push_back (availabilitySent);
+    return m_similarity.size () - 1;
+}
+
+void
+V2vAffinityPropagation::Update (double lamda, double selfSimilarity, double &selfResp, double &selfAvail){
+
+    uint32_t n = m_similarity.size ();
+    m_positiveResponsibility.resize (n);
+
+    const double *s = n ? &m_similarity[0] : 0;
+    const double *aR = n ? &m_availabilityReceived[0] : 0;
+    const double *rR = n ? &m_responsibilityReceived[0] : 0;
+    double *rS = n ? &m_responsibilitySent[0] : 0;
+    double *aS = n ? &m_availabilitySent[0] : 0;
+    double *rP = n ? &m_positiveResponsibility[0] : 0;
+
+    // max(similarity + availability received) and sum of positive responsibilities
+    double maxResp = -1e100;
+    double sumAvail = 0.0;
+    for (uint32_t i = 0; i < n; ++i){
+        maxResp = std::max (maxResp, s[i] + aR[i]);
+        rP[i] = std::max (0.0, rR[i]);
+        sumAvail += rP[i];
+    }
+
+    selfResp = ((1-lamda)*(selfSimilarity - maxResp)) + (lamda*selfResp);
+    selfAvail = ((1-lamda)*(sumAvail)) + (lamda*selfAvail);
+
+    for (uint32_t i = 0; i < n; ++i){
+        rS[i] = ((1-lamda)*(s[i] - maxResp)) + (lamda*rS[i]);
+        aS[i] = (1-lamda)*std::min (0.0, rR[i] + (sumAvail - rP[i])) + (lamda*aS[i]);
+    }
+}
+
+double
+V2vAffinityPropagation::GetResponsibilitySent (uint32_t index) const {
+    NS_ASSERT (index < m_responsibilitySent.size ());
+    return m_responsibilitySent[index];
+}
+
+double
+V2vAffinityPropagation::GetAvailabilitySent (uint32_t index) const {
+    NS_ASSERT (index < m_availabilitySent.size ());
+    return m_availabilitySent[index];
+}
+
+} // namespace ns3
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_AFFINITY_PROPAGATION_H
+#define V2V_AFFINITY_PROPAGATION_H
+
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vAffinityPropagation
+ * \brief Responsibility/availability update of V2vAffinityAlgorithmClient.
+ *
+ * The neighbor state is kept as a structure of arrays, one contiguous
+ * array per quantity, so every pass is a plain indexed loop without
+ * branches that the compiler can vectorize.
+ *
+ * The responsibility sent to a neighbor uses the maximum of
+ * (similarity + availability received) over all the neighbors, and the
+ * availability sent uses the sum of the positive responsibilities
+ * received from all the other neighbors. Both are computed once with a
+ * max and a sum reduction, making an iteration O(n) instead of O(n^2).
+ *
+ * The buffers are kept between iterations, so a Clear () followed by
+ * Add () calls does not allocate once the neighborhood size is stable.
+ */
+class V2vAffinityPropagation {
+public:
+
+    V2vAffinityPropagation ();
+
+    /**
+     * \brief Remove all the neighbors, keeping the buffers.
+     */
+    void Clear (void);
+
+    /**
+     * \return the number of neighbors
+     */
+    uint32_t GetSize (void) const;
+
+    /**
+     * \brief Append a neighbor.
+     * \param similarity the similarity with the neighbor
+     * \param availabilityReceived the availability received from the neighbor
+     * \param responsibilityReceived the responsibility received from the neighbor
+     * \param responsibilitySent the previous responsibility sent to the neighbor
+     * \param availabilitySent the previous availability sent to the neighbor
+     * \return the index of the neighbor
+     */
+    uint32_t Add (double similarity, double availabilityReceived, double responsibilityReceived,
+                  double responsibilitySent, double availabilitySent);
+
+    /**
+     * \brief Run one damped iteration over all the neighbors.
+     * \param lamda the damping factor
+     * \param selfSimilarity the self similarity (exemplar preference)
+     * \param selfResp the self responsibility, updated in place
+     * \param selfAvail the self availability, updated in place
+     */
+    void Update (double lamda, double selfSimilarity, double &selfResp, double &selfAvail);
+
+    /**
+     * \param index the neighbor index
+     * \return the responsibility to send to the neighbor
+     */
+    double GetResponsibilitySent (uint32_t index) const;
+
+    /**
+     * \param index the neighbor index
+     * \return the availability to send to the neighbor
+     */
+    double GetAvailabilitySent (uint32_t index) const;
+
+private:
+
+    std::vector<double> m_similarity;
+    std::vector<double> m_availabilityReceived;
+    std::vector<double> m_responsibilityReceived;
+    std::vector<double> m_responsibilitySent;
+    std::vector<double> m_availabilitySent;
+    std::vector<double> m_positiveResponsibility;   //!< scratch: max(0, responsibility received)
+};
+
+} // namespace ns3
+
+#endif // V2V_AFFINITY_PROPAGATION_H
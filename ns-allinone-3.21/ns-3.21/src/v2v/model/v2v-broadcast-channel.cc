@@ -0,0 +1,275 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/mobility-model.h"
+#include "v2v-broadcast-channel.h"
+#include "v2v-broadcast-net-device.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vBroadcastChannel");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vBroadcastChannel);
+
+TypeId V2vBroadcastChannel::GetTypeId(void) {
+    static TypeId tid =
+            TypeId("ns3::V2vBroadcastChannel").SetParent<Channel>()
+            .AddConstructor<V2vBroadcastChannel>()
+            .AddAttribute("ReceptionModel",
+                    "How the reception range is derived",
+                    EnumValue(V2vBroadcastChannel::UNIT_DISK),
+                    MakeEnumAccessor(&V2vBroadcastChannel::m_model),
+                    MakeEnumChecker(V2vBroadcastChannel::UNIT_DISK, "UnitDisk",
+                                    V2vBroadcastChannel::LOG_DISTANCE, "LogDistance"))
+            .AddAttribute("Range",
+                    "Reception range of the unit disk model (m)", DoubleValue(500.0),
+                    MakeDoubleAccessor(&V2vBroadcastChannel::m_range),
+                    MakeDoubleChecker<double>(0.0))
+            .AddAttribute("TxPower",
+                    "Transmission power of the log-distance model (dBm)", DoubleValue(16.0206),
+                    MakeDoubleAccessor(&V2vBroadcastChannel::m_txPower),
+                    MakeDoubleChecker<double>())
+            .AddAttribute("TxGain",
+                    "Transmission gain of the log-distance model (dB)", DoubleValue(1.0),
+                    MakeDoubleAccessor(&V2vBroadcastChannel::m_txGain),
+                    MakeDoubleChecker<double>())
+            .AddAttribute("RxGain",
+                    "Reception gain of the log-distance model (dB)", DoubleValue(1.0),
+                    MakeDoubleAccessor(&V2vBroadcastChannel::m_rxGain),
+                    MakeDoubleChecker<double>())
+            .AddAttribute("RxSensitivity",
+                    "Weakest received power of the log-distance model (dBm)", DoubleValue(-96.0),
+                    MakeDoubleAccessor(&V2vBroadcastChannel::m_rxSensitivity),
+                    MakeDoubleChecker<double>())
+            .AddAttribute("PathLossExponent",
+                    "Path loss exponent of the log-distance model", DoubleValue(3.0),
+                    MakeDoubleAccessor(&V2vBroadcastChannel::m_exponent),
+                    MakeDoubleChecker<double>(0.1))
+            .AddAttribute("ReferenceDistance",
+                    "Reference distance of the log-distance model (m)", DoubleValue(1.0),
+                    MakeDoubleAccessor(&V2vBroadcastChannel::m_referenceDistance),
+                    MakeDoubleChecker<double>(0.0))
+            .AddAttribute("ReferenceLoss",
+                    "Path loss at the reference distance of the log-distance model (dB)", DoubleValue(46.6777),
+                    MakeDoubleAccessor(&V2vBroadcastChannel::m_referenceLoss),
+                    MakeDoubleChecker<double>())
+            .AddAttribute("LossProbability",
+                    "Probability that a receiver in range misses a frame", DoubleValue(0.0),
+                    MakeDoubleAccessor(&V2vBroadcastChannel::m_lossProbability),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("Delay",
+                    "Propagation and access delay added to every frame", TimeValue(MicroSeconds(0)),
+                    MakeTimeAccessor(&V2vBroadcastChannel::m_delay),
+                    MakeTimeChecker())
+            .AddAttribute("DataRate",
+                    "Rate of the frame transmission time, 0 for none", DataRateValue(DataRate("6Mbps")),
+                    MakeDataRateAccessor(&V2vBroadcastChannel::m_dataRate),
+                    MakeDataRateChecker())
+            .AddAttribute("MaxSpeed",
+                    "Highest node speed assumed between grid refreshes (m/s)", DoubleValue(50.0),
+                    MakeDoubleAccessor(&V2vBroadcastChannel::m_maxSpeed),
+                    MakeDoubleChecker<double>(0.0))
+            .AddAttribute("GridRefresh",
+                    "Period of the device positions refresh in the spatial grid", TimeValue(MilliSeconds(100)),
+                    MakeTimeAccessor(&V2vBroadcastChannel::m_gridRefresh),
+                    MakeTimeChecker());
+    return tid;
+}
+
+V2vBroadcastChannel::V2vBroadcastChannel (){
+    NS_LOG_FUNCTION (this);
+    m_nPartitions = 0;
+}
+
+V2vBroadcastChannel::~V2vBroadcastChannel (){
+    NS_LOG_FUNCTION (this);
+}
+
+void
+V2vBroadcastChannel::DoDispose (void){
+    NS_LOG_FUNCTION (this);
+    m_devices.clear ();
+    m_partitions.clear ();
+    m_nPartitions = 0;
+    Channel::DoDispose ();
+}
+
+void
+V2vBroadcastChannel::Add (Ptr<V2vBroadcastNetDevice> device){
+    NS_LOG_FUNCTION (this << device);
+    Ptr<Node> node = device->GetNode ();
+    NS_ASSERT_MSG (node != 0, "V2vBroadcastChannel: the device needs its node before the channel");
+    uint32_t systemId = node->GetSystemId ();
+    if(systemId >= m_partitions.size ()){
+        m_partitions.resize (systemId + 1);
+    }
+    Partition &partition = m_partitions[systemId];
+    if(partition.devices.empty ()){
+        partition.context = node->GetId ();
+        partition.gridValid = false;
+        partition.random = CreateObject<UniformRandomVariable> ();
+        m_nPartitions++;
+    }
+    partition.devices.push_back (m_devices.size ());
+    partition.gridValid = false;
+    m_devices.push_back (device);
+}
+
+uint32_t
+V2vBroadcastChannel::GetNDevices (void) const {
+    return m_devices.size ();
+}
+
+Ptr<NetDevice>
+V2vBroadcastChannel::GetDevice (uint32_t i) const {
+    return m_devices[i];
+}
+
+double
+V2vBroadcastChannel::GetRange (void) const {
+    if(m_model == UNIT_DISK){
+        return m_range;
+    }
+    // rx = tx + gains - L0 - 10 n log10 (d / d0) >= sensitivity
+    double budget = m_txPower + m_txGain + m_rxGain - m_rxSensitivity - m_referenceLoss;
+    if(budget < 0){
+        return m_referenceDistance;
+    }
+    return m_referenceDistance * std::pow (10.0, budget / (10.0 * m_exponent));
+}
+
+int64_t
+V2vBroadcastChannel::AssignStreams (int64_t stream){
+    int64_t streams = 0;
+    for(uint32_t i = 0; i < m_partitions.size (); ++i){
+        if(!m_partitions[i].devices.empty ()){
+            m_partitions[i].random->SetStream (stream + streams);
+            streams++;
+        }
+    }
+    return streams;
+}
+
+Vector
+V2vBroadcastChannel::GetPosition (Ptr<V2vBroadcastNetDevice> device) const {
+    Ptr<MobilityModel> mobility = device->GetNode ()->GetObject<MobilityModel> ();
+    NS_ASSERT_MSG (mobility != 0, "V2vBroadcastChannel needs a MobilityModel on every node");
+    return mobility->GetPosition ();
+}
+
+void
+V2vBroadcastChannel::RefreshGrid (Partition &partition){
+    NS_LOG_FUNCTION (this);
+    double range = GetRange ();
+    if(partition.grid.GetCellSize () != range && range > 0){
+        partition.grid.SetCellSize (range);
+    }
+    Vector velocity;
+    for(uint32_t i = 0; i < partition.devices.size (); ++i){
+        uint32_t device = partition.devices[i];
+        partition.grid.Insert (device, GetPosition (m_devices[device]), velocity, device);
+    }
+    partition.lastRefresh = Simulator::Now ();
+    partition.gridValid = true;
+}
+
+void
+V2vBroadcastChannel::Send (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from,
+                           Ptr<V2vBroadcastNetDevice> sender){
+    NS_LOG_FUNCTION (this << packet << protocol << to << from << sender);
+
+    Frame frame;
+    frame.packet = packet;
+    frame.protocol = protocol;
+    frame.to = to;
+    frame.from = from;
+    frame.sender = sender;
+    frame.position = GetPosition (sender);
+    frame.txTime = Seconds (0);
+    if(m_dataRate.GetBitRate () > 0){
+        frame.txTime = Seconds (m_dataRate.CalculateTxTime (packet->GetSize ()));
+    }
+
+    if(m_nPartitions == 1){
+        // all the receivers are read now, in the order of the grid
+        frame.txTime += m_delay;
+        Deliver (sender->GetNode ()->GetSystemId (), frame, Seconds (0));
+        return;
+    }
+    for(uint32_t i = 0; i < m_partitions.size (); ++i){
+        if(m_partitions[i].devices.empty ()){
+            continue;
+        }
+        frame.packet = packet->Copy ();
+        Simulator::ScheduleWithContext (m_partitions[i].context, m_delay,
+                                        &V2vBroadcastChannel::DeliverPartition, this, i, frame);
+    }
+}
+
+void
+V2vBroadcastChannel::DeliverPartition (uint32_t partition, Frame frame){
+    NS_LOG_FUNCTION (this << partition);
+    Deliver (partition, frame, m_delay);
+}
+
+void
+V2vBroadcastChannel::Deliver (uint32_t index, const Frame &frame, Time age){
+    Partition &partition = m_partitions[index];
+    if(!partition.gridValid || Simulator::Now () - partition.lastRefresh >= m_gridRefresh){
+        RefreshGrid (partition);
+    }
+
+    // the receivers moved at most MaxSpeed since the refresh and the transmission
+    double range = GetRange ();
+    double drift = m_maxSpeed * (Simulator::Now () - partition.lastRefresh + age).GetSeconds ();
+
+    partition.grid.FindInRange (frame.position, range + drift, partition.candidates);
+    for(uint32_t k = 0; k < partition.candidates.size (); ++k){
+        Ptr<V2vBroadcastNetDevice> receiver = m_devices[partition.grid.GetEntry (partition.candidates[k]).value];
+        if(receiver == frame.sender){
+            continue;
+        }
+        Vector position = GetPosition (receiver);
+        if(age.IsStrictlyPositive ()){
+            Vector velocity = receiver->GetNode ()->GetObject<MobilityModel> ()->GetVelocity ();
+            double t = age.GetSeconds ();
+            position = Vector (position.x - velocity.x * t, position.y - velocity.y * t, position.z - velocity.z * t);
+        }
+        if(CalculateDistance (frame.position, position) > range){
+            continue;
+        }
+        if(m_lossProbability > 0 && partition.random->GetValue () < m_lossProbability){
+            NS_LOG_LOGIC ("Frame lost on the way to " << receiver->GetNode ()->GetId ());
+            continue;
+        }
+        Simulator::ScheduleWithContext (receiver->GetNode ()->GetId (), frame.txTime,
+                                        &V2vBroadcastNetDevice::Receive, receiver,
+                                        frame.packet->Copy (), frame.protocol, frame.to, frame.from);
+    }
+}
+
+} // namespace ns3
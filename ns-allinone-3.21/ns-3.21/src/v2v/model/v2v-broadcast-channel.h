@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_BROADCAST_CHANNEL_H
+#define V2V_BROADCAST_CHANNEL_H
+
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/channel.h"
+#include "ns3/data-rate.h"
+#include "ns3/mac48-address.h"
+#include "ns3/random-variable-stream.h"
+#include "v2v-neighbor-table.h"
+
+namespace ns3 {
+
+class Packet;
+class V2vBroadcastNetDevice;
+
+/**
+ * \ingroup v2v
+ * \class V2vBroadcastChannel
+ * \brief Abstract broadcast medium for clustering studies.
+ *
+ * A frame sent by a device is delivered to every other device within the
+ * reception range of the sender, each copy being lost independently with
+ * LossProbability, after Delay plus the frame transmission time at
+ * DataRate. There is no PHY, interference, carrier sense or MAC
+ * retransmission.
+ *
+ * With the UNIT_DISK model the range is the Range attribute. With the
+ * LOG_DISTANCE model it is the distance where the received power of the
+ * log-distance path loss (the YansWifiChannelHelper default) drops under
+ * RxSensitivity, so the Tx power and gains of a Wifi setup can be reused.
+ *
+ * The devices are kept in a V2vNeighborTable spatial grid that is
+ * refreshed every GridRefresh. Between refreshes a node moves at most
+ * MaxSpeed, so a transmission only checks the devices within the range
+ * plus this drift of the sender.
+ *
+ * When the nodes of the devices have several system ids, e.g. to run them
+ * in the partitions of the MultithreadedSimulatorImpl, the devices of each
+ * system id have their own grid and loss random variable, and a frame is
+ * handed to each system id by an event scheduled Delay after the
+ * transmission, on one of its nodes, with the position of the sender. That
+ * event finds the receivers in range, their positions at the transmission
+ * being extrapolated back with their velocity, and schedules their
+ * receptions after the frame transmission time. The mobility and devices
+ * of the receivers are thus only read by the events of their own system
+ * id, and Delay is the lookahead of the channel. The receptions are the
+ * same with every simulator implementation.
+ */
+class V2vBroadcastChannel : public Channel {
+public:
+
+    enum ReceptionModel {
+        UNIT_DISK = 0,
+        LOG_DISTANCE
+    };
+
+    static TypeId GetTypeId (void);
+
+    V2vBroadcastChannel ();
+    virtual ~V2vBroadcastChannel ();
+
+    /**
+     * \param device the device to attach to the channel
+     */
+    void Add (Ptr<V2vBroadcastNetDevice> device);
+
+    /**
+     * \brief Deliver a frame to the devices in range of the sender.
+     * \param packet the frame
+     * \param protocol the protocol number of the frame
+     * \param to the destination address
+     * \param from the source address
+     * \param sender the transmitting device
+     */
+    void Send (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from,
+               Ptr<V2vBroadcastNetDevice> sender);
+
+    /**
+     * \return the reception range (m)
+     */
+    double GetRange (void) const;
+
+    /**
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams (int64_t stream);
+
+    virtual uint32_t GetNDevices (void) const;
+    virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+
+protected:
+
+    virtual void DoDispose (void);
+
+private:
+
+    /**
+     * \brief The devices of the nodes of a system id.
+     */
+    struct Partition {
+        uint32_t context;                           //!< node of the frame events of the system id
+        std::vector<uint32_t> devices;              //!< indices of the devices in m_devices
+        V2vNeighborTable<uint32_t> grid;            //!< device positions at the last refresh
+        Time lastRefresh;
+        bool gridValid;
+        std::vector<uint32_t> candidates;           //!< scratch buffer of the grid queries
+        Ptr<UniformRandomVariable> random;
+    };
+
+    /**
+     * \brief A frame handed to the devices of a system id.
+     */
+    struct Frame {
+        Ptr<Packet> packet;
+        uint16_t protocol;
+        Mac48Address to;
+        Mac48Address from;
+        Ptr<V2vBroadcastNetDevice> sender;
+        Vector position;                            //!< position of the sender at the transmission
+        Time txTime;                                //!< delay of the receptions after the event
+    };
+
+    void RefreshGrid (Partition &partition);
+    Vector GetPosition (Ptr<V2vBroadcastNetDevice> device) const;
+    /**
+     * \brief Schedule the receptions of the devices of a system id in range
+     * of the sender.
+     * \param partition the system id
+     * \param frame the frame
+     * \param age the time elapsed since the transmission
+     */
+    void Deliver (uint32_t partition, const Frame &frame, Time age);
+    /**
+     * \brief The event handing a frame to the devices of a system id.
+     */
+    void DeliverPartition (uint32_t partition, Frame frame);
+
+    std::vector<Ptr<V2vBroadcastNetDevice> > m_devices;
+    std::vector<Partition> m_partitions;            //!< by system id
+    uint32_t m_nPartitions;                         //!< system ids with devices
+
+    ReceptionModel m_model;
+    double m_range;
+    double m_txPower;
+    double m_txGain;
+    double m_rxGain;
+    double m_rxSensitivity;
+    double m_exponent;
+    double m_referenceDistance;
+    double m_referenceLoss;
+    double m_lossProbability;
+    Time m_delay;
+    DataRate m_dataRate;
+    double m_maxSpeed;
+    Time m_gridRefresh;
+};
+
+} // namespace ns3
+
+#endif // V2V_BROADCAST_CHANNEL_H
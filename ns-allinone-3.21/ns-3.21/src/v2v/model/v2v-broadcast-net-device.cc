@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/trace-source-accessor.h"
+#include "v2v-broadcast-channel.h"
+#include "v2v-broadcast-net-device.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vBroadcastNetDevice");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vBroadcastNetDevice);
+
+TypeId V2vBroadcastNetDevice::GetTypeId(void) {
+    static TypeId tid =
+            TypeId("ns3::V2vBroadcastNetDevice").SetParent<NetDevice>()
+            .AddConstructor<V2vBroadcastNetDevice>()
+            .AddAttribute("Mtu",
+                    "The MAC-level Maximum Transmission Unit", UintegerValue(2296),
+                    MakeUintegerAccessor(&V2vBroadcastNetDevice::SetMtu, &V2vBroadcastNetDevice::GetMtu),
+                    MakeUintegerChecker<uint16_t>(1, 2296))
+            .AddTraceSource("MacTx", "A packet has been handed to the channel",
+                    MakeTraceSourceAccessor(&V2vBroadcastNetDevice::m_macTxTrace))
+            .AddTraceSource("MacRx", "A packet has been received from the channel",
+                    MakeTraceSourceAccessor(&V2vBroadcastNetDevice::m_macRxTrace));
+    return tid;
+}
+
+V2vBroadcastNetDevice::V2vBroadcastNetDevice (){
+    NS_LOG_FUNCTION (this);
+    m_mtu = 2296;
+    m_ifIndex = 0;
+    m_linkUp = false;
+}
+
+V2vBroadcastNetDevice::~V2vBroadcastNetDevice (){
+    NS_LOG_FUNCTION (this);
+}
+
+void
+V2vBroadcastNetDevice::DoDispose (void){
+    NS_LOG_FUNCTION (this);
+    m_channel = 0;
+    m_node = 0;
+    m_rxCallback.Nullify ();
+    m_promiscCallback.Nullify ();
+    NetDevice::DoDispose ();
+}
+
+void
+V2vBroadcastNetDevice::SetChannel (Ptr<V2vBroadcastChannel> channel){
+    NS_LOG_FUNCTION (this << channel);
+    m_channel = channel;
+    m_channel->Add (this);
+    m_linkUp = true;
+    m_linkChangeCallbacks ();
+}
+
+void
+V2vBroadcastNetDevice::Receive (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from){
+    NS_LOG_FUNCTION (this << packet << protocol << to << from);
+
+    NetDevice::PacketType packetType;
+    if(to == m_address){
+        packetType = NetDevice::PACKET_HOST;
+    }
+    else if(to.IsBroadcast ()){
+        packetType = NetDevice::PACKET_BROADCAST;
+    }
+    else if(to.IsGroup ()){
+        packetType = NetDevice::PACKET_MULTICAST;
+    }
+    else{
+        packetType = NetDevice::PACKET_OTHERHOST;
+    }
+
+    m_macRxTrace (packet);
+    if(packetType != NetDevice::PACKET_OTHERHOST && !m_rxCallback.IsNull ()){
+        m_rxCallback (this, packet, protocol, from);
+    }
+    if(!m_promiscCallback.IsNull ()){
+        m_promiscCallback (this, packet, protocol, from, to, packetType);
+    }
+}
+
+void
+V2vBroadcastNetDevice::SetIfIndex (const uint32_t index){
+    m_ifIndex = index;
+}
+
+uint32_t
+V2vBroadcastNetDevice::GetIfIndex (void) const {
+    return m_ifIndex;
+}
+
+Ptr<Channel>
+V2vBroadcastNetDevice::GetChannel (void) const {
+    return m_channel;
+}
+
+void
+V2vBroadcastNetDevice::SetAddress (Address address){
+    m_address = Mac48Address::ConvertFrom (address);
+}
+
+Address
+V2vBroadcastNetDevice::GetAddress (void) const {
+    return m_address;
+}
+
+bool
+V2vBroadcastNetDevice::SetMtu (const uint16_t mtu){
+    m_mtu = mtu;
+    return true;
+}
+
+uint16_t
+V2vBroadcastNetDevice::GetMtu (void) const {
+    return m_mtu;
+}
+
+bool
+V2vBroadcastNetDevice::IsLinkUp (void) const {
+    return m_linkUp;
+}
+
+void
+V2vBroadcastNetDevice::AddLinkChangeCallback (Callback<void> callback){
+    m_linkChangeCallbacks.ConnectWithoutContext (callback);
+}
+
+bool
+V2vBroadcastNetDevice::IsBroadcast (void) const {
+    return true;
+}
+
+Address
+V2vBroadcastNetDevice::GetBroadcast (void) const {
+    return Mac48Address::GetBroadcast ();
+}
+
+bool
+V2vBroadcastNetDevice::IsMulticast (void) const {
+    return true;
+}
+
+Address
+V2vBroadcastNetDevice::GetMulticast (Ipv4Address multicastGroup) const {
+    return Mac48Address::GetMulticast (multicastGroup);
+}
+
+Address
+V2vBroadcastNetDevice::GetMulticast (Ipv6Address addr) const {
+    return Mac48Address::GetMulticast (addr);
+}
+
+bool
+V2vBroadcastNetDevice::IsPointToPoint (void) const {
+    return false;
+}
+
+bool
+V2vBroadcastNetDevice::IsBridge (void) const {
+    return false;
+}
+
+bool
+V2vBroadcastNetDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber){
+    return SendFrom (packet, m_address, dest, protocolNumber);
+}
+
+bool
+V2vBroadcastNetDevice::SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber){
+    NS_LOG_FUNCTION (this << packet << source << dest << protocolNumber);
+    if(m_channel == 0 || packet->GetSize () > GetMtu ()){
+        return false;
+    }
+    m_macTxTrace (packet);
+    m_channel->Send (packet, protocolNumber, Mac48Address::ConvertFrom (dest),
+                     Mac48Address::ConvertFrom (source), this);
+    return true;
+}
+
+Ptr<Node>
+V2vBroadcastNetDevice::GetNode (void) const {
+    return m_node;
+}
+
+void
+V2vBroadcastNetDevice::SetNode (Ptr<Node> node){
+    m_node = node;
+}
+
+bool
+V2vBroadcastNetDevice::NeedsArp (void) const {
+    return false;
+}
+
+void
+V2vBroadcastNetDevice::SetReceiveCallback (NetDevice::ReceiveCallback cb){
+    m_rxCallback = cb;
+}
+
+void
+V2vBroadcastNetDevice::SetPromiscReceiveCallback (PromiscReceiveCallback cb){
+    m_promiscCallback = cb;
+}
+
+bool
+V2vBroadcastNetDevice::SupportsSendFrom (void) const {
+    return true;
+}
+
+} // namespace ns3
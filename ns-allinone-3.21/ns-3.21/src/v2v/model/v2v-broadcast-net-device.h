@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_BROADCAST_NET_DEVICE_H
+#define V2V_BROADCAST_NET_DEVICE_H
+
+#include <stdint.h>
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+class V2vBroadcastChannel;
+
+/**
+ * \ingroup v2v
+ * \class V2vBroadcastNetDevice
+ * \brief NetDevice of a V2vBroadcastChannel.
+ *
+ * The device does not need ARP: every frame goes to the broadcast
+ * address of the channel and the receivers filter on the IP destination,
+ * which is what the clustering clients use anyway. Frames are handed to
+ * the channel immediately, without a transmit queue.
+ */
+class V2vBroadcastNetDevice : public NetDevice {
+public:
+
+    static TypeId GetTypeId (void);
+
+    V2vBroadcastNetDevice ();
+    virtual ~V2vBroadcastNetDevice ();
+
+    /**
+     * \param channel the channel the device is attached to
+     */
+    void SetChannel (Ptr<V2vBroadcastChannel> channel);
+
+    /**
+     * \brief Called by the channel when a frame reaches the device.
+     */
+    void Receive (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from);
+
+    // inherited from NetDevice
+    virtual void SetIfIndex (const uint32_t index);
+    virtual uint32_t GetIfIndex (void) const;
+    virtual Ptr<Channel> GetChannel (void) const;
+    virtual void SetAddress (Address address);
+    virtual Address GetAddress (void) const;
+    virtual bool SetMtu (const uint16_t mtu);
+    virtual uint16_t GetMtu (void) const;
+    virtual bool IsLinkUp (void) const;
+    virtual void AddLinkChangeCallback (Callback<void> callback);
+    virtual bool IsBroadcast (void) const;
+    virtual Address GetBroadcast (void) const;
+    virtual bool IsMulticast (void) const;
+    virtual Address GetMulticast (Ipv4Address multicastGroup) const;
+    virtual Address GetMulticast (Ipv6Address addr) const;
+    virtual bool IsPointToPoint (void) const;
+    virtual bool IsBridge (void) const;
+    virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
+    virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
+    virtual Ptr<Node> GetNode (void) const;
+    virtual void SetNode (Ptr<Node> node);
+    virtual bool NeedsArp (void) const;
+    virtual void SetReceiveCallback (NetDevice::ReceiveCallback cb);
+    virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
+    virtual bool SupportsSendFrom (void) const;
+
+protected:
+
+    virtual void DoDispose (void);
+
+private:
+
+    Ptr<V2vBroadcastChannel> m_channel;
+    Ptr<Node> m_node;
+    Mac48Address m_address;
+    uint16_t m_mtu;
+    uint32_t m_ifIndex;
+    bool m_linkUp;
+    NetDevice::ReceiveCallback m_rxCallback;
+    NetDevice::PromiscReceiveCallback m_promiscCallback;
+    TracedCallback<> m_linkChangeCallbacks;
+    TracedCallback<Ptr<const Packet> > m_macTxTrace;
+    TracedCallback<Ptr<const Packet> > m_macRxTrace;
+};
+
+} // namespace ns3
+
+#endif // V2V_BROADCAST_NET_DEVICE_H
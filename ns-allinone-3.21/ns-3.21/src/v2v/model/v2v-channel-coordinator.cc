@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "v2v-channel-coordinator.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vChannelCoordinator");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vChannelCoordinator);
+
+TypeId V2vChannelCoordinator::GetTypeId(void) {
+    static TypeId tid =
+            TypeId("ns3::V2vChannelCoordinator").SetParent<Object>()
+            .AddConstructor<V2vChannelCoordinator>()
+            .AddAttribute("CchInterval",
+                    "CCH interval of the alternating access", TimeValue(MilliSeconds(50)),
+                    MakeTimeAccessor(&V2vChannelCoordinator::m_cchi),
+                    MakeTimeChecker())
+            .AddAttribute("SchInterval",
+                    "SCH interval of the alternating access", TimeValue(MilliSeconds(50)),
+                    MakeTimeAccessor(&V2vChannelCoordinator::m_schi),
+                    MakeTimeChecker())
+            .AddAttribute("GuardInterval",
+                    "Channel switch time at the start of the CCH and SCH intervals", TimeValue(MilliSeconds(4)),
+                    MakeTimeAccessor(&V2vChannelCoordinator::m_gi),
+                    MakeTimeChecker());
+    return tid;
+}
+
+V2vChannelCoordinator::V2vChannelCoordinator (){
+    NS_LOG_FUNCTION (this);
+}
+
+V2vChannelCoordinator::~V2vChannelCoordinator (){
+    NS_LOG_FUNCTION (this);
+}
+
+Time
+V2vChannelCoordinator::GetCchInterval (void) const {
+    return m_cchi;
+}
+
+Time
+V2vChannelCoordinator::GetSchInterval (void) const {
+    return m_schi;
+}
+
+Time
+V2vChannelCoordinator::GetGuardInterval (void) const {
+    return m_gi;
+}
+
+Time
+V2vChannelCoordinator::GetSyncInterval (void) const {
+    return m_cchi + m_schi;
+}
+
+bool
+V2vChannelCoordinator::IsValidConfig (void) const {
+    return m_cchi > m_gi && m_schi > m_gi && !m_gi.IsNegative ();
+}
+
+Time
+V2vChannelCoordinator::GetIntervalTime (Time duration) const {
+    NS_ASSERT_MSG (IsValidConfig (), "Invalid CCH, SCH or guard interval");
+    int64_t sync = GetSyncInterval ().GetTimeStep ();
+    return TimeStep ((Simulator::Now () + duration).GetTimeStep () % sync);
+}
+
+bool
+V2vChannelCoordinator::IsCchInterval (Time duration) const {
+    return GetIntervalTime (duration) < m_cchi;
+}
+
+bool
+V2vChannelCoordinator::IsSchInterval (Time duration) const {
+    return !IsCchInterval (duration);
+}
+
+bool
+V2vChannelCoordinator::IsGuardInterval (Time duration) const {
+    Time position = GetIntervalTime (duration);
+    if(position >= m_cchi){
+        position -= m_cchi;
+    }
+    return position < m_gi;
+}
+
+Time
+V2vChannelCoordinator::NeedTimeToCchInterval (Time duration) const {
+    Time position = GetIntervalTime (duration);
+    if(position < m_cchi){
+        return Time (0);
+    }
+    return GetSyncInterval () - position;
+}
+
+Time
+V2vChannelCoordinator::NeedTimeToSchInterval (Time duration) const {
+    Time position = GetIntervalTime (duration);
+    if(position >= m_cchi){
+        return Time (0);
+    }
+    return m_cchi - position;
+}
+
+Time
+V2vChannelCoordinator::NeedTimeToCchAccess (Time duration) const {
+    Time position = GetIntervalTime (duration);
+    if(position < m_gi){
+        return m_gi - position;
+    }
+    if(position < m_cchi){
+        return Time (0);
+    }
+    return GetSyncInterval () - position + m_gi;
+}
+
+Time
+V2vChannelCoordinator::NeedTimeToSchAccess (Time duration) const {
+    Time position = GetIntervalTime (duration);
+    if(position < m_cchi + m_gi){
+        return m_cchi + m_gi - position;
+    }
+    return Time (0);
+}
+
+} // namespace ns3
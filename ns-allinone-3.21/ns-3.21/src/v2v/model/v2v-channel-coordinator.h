@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_CHANNEL_COORDINATOR_H
+#define V2V_CHANNEL_COORDINATOR_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vChannelCoordinator
+ * \brief CCH and SCH intervals of the IEEE 1609.4 alternating access.
+ *
+ * The sync interval, CchInterval followed by SchInterval, repeats from
+ * time 0, the simulated UTC every node is synchronized to. Each interval
+ * starts with GuardInterval, where nobody transmits while the radios
+ * switch channel.
+ *
+ * Every method answers for the time Now () + duration.
+ */
+class V2vChannelCoordinator : public Object {
+public:
+
+    static TypeId GetTypeId (void);
+
+    V2vChannelCoordinator ();
+    virtual ~V2vChannelCoordinator ();
+
+    Time GetCchInterval (void) const;
+    Time GetSchInterval (void) const;
+    Time GetGuardInterval (void) const;
+
+    /**
+     * \return the CCH plus SCH interval
+     */
+    Time GetSyncInterval (void) const;
+
+    /**
+     * \return true if both intervals are longer than the guard interval
+     */
+    bool IsValidConfig (void) const;
+
+    bool IsCchInterval (Time duration = Seconds (0.0)) const;
+    bool IsSchInterval (Time duration = Seconds (0.0)) const;
+    bool IsGuardInterval (Time duration = Seconds (0.0)) const;
+
+    /**
+     * \return the time before the next CCH interval, 0 within one
+     */
+    Time NeedTimeToCchInterval (Time duration = Seconds (0.0)) const;
+
+    /**
+     * \return the time before the next SCH interval, 0 within one
+     */
+    Time NeedTimeToSchInterval (Time duration = Seconds (0.0)) const;
+
+    /**
+     * \return the time before the CCH can be used, 0 within a CCH interval
+     * past its guard interval
+     */
+    Time NeedTimeToCchAccess (Time duration = Seconds (0.0)) const;
+
+    /**
+     * \return the time before the SCHs can be used, 0 within a SCH
+     * interval past its guard interval
+     */
+    Time NeedTimeToSchAccess (Time duration = Seconds (0.0)) const;
+
+private:
+
+    /**
+     * \return the position of Now () + duration in the sync interval
+     */
+    Time GetIntervalTime (Time duration) const;
+
+    Time m_cchi;            //!< CCH interval
+    Time m_schi;            //!< SCH interval
+    Time m_gi;              //!< guard interval
+};
+
+} // namespace ns3
+
+#endif // V2V_CHANNEL_COORDINATOR_H
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include "ns3/log.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "v2v-channel-scheduler.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vChannelScheduler");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vChannelScheduler);
+
+const uint32_t V2vChannelScheduler::CCH;
+
+TypeId V2vChannelScheduler::GetTypeId(void) {
+    static TypeId tid =
+            TypeId("ns3::V2vChannelScheduler").SetParent<Object>()
+            .AddConstructor<V2vChannelScheduler>()
+            .AddAttribute("AccessMode",
+                    "Continuous access with a radio per channel, or alternating CCH and SCH intervals",
+                    EnumValue(V2vChannelScheduler::CONTINUOUS),
+                    MakeEnumAccessor(&V2vChannelScheduler::m_mode),
+                    MakeEnumChecker(V2vChannelScheduler::CONTINUOUS, "Continuous",
+                                    V2vChannelScheduler::ALTERNATING, "Alternating"))
+            .AddAttribute("MaxQueueSize",
+                    "Packets waiting for their channel interval, per channel", UintegerValue(64),
+                    MakeUintegerAccessor(&V2vChannelScheduler::m_maxQueueSize),
+                    MakeUintegerChecker<uint32_t>(1))
+            .AddTraceSource("Drop", "A packet has been dropped from a full channel queue, with the channel number",
+                    MakeTraceSourceAccessor(&V2vChannelScheduler::m_dropTrace));
+    return tid;
+}
+
+V2vChannelScheduler::V2vChannelScheduler (){
+    NS_LOG_FUNCTION (this);
+}
+
+V2vChannelScheduler::~V2vChannelScheduler (){
+    NS_LOG_FUNCTION (this);
+}
+
+void
+V2vChannelScheduler::DoDispose (void){
+    NS_LOG_FUNCTION (this);
+    for(std::map<uint32_t, ChannelState>::iterator it = m_channels.begin (); it != m_channels.end (); ++it){
+        Simulator::Cancel (it->second.flushEvent);
+    }
+    m_channels.clear ();
+    m_coordinator = 0;
+    Object::DoDispose ();
+}
+
+void
+V2vChannelScheduler::SetCoordinator (Ptr<V2vChannelCoordinator> coordinator){
+    m_coordinator = coordinator;
+}
+
+Ptr<V2vChannelCoordinator>
+V2vChannelScheduler::GetCoordinator (void) const {
+    return m_coordinator;
+}
+
+void
+V2vChannelScheduler::AddChannel (uint32_t channelNumber, Ptr<NetDevice> device){
+    NS_LOG_FUNCTION (this << channelNumber << device);
+    ChannelState &state = m_channels[channelNumber];
+    state.device = device;
+    state.sent = 0;
+    state.queued = 0;
+    state.dropped = 0;
+}
+
+Ptr<NetDevice>
+V2vChannelScheduler::GetDevice (uint32_t channelNumber) const {
+    std::map<uint32_t, ChannelState>::const_iterator it = m_channels.find (channelNumber);
+    if(it == m_channels.end ()){
+        return 0;
+    }
+    return it->second.device;
+}
+
+std::vector<uint32_t>
+V2vChannelScheduler::GetSchs (void) const {
+    std::vector<uint32_t> schs;
+    for(std::map<uint32_t, ChannelState>::const_iterator it = m_channels.begin (); it != m_channels.end (); ++it){
+        if(it->first != CCH){
+            schs.push_back (it->first);
+        }
+    }
+    return schs;
+}
+
+uint32_t
+V2vChannelScheduler::SelectSch (uint64_t key) const {
+    std::vector<uint32_t> schs = GetSchs ();
+    if(schs.empty ()){
+        return CCH;
+    }
+    return schs[key % schs.size ()];
+}
+
+bool
+V2vChannelScheduler::BindToChannel (Ptr<Socket> socket, uint32_t channelNumber) const {
+    Ptr<NetDevice> device = GetDevice (channelNumber);
+    if(device == 0){
+        return false;
+    }
+    socket->BindToNetDevice (device);
+    return true;
+}
+
+Time
+V2vChannelScheduler::NeedTimeToAccess (uint32_t channelNumber) const {
+    if(m_mode == CONTINUOUS){
+        return Time (0);
+    }
+    NS_ASSERT_MSG (m_coordinator != 0, "The alternating access needs a V2vChannelCoordinator");
+    if(channelNumber == CCH){
+        return m_coordinator->NeedTimeToCchAccess ();
+    }
+    return m_coordinator->NeedTimeToSchAccess ();
+}
+
+void
+V2vChannelScheduler::Send (Ptr<Socket> socket, Ptr<Packet> packet, uint32_t channelNumber){
+    NS_LOG_FUNCTION (this << socket << packet << channelNumber);
+
+    std::map<uint32_t, ChannelState>::iterator it = m_channels.find (channelNumber);
+    NS_ASSERT_MSG (it != m_channels.end (), "No device on channel " << channelNumber);
+    ChannelState &state = it->second;
+
+    Time wait = NeedTimeToAccess (channelNumber);
+    if(wait.IsZero () && state.queue.empty ()){
+        socket->Send (packet);
+        state.sent ++;
+        return;
+    }
+
+    if(state.queue.size () >= m_maxQueueSize){
+        NS_LOG_LOGIC ("Queue of channel " << channelNumber << " full, drop");
+        state.dropped ++;
+        m_dropTrace (packet, channelNumber);
+        return;
+    }
+    PendingPacket pending;
+    pending.socket = socket;
+    pending.packet = packet;
+    state.queue.push_back (pending);
+    state.queued ++;
+    if(!state.flushEvent.IsRunning ()){
+        state.flushEvent = Simulator::Schedule (wait, &V2vChannelScheduler::Flush, this, channelNumber);
+    }
+}
+
+void
+V2vChannelScheduler::Flush (uint32_t channelNumber){
+    NS_LOG_FUNCTION (this << channelNumber);
+
+    ChannelState &state = m_channels[channelNumber];
+    while(!state.queue.empty ()){
+        PendingPacket pending = state.queue.front ();
+        state.queue.pop_front ();
+        pending.socket->Send (pending.packet);
+        state.sent ++;
+    }
+}
+
+uint64_t
+V2vChannelScheduler::GetSent (uint32_t channelNumber) const {
+    std::map<uint32_t, ChannelState>::const_iterator it = m_channels.find (channelNumber);
+    return it == m_channels.end () ? 0 : it->second.sent;
+}
+
+uint64_t
+V2vChannelScheduler::GetQueued (uint32_t channelNumber) const {
+    std::map<uint32_t, ChannelState>::const_iterator it = m_channels.find (channelNumber);
+    return it == m_channels.end () ? 0 : it->second.queued;
+}
+
+uint64_t
+V2vChannelScheduler::GetDropped (uint32_t channelNumber) const {
+    std::map<uint32_t, ChannelState>::const_iterator it = m_channels.find (channelNumber);
+    return it == m_channels.end () ? 0 : it->second.dropped;
+}
+
+} // namespace ns3
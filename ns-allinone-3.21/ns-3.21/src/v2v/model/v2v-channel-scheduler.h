@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_CHANNEL_SCHEDULER_H
+#define V2V_CHANNEL_SCHEDULER_H
+
+#include <map>
+#include <deque>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/object.h"
+#include "ns3/socket.h"
+#include "ns3/packet.h"
+#include "ns3/event-id.h"
+#include "ns3/net-device.h"
+#include "ns3/traced-callback.h"
+#include "v2v-channel-coordinator.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vChannelScheduler
+ * \brief Per node access to the WAVE control and service channels.
+ *
+ * Each channel, identified by its IEEE 1609.4 number, is a NetDevice of
+ * the node attached to its own medium, e.g. one YansWifiChannel or
+ * V2vBroadcastChannel per channel number. The clustering clients send
+ * their beacons on the CCH and the cluster members their data on a SCH
+ * chosen by the cluster, so the load is spread over the channels.
+ *
+ * With the CONTINUOUS access every channel has its own radio and is
+ * always available. With the ALTERNATING access a single radio switches
+ * between the CCH interval and the SCH interval of the coordinator: a
+ * packet sent outside the interval of its channel, or in a guard
+ * interval, waits in the queue of the channel, of MaxQueueSize packets,
+ * until the channel can be used. Only the transmissions are gated; the
+ * devices keep receiving on every channel.
+ */
+class V2vChannelScheduler : public Object {
+public:
+
+    static const uint32_t CCH = 178;        //!< control channel number
+
+    enum AccessMode {
+        CONTINUOUS = 0,
+        ALTERNATING
+    };
+
+    static TypeId GetTypeId (void);
+
+    V2vChannelScheduler ();
+    virtual ~V2vChannelScheduler ();
+
+    /**
+     * \param coordinator the CCH and SCH intervals, shared by the nodes
+     */
+    void SetCoordinator (Ptr<V2vChannelCoordinator> coordinator);
+    Ptr<V2vChannelCoordinator> GetCoordinator (void) const;
+
+    /**
+     * \param channelNumber CCH or a service channel number
+     * \param device the device of the node on this channel
+     */
+    void AddChannel (uint32_t channelNumber, Ptr<NetDevice> device);
+
+    /**
+     * \param channelNumber a channel number
+     * \return the device on this channel, 0 if none
+     */
+    Ptr<NetDevice> GetDevice (uint32_t channelNumber) const;
+
+    /**
+     * \return the service channel numbers, in increasing order
+     */
+    std::vector<uint32_t> GetSchs (void) const;
+
+    /**
+     * \param key e.g. the id of a cluster head
+     * \return the service channel of the key, spread evenly over the
+     * SCHs; the CCH when there is none
+     */
+    uint32_t SelectSch (uint64_t key) const;
+
+    /**
+     * \brief Restrict a socket to the device of a channel.
+     * \param socket a bound socket
+     * \param channelNumber the channel number
+     * \return false if there is no device on this channel
+     */
+    bool BindToChannel (Ptr<Socket> socket, uint32_t channelNumber) const;
+
+    /**
+     * \brief Send a packet on a channel, now or once the channel can be
+     * used.
+     * \param socket a socket bound to the channel with BindToChannel
+     * \param packet the packet
+     * \param channelNumber the channel number
+     */
+    void Send (Ptr<Socket> socket, Ptr<Packet> packet, uint32_t channelNumber);
+
+    /**
+     * \return the packets handed to the socket on a channel
+     */
+    uint64_t GetSent (uint32_t channelNumber) const;
+
+    /**
+     * \return the packets that had to wait for a channel interval
+     */
+    uint64_t GetQueued (uint32_t channelNumber) const;
+
+    /**
+     * \return the packets dropped from a full queue
+     */
+    uint64_t GetDropped (uint32_t channelNumber) const;
+
+protected:
+
+    virtual void DoDispose (void);
+
+private:
+
+    struct PendingPacket {
+        Ptr<Socket> socket;
+        Ptr<Packet> packet;
+    };
+
+    struct ChannelState {
+        Ptr<NetDevice> device;
+        std::deque<PendingPacket> queue;
+        EventId flushEvent;
+        uint64_t sent;
+        uint64_t queued;
+        uint64_t dropped;
+    };
+
+    /**
+     * \return the time before a channel can be used, 0 if now
+     */
+    Time NeedTimeToAccess (uint32_t channelNumber) const;
+    void Flush (uint32_t channelNumber);
+
+    std::map<uint32_t, ChannelState> m_channels;
+    Ptr<V2vChannelCoordinator> m_coordinator;
+    AccessMode m_mode;
+    uint32_t m_maxQueueSize;
+
+    TracedCallback<Ptr<const Packet>, uint32_t> m_dropTrace;
+};
+
+} // namespace ns3
+
+#endif // V2V_CHANNEL_SCHEDULER_H
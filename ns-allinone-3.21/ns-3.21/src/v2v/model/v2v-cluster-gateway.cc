@@ -0,0 +1,330 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/double.h"
+#include "ns3/packet.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/trace-source-accessor.h"
+#include "v2v-cluster-header.h"
+#include "v2v-cluster-gateway.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vClusterGateway");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vClusterGateway);
+
+TypeId V2vClusterGateway::GetTypeId(void) {
+    static TypeId tid =
+            TypeId("ns3::V2vClusterGateway").SetParent<Application>()
+            .AddConstructor<V2vClusterGateway>()
+            .AddAttribute("WaveAddress",
+                    "The broadcast address and port of the member reports", AddressValue(),
+                    MakeAddressAccessor(&V2vClusterGateway::m_waveAddress),
+                    MakeAddressChecker())
+            .AddAttribute("UplinkAddress",
+                    "The address and port of the server of the uplink bursts", AddressValue(),
+                    MakeAddressAccessor(&V2vClusterGateway::m_uplinkAddress),
+                    MakeAddressChecker())
+            .AddAttribute("Port",
+                    "The port the cluster heads listen to for member reports", UintegerValue(5000),
+                    MakeUintegerAccessor(&V2vClusterGateway::m_port),
+                    MakeUintegerChecker<uint16_t>())
+            .AddAttribute("ReportInterval",
+                    "The time between two reports of a vehicle", TimeValue(Seconds(1.0)),
+                    MakeTimeAccessor(&V2vClusterGateway::m_reportInterval),
+                    MakeTimeChecker())
+            .AddAttribute("ReportSize",
+                    "The payload size of a report (bytes)", UintegerValue(200),
+                    MakeUintegerAccessor(&V2vClusterGateway::m_reportSize),
+                    MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Aggregation",
+                    "Relay the reports through the cluster heads instead of sending each one over the uplink",
+                    BooleanValue(true),
+                    MakeBooleanAccessor(&V2vClusterGateway::m_aggregation),
+                    MakeBooleanChecker())
+            .AddAttribute("AggregationInterval",
+                    "The time between two uplink bursts of a cluster head", TimeValue(Seconds(1.0)),
+                    MakeTimeAccessor(&V2vClusterGateway::m_aggregationInterval),
+                    MakeTimeChecker())
+            .AddAttribute("MaxUplinkSize",
+                    "The largest uplink burst (bytes), larger batches are split", UintegerValue(1400),
+                    MakeUintegerAccessor(&V2vClusterGateway::m_maxUplinkSize),
+                    MakeUintegerChecker<uint32_t>(64))
+            .AddAttribute("CompressionRatio",
+                    "Compressed over raw size of the payloads of a burst", DoubleValue(0.5),
+                    MakeDoubleAccessor(&V2vClusterGateway::m_compressionRatio),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+            .AddTraceSource("Report", "A report has been generated",
+                    MakeTraceSourceAccessor(&V2vClusterGateway::m_reportTrace))
+            .AddTraceSource("Uplink", "A burst has been sent over the uplink, with its number of reports",
+                    MakeTraceSourceAccessor(&V2vClusterGateway::m_uplinkTrace));
+    return tid;
+}
+
+V2vClusterGateway::V2vClusterGateway (){
+    NS_LOG_FUNCTION (this);
+    m_seq = 0;
+    m_generatedReports = 0;
+    m_relayedReports = 0;
+    m_uplinkPackets = 0;
+    m_uplinkBytes = 0;
+}
+
+V2vClusterGateway::~V2vClusterGateway (){
+    NS_LOG_FUNCTION (this);
+}
+
+void
+V2vClusterGateway::DoDispose (void){
+    NS_LOG_FUNCTION (this);
+    m_role = RoleCallback ();
+    m_clusterId = ClusterIdCallback ();
+    m_waveSocket = 0;
+    m_listeningSocket = 0;
+    m_uplinkSocket = 0;
+    m_scheduler = 0;
+    m_schSockets.clear ();
+    Application::DoDispose ();
+}
+
+void
+V2vClusterGateway::SetClusterCallbacks (RoleCallback role, ClusterIdCallback clusterId){
+    NS_LOG_FUNCTION (this);
+    m_role = role;
+    m_clusterId = clusterId;
+}
+
+uint64_t
+V2vClusterGateway::GetGeneratedReports (void) const {
+    return m_generatedReports;
+}
+
+uint64_t
+V2vClusterGateway::GetRelayedReports (void) const {
+    return m_relayedReports;
+}
+
+uint64_t
+V2vClusterGateway::GetUplinkPackets (void) const {
+    return m_uplinkPackets;
+}
+
+uint64_t
+V2vClusterGateway::GetUplinkBytes (void) const {
+    return m_uplinkBytes;
+}
+
+void
+V2vClusterGateway::StartApplication (void){
+    NS_LOG_FUNCTION (this);
+
+    if(!m_uplinkSocket){
+        m_uplinkSocket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+        m_uplinkSocket->Bind ();
+        m_uplinkSocket->Connect (m_uplinkAddress);
+        m_uplinkSocket->ShutdownRecv ();
+    }
+
+    if(m_aggregation){
+        if(!m_waveSocket){
+            m_waveSocket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+            m_waveSocket->Bind ();
+            m_waveSocket->SetAllowBroadcast (true);
+            m_waveSocket->Connect (m_waveAddress);
+            m_waveSocket->ShutdownRecv ();
+        }
+        m_scheduler = GetNode ()->GetObject<V2vChannelScheduler> ();
+        if(m_scheduler != 0 && m_schSockets.empty ()){
+            // limited broadcasts, which only leave through the bound SCH device
+            uint16_t port = InetSocketAddress::ConvertFrom (m_waveAddress).GetPort ();
+            std::vector<uint32_t> schs = m_scheduler->GetSchs ();
+            for(uint32_t i = 0; i < schs.size (); ++i){
+                Ptr<Socket> socket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+                socket->Bind ();
+                m_scheduler->BindToChannel (socket, schs[i]);
+                socket->SetAllowBroadcast (true);
+                socket->Connect (InetSocketAddress (Ipv4Address::GetBroadcast (), port));
+                socket->ShutdownRecv ();
+                m_schSockets[schs[i]] = socket;
+            }
+        }
+        if(!m_listeningSocket){
+            m_listeningSocket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+            m_listeningSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_port));
+            m_listeningSocket->ShutdownSend ();
+        }
+        m_listeningSocket->SetRecvCallback (MakeCallback (&V2vClusterGateway::HandleRead, this));
+        m_flushEvent = Simulator::Schedule (m_aggregationInterval, &V2vClusterGateway::Flush, this);
+    }
+
+    m_reportEvent = Simulator::ScheduleNow (&V2vClusterGateway::GenerateReport, this);
+}
+
+void
+V2vClusterGateway::StopApplication (void){
+    NS_LOG_FUNCTION (this);
+
+    Simulator::Cancel (m_reportEvent);
+    Simulator::Cancel (m_flushEvent);
+    if(m_uplinkSocket){
+        m_uplinkSocket->Close ();
+        m_uplinkSocket = 0;
+    }
+    if(m_waveSocket){
+        m_waveSocket->Close ();
+        m_waveSocket = 0;
+    }
+    for(std::map<uint32_t, Ptr<Socket> >::iterator it = m_schSockets.begin (); it != m_schSockets.end (); ++it){
+        it->second->Close ();
+    }
+    m_schSockets.clear ();
+    if(m_listeningSocket){
+        m_listeningSocket->Close ();
+        m_listeningSocket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+        m_listeningSocket = 0;
+    }
+    m_buffer.clear ();
+}
+
+V2vClusterSap::NovelNodeDegree
+V2vClusterGateway::GetRole (void) const {
+    if(m_role.IsNull ()){
+        return V2vClusterSap::STANDALONE;
+    }
+    return m_role ();
+}
+
+uint64_t
+V2vClusterGateway::GetClusterId (void) const {
+    if(m_clusterId.IsNull ()){
+        return 0;
+    }
+    return m_clusterId ();
+}
+
+void
+V2vClusterGateway::GenerateReport (void){
+    NS_LOG_FUNCTION (this);
+
+    V2vClusterSap::GatewayReport report;
+    report.id = GetNode ()->GetId ();
+    report.seq = m_seq++;
+    report.size = m_reportSize;
+    report.ts = Simulator::Now ();
+    m_generatedReports++;
+
+    if(!m_aggregation){
+        std::vector<V2vClusterSap::GatewayReport> reports (1, report);
+        SendUplink (reports);
+    }
+    else if(GetRole () == V2vClusterSap::CM && GetClusterId () != 0){
+        report.clusterId = GetClusterId ();
+        V2vGatewayReportHeader header;
+        header.SetReport (report);
+        Ptr<Packet> packet = Create<Packet> (m_reportSize);
+        packet->AddHeader (header);
+        m_reportTrace (packet);
+        if(!m_schSockets.empty ()){
+            uint32_t sch = m_scheduler->SelectSch (report.clusterId);
+            m_scheduler->Send (m_schSockets[sch], packet, sch);
+        }
+        else{
+            m_waveSocket->Send (packet);
+        }
+        NS_LOG_LOGIC ("Node " << report.id << " sent report " << report.seq << " to CH " << report.clusterId);
+    }
+    else{
+        report.clusterId = report.id;
+        m_buffer.push_back (report);
+    }
+
+    m_reportEvent = Simulator::Schedule (m_reportInterval, &V2vClusterGateway::GenerateReport, this);
+}
+
+void
+V2vClusterGateway::HandleRead (Ptr<Socket> socket){
+    NS_LOG_FUNCTION (this << socket);
+
+    Ptr<Packet> packet;
+    Address from;
+    while((packet = socket->RecvFrom (from))){
+        V2vGatewayReportHeader header;
+        packet->RemoveHeader (header);
+        V2vClusterSap::GatewayReport report = header.GetReport ();
+        // members broadcast, keep only the reports of our own cluster
+        if(report.clusterId != GetNode ()->GetId () || GetRole () != V2vClusterSap::CH){
+            continue;
+        }
+        m_relayedReports++;
+        m_buffer.push_back (report);
+    }
+}
+
+void
+V2vClusterGateway::Flush (void){
+    NS_LOG_FUNCTION (this << m_buffer.size ());
+
+    if(!m_buffer.empty ()){
+        SendUplink (m_buffer);
+        m_buffer.clear ();
+    }
+    m_flushEvent = Simulator::Schedule (m_aggregationInterval, &V2vClusterGateway::Flush, this);
+}
+
+void
+V2vClusterGateway::SendUplink (const std::vector<V2vClusterSap::GatewayReport> &reports){
+    NS_LOG_FUNCTION (this << reports.size ());
+
+    uint32_t next = 0;
+    while(next < reports.size ()){
+        // fill the burst up to MaxUplinkSize, but always carry one report
+        V2vGatewayAggregateHeader header;
+        header.SetGatewayId (GetNode ()->GetId ());
+        double raw = 0;
+        uint32_t payload = 0;
+        do{
+            double candidate = raw + reports[next].size;
+            uint32_t candidatePayload = std::ceil (candidate * m_compressionRatio);
+            if(header.GetReports ().size () > 0 &&
+               header.GetSerializedSize () + V2vGatewayAggregateHeader::GetEntrySize () + candidatePayload > m_maxUplinkSize){
+                break;
+            }
+            header.AddReport (reports[next]);
+            raw = candidate;
+            payload = candidatePayload;
+            next++;
+        } while(next < reports.size () && header.GetReports ().size () < 0xffff);
+
+        Ptr<Packet> packet = Create<Packet> (payload);
+        packet->AddHeader (header);
+        m_uplinkPackets++;
+        m_uplinkBytes += packet->GetSize ();
+        m_uplinkTrace (packet, header.GetReports ().size ());
+        m_uplinkSocket->Send (packet);
+        NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " sent a burst of " << header.GetReports ().size ()
+                      << " reports, " << packet->GetSize () << " bytes");
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef V2V_CLUSTER_GATEWAY_H
+#define V2V_CLUSTER_GATEWAY_H
+
+#include <map>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/socket.h"
+#include "ns3/address.h"
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/application.h"
+#include "ns3/traced-callback.h"
+#include "ns3/v2v-cluster-sap.h"
+#include "ns3/v2v-channel-scheduler.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup v2v
+ * \class V2vClusterGateway
+ * \brief Reports of a vehicle to a remote server, aggregated by the
+ * cluster heads.
+ *
+ * Every ReportInterval the vehicle generates a report of ReportSize
+ * bytes. With Aggregation disabled each report goes alone over the
+ * uplink, e.g. an LTE bearer, to UplinkAddress.
+ *
+ * With Aggregation enabled a cluster member sends its reports to the
+ * WaveAddress (one-hop broadcast) and its cluster head keeps the ones
+ * addressed to it. Cluster heads and standalone vehicles buffer their own
+ * and the relayed reports and every AggregationInterval flush them in
+ * uplink bursts of at most MaxUplinkSize bytes, where the payloads are
+ * shrunk by CompressionRatio.
+ *
+ * When the node has a V2vChannelScheduler with service channels, a
+ * member sends its reports on the SCH its cluster head is mapped to by
+ * V2vChannelScheduler::SelectSch, away from the clustering beacons of
+ * the CCH.
+ *
+ * The role and the cluster head come from the clustering client of the
+ * node through the callbacks set by V2vClusterGatewayHelper; without
+ * them the vehicle is standalone.
+ */
+class V2vClusterGateway : public Application {
+public:
+
+    typedef Callback<V2vClusterSap::NovelNodeDegree> RoleCallback;
+    typedef Callback<uint64_t> ClusterIdCallback;
+
+    static TypeId GetTypeId (void);
+
+    V2vClusterGateway ();
+    virtual ~V2vClusterGateway ();
+
+    /**
+     * \param role returns the current role of the node
+     * \param clusterId returns the node id of the current cluster head
+     */
+    void SetClusterCallbacks (RoleCallback role, ClusterIdCallback clusterId);
+
+    /**
+     * \return the reports generated by the node
+     */
+    uint64_t GetGeneratedReports (void) const;
+
+    /**
+     * \return the member reports received as cluster head
+     */
+    uint64_t GetRelayedReports (void) const;
+
+    /**
+     * \return the packets sent over the uplink
+     */
+    uint64_t GetUplinkPackets (void) const;
+
+    /**
+     * \return the bytes sent over the uplink, without the UDP/IP headers
+     */
+    uint64_t GetUplinkBytes (void) const;
+
+protected:
+
+    virtual void DoDispose (void);
+
+private:
+
+    virtual void StartApplication (void);
+    virtual void StopApplication (void);
+
+    void GenerateReport (void);
+    void HandleRead (Ptr<Socket> socket);
+    void Flush (void);
+    void SendUplink (const std::vector<V2vClusterSap::GatewayReport> &reports);
+    V2vClusterSap::NovelNodeDegree GetRole (void) const;
+    uint64_t GetClusterId (void) const;
+
+    Address m_waveAddress;              //!< destination of the member reports
+    Address m_uplinkAddress;            //!< destination of the uplink bursts
+    uint16_t m_port;                    //!< port of the member reports
+    Time m_reportInterval;
+    uint32_t m_reportSize;
+    bool m_aggregation;
+    Time m_aggregationInterval;
+    uint32_t m_maxUplinkSize;
+    double m_compressionRatio;
+
+    Ptr<Socket> m_waveSocket;
+    Ptr<Socket> m_listeningSocket;
+    Ptr<Socket> m_uplinkSocket;
+    Ptr<V2vChannelScheduler> m_scheduler;              //!< channel access of the node, 0 for a single channel
+    std::map<uint32_t, Ptr<Socket> > m_schSockets;      //!< member report socket of each service channel
+    EventId m_reportEvent;
+    EventId m_flushEvent;
+    RoleCallback m_role;
+    ClusterIdCallback m_clusterId;
+
+    uint32_t m_seq;
+    std::vector<V2vClusterSap::GatewayReport> m_buffer;    //!< reports waiting for the next burst
+
+    uint64_t m_generatedReports;
+    uint64_t m_relayedReports;
+    uint64_t m_uplinkPackets;
+    uint64_t m_uplinkBytes;
+
+    TracedCallback<Ptr<const Packet> > m_reportTrace;
+    TracedCallback<Ptr<const Packet>, uint32_t> m_uplinkTrace;
+};
+
+} // namespace ns3
+
+#endif // V2V_CLUSTER_GATEWAY_H
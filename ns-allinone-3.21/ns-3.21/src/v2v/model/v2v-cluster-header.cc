@@ -18,6 +18,7 @@
  * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
  */
 
+#include <algorithm>
 #include "ns3/simulator.h"
 #include "v2v-cluster-header.h"
 
@@ -25,6 +26,97 @@ NS_LOG_COMPONENT_DEFINE ("V2vClusterHeader");
 
 namespace ns3 {
 
+/////////////////////////////////////////////////////////////////////
+NS_OBJECT_ENSURE_REGISTERED(V2vClusterTypeHeader);
+
+V2vClusterTypeHeader::V2vClusterTypeHeader(V2vClusterSap::MessageType type) :
+        m_type(type),
+        m_compact(false),
+        m_valid(true){
+    NS_LOG_FUNCTION (this << type);
+}
+
+V2vClusterTypeHeader::~V2vClusterTypeHeader(){
+    NS_LOG_FUNCTION (this);
+}
+
+void
+V2vClusterTypeHeader::SetType(V2vClusterSap::MessageType type){
+    NS_LOG_FUNCTION (this << type);
+    m_type = type;
+    m_valid = true;
+}
+
+V2vClusterSap::MessageType
+V2vClusterTypeHeader::GetType(void) const {
+    NS_LOG_FUNCTION (this);
+    return m_type;
+}
+
+void
+V2vClusterTypeHeader::SetCompact(bool compact){
+    NS_LOG_FUNCTION (this << compact);
+    m_compact = compact;
+}
+
+bool
+V2vClusterTypeHeader::IsCompact(void) const {
+    NS_LOG_FUNCTION (this);
+    return m_compact;
+}
+
+bool
+V2vClusterTypeHeader::IsValid(void) const {
+    NS_LOG_FUNCTION (this);
+    return m_valid;
+}
+
+TypeId
+V2vClusterTypeHeader::GetTypeId(void) {
+    static TypeId tid =
+            TypeId("ns3::V2vClusterTypeHeader").SetParent<Header>().AddConstructor<V2vClusterTypeHeader>();
+    return tid;
+}
+
+TypeId
+V2vClusterTypeHeader::GetInstanceTypeId(void) const {
+    return GetTypeId();
+}
+
+void
+V2vClusterTypeHeader::Print(std::ostream &os) const {
+    NS_LOG_FUNCTION (this << &os);
+    os << "(type=" << (uint32_t)m_type << " compact=" << m_compact << ")";
+}
+
+uint32_t
+V2vClusterTypeHeader::GetSerializedSize(void) const {
+    NS_LOG_FUNCTION (this);
+    return sizeof(uint8_t);
+}
+
+void
+V2vClusterTypeHeader::Serialize(Buffer::Iterator start) const {
+    NS_LOG_FUNCTION (this << &start);
+
+    Buffer::Iterator i = start;
+    i.WriteU8((uint8_t)m_type | (m_compact ? 0x80 : 0));
+}
+
+uint32_t
+V2vClusterTypeHeader::Deserialize(Buffer::Iterator start) {
+    NS_LOG_INFO (this << &start);
+
+    Buffer::Iterator i = start;
+    uint8_t type = i.ReadU8 ();
+    m_compact = (type & 0x80) != 0;
+    type &= 0x7f;
+    m_valid = (type > V2vClusterSap::UNKNOWN_MESSAGE) && (type < V2vClusterSap::MESSAGE_TYPES);
+    m_type = m_valid ? (V2vClusterSap::MessageType)type : V2vClusterSap::UNKNOWN_MESSAGE;
+
+    return GetSerializedSize();
+}
+
 /* Novel Algorithm Headers */
 /////////////////////////////////////////////////////////////////////
 NS_OBJECT_ENSURE_REGISTERED(V2vNovelCOVHeader);
@@ -274,6 +366,168 @@ V2vNovelUpdateHeader::Deserialize(Buffer::Iterator start) {
     return GetSerializedSize();
 }
 
+////////////////////////////////
+NS_OBJECT_ENSURE_REGISTERED(V2vNovelCompactUpdateHeader);
+
+V2vNovelCompactUpdateHeader::V2vNovelCompactUpdateHeader(){
+    NS_LOG_FUNCTION (this);
+}
+
+V2vNovelCompactUpdateHeader::~V2vNovelCompactUpdateHeader(){
+    NS_LOG_FUNCTION (this);
+}
+
+void
+V2vNovelCompactUpdateHeader::SetCompactUpdate(const V2vClusterSap::NovelCompactUpdate &update){
+    NS_LOG_FUNCTION (this << update.id);
+    m_update = update;
+    if(m_update.flags & V2vClusterSap::COMPACT_KEY_FRAME){
+        m_update.flags = 0xff;
+    }
+}
+
+const V2vClusterSap::NovelCompactUpdate &
+V2vNovelCompactUpdateHeader::GetCompactUpdate (void) const {
+    NS_LOG_FUNCTION (this);
+    return m_update;
+}
+
+TypeId
+V2vNovelCompactUpdateHeader::GetTypeId(void) {
+    static TypeId tid =
+            TypeId("ns3::V2vNovelCompactUpdateHeader").SetParent<Header>().AddConstructor<V2vNovelCompactUpdateHeader>();
+    return tid;
+}
+
+TypeId
+V2vNovelCompactUpdateHeader::GetInstanceTypeId(void) const {
+    return GetTypeId();
+}
+
+void
+V2vNovelCompactUpdateHeader::Print(std::ostream &os) const {
+    NS_LOG_FUNCTION (this << &os);
+    os << "(flags=" << (uint32_t)m_update.flags
+       << " key=" << (uint32_t)m_update.keySeq
+       << " Id=" << m_update.id
+       << " ts=" << m_update.ts
+       << " Cluster Id=" << m_update.clusterId
+       << " CM Members=" << m_update.chMembers << ")";
+}
+
+uint32_t
+V2vNovelCompactUpdateHeader::GetSerializedSize(void) const {
+    NS_LOG_FUNCTION (this);
+
+    uint8_t flags = m_update.flags;
+    if(flags & V2vClusterSap::COMPACT_KEY_FRAME){
+        return 2 + 4 + 8 + 3*4 + 3*2 + 3*2 + 4 + 4 + 2 + 1;
+    }
+    uint32_t size = 2 + 4 + 4;
+    size += (flags & V2vClusterSap::COMPACT_POSITION) ? 3*2 : 0;
+    size += (flags & V2vClusterSap::COMPACT_VELOCITY) ? 3*2 : 0;
+    size += (flags & V2vClusterSap::COMPACT_DIRECTION) ? 3*2 : 0;
+    size += (flags & V2vClusterSap::COMPACT_CLUSTER) ? 4 : 0;
+    size += (flags & V2vClusterSap::COMPACT_TEMP_CLUSTER) ? 4 : 0;
+    size += (flags & V2vClusterSap::COMPACT_MEMBERS) ? 2 : 0;
+    size += (flags & V2vClusterSap::COMPACT_DEGREE) ? 1 : 0;
+    return size;
+}
+
+void
+V2vNovelCompactUpdateHeader::Serialize(Buffer::Iterator start) const {
+    NS_LOG_FUNCTION (this << &start);
+
+    Buffer::Iterator i = start;
+    uint8_t flags = m_update.flags;
+    bool key = flags & V2vClusterSap::COMPACT_KEY_FRAME;
+    i.WriteU8 (flags);
+    i.WriteU8 (m_update.keySeq);
+    i.WriteHtonU32 (m_update.id);
+    if(key){
+        i.WriteHtonU64 (m_update.ts);
+    }
+    else{
+        i.WriteHtonU32 ((uint32_t) m_update.ts);
+    }
+    if(flags & V2vClusterSap::COMPACT_POSITION){
+        for(uint32_t k = 0; k < 3; ++k){
+            if(key){
+                i.WriteHtonU32 ((uint32_t) m_update.position[k]);
+            }
+            else{
+                i.WriteHtonU16 ((uint16_t) m_update.position[k]);
+            }
+        }
+    }
+    if(flags & V2vClusterSap::COMPACT_VELOCITY){
+        for(uint32_t k = 0; k < 3; ++k){
+            i.WriteHtonU16 ((uint16_t) m_update.velocity[k]);
+        }
+    }
+    if(flags & V2vClusterSap::COMPACT_DIRECTION){
+        for(uint32_t k = 0; k < 3; ++k){
+            i.WriteHtonU16 ((uint16_t) m_update.direction[k]);
+        }
+    }
+    if(flags & V2vClusterSap::COMPACT_CLUSTER){
+        i.WriteHtonU32 (m_update.clusterId);
+    }
+    if(flags & V2vClusterSap::COMPACT_TEMP_CLUSTER){
+        i.WriteHtonU32 (m_update.tempClusterId);
+    }
+    if(flags & V2vClusterSap::COMPACT_MEMBERS){
+        i.WriteHtonU16 (m_update.chMembers);
+    }
+    if(flags & V2vClusterSap::COMPACT_DEGREE){
+        i.WriteU8 (m_update.degree);
+    }
+}
+
+uint32_t
+V2vNovelCompactUpdateHeader::Deserialize(Buffer::Iterator start) {
+    NS_LOG_INFO (this << &start);
+
+    Buffer::Iterator i = start;
+    m_update = V2vClusterSap::NovelCompactUpdate ();
+    m_update.flags = i.ReadU8 ();
+    m_update.keySeq = i.ReadU8 ();
+    m_update.id = i.ReadNtohU32 ();
+
+    uint8_t flags = m_update.flags;
+    bool key = flags & V2vClusterSap::COMPACT_KEY_FRAME;
+    m_update.ts = key ? i.ReadNtohU64 () : i.ReadNtohU32 ();
+    if(flags & V2vClusterSap::COMPACT_POSITION){
+        for(uint32_t k = 0; k < 3; ++k){
+            m_update.position[k] = key ? (int32_t) i.ReadNtohU32 () : (int16_t) i.ReadNtohU16 ();
+        }
+    }
+    if(flags & V2vClusterSap::COMPACT_VELOCITY){
+        for(uint32_t k = 0; k < 3; ++k){
+            m_update.velocity[k] = (int16_t) i.ReadNtohU16 ();
+        }
+    }
+    if(flags & V2vClusterSap::COMPACT_DIRECTION){
+        for(uint32_t k = 0; k < 3; ++k){
+            m_update.direction[k] = (int16_t) i.ReadNtohU16 ();
+        }
+    }
+    if(flags & V2vClusterSap::COMPACT_CLUSTER){
+        m_update.clusterId = i.ReadNtohU32 ();
+    }
+    if(flags & V2vClusterSap::COMPACT_TEMP_CLUSTER){
+        m_update.tempClusterId = i.ReadNtohU32 ();
+    }
+    if(flags & V2vClusterSap::COMPACT_MEMBERS){
+        m_update.chMembers = i.ReadNtohU16 ();
+    }
+    if(flags & V2vClusterSap::COMPACT_DEGREE){
+        m_update.degree = i.ReadU8 ();
+    }
+
+    return GetSerializedSize();
+}
+
 /////////////////////////////////////////////////////////////////////
 NS_OBJECT_ENSURE_REGISTERED(V2vNovelMergeHeader);
 
@@ -460,6 +714,11 @@ V2vAffinityHelloHeader::Deserialize(Buffer::Iterator start) {
 /////////////////////////////////////////////////////////////////////
 NS_OBJECT_ENSURE_REGISTERED(V2vAffinityRespAvailHeader);
 
+static bool
+AffinitySubStructureIdLess (const V2vClusterSap::AffinitySubStructure &a, const V2vClusterSap::AffinitySubStructure &b){
+    return a.id < b.id;
+}
+
 V2vAffinityRespAvailHeader::V2vAffinityRespAvailHeader() :
         m_ts(Simulator::Now().GetTimeStep()){
     NS_LOG_FUNCTION (this);
@@ -488,17 +747,31 @@ V2vAffinityRespAvailHeader::GetRespAvailInfo (void) const {
 }
 
 void
-V2vAffinityRespAvailHeader::SetRespAvailList(std::list<V2vClusterSap::AffinitySubStructure> respAvailList){
+V2vAffinityRespAvailHeader::SetRespAvailList(const std::vector<V2vClusterSap::AffinitySubStructure> &respAvailList){
     NS_LOG_FUNCTION (this << respAvailList.size());
     m_respAvailList = respAvailList;
+    std::sort (m_respAvailList.begin (), m_respAvailList.end (), AffinitySubStructureIdLess);
 }
 
-std::list<V2vClusterSap::AffinitySubStructure>
+const std::vector<V2vClusterSap::AffinitySubStructure> &
 V2vAffinityRespAvailHeader::GetRespAvailList(void) const{
     NS_LOG_FUNCTION (this);
     return m_respAvailList;
 }
 
+const V2vClusterSap::AffinitySubStructure *
+V2vAffinityRespAvailHeader::FindRespAvail(uint64_t id) const{
+    NS_LOG_FUNCTION (this << id);
+    V2vClusterSap::AffinitySubStructure key;
+    key.id = id;
+    std::vector<V2vClusterSap::AffinitySubStructure>::const_iterator it =
+            std::lower_bound (m_respAvailList.begin (), m_respAvailList.end (), key, AffinitySubStructureIdLess);
+    if(it != m_respAvailList.end () && it->id == id){
+        return &(*it);
+    }
+    return 0;
+}
+
 TypeId
 V2vAffinityRespAvailHeader::GetTypeId(void) {
     static TypeId tid =
@@ -539,15 +812,10 @@ V2vAffinityRespAvailHeader::Serialize(Buffer::Iterator start) const {
     memcpy( temp, &m_respAvailInfo, sizeof(V2vClusterSap::AffinityRespAvail));
     i.Write(temp, sizeof(V2vClusterSap::AffinityRespAvail));
 
-    for (std::list<V2vClusterSap::AffinitySubStructure>::const_iterator it = m_respAvailList.begin (); it != m_respAvailList.end (); ++it) {
-        V2vClusterSap::AffinitySubStructure tmpStruct;
-        tmpStruct.id = it->id;
-        tmpStruct.resp = it->resp;
-        tmpStruct.avail = it->avail;
-
-        unsigned char tmp[sizeof(V2vClusterSap::AffinitySubStructure)];
-        memcpy( tmp, &tmpStruct, sizeof(V2vClusterSap::AffinitySubStructure));
-        i.Write(tmp, sizeof(V2vClusterSap::AffinitySubStructure));
+    // The entries are plain data, so the array is written in one go
+    if(!m_respAvailList.empty ()){
+        i.Write(reinterpret_cast<const uint8_t *> (&m_respAvailList[0]),
+                sizeof(V2vClusterSap::AffinitySubStructure)*m_respAvailList.size ());
     }
 
 }
@@ -563,14 +831,18 @@ V2vAffinityRespAvailHeader::Deserialize(Buffer::Iterator start) {
     i.Read(temp, sizeof(V2vClusterSap::AffinityRespAvail));
     memcpy(&m_respAvailInfo, &temp, sizeof(V2vClusterSap::AffinityRespAvail));
 
-    for (uint64_t j = 0; j < m_respAvailInfo.neighboursNumber; ++j) {
-        V2vClusterSap::AffinitySubStructure tmpStruct;
-
-        unsigned char tmp[sizeof(V2vClusterSap::AffinitySubStructure)];
-        i.Read(tmp, sizeof(V2vClusterSap::AffinitySubStructure));
-        memcpy(&tmpStruct, &tmp, sizeof(V2vClusterSap::AffinitySubStructure));
+    m_respAvailList.resize (m_respAvailInfo.neighboursNumber);
+    if(!m_respAvailList.empty ()){
+        i.Read(reinterpret_cast<uint8_t *> (&m_respAvailList[0]),
+               sizeof(V2vClusterSap::AffinitySubStructure)*m_respAvailList.size ());
+    }
 
-        m_respAvailList.push_back (tmpStruct);
+    // Senders keep the list sorted; restore the invariant for any that do not
+    for (uint32_t j = 1; j < m_respAvailList.size (); ++j) {
+        if(m_respAvailList[j].id < m_respAvailList[j-1].id){
+            std::sort (m_respAvailList.begin (), m_respAvailList.end (), AffinitySubStructureIdLess);
+            break;
+        }
     }
 
     return GetSerializedSize();
@@ -839,4 +1111,187 @@ V2vDMACJoinHeader::Deserialize(Buffer::Iterator start) {
     return GetSerializedSize();
 }
 
+
+/* Cluster Gateway Headers */
+/////////////////////////////////////////////////////////////////////
+NS_OBJECT_ENSURE_REGISTERED(V2vGatewayReportHeader);
+
+V2vGatewayReportHeader::V2vGatewayReportHeader(){
+    NS_LOG_FUNCTION (this);
+}
+
+V2vGatewayReportHeader::~V2vGatewayReportHeader(){
+    NS_LOG_FUNCTION (this);
+}
+
+void
+V2vGatewayReportHeader::SetReport(const V2vClusterSap::GatewayReport &report){
+    NS_LOG_FUNCTION (this << report.id << report.seq);
+    m_report = report;
+}
+
+V2vClusterSap::GatewayReport
+V2vGatewayReportHeader::GetReport(void) const {
+    NS_LOG_FUNCTION (this);
+    return m_report;
+}
+
+TypeId
+V2vGatewayReportHeader::GetTypeId(void) {
+    static TypeId tid =
+            TypeId("ns3::V2vGatewayReportHeader").SetParent<Header>().AddConstructor<V2vGatewayReportHeader>();
+    return tid;
+}
+
+TypeId
+V2vGatewayReportHeader::GetInstanceTypeId(void) const {
+    return GetTypeId();
+}
+
+void
+V2vGatewayReportHeader::Print(std::ostream &os) const {
+    NS_LOG_FUNCTION (this << &os);
+    os << "(time=" << m_report.ts.GetSeconds()
+       << " id=" << m_report.id
+       << " clusterId=" << m_report.clusterId
+       << " seq=" << m_report.seq
+       << " size=" << m_report.size
+       << ")";
+}
+
+uint32_t
+V2vGatewayReportHeader::GetSerializedSize(void) const {
+    NS_LOG_FUNCTION (this);
+    return 3*sizeof(uint64_t) + 2*sizeof(uint32_t);
+}
+
+void
+V2vGatewayReportHeader::Serialize(Buffer::Iterator start) const {
+    NS_LOG_FUNCTION (this << &start);
+
+    Buffer::Iterator i = start;
+    i.WriteHtonU64(m_report.id);
+    i.WriteHtonU64(m_report.clusterId);
+    i.WriteHtonU32(m_report.seq);
+    i.WriteHtonU32(m_report.size);
+    i.WriteHtonU64(m_report.ts.GetTimeStep());
+}
+
+uint32_t
+V2vGatewayReportHeader::Deserialize(Buffer::Iterator start) {
+    NS_LOG_INFO (this << &start);
+
+    Buffer::Iterator i = start;
+    m_report.id = i.ReadNtohU64();
+    m_report.clusterId = i.ReadNtohU64();
+    m_report.seq = i.ReadNtohU32();
+    m_report.size = i.ReadNtohU32();
+    m_report.ts = TimeStep(i.ReadNtohU64());
+
+    return GetSerializedSize();
+}
+
+
+/////////////////////////////////////////////////////////////////////
+NS_OBJECT_ENSURE_REGISTERED(V2vGatewayAggregateHeader);
+
+V2vGatewayAggregateHeader::V2vGatewayAggregateHeader() :
+        m_gatewayId(0){
+    NS_LOG_FUNCTION (this);
+}
+
+V2vGatewayAggregateHeader::~V2vGatewayAggregateHeader(){
+    NS_LOG_FUNCTION (this);
+}
+
+void
+V2vGatewayAggregateHeader::SetGatewayId(uint64_t id){
+    NS_LOG_FUNCTION (this << id);
+    m_gatewayId = id;
+}
+
+uint64_t
+V2vGatewayAggregateHeader::GetGatewayId(void) const {
+    NS_LOG_FUNCTION (this);
+    return m_gatewayId;
+}
+
+void
+V2vGatewayAggregateHeader::AddReport(const V2vClusterSap::GatewayReport &report){
+    NS_LOG_FUNCTION (this << report.id << report.seq);
+    NS_ASSERT_MSG (m_reports.size () < 0xffff, "Too many reports in one burst");
+    m_reports.push_back (report);
+}
+
+const std::vector<V2vClusterSap::GatewayReport> &
+V2vGatewayAggregateHeader::GetReports(void) const {
+    return m_reports;
+}
+
+uint32_t
+V2vGatewayAggregateHeader::GetEntrySize(void) {
+    return 2*sizeof(uint64_t) + 2*sizeof(uint32_t);
+}
+
+TypeId
+V2vGatewayAggregateHeader::GetTypeId(void) {
+    static TypeId tid =
+            TypeId("ns3::V2vGatewayAggregateHeader").SetParent<Header>().AddConstructor<V2vGatewayAggregateHeader>();
+    return tid;
+}
+
+TypeId
+V2vGatewayAggregateHeader::GetInstanceTypeId(void) const {
+    return GetTypeId();
+}
+
+void
+V2vGatewayAggregateHeader::Print(std::ostream &os) const {
+    NS_LOG_FUNCTION (this << &os);
+    os << "(gateway=" << m_gatewayId
+       << " reports=" << m_reports.size()
+       << ")";
+}
+
+uint32_t
+V2vGatewayAggregateHeader::GetSerializedSize(void) const {
+    NS_LOG_FUNCTION (this);
+    return sizeof(uint64_t) + sizeof(uint16_t) + m_reports.size()*GetEntrySize();
+}
+
+void
+V2vGatewayAggregateHeader::Serialize(Buffer::Iterator start) const {
+    NS_LOG_FUNCTION (this << &start);
+
+    Buffer::Iterator i = start;
+    i.WriteHtonU64(m_gatewayId);
+    i.WriteHtonU16(m_reports.size());
+    for(std::vector<V2vClusterSap::GatewayReport>::const_iterator it = m_reports.begin(); it != m_reports.end(); ++it){
+        i.WriteHtonU64(it->id);
+        i.WriteHtonU32(it->seq);
+        i.WriteHtonU32(it->size);
+        i.WriteHtonU64(it->ts.GetTimeStep());
+    }
+}
+
+uint32_t
+V2vGatewayAggregateHeader::Deserialize(Buffer::Iterator start) {
+    NS_LOG_INFO (this << &start);
+
+    Buffer::Iterator i = start;
+    m_gatewayId = i.ReadNtohU64();
+    uint16_t count = i.ReadNtohU16();
+    m_reports.resize(count);
+    for(uint16_t k = 0; k < count; ++k){
+        V2vClusterSap::GatewayReport &report = m_reports[k];
+        report.id = i.ReadNtohU64();
+        report.clusterId = m_gatewayId;
+        report.seq = i.ReadNtohU32();
+        report.size = i.ReadNtohU32();
+        report.ts = TimeStep(i.ReadNtohU64());
+    }
+
+    return GetSerializedSize();
+}
+
 } // namespace ns3
@@ -21,12 +21,70 @@
 #ifndef V2V_CLUSTER_HEADER_H
 #define V2V_CLUSTER_HEADER_H
 
+#include <vector>
 #include "ns3/log.h"
 #include "ns3/header.h"
 #include "v2v-cluster-sap.h"
 
 namespace ns3 {
 
+/**
+ * \ingroup v2v
+ * \class V2vClusterTypeHeader
+ * \brief Message type header prepended to every clustering packet.
+ *
+ * The header is made of a single 8bits field, so the clients can dispatch
+ * a received packet without packet metadata. The low 7 bits are the
+ * message type, the high bit tells the body uses the compact wire format.
+ */
+class V2vClusterTypeHeader: public Header {
+public:
+
+    V2vClusterTypeHeader(V2vClusterSap::MessageType type = V2vClusterSap::UNKNOWN_MESSAGE);
+    virtual ~V2vClusterTypeHeader();
+
+    /**
+     * \param type the message type
+     */
+    void SetType(V2vClusterSap::MessageType type);
+    /**
+     * \return the message type
+     */
+    V2vClusterSap::MessageType GetType(void) const;
+
+    /**
+     * \param compact true if the body uses the compact wire format
+     */
+    void SetCompact(bool compact);
+    /**
+     * \return true if the body uses the compact wire format
+     */
+    bool IsCompact(void) const;
+
+    /**
+     * \return true if the deserialized message type is known
+     */
+    bool IsValid(void) const;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId(void);
+    virtual TypeId GetInstanceTypeId(void) const;
+    virtual void Print(std::ostream &os) const;
+    virtual uint32_t GetSerializedSize(void) const;
+    virtual void Serialize(Buffer::Iterator start) const;
+    virtual uint32_t Deserialize(Buffer::Iterator start);
+
+private:
+
+    V2vClusterSap::MessageType m_type;  //!< Message type
+    bool m_compact;                     //!< Compact body
+    bool m_valid;                       //!< Known message type
+};
+
+
 /* Novel Algorithm Headers */
 /**
  * \ingroup v2v
@@ -165,6 +223,49 @@ private:
     V2vClusterSap::NovelNeighborInfo m_updateInfo;
 };
 
+/**
+ * \ingroup v2v
+ * \class V2vNovelCompactUpdateHeader
+ * \brief Compact wire format of V2vNovelUpdateHeader.
+ *
+ * The header starts with the 8bits NovelCompactFields flags and the 8bits
+ * key frame sequence, followed by a 32bits node id. A key frame carries a
+ * 64bits time stamp, 32bits positions, and every other field. A delta
+ * carries a 32bits time offset and only the flagged fields, with 16bits
+ * positions relative to the key frame. Velocity and direction are 16bits
+ * in both. V2vNovelUpdateCodec fills and expands the header.
+ */
+class V2vNovelCompactUpdateHeader: public Header {
+public:
+
+    V2vNovelCompactUpdateHeader();
+    virtual ~V2vNovelCompactUpdateHeader();
+
+    /**
+     * \param update the quantized update
+     */
+    void SetCompactUpdate(const V2vClusterSap::NovelCompactUpdate &update);
+    /**
+     * \return the quantized update
+     */
+    const V2vClusterSap::NovelCompactUpdate &GetCompactUpdate(void) const;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId(void);
+    virtual TypeId GetInstanceTypeId(void) const;
+    virtual void Print(std::ostream &os) const;
+    virtual uint32_t GetSerializedSize(void) const;
+    virtual void Serialize(Buffer::Iterator start) const;
+    virtual uint32_t Deserialize(Buffer::Iterator start);
+
+private:
+
+    V2vClusterSap::NovelCompactUpdate m_update;
+};
+
 /**
  * \ingroup v2v
  * \class V2vNovelMergeHeader
@@ -294,16 +395,22 @@ public:
     V2vClusterSap::AffinityRespAvail GetRespAvailInfo(void) const;
 
     /**
-     * @brief SetRespAvailList
-     * @param respAvailList
+     * \brief Set the responsibility/availability entries, sorted by id.
+     * \param respAvailList the entries, one per neighbor
      */
-    void SetRespAvailList(std::list<V2vClusterSap::AffinitySubStructure> respAvailList);
+    void SetRespAvailList(const std::vector<V2vClusterSap::AffinitySubStructure> &respAvailList);
 
     /**
-     * @brief GetRespAvailList
-     * @return
+     * \return the entries, sorted by id, without copying them
      */
-    std::list<V2vClusterSap::AffinitySubStructure> GetRespAvailList(void) const;
+    const std::vector<V2vClusterSap::AffinitySubStructure> &GetRespAvailList(void) const;
+
+    /**
+     * \brief Binary search for the entry addressed to a node.
+     * \param id the node id
+     * \return the entry, or 0 when the list carries none for the node
+     */
+    const V2vClusterSap::AffinitySubStructure *FindRespAvail(uint64_t id) const;
 
 
     /**
@@ -321,7 +428,7 @@ private:
 
     uint64_t m_ts;                                      //!< Timestamp
     V2vClusterSap::AffinityRespAvail m_respAvailInfo;
-    std::list<V2vClusterSap::AffinitySubStructure> m_respAvailList;
+    std::vector<V2vClusterSap::AffinitySubStructure> m_respAvailList;  //!< Entries sorted by id
 };
 //////////////////////////////////
 
@@ -459,6 +566,109 @@ private:
     V2vClusterSap::DMACJoin m_sendJoin;
 };
 
+//////////////////////////////////
+
+
+
+/* Cluster Gateway Headers */
+/**
+ * \ingroup v2v
+ * \class V2vGatewayReportHeader
+ * \brief Packet header of a member report sent to its cluster head.
+ *
+ * The header is made of the 64bits source and cluster IDs, a 32bits
+ * sequence number, the 32bits payload size and the 64bits generation
+ * time stamp. The payload follows the header.
+ */
+class V2vGatewayReportHeader: public Header {
+public:
+
+    V2vGatewayReportHeader();
+    virtual ~V2vGatewayReportHeader();
+
+    /**
+     * \param report the GatewayReport structure
+     */
+    void SetReport(const V2vClusterSap::GatewayReport &report);
+    /**
+     * \return the V2vClusterSap::GatewayReport struct
+     */
+    V2vClusterSap::GatewayReport GetReport(void) const;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId(void);
+    virtual TypeId GetInstanceTypeId(void) const;
+    virtual void Print(std::ostream &os) const;
+    virtual uint32_t GetSerializedSize(void) const;
+    virtual void Serialize(Buffer::Iterator start) const;
+    virtual uint32_t Deserialize(Buffer::Iterator start);
+
+private:
+
+    V2vClusterSap::GatewayReport m_report;
+};
+
+
+/**
+ * \ingroup v2v
+ * \class V2vGatewayAggregateHeader
+ * \brief Packet header of an aggregated uplink burst.
+ *
+ * The header is made of the 64bits gateway ID and a 16bits report count,
+ * followed by one entry per report: the 64bits source ID, the 32bits
+ * sequence number, the 32bits payload size and the 64bits generation
+ * time stamp. The compressed payloads of the reports follow the header.
+ */
+class V2vGatewayAggregateHeader: public Header {
+public:
+
+    V2vGatewayAggregateHeader();
+    virtual ~V2vGatewayAggregateHeader();
+
+    /**
+     * \param id the node id of the gateway
+     */
+    void SetGatewayId(uint64_t id);
+    /**
+     * \return the node id of the gateway
+     */
+    uint64_t GetGatewayId(void) const;
+
+    /**
+     * \param report a report carried by the burst
+     */
+    void AddReport(const V2vClusterSap::GatewayReport &report);
+
+    /**
+     * \return the reports carried by the burst
+     */
+    const std::vector<V2vClusterSap::GatewayReport> &GetReports(void) const;
+
+    /**
+     * \return the serialized size of one report entry
+     */
+    static uint32_t GetEntrySize(void);
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId(void);
+    virtual TypeId GetInstanceTypeId(void) const;
+    virtual void Print(std::ostream &os) const;
+    virtual uint32_t GetSerializedSize(void) const;
+    virtual void Serialize(Buffer::Iterator start) const;
+    virtual uint32_t Deserialize(Buffer::Iterator start);
+
+private:
+
+    uint64_t m_gatewayId;
+    std::vector<V2vClusterSap::GatewayReport> m_reports;
+};
+
 
 } // namespace ns3
 
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/singleton.h"
+#include "v2v-cluster-registry.h"
+#include "v2v-cluster-snapshot.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vClusterRegistry");
+
+namespace ns3 {
+
+V2vClusterRegistry::V2vClusterRegistry ():
+    m_numberOfMessages(0),
+    m_clusterChanges(0),
+    m_sampledNumberOfMessages(0),
+    m_sampledClusterChanges(0){
+    for(uint32_t i = 0; i < V2vClusterSap::DEGREE_STATES; ++i){
+        m_nodes[i] = 0;
+    }
+}
+
+V2vClusterRegistry*
+V2vClusterRegistry::Get (void){
+    return Singleton<V2vClusterRegistry>::Get ();
+}
+
+void
+V2vClusterRegistry::Register (V2vClusterSap::NovelNodeDegree role){
+    NS_LOG_FUNCTION (this << role);
+    NS_ASSERT (role < V2vClusterSap::DEGREE_STATES);
+    m_nodes[role]++;
+}
+
+void
+V2vClusterRegistry::Unregister (V2vClusterSap::NovelNodeDegree role){
+    NS_LOG_FUNCTION (this << role);
+    NS_ASSERT (role < V2vClusterSap::DEGREE_STATES && m_nodes[role] > 0);
+    m_nodes[role]--;
+}
+
+void
+V2vClusterRegistry::NotifyRoleChange (V2vClusterSap::NovelNodeDegree oldRole, V2vClusterSap::NovelNodeDegree newRole){
+    NS_LOG_FUNCTION (this << oldRole << newRole);
+    NS_ASSERT (oldRole < V2vClusterSap::DEGREE_STATES && m_nodes[oldRole] > 0);
+    NS_ASSERT (newRole < V2vClusterSap::DEGREE_STATES);
+    m_nodes[oldRole]--;
+    m_nodes[newRole]++;
+}
+
+void
+V2vClusterRegistry::NotifyMessageSent (void){
+    m_numberOfMessages++;
+}
+
+void
+V2vClusterRegistry::NotifyClusterChange (void){
+    m_clusterChanges++;
+}
+
+uint32_t
+V2vClusterRegistry::GetNodes (void) const {
+    uint32_t nodes = 0;
+    for(uint32_t i = 0; i < V2vClusterSap::DEGREE_STATES; ++i){
+        nodes += m_nodes[i];
+    }
+    return nodes;
+}
+
+uint32_t
+V2vClusterRegistry::GetNodes (V2vClusterSap::NovelNodeDegree role) const {
+    NS_ASSERT (role < V2vClusterSap::DEGREE_STATES);
+    return m_nodes[role];
+}
+
+uint64_t
+V2vClusterRegistry::GetNumberOfMessages (void) const {
+    return m_numberOfMessages;
+}
+
+uint64_t
+V2vClusterRegistry::GetClusterChanges (void) const {
+    return m_clusterChanges;
+}
+
+uint64_t
+V2vClusterRegistry::GetNumberOfMessagesPerSecond (void){
+    uint64_t tmp = m_numberOfMessages - m_sampledNumberOfMessages;
+    m_sampledNumberOfMessages = m_numberOfMessages;
+
+    return tmp;
+}
+
+uint64_t
+V2vClusterRegistry::GetClusterChangesPerSecond (void){
+    uint64_t tmp = m_clusterChanges - m_sampledClusterChanges;
+    m_sampledClusterChanges = m_clusterChanges;
+
+    return tmp;
+}
+
+void
+V2vClusterRegistry::SaveState (V2vSnapshotWriter &writer) const {
+    writer.Write ("numberOfMessages", m_numberOfMessages);
+    writer.Write ("clusterChanges", m_clusterChanges);
+    writer.Write ("sampledNumberOfMessages", m_sampledNumberOfMessages);
+    writer.Write ("sampledClusterChanges", m_sampledClusterChanges);
+}
+
+void
+V2vClusterRegistry::LoadState (V2vSnapshotReader &reader){
+    NS_LOG_FUNCTION (this);
+    reader.Read ("numberOfMessages", m_numberOfMessages);
+    reader.Read ("clusterChanges", m_clusterChanges);
+    reader.Read ("sampledNumberOfMessages", m_sampledNumberOfMessages);
+    reader.Read ("sampledClusterChanges", m_sampledClusterChanges);
+}
+
+} // namespace ns3
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_CLUSTER_REGISTRY_H
+#define V2V_CLUSTER_REGISTRY_H
+
+#include <stdint.h>
+#include "ns3/v2v-cluster-sap.h"
+
+namespace ns3 {
+
+class V2vSnapshotWriter;
+class V2vSnapshotReader;
+
+/**
+ * \ingroup v2v
+ * \class V2vClusterRegistry
+ * \brief Global census of the clustering clients.
+ *
+ * The clients register their role when they start, report every role
+ * change, sent message and cluster change, and unregister when they are
+ * disposed. The registry only updates counters, so sampling the number of
+ * cluster heads or the messages per interval costs O(1) instead of a
+ * scan over all the nodes.
+ *
+ * The affinity client has no standalone state: nodes that are not their
+ * own cluster head are counted as members.
+ */
+class V2vClusterRegistry {
+public:
+
+    V2vClusterRegistry ();
+
+    /**
+     * \return the process-wide registry
+     */
+    static V2vClusterRegistry* Get (void);
+
+    /**
+     * \param role the role of a client that starts
+     */
+    void Register (V2vClusterSap::NovelNodeDegree role);
+
+    /**
+     * \param role the last reported role of a client that goes away
+     */
+    void Unregister (V2vClusterSap::NovelNodeDegree role);
+
+    /**
+     * \param oldRole the last reported role of the client
+     * \param newRole the new role of the client
+     */
+    void NotifyRoleChange (V2vClusterSap::NovelNodeDegree oldRole, V2vClusterSap::NovelNodeDegree newRole);
+
+    /**
+     * \brief Count one clustering message sent by a client.
+     */
+    void NotifyMessageSent (void);
+
+    /**
+     * \brief Count one cluster change of a client.
+     */
+    void NotifyClusterChange (void);
+
+    /**
+     * \return the number of registered clients
+     */
+    uint32_t GetNodes (void) const;
+
+    /**
+     * \param role the role to count
+     * \return the number of registered clients in the role
+     */
+    uint32_t GetNodes (V2vClusterSap::NovelNodeDegree role) const;
+
+    /**
+     * \return the messages sent since the process started
+     */
+    uint64_t GetNumberOfMessages (void) const;
+
+    /**
+     * \return the cluster changes since the process started
+     */
+    uint64_t GetClusterChanges (void) const;
+
+    /**
+     * \return the messages sent since the previous call
+     */
+    uint64_t GetNumberOfMessagesPerSecond (void);
+
+    /**
+     * \return the cluster changes since the previous call
+     */
+    uint64_t GetClusterChangesPerSecond (void);
+
+    /**
+     * \brief Write the message and cluster change counters to a snapshot.
+     *
+     * The role census is not part of it: the restored clients register
+     * their roles again when they start.
+     */
+    void SaveState (V2vSnapshotWriter &writer) const;
+
+    /**
+     * \brief Restore the counters written by SaveState.
+     */
+    void LoadState (V2vSnapshotReader &reader);
+
+private:
+
+    uint32_t m_nodes[V2vClusterSap::DEGREE_STATES];     //!< Registered clients per role
+    uint64_t m_numberOfMessages;
+    uint64_t m_clusterChanges;
+    uint64_t m_sampledNumberOfMessages;                 //!< m_numberOfMessages at the previous sample
+    uint64_t m_sampledClusterChanges;                   //!< m_clusterChanges at the previous sample
+};
+
+} // namespace ns3
+
+#endif // V2V_CLUSTER_REGISTRY_H
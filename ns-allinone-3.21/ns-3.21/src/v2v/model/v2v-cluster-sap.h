@@ -32,6 +32,23 @@ class V2vClusterSap {
 public:
     virtual ~V2vClusterSap ();
 
+    /* Message types carried by V2vClusterTypeHeader */
+    enum MessageType{
+        UNKNOWN_MESSAGE = 0,
+        NOVEL_COV_MESSAGE,
+        NOVEL_FORMATION_MESSAGE,
+        NOVEL_UPDATE_MESSAGE,
+        NOVEL_MERGE_MESSAGE,
+        AFFINITY_HELLO_MESSAGE,
+        AFFINITY_RESP_AVAIL_MESSAGE,
+        DMAC_HELLO_MESSAGE,
+        DMAC_CH_MESSAGE,
+        DMAC_JOIN_MESSAGE,
+        MESSAGE_TYPES
+    };
+    ////////////////////////////////////
+
+
     /* Novel Algorithm Structures */
     enum NovelNodeState{
         NONE = 0,
@@ -60,6 +77,59 @@ public:
         Vector velocity;
         Vector direction;
         NovelNodeDegree degree;
+
+        NovelNeighborInfo():
+            ts(0),
+            id(0),
+            clusterId(0),
+            tempClusterId(0),
+            chMembers(0),
+            position(0.0, 0.0, 0.0),
+            velocity(0.0, 0.0, 0.0),
+            direction(0.0, 0.0, 0.0),
+            degree(STANDALONE){}
+    };
+
+    /* Compact wire format of NovelNeighborInfo, see V2vNovelUpdateCodec */
+    enum NovelCompactFields{
+        COMPACT_KEY_FRAME = 0x01,       //!< every field present, absolute values
+        COMPACT_POSITION = 0x02,
+        COMPACT_VELOCITY = 0x04,
+        COMPACT_DIRECTION = 0x08,
+        COMPACT_CLUSTER = 0x10,
+        COMPACT_TEMP_CLUSTER = 0x20,
+        COMPACT_MEMBERS = 0x40,
+        COMPACT_DEGREE = 0x80
+    };
+
+    struct NovelCompactUpdate{
+        uint8_t flags;                  //!< NovelCompactFields present in the message
+        uint8_t keySeq;                 //!< sequence number of the key frame
+        uint32_t id;
+        uint64_t ts;                    //!< time step of a key frame, us after the key frame of a delta
+        int32_t position[3];            //!< cm, relative to the key frame in a delta
+        int16_t velocity[3];            //!< cm/s
+        int16_t direction[3];           //!< 1/10000
+        uint32_t clusterId;
+        uint32_t tempClusterId;
+        uint16_t chMembers;
+        uint8_t degree;
+
+        NovelCompactUpdate():
+            flags(0),
+            keySeq(0),
+            id(0),
+            ts(0),
+            clusterId(0),
+            tempClusterId(0),
+            chMembers(0),
+            degree(0){
+            for(uint32_t k = 0; k < 3; ++k){
+                position[k] = 0;
+                velocity[k] = 0;
+                direction[k] = 0;
+            }
+        }
     };
     ////////////////////////////////////
 
@@ -193,7 +263,8 @@ public:
             CHindex(0),
             position(0.0, 0.0, 0.0),
             velocity(0.0, 0.0, 0.0),
-            direction(0.0, 0.0, 0.0){}
+            direction(0.0, 0.0, 0.0),
+            role(STANDALONE){}
     };
 
     struct DMACNeighbours{
@@ -212,7 +283,8 @@ public:
             weight(0.0),
             position(0.0, 0.0, 0.0),
             velocity(0.0, 0.0, 0.0),
-            direction(0.0, 0.0, 0.0){}
+            direction(0.0, 0.0, 0.0),
+            role(STANDALONE){}
     };
 
     struct DMACHello{
@@ -231,7 +303,8 @@ public:
             weight(0.0),
             position(0.0, 0.0, 0.0),
             velocity(0.0, 0.0, 0.0),
-            direction(0.0, 0.0, 0.0){}
+            direction(0.0, 0.0, 0.0),
+            role(STANDALONE){}
     };
 
     struct DMACCH{
@@ -244,6 +317,24 @@ public:
         uint16_t ttl;
         uint64_t CHindex;
     };
+    ////////////////////////////////////
+
+
+    /* Cluster Gateway Structures */
+    struct GatewayReport{
+        uint64_t id;            //!< node that generated the report
+        uint64_t clusterId;     //!< cluster head expected to forward it
+        uint32_t seq;
+        uint32_t size;          //!< payload bytes
+        Time ts;                //!< generation time
+
+        GatewayReport():
+            id(0),
+            clusterId(0),
+            seq(0),
+            size(0),
+            ts(Seconds(0)){}
+    };
 
 private:
 
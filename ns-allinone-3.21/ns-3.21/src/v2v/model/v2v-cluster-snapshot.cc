@@ -0,0 +1,413 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include <cstdlib>
+#include <cstdio>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "v2v-cluster-snapshot.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vClusterSnapshot");
+
+namespace ns3 {
+
+V2vSnapshotWriter::V2vSnapshotWriter (std::ostream &os):
+    m_os(os){
+    m_precision = m_os.precision (17);
+}
+
+V2vSnapshotWriter::~V2vSnapshotWriter (){
+    m_os.precision (m_precision);
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, bool value){
+    m_os << name << " " << (value ? 1 : 0) << "\n";
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, uint32_t value){
+    m_os << name << " " << value << "\n";
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, uint64_t value){
+    m_os << name << " " << value << "\n";
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, int64_t value){
+    m_os << name << " " << value << "\n";
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, double value){
+    m_os << name << " " << value << "\n";
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const Vector &value){
+    m_os << name << " " << value.x << " " << value.y << " " << value.z << "\n";
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const Time &value){
+    m_os << name << " " << value.GetTimeStep () << "\n";
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const Address &value){
+    uint8_t buffer[Address::MAX_SIZE + 2];
+    uint32_t size = value.CopyAllTo (buffer, sizeof (buffer));
+    m_os << name << " ";
+    for(uint32_t i = 0; i < size; ++i){
+        char hex[3];
+        std::sprintf (hex, "%02x", buffer[i]);
+        m_os << hex;
+    }
+    m_os << "\n";
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const V2vStatisticsAccumulator &value){
+    m_os << name << " ";
+    value.Save (m_os);
+    m_os << "\n";
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const V2vClusterSap::NovelNeighborInfo &value){
+    Write (name + ".ts", value.ts);
+    Write (name + ".id", value.id);
+    Write (name + ".clusterId", value.clusterId);
+    Write (name + ".tempClusterId", value.tempClusterId);
+    Write (name + ".chMembers", value.chMembers);
+    Write (name + ".position", value.position);
+    Write (name + ".velocity", value.velocity);
+    Write (name + ".direction", value.direction);
+    Write (name + ".degree", (uint32_t) value.degree);
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const V2vClusterSap::AffinityCurrentInfo &value){
+    Write (name + ".CHcnvg", value.CHcnvg);
+    Write (name + ".id", value.id);
+    Write (name + ".CHindex", value.CHindex);
+    Write (name + ".position", value.position);
+    Write (name + ".velocity", value.velocity);
+    Write (name + ".direction", value.direction);
+    Write (name + ".selfSim", value.selfSim);
+    Write (name + ".selfResp", value.selfResp);
+    Write (name + ".selfAvail", value.selfAvail);
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const V2vClusterSap::AffinityNeighbors &value){
+    Write (name + ".position", value.position);
+    Write (name + ".velocity", value.velocity);
+    Write (name + ".direction", value.direction);
+    Write (name + ".similarity", value.similarity);
+    Write (name + ".availabilitySent", value.availabilitySent);
+    Write (name + ".availabilityReceived", value.availabilityReceived);
+    Write (name + ".responsibilitySent", value.responsibilitySent);
+    Write (name + ".responsibilityReceived", value.responsibilityReceived);
+    Write (name + ".CHcnvg", value.CHcnvg);
+    Write (name + ".tExpire", value.tExpire);
+    Write (name + ".CHindex", value.CHindex);
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const V2vClusterSap::DMACCurrentInfo &value){
+    Write (name + ".id", value.id);
+    Write (name + ".weight", value.weight);
+    Write (name + ".CHindex", value.CHindex);
+    Write (name + ".position", value.position);
+    Write (name + ".velocity", value.velocity);
+    Write (name + ".direction", value.direction);
+    Write (name + ".role", (uint32_t) value.role);
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const V2vClusterSap::DMACNeighbours &value){
+    Write (name + ".beats", value.beats);
+    Write (name + ".weight", value.weight);
+    Write (name + ".position", value.position);
+    Write (name + ".velocity", value.velocity);
+    Write (name + ".direction", value.direction);
+    Write (name + ".tExpire", value.tExpire);
+    Write (name + ".role", (uint32_t) value.role);
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const V2vClusterSap::DMACHello &value){
+    Write (name + ".id", value.id);
+    Write (name + ".ttl", (uint32_t) value.ttl);
+    Write (name + ".weight", value.weight);
+    Write (name + ".position", value.position);
+    Write (name + ".velocity", value.velocity);
+    Write (name + ".direction", value.direction);
+    Write (name + ".role", (uint32_t) value.role);
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const V2vClusterSap::DMACCH &value){
+    Write (name + ".id", value.id);
+    Write (name + ".ttl", (uint32_t) value.ttl);
+}
+
+void
+V2vSnapshotWriter::Write (const std::string &name, const V2vClusterSap::DMACJoin &value){
+    Write (name + ".id", value.id);
+    Write (name + ".ttl", (uint32_t) value.ttl);
+    Write (name + ".CHindex", value.CHindex);
+}
+
+void
+V2vSnapshotWriter::WriteEvent (const std::string &name, const EventId &event){
+    if(event.IsRunning ()){
+        Write (name, Simulator::GetDelayLeft (event));
+    }
+    else{
+        Write (name, (int64_t) -1);
+    }
+}
+
+
+V2vSnapshotReader::V2vSnapshotReader (std::istream &is):
+    m_is(is){
+}
+
+void
+V2vSnapshotReader::Expect (const std::string &name){
+    std::string token;
+    if(!(m_is >> token) || token != name){
+        NS_FATAL_ERROR ("Malformed snapshot: expected field " << name << ", found \"" << token << "\"");
+    }
+}
+
+std::string
+V2vSnapshotReader::Token (const std::string &name){
+    std::string token;
+    if(!(m_is >> token)){
+        NS_FATAL_ERROR ("Malformed snapshot: missing value of field " << name);
+    }
+    return token;
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, bool &value){
+    uint64_t flag;
+    Read (name, flag);
+    value = flag != 0;
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, uint32_t &value){
+    uint64_t wide;
+    Read (name, wide);
+    value = wide;
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, uint64_t &value){
+    Expect (name);
+    std::string token = Token (name);
+    char *end;
+    value = std::strtoull (token.c_str (), &end, 10);
+    if(*end != '\0' || token[0] == '-'){
+        NS_FATAL_ERROR ("Malformed snapshot: bad value \"" << token << "\" of field " << name);
+    }
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, int64_t &value){
+    Expect (name);
+    std::string token = Token (name);
+    char *end;
+    value = std::strtoll (token.c_str (), &end, 10);
+    if(*end != '\0'){
+        NS_FATAL_ERROR ("Malformed snapshot: bad value \"" << token << "\" of field " << name);
+    }
+}
+
+double
+V2vSnapshotReader::ParseDouble (const std::string &name){
+    std::string token = Token (name);
+    char *end;
+    // strtod also parses the inf and nan written by the stream
+    double value = std::strtod (token.c_str (), &end);
+    if(*end != '\0'){
+        NS_FATAL_ERROR ("Malformed snapshot: bad value \"" << token << "\" of field " << name);
+    }
+    return value;
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, double &value){
+    Expect (name);
+    value = ParseDouble (name);
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, Vector &value){
+    Expect (name);
+    value.x = ParseDouble (name);
+    value.y = ParseDouble (name);
+    value.z = ParseDouble (name);
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, Time &value){
+    int64_t step;
+    Read (name, step);
+    value = TimeStep (step);
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, Address &value){
+    Expect (name);
+    std::string token = Token (name);
+    uint8_t buffer[Address::MAX_SIZE + 2];
+    if(token.size () % 2 != 0 || token.size () / 2 < 2 || token.size () / 2 > sizeof (buffer)){
+        NS_FATAL_ERROR ("Malformed snapshot: bad value \"" << token << "\" of field " << name);
+    }
+    for(uint32_t i = 0; i < token.size () / 2; ++i){
+        buffer[i] = std::strtoul (token.substr (2 * i, 2).c_str (), 0, 16);
+    }
+    value.CopyAllFrom (buffer, token.size () / 2);
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, V2vStatisticsAccumulator &value){
+    Expect (name);
+    if(!value.Load (m_is)){
+        NS_FATAL_ERROR ("Malformed snapshot: bad value of field " << name);
+    }
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, V2vClusterSap::NovelNeighborInfo &value){
+    uint32_t degree;
+    Read (name + ".ts", value.ts);
+    Read (name + ".id", value.id);
+    Read (name + ".clusterId", value.clusterId);
+    Read (name + ".tempClusterId", value.tempClusterId);
+    Read (name + ".chMembers", value.chMembers);
+    Read (name + ".position", value.position);
+    Read (name + ".velocity", value.velocity);
+    Read (name + ".direction", value.direction);
+    Read (name + ".degree", degree);
+    value.degree = (V2vClusterSap::NovelNodeDegree) degree;
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, V2vClusterSap::AffinityCurrentInfo &value){
+    Read (name + ".CHcnvg", value.CHcnvg);
+    Read (name + ".id", value.id);
+    Read (name + ".CHindex", value.CHindex);
+    Read (name + ".position", value.position);
+    Read (name + ".velocity", value.velocity);
+    Read (name + ".direction", value.direction);
+    Read (name + ".selfSim", value.selfSim);
+    Read (name + ".selfResp", value.selfResp);
+    Read (name + ".selfAvail", value.selfAvail);
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, V2vClusterSap::AffinityNeighbors &value){
+    Read (name + ".position", value.position);
+    Read (name + ".velocity", value.velocity);
+    Read (name + ".direction", value.direction);
+    Read (name + ".similarity", value.similarity);
+    Read (name + ".availabilitySent", value.availabilitySent);
+    Read (name + ".availabilityReceived", value.availabilityReceived);
+    Read (name + ".responsibilitySent", value.responsibilitySent);
+    Read (name + ".responsibilityReceived", value.responsibilityReceived);
+    Read (name + ".CHcnvg", value.CHcnvg);
+    Read (name + ".tExpire", value.tExpire);
+    Read (name + ".CHindex", value.CHindex);
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, V2vClusterSap::DMACCurrentInfo &value){
+    uint32_t role;
+    Read (name + ".id", value.id);
+    Read (name + ".weight", value.weight);
+    Read (name + ".CHindex", value.CHindex);
+    Read (name + ".position", value.position);
+    Read (name + ".velocity", value.velocity);
+    Read (name + ".direction", value.direction);
+    Read (name + ".role", role);
+    value.role = (V2vClusterSap::NovelNodeDegree) role;
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, V2vClusterSap::DMACNeighbours &value){
+    uint32_t role;
+    Read (name + ".beats", value.beats);
+    Read (name + ".weight", value.weight);
+    Read (name + ".position", value.position);
+    Read (name + ".velocity", value.velocity);
+    Read (name + ".direction", value.direction);
+    Read (name + ".tExpire", value.tExpire);
+    Read (name + ".role", role);
+    value.role = (V2vClusterSap::NovelNodeDegree) role;
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, V2vClusterSap::DMACHello &value){
+    uint32_t ttl;
+    uint32_t role;
+    Read (name + ".id", value.id);
+    Read (name + ".ttl", ttl);
+    Read (name + ".weight", value.weight);
+    Read (name + ".position", value.position);
+    Read (name + ".velocity", value.velocity);
+    Read (name + ".direction", value.direction);
+    Read (name + ".role", role);
+    value.ttl = ttl;
+    value.role = (V2vClusterSap::NovelNodeDegree) role;
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, V2vClusterSap::DMACCH &value){
+    uint32_t ttl;
+    Read (name + ".id", value.id);
+    Read (name + ".ttl", ttl);
+    value.ttl = ttl;
+}
+
+void
+V2vSnapshotReader::Read (const std::string &name, V2vClusterSap::DMACJoin &value){
+    uint32_t ttl;
+    Read (name + ".id", value.id);
+    Read (name + ".ttl", ttl);
+    Read (name + ".CHindex", value.CHindex);
+    value.ttl = ttl;
+}
+
+Time
+V2vSnapshotReader::ReadEvent (const std::string &name){
+    Time delay;
+    Read (name, delay);
+    return delay;
+}
+
+} // namespace ns3
@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_CLUSTER_SNAPSHOT_H
+#define V2V_CLUSTER_SNAPSHOT_H
+
+#include <string>
+#include <istream>
+#include <ostream>
+#include <stdint.h>
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/address.h"
+#include "ns3/event-id.h"
+#include "v2v-cluster-sap.h"
+#include "v2v-timer-wheel.h"
+#include "v2v-neighbor-table.h"
+#include "v2v-statistics-accumulator.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vSnapshotWriter
+ * \brief Writes the clustering state of a client as a snapshot record.
+ *
+ * A record is a sequence of lines, one per field, holding the field name
+ * followed by its value. Doubles keep 17 significant digits and times
+ * their time step, so a record restores the state exactly. A pending
+ * event is written as the delay left before it expires, or -1 if none.
+ */
+class V2vSnapshotWriter {
+public:
+
+    /**
+     * \param os the stream the record is written to
+     */
+    V2vSnapshotWriter (std::ostream &os);
+    ~V2vSnapshotWriter ();
+
+    void Write (const std::string &name, bool value);
+    void Write (const std::string &name, uint32_t value);
+    void Write (const std::string &name, uint64_t value);
+    void Write (const std::string &name, int64_t value);
+    void Write (const std::string &name, double value);
+    void Write (const std::string &name, const Vector &value);
+    void Write (const std::string &name, const Time &value);
+    void Write (const std::string &name, const Address &value);
+    void Write (const std::string &name, const V2vStatisticsAccumulator &value);
+    void Write (const std::string &name, const V2vClusterSap::NovelNeighborInfo &value);
+    void Write (const std::string &name, const V2vClusterSap::AffinityCurrentInfo &value);
+    void Write (const std::string &name, const V2vClusterSap::AffinityNeighbors &value);
+    void Write (const std::string &name, const V2vClusterSap::DMACCurrentInfo &value);
+    void Write (const std::string &name, const V2vClusterSap::DMACNeighbours &value);
+    void Write (const std::string &name, const V2vClusterSap::DMACHello &value);
+    void Write (const std::string &name, const V2vClusterSap::DMACCH &value);
+    void Write (const std::string &name, const V2vClusterSap::DMACJoin &value);
+
+    /**
+     * \param name the field name
+     * \param event the event, written as the delay left before it expires
+     */
+    void WriteEvent (const std::string &name, const EventId &event);
+
+    /**
+     * \brief Write the records of a neighbor table in storage order.
+     * \param name the field name
+     * \param table the table
+     * \param expiry the expiry times of the records, or 0 if not tracked
+     */
+    template <typename T>
+    void WriteTable (const std::string &name, const V2vNeighborTable<T> &table, const V2vTimerWheel *expiry);
+
+private:
+
+    std::ostream &m_os;
+    std::streamsize m_precision;    //!< precision of the stream to restore
+};
+
+/**
+ * \ingroup v2v
+ * \class V2vSnapshotReader
+ * \brief Reads back a snapshot record written by V2vSnapshotWriter.
+ *
+ * The fields must be read in the order they were written; a name or
+ * value that does not match is a fatal error.
+ */
+class V2vSnapshotReader {
+public:
+
+    /**
+     * \param is the stream the record is read from
+     */
+    V2vSnapshotReader (std::istream &is);
+
+    void Read (const std::string &name, bool &value);
+    void Read (const std::string &name, uint32_t &value);
+    void Read (const std::string &name, uint64_t &value);
+    void Read (const std::string &name, int64_t &value);
+    void Read (const std::string &name, double &value);
+    void Read (const std::string &name, Vector &value);
+    void Read (const std::string &name, Time &value);
+    void Read (const std::string &name, Address &value);
+    void Read (const std::string &name, V2vStatisticsAccumulator &value);
+    void Read (const std::string &name, V2vClusterSap::NovelNeighborInfo &value);
+    void Read (const std::string &name, V2vClusterSap::AffinityCurrentInfo &value);
+    void Read (const std::string &name, V2vClusterSap::AffinityNeighbors &value);
+    void Read (const std::string &name, V2vClusterSap::DMACCurrentInfo &value);
+    void Read (const std::string &name, V2vClusterSap::DMACNeighbours &value);
+    void Read (const std::string &name, V2vClusterSap::DMACHello &value);
+    void Read (const std::string &name, V2vClusterSap::DMACCH &value);
+    void Read (const std::string &name, V2vClusterSap::DMACJoin &value);
+
+    /**
+     * \param name the field name
+     * \return the delay left before the event expires, negative if none
+     */
+    Time ReadEvent (const std::string &name);
+
+    /**
+     * \brief Replace the records of a neighbor table.
+     * \param name the field name
+     * \param table the table, refilled in the written storage order
+     * \param expiry the expiry times of the records, or 0 if not tracked
+     */
+    template <typename T>
+    void ReadTable (const std::string &name, V2vNeighborTable<T> &table, V2vTimerWheel *expiry);
+
+private:
+
+    /**
+     * \brief Consume the next token, which must be the field name.
+     */
+    void Expect (const std::string &name);
+    std::string Token (const std::string &name);
+    double ParseDouble (const std::string &name);
+
+    std::istream &m_is;
+};
+
+
+template <typename T>
+void
+V2vSnapshotWriter::WriteTable (const std::string &name, const V2vNeighborTable<T> &table, const V2vTimerWheel *expiry){
+    Write (name, table.GetSize ());
+    for(typename V2vNeighborTable<T>::ConstIterator it = table.Begin (); it != table.End (); ++it){
+        Write ("id", it->id);
+        Write ("position", it->position);
+        Write ("velocity", it->velocity);
+        Write ("expiry", expiry && expiry->Contains (it->id) ? expiry->GetDeadline (it->id) : Time::Max ());
+        Write ("value", it->value);
+    }
+}
+
+template <typename T>
+void
+V2vSnapshotReader::ReadTable (const std::string &name, V2vNeighborTable<T> &table, V2vTimerWheel *expiry){
+    uint32_t size;
+    Read (name, size);
+    table.Clear ();
+    if(expiry){
+        expiry->Clear ();
+    }
+    for(uint32_t i = 0; i < size; ++i){
+        uint64_t id;
+        Vector position;
+        Vector velocity;
+        Time deadline;
+        T value;
+        Read ("id", id);
+        Read ("position", position);
+        Read ("velocity", velocity);
+        Read ("expiry", deadline);
+        Read ("value", value);
+        table.Insert (id, position, velocity, value);
+        if(expiry && deadline != Time::Max ()){
+            expiry->Schedule (id, deadline);
+        }
+    }
+}
+
+} // namespace ns3
+
+#endif // V2V_CLUSTER_SNAPSHOT_H
@@ -0,0 +1,273 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "v2v-fcd-mobility-feed.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vFcdMobilityFeed");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vFcdMobilityFeed);
+
+TypeId V2vFcdMobilityFeed::GetTypeId(void) {
+    static TypeId tid =
+            TypeId("ns3::V2vFcdMobilityFeed").SetParent<Object>()
+            .AddConstructor<V2vFcdMobilityFeed>()
+            .AddAttribute("Source",
+                    "FCD stream: a file or named pipe, - for the standard input or tcp:host:port", StringValue(""),
+                    MakeStringAccessor(&V2vFcdMobilityFeed::m_source),
+                    MakeStringChecker())
+            .AddAttribute("ParkingPosition",
+                    "Position of the parked node with id 0", VectorValue(Vector(-100000.0, -100000.0, 0.0)),
+                    MakeVectorAccessor(&V2vFcdMobilityFeed::m_parkingPosition),
+                    MakeVectorChecker())
+            .AddAttribute("ParkingSpacing",
+                    "Distance along x between the parked nodes of consecutive ids (m)", DoubleValue(10000.0),
+                    MakeDoubleAccessor(&V2vFcdMobilityFeed::m_parkingSpacing),
+                    MakeDoubleChecker<double>(0.0))
+            .AddTraceSource("VehicleArrival", "A vehicle entered the trace and took a node",
+                    MakeTraceSourceAccessor(&V2vFcdMobilityFeed::m_arrivalTrace))
+            .AddTraceSource("VehicleDeparture", "A vehicle left the trace and released its node",
+                    MakeTraceSourceAccessor(&V2vFcdMobilityFeed::m_departureTrace));
+    return tid;
+}
+
+V2vFcdMobilityFeed::V2vFcdMobilityFeed (){
+    NS_LOG_FUNCTION (this);
+    m_currentTime = 0.0;
+    m_nextTime = 0.0;
+    m_timestep = 0;
+    m_nodes = 0;
+    m_arrivals = 0;
+    m_departures = 0;
+}
+
+V2vFcdMobilityFeed::~V2vFcdMobilityFeed (){
+    NS_LOG_FUNCTION (this);
+}
+
+void
+V2vFcdMobilityFeed::DoDispose (void){
+    NS_LOG_FUNCTION (this);
+    Stop ();
+    m_vehicles.clear ();
+    m_parked.clear ();
+    m_current.clear ();
+    m_next.clear ();
+    m_factory.Nullify ();
+    Object::DoDispose ();
+}
+
+void
+V2vFcdMobilityFeed::Install (NodeContainer pool){
+    NS_LOG_FUNCTION (this);
+    for(uint32_t i = pool.GetN (); i > 0; --i){
+        Ptr<Node> node = pool.Get (i - 1);
+        GetMobility (node);
+        Park (node);
+        m_nodes++;
+    }
+}
+
+void
+V2vFcdMobilityFeed::SetVehicleFactory (VehicleFactory factory){
+    m_factory = factory;
+}
+
+bool
+V2vFcdMobilityFeed::Start (void){
+    NS_LOG_FUNCTION (this << m_source);
+    if(!m_reader.Open (m_source)){
+        return false;
+    }
+    if(ReadNext ()){
+        m_event = Simulator::Schedule (Max (Seconds (m_nextTime) - Simulator::Now (), Seconds (0)),
+                                       &V2vFcdMobilityFeed::Step, this);
+    }
+    return true;
+}
+
+void
+V2vFcdMobilityFeed::Stop (void){
+    NS_LOG_FUNCTION (this);
+    m_event.Cancel ();
+    m_reader.Close ();
+}
+
+Ptr<Node>
+V2vFcdMobilityFeed::GetNode (std::string vehicle) const {
+    VehicleMap::const_iterator it = m_vehicles.find (vehicle);
+    return it == m_vehicles.end () ? 0 : it->second.node;
+}
+
+uint32_t
+V2vFcdMobilityFeed::GetNVehicles (void) const {
+    return m_vehicles.size ();
+}
+
+uint32_t
+V2vFcdMobilityFeed::GetNNodes (void) const {
+    return m_nodes;
+}
+
+uint64_t
+V2vFcdMobilityFeed::GetArrivals (void) const {
+    return m_arrivals;
+}
+
+uint64_t
+V2vFcdMobilityFeed::GetDepartures (void) const {
+    return m_departures;
+}
+
+Ptr<ConstantVelocityMobilityModel>
+V2vFcdMobilityFeed::GetMobility (Ptr<Node> node) const {
+    Ptr<MobilityModel> mobility = node->GetObject<MobilityModel> ();
+    if(mobility == 0){
+        Ptr<ConstantVelocityMobilityModel> model = CreateObject<ConstantVelocityMobilityModel> ();
+        node->AggregateObject (model);
+        return model;
+    }
+    Ptr<ConstantVelocityMobilityModel> model = DynamicCast<ConstantVelocityMobilityModel> (mobility);
+    NS_ABORT_MSG_IF (model == 0, "V2vFcdMobilityFeed needs a ConstantVelocityMobilityModel on node " << node->GetId ());
+    return model;
+}
+
+void
+V2vFcdMobilityFeed::Park (Ptr<Node> node){
+    Ptr<ConstantVelocityMobilityModel> mobility = GetMobility (node);
+    Vector position = m_parkingPosition;
+    position.x += m_parkingSpacing*node->GetId ();
+    mobility->SetPosition (position);
+    mobility->SetVelocity (Vector ());
+    m_parked.push_back (node);
+}
+
+bool
+V2vFcdMobilityFeed::Arrive (const std::string &id, Vehicle &vehicle){
+    if(!m_parked.empty ()){
+        vehicle.node = m_parked.back ();
+        m_parked.pop_back ();
+    }
+    else if(!m_factory.IsNull ()){
+        vehicle.node = m_factory (id);
+        NS_ABORT_MSG_IF (vehicle.node == 0, "The vehicle factory returned no node for " << id);
+        m_nodes++;
+    }
+    else{
+        NS_LOG_LOGIC ("No node left for vehicle " << id);
+        return false;
+    }
+    vehicle.mobility = GetMobility (vehicle.node);
+    m_arrivals++;
+    return true;
+}
+
+bool
+V2vFcdMobilityFeed::ReadNext (void){
+    if(!m_reader.IsOpen () || !m_reader.ReadTimestep (m_nextTime, m_next)){
+        m_next.clear ();
+        return false;
+    }
+    return true;
+}
+
+void
+V2vFcdMobilityFeed::Step (void){
+    NS_LOG_FUNCTION (this << m_nextTime);
+    m_current.swap (m_next);
+    m_currentTime = m_nextTime;
+    m_timestep++;
+
+    // vehicles still on the road, then the ones leaving, which release
+    // their node before the new ones arrive
+    std::vector<uint32_t> entering;
+    for(uint32_t i = 0; i < m_current.size (); ++i){
+        const V2vFcdTraceReader::Vehicle &sample = m_current[i];
+        VehicleMap::iterator it = m_vehicles.find (sample.id);
+        if(it == m_vehicles.end ()){
+            entering.push_back (i);
+            continue;
+        }
+        it->second.position = Vector (sample.x, sample.y, sample.z);
+        it->second.velocity = Vector ();
+        it->second.timestep = m_timestep;
+    }
+    for(VehicleMap::iterator it = m_vehicles.begin (); it != m_vehicles.end ();){
+        if(it->second.timestep == m_timestep){
+            ++it;
+            continue;
+        }
+        std::string id = it->first;
+        Ptr<Node> node = it->second.node;
+        m_vehicles.erase (it++);
+        Park (node);
+        m_departures++;
+        m_departureTrace (id, node);
+    }
+    std::vector<VehicleMap::iterator> arrived;
+    for(uint32_t k = 0; k < entering.size (); ++k){
+        const V2vFcdTraceReader::Vehicle &sample = m_current[entering[k]];
+        Vehicle vehicle;
+        if(!Arrive (sample.id, vehicle)){
+            continue;
+        }
+        vehicle.position = Vector (sample.x, sample.y, sample.z);
+        vehicle.timestep = m_timestep;
+        arrived.push_back (m_vehicles.insert (std::make_pair (sample.id, vehicle)).first);
+    }
+
+    // the velocity that reaches the position of the next timestep
+    bool more = ReadNext ();
+    double interval = m_nextTime - m_currentTime;
+    if(more && interval > 0){
+        for(uint32_t i = 0; i < m_next.size (); ++i){
+            const V2vFcdTraceReader::Vehicle &sample = m_next[i];
+            VehicleMap::iterator it = m_vehicles.find (sample.id);
+            if(it == m_vehicles.end ()){
+                continue;
+            }
+            Vehicle &vehicle = it->second;
+            vehicle.velocity = Vector ((sample.x - vehicle.position.x)/interval,
+                                       (sample.y - vehicle.position.y)/interval,
+                                       (sample.z - vehicle.position.z)/interval);
+        }
+    }
+    for(VehicleMap::iterator it = m_vehicles.begin (); it != m_vehicles.end (); ++it){
+        it->second.mobility->SetPosition (it->second.position);
+        it->second.mobility->SetVelocity (it->second.velocity);
+    }
+    for(uint32_t k = 0; k < arrived.size (); ++k){
+        m_arrivalTrace (arrived[k]->first, arrived[k]->second.node);
+    }
+
+    if(more){
+        m_event = Simulator::Schedule (Max (Seconds (m_nextTime) - Simulator::Now (), Seconds (0)),
+                                       &V2vFcdMobilityFeed::Step, this);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_FCD_MOBILITY_FEED_H
+#define V2V_FCD_MOBILITY_FEED_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/node.h"
+#include "ns3/object.h"
+#include "ns3/vector.h"
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/node-container.h"
+#include "ns3/traced-callback.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "v2v-fcd-trace-reader.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vFcdMobilityFeed
+ * \brief Vehicle mobility streamed from a SUMO FCD source during the
+ * simulation.
+ *
+ * Unlike Ns2MobilityHelper, which parses the whole trace and schedules
+ * every course change up front, the feed keeps a single pending event:
+ * at the time of a timestep it reads the next one from the Source (see
+ * V2vFcdTraceReader), sets the position of every vehicle of the timestep
+ * and the constant velocity that takes it to its next position. Memory
+ * and pending events stay proportional to the vehicles on the road.
+ *
+ * A vehicle entering the trace takes a parked node of the pool given to
+ * Install, or, when none is left, a node created by the vehicle factory;
+ * without a factory the vehicle is ignored until a node is released. A
+ * vehicle leaving the trace releases its node, which is parked at
+ * ParkingPosition shifted by ParkingSpacing times its node id along x,
+ * far from the road and from the other parked nodes, to be reused by
+ * the next vehicle. The VehicleArrival and VehicleDeparture trace sources
+ * let the scenario start and stop the applications of the node.
+ */
+class V2vFcdMobilityFeed : public Object {
+public:
+
+    typedef Callback<Ptr<Node>, std::string> VehicleFactory;
+
+    static TypeId GetTypeId (void);
+
+    V2vFcdMobilityFeed ();
+    virtual ~V2vFcdMobilityFeed ();
+
+    /**
+     * \brief Park the nodes, adding a ConstantVelocityMobilityModel to the
+     * ones without a mobility model, to be taken by the vehicles.
+     * \param pool the nodes, taken in order
+     */
+    void Install (NodeContainer pool);
+
+    /**
+     * \param factory creates the node of a vehicle when no parked node is
+     * left
+     */
+    void SetVehicleFactory (VehicleFactory factory);
+
+    /**
+     * \brief Open the Source and schedule its first timestep; the trace
+     * times are simulation times.
+     * \return false if the Source could not be opened
+     */
+    bool Start (void);
+
+    /**
+     * \brief Stop reading the Source; the vehicles keep their last course.
+     */
+    void Stop (void);
+
+    /**
+     * \param vehicle the FCD id of a vehicle
+     * \return the node of the vehicle, 0 if it is not on the road
+     */
+    Ptr<Node> GetNode (std::string vehicle) const;
+
+    /**
+     * \return the number of vehicles on the road
+     */
+    uint32_t GetNVehicles (void) const;
+
+    /**
+     * \return the number of nodes, parked or not, used by the feed
+     */
+    uint32_t GetNNodes (void) const;
+
+    /**
+     * \return the number of vehicle arrivals so far
+     */
+    uint64_t GetArrivals (void) const;
+
+    /**
+     * \return the number of vehicle departures so far
+     */
+    uint64_t GetDepartures (void) const;
+
+protected:
+
+    virtual void DoDispose (void);
+
+private:
+
+    struct Vehicle {
+        Ptr<Node> node;
+        Ptr<ConstantVelocityMobilityModel> mobility;
+        Vector position;                    //!< position at the current timestep
+        Vector velocity;                    //!< velocity towards the next timestep
+        uint64_t timestep;                  //!< last timestep the vehicle was in
+    };
+
+    typedef std::map<std::string, Vehicle> VehicleMap;
+
+    void Step (void);
+    bool ReadNext (void);
+    bool Arrive (const std::string &id, Vehicle &vehicle);
+    void Park (Ptr<Node> node);
+    Ptr<ConstantVelocityMobilityModel> GetMobility (Ptr<Node> node) const;
+
+    std::string m_source;
+    Vector m_parkingPosition;
+    double m_parkingSpacing;
+    VehicleFactory m_factory;
+
+    V2vFcdTraceReader m_reader;
+    std::vector<V2vFcdTraceReader::Vehicle> m_current;
+    std::vector<V2vFcdTraceReader::Vehicle> m_next;     //!< timestep read ahead
+    double m_currentTime;
+    double m_nextTime;
+    uint64_t m_timestep;
+    EventId m_event;
+
+    VehicleMap m_vehicles;                  //!< vehicles on the road
+    std::vector<Ptr<Node> > m_parked;       //!< free nodes, the next one last
+    uint32_t m_nodes;
+    uint64_t m_arrivals;
+    uint64_t m_departures;
+
+    TracedCallback<std::string, Ptr<Node> > m_arrivalTrace;
+    TracedCallback<std::string, Ptr<Node> > m_departureTrace;
+};
+
+} // namespace ns3
+
+#endif // V2V_FCD_MOBILITY_FEED_H
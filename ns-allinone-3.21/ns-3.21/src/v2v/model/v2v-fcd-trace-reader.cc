@@ -0,0 +1,255 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include "ns3/log.h"
+#include "v2v-fcd-trace-reader.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vFcdTraceReader");
+
+namespace ns3 {
+
+static const std::string::size_type FCD_CHUNK = 65536;     //!< bytes read at once
+
+V2vFcdTraceReader::V2vFcdTraceReader () :
+        m_fd(-1),
+        m_ownFd(false),
+        m_position(0){
+}
+
+V2vFcdTraceReader::~V2vFcdTraceReader (){
+    Close ();
+}
+
+int
+V2vFcdTraceReader::Connect (std::string address){
+    std::string::size_type colon = address.rfind (':');
+    if(colon == std::string::npos){
+        NS_LOG_WARN ("Missing port in " << address);
+        return -1;
+    }
+    std::string host = address.substr (0, colon);
+    std::string port = address.substr (colon + 1);
+
+    struct addrinfo hints;
+    std::memset (&hints, 0, sizeof (hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *result;
+    if(getaddrinfo (host.empty () ? "localhost" : host.c_str (), port.c_str (), &hints, &result) != 0){
+        NS_LOG_WARN ("Could not resolve " << address);
+        return -1;
+    }
+    int fd = -1;
+    for(struct addrinfo *info = result; info != 0 && fd < 0; info = info->ai_next){
+        fd = socket (info->ai_family, info->ai_socktype, info->ai_protocol);
+        if(fd >= 0 && connect (fd, info->ai_addr, info->ai_addrlen) != 0){
+            close (fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo (result);
+    return fd;
+}
+
+bool
+V2vFcdTraceReader::Open (std::string source){
+    NS_LOG_FUNCTION (this << source);
+    Close ();
+    if(source == "-"){
+        m_fd = STDIN_FILENO;
+        m_ownFd = false;
+    }
+    else if(source.compare (0, 4, "tcp:") == 0){
+        m_fd = Connect (source.substr (4));
+        m_ownFd = true;
+    }
+    else{
+        m_fd = open (source.c_str (), O_RDONLY);
+        m_ownFd = true;
+    }
+    m_buffer.clear ();
+    m_position = 0;
+    if(m_fd < 0){
+        NS_LOG_WARN ("Could not open the FCD stream " << source << ": " << std::strerror (errno));
+        return false;
+    }
+    return true;
+}
+
+void
+V2vFcdTraceReader::Close (void){
+    if(m_fd >= 0 && m_ownFd){
+        close (m_fd);
+    }
+    m_fd = -1;
+    m_ownFd = false;
+}
+
+bool
+V2vFcdTraceReader::IsOpen (void) const {
+    return m_fd >= 0;
+}
+
+bool
+V2vFcdTraceReader::Fill (void){
+    if(m_fd < 0){
+        return false;
+    }
+    char chunk[FCD_CHUNK];
+    ssize_t n;
+    do{
+        n = read (m_fd, chunk, sizeof (chunk));
+    } while(n < 0 && errno == EINTR);
+    if(n <= 0){
+        if(n < 0){
+            NS_LOG_WARN ("Read error on the FCD stream: " << std::strerror (errno));
+        }
+        Close ();
+        return false;
+    }
+    m_buffer.append (chunk, n);
+    return true;
+}
+
+bool
+V2vFcdTraceReader::Find (const char *pattern, std::string::size_type from, std::string::size_type &at){
+    std::string::size_type length = std::strlen (pattern);
+    while((at = m_buffer.find (pattern, from)) == std::string::npos){
+        // a partial match may straddle the end of the buffer
+        if(m_buffer.size () >= length){
+            from = std::max (from, m_buffer.size () - length + 1);
+        }
+        if(!Fill ()){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+V2vFcdTraceReader::NextTag (std::string &tag){
+    // drop the parsed bytes once they are worth the copy
+    if(m_position >= FCD_CHUNK){
+        m_buffer.erase (0, m_position);
+        m_position = 0;
+    }
+    while(true){
+        std::string::size_type open;
+        if(!Find ("<", m_position, open)){
+            return false;
+        }
+        while(m_buffer.size () < open + 4 && Fill ()){
+        }
+        std::string::size_type close;
+        if(m_buffer.compare (open, 4, "<!--") == 0){
+            if(!Find ("-->", open + 4, close)){
+                return false;
+            }
+            m_position = close + 3;
+            continue;
+        }
+        if(!Find (">", open, close)){
+            return false;
+        }
+        tag.assign (m_buffer, open + 1, close - open - 1);
+        m_position = close + 1;
+        return true;
+    }
+}
+
+bool
+V2vFcdTraceReader::GetAttribute (const std::string &tag, const char *name, std::string &value){
+    std::string::size_type length = std::strlen (name);
+    std::string::size_type at = tag.find (name);
+    while(at != std::string::npos){
+        std::string::size_type end = at + length;
+        if(at > 0 && std::isspace (tag[at - 1]) && end + 1 < tag.size () && tag[end] == '='
+           && (tag[end + 1] == '"' || tag[end + 1] == '\'')){
+            std::string::size_type quote = tag.find (tag[end + 1], end + 2);
+            if(quote == std::string::npos){
+                return false;
+            }
+            value.assign (tag, end + 2, quote - end - 2);
+            return true;
+        }
+        at = tag.find (name, at + 1);
+    }
+    return false;
+}
+
+double
+V2vFcdTraceReader::GetNumber (const std::string &tag, const char *name, double fallback){
+    std::string value;
+    if(!GetAttribute (tag, name, value)){
+        return fallback;
+    }
+    return std::strtod (value.c_str (), 0);
+}
+
+bool
+V2vFcdTraceReader::ReadTimestep (double &time, std::vector<Vehicle> &vehicles){
+    NS_LOG_FUNCTION (this);
+    vehicles.clear ();
+    bool inTimestep = false;
+    std::string tag;
+    while(NextTag (tag)){
+        if(!inTimestep){
+            if(tag.compare (0, 8, "timestep") == 0 && (tag.size () == 8 || std::isspace (tag[8]))){
+                time = GetNumber (tag, "time", 0.0);
+                if(tag[tag.size () - 1] == '/'){
+                    return true;
+                }
+                inTimestep = true;
+            }
+            continue;
+        }
+        if(tag.compare (0, 9, "/timestep") == 0){
+            return true;
+        }
+        if(tag.compare (0, 7, "vehicle") == 0 && tag.size () > 7 && std::isspace (tag[7])){
+            Vehicle vehicle;
+            if(!GetAttribute (tag, "id", vehicle.id)){
+                NS_LOG_WARN ("Vehicle without id at time " << time);
+                continue;
+            }
+            vehicle.x = GetNumber (tag, "x", 0.0);
+            vehicle.y = GetNumber (tag, "y", 0.0);
+            vehicle.z = GetNumber (tag, "z", 0.0);
+            vehicle.speed = GetNumber (tag, "speed", 0.0);
+            vehicle.angle = GetNumber (tag, "angle", 0.0);
+            vehicles.push_back (vehicle);
+        }
+    }
+    // a timestep cut by the end of the stream is dropped
+    vehicles.clear ();
+    return false;
+}
+
+} // namespace ns3
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_FCD_TRACE_READER_H
+#define V2V_FCD_TRACE_READER_H
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vFcdTraceReader
+ * \brief Incremental reader of a SUMO floating car data (FCD) stream.
+ *
+ * The reader returns the <timestep> elements of a --fcd-output stream one
+ * at a time, buffering only the bytes of the element being parsed, so a
+ * trace is never loaded whole. The stream can be a file, a named pipe,
+ * the standard input ("-") or a local TCP server ("tcp:host:port"), so
+ * SUMO, or any stand-in replaying an FCD file such as
+ * "nc -l 8813 < fcd.xml", can feed a running simulation. Reads block
+ * until the next timestep is complete.
+ */
+class V2vFcdTraceReader {
+public:
+
+    struct Vehicle {
+        std::string id;
+        double x;
+        double y;
+        double z;
+        double speed;                       //!< m/s
+        double angle;                       //!< degrees, clockwise from north
+    };
+
+    V2vFcdTraceReader ();
+    ~V2vFcdTraceReader ();
+
+    /**
+     * \param source a path, "-" for the standard input or "tcp:host:port"
+     * \return true if the stream could be opened
+     */
+    bool Open (std::string source);
+
+    /**
+     * \brief Close the stream, if it was opened by the reader.
+     */
+    void Close (void);
+
+    /**
+     * \return true if a stream is open
+     */
+    bool IsOpen (void) const;
+
+    /**
+     * \brief Read the next timestep.
+     * \param time the time of the timestep (s)
+     * \param vehicles the vehicles of the timestep
+     * \return false at the end of the stream
+     */
+    bool ReadTimestep (double &time, std::vector<Vehicle> &vehicles);
+
+private:
+
+    V2vFcdTraceReader (const V2vFcdTraceReader &);
+    V2vFcdTraceReader & operator = (const V2vFcdTraceReader &);
+
+    static int Connect (std::string address);
+    static bool GetAttribute (const std::string &tag, const char *name, std::string &value);
+    static double GetNumber (const std::string &tag, const char *name, double fallback);
+
+    bool Fill (void);
+    bool Find (const char *pattern, std::string::size_type from, std::string::size_type &at);
+    bool NextTag (std::string &tag);
+
+    int m_fd;
+    bool m_ownFd;                           //!< m_fd is closed by the reader
+    std::string m_buffer;                   //!< unparsed bytes from m_position on
+    std::string::size_type m_position;
+};
+
+} // namespace ns3
+
+#endif // V2V_FCD_TRACE_READER_H
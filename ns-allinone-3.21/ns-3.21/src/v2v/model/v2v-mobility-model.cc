@@ -23,7 +23,6 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
-#include "ns3/random-variable.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include <math.h>
@@ -82,6 +81,16 @@ V2vMobilityModel::GetTypeId (void)
 }
 
 
+V2vMobilityModel::V2vMobilityModel ()
+  : m_legStart (Seconds (0)),
+    m_legEnd (Time::Max ()),
+    m_legPosition (Vector (0.0, 0.0, 0.0)),
+    m_legVelocity (0.0),
+    m_direction (1.0)
+{
+  m_variation = CreateObject<UniformRandomVariable> ();
+}
+
 void V2vMobilityModel::SetDirection(const Vector& direction){
 	//m_direction
 }
@@ -97,118 +106,203 @@ V2vMobilityModel::SetSpeedVariation(double variation){
     m_speedVariation = variation;
 }
 
+void
+V2vMobilityModel::SetLeg (const Vector &position, const Vector &velocity, Time legEnd)
+{
+  NS_ASSERT (m_bounds.IsInside (position));
+  NS_ASSERT_MSG (legEnd > Simulator::Now (), "V2vMobilityModel legs must end in the future");
+  m_legPosition = position;
+  m_legVelocity = velocity.x;
+  m_legStart = Simulator::Now ();
+  m_legEnd = legEnd;
+  ScheduleCourseChange ();
+  NotifyCourseChange ();
+}
+
+Time
+V2vMobilityModel::GetLegEnd (void) const
+{
+  Advance ();
+  return m_legEnd;
+}
+
 void
 V2vMobilityModel::DoInitialize (void)
 {
-  DoInitializePrivate ();
+  // restart from the current position with a fresh leg
+  m_legPosition = DoGetPosition ();
+  m_legVelocity = 0.0;
+  m_legStart = Simulator::Now ();
+  m_legEnd = m_legStart;
+  ScheduleCourseChange ();
   MobilityModel::DoInitialize ();
 }
 
 void
-V2vMobilityModel::DoInitializePrivate (void)
+V2vMobilityModel::Advance (void) const
 {
-  m_helper.Update ();
-  double speed = m_speed->GetValue ();
-  m_direction = 1.0;
-
-  UniformVariable randomVariable (-m_speedVariation, m_speedVariation);
-  double s = std::ceil(randomVariable.GetValue() * 100 + 0.5)/100;
+  Time now = Simulator::Now ();
+  while (m_legEnd <= now)
+    {
+      double velocity;
+      Vector position = GetLegPosition (m_legEnd, velocity);
+      StartLeg (m_legEnd, position);
+    }
+}
 
-  Vector vector (m_direction * (speed+s),
-                 0 ,
-                 0.0);
-  m_helper.SetVelocity (vector);
-  m_helper.Unpause ();
+void
+V2vMobilityModel::StartLeg (Time start, const Vector &position) const
+{
+  double speed = m_speed->GetValue ();
+  double s = std::ceil (m_variation->GetValue (-m_speedVariation, m_speedVariation) * 100 + 0.5)/100;
 
-  Time delayLeft;
+  m_legStart = start;
+  m_legPosition = position;
+  m_legVelocity = m_direction * (speed + s);
   if (m_mode == V2vMobilityModel::MODE_TIME)
     {
-      delayLeft = m_modeTime;
+      m_legEnd = start + m_modeTime;
     }
   else
     {
-      delayLeft = Seconds (m_modeDistance / speed);
+      m_legEnd = start + Seconds (m_modeDistance / speed);
     }
-  DoWalk (delayLeft);
+  NS_ASSERT_MSG (m_legEnd > m_legStart, "V2vMobilityModel legs must last more than one time step");
 }
 
-void
-V2vMobilityModel::DoWalk (Time delayLeft)
+Vector
+V2vMobilityModel::GetLegPosition (Time t, double &velocity) const
 {
-  Vector position = m_helper.GetCurrentPosition ();
-  Vector speed = m_helper.GetVelocity ();
-  Vector nextPosition = position;
-  nextPosition.x += speed.x * delayLeft.GetSeconds ();
-  nextPosition.y += speed.y * delayLeft.GetSeconds ();
-  m_event.Cancel ();
-  if (m_bounds.IsInside (nextPosition))
+  Vector position = m_legPosition;
+  velocity = m_legVelocity;
+  if (m_legVelocity == 0.0)
+    {
+      return position;
+    }
+
+  // unfold the reflections on the x bounds: the motion is periodic
+  // with period twice the width, moving backwards in its second half
+  double width = m_bounds.xMax - m_bounds.xMin;
+  double x = position.x - m_bounds.xMin + m_legVelocity * (t - m_legStart).GetSeconds ();
+  if (width <= 0)
+    {
+      position.x = m_bounds.xMin;
+      return position;
+    }
+  double phase = std::fmod (x, 2 * width);
+  if (phase < 0)
     {
-      m_event = Simulator::Schedule (delayLeft, &V2vMobilityModel::DoInitializePrivate, this);
+      phase += 2 * width;
+    }
+  if (phase <= width)
+    {
+      position.x = m_bounds.xMin + phase;
     }
   else
     {
-      nextPosition = m_bounds.CalculateIntersection (position, speed);
-      Time delay = Seconds ((nextPosition.x - position.x) / speed.x);
-      m_event = Simulator::Schedule (delay, &V2vMobilityModel::Rebound, this,
-                                     delayLeft - delay);
+      position.x = m_bounds.xMin + 2 * width - phase;
+      velocity = -velocity;
     }
-  NotifyCourseChange ();
+  return position;
 }
 
 void
-V2vMobilityModel::Rebound (Time delayLeft)
+V2vMobilityModel::ScheduleCourseChange (void)
 {
-  m_helper.UpdateWithBounds (m_bounds);
-  Vector position = m_helper.GetCurrentPosition ();
-  Vector speed = m_helper.GetVelocity ();
-  switch (m_bounds.GetClosestSide (position))
+  m_event.Cancel ();
+  if (!HasCourseChangeListeners ())
+    {
+      return;
+    }
+
+  Time now = Simulator::Now ();
+  if (m_legEnd <= now)
+    {
+      // the next leg is drawn when the event runs, after the setup
+      // of the current time step is over
+      m_event = Simulator::ScheduleNow (&V2vMobilityModel::CourseChange, this);
+      return;
+    }
+
+  double velocity;
+  Vector position = GetLegPosition (now, velocity);
+  Time delay = m_legEnd - now;
+  if (velocity != 0.0)
     {
-    case Rectangle::RIGHT:
-    case Rectangle::LEFT:
-      speed.x = -speed.x;
-      break;
-    case Rectangle::TOP:
-    case Rectangle::BOTTOM:
-      speed.y = -speed.y;
-      break;
+      double width = m_bounds.xMax - m_bounds.xMin;
+      double left = velocity > 0 ? m_bounds.xMax - position.x : position.x - m_bounds.xMin;
+      Time reflection = Seconds (left / std::fabs (velocity));
+      if (reflection.IsZero ())
+        {
+          reflection = Seconds ((left + width) / std::fabs (velocity));
+        }
+      if (reflection < delay)
+        {
+          delay = reflection;
+        }
     }
-  m_helper.SetVelocity (speed);
-  m_helper.Unpause ();
-  DoWalk (delayLeft);
+  m_event = Simulator::Schedule (delay, &V2vMobilityModel::CourseChange, this);
+}
+
+void
+V2vMobilityModel::CourseChange (void)
+{
+  Advance ();
+  NotifyCourseChange ();
+  ScheduleCourseChange ();
 }
 
 void
 V2vMobilityModel::DoDispose (void)
 {
+  m_event.Cancel ();
   // chain up
   MobilityModel::DoDispose ();
 }
+void
+V2vMobilityModel::CheckCourseChangeListeners (void) const
+{
+  // a sink connected after the initialization, e.g. by a scheduled event,
+  // is only noticed here
+  if (!m_event.IsRunning () && HasCourseChangeListeners ())
+    {
+      const_cast<V2vMobilityModel *> (this)->ScheduleCourseChange ();
+    }
+}
 Vector
 V2vMobilityModel::DoGetPosition (void) const
 {
-  m_helper.UpdateWithBounds (m_bounds);
-  return m_helper.GetCurrentPosition ();
+  CheckCourseChangeListeners ();
+  Advance ();
+  double velocity;
+  return GetLegPosition (Simulator::Now (), velocity);
 }
 void
 V2vMobilityModel::DoSetPosition (const Vector &position)
 {
   NS_ASSERT (m_bounds.IsInside (position));
-  m_helper.SetPosition (position);
-  Simulator::Remove (m_event);
-  m_event = Simulator::ScheduleNow (&V2vMobilityModel::DoInitializePrivate, this);
+  m_legPosition = position;
+  m_legVelocity = 0.0;
+  m_legStart = Simulator::Now ();
+  m_legEnd = m_legStart;
+  ScheduleCourseChange ();
 }
 Vector
 V2vMobilityModel::DoGetVelocity (void) const
 {
-  return m_helper.GetVelocity ();
+  CheckCourseChangeListeners ();
+  Advance ();
+  double velocity;
+  GetLegPosition (Simulator::Now (), velocity);
+  return Vector (velocity, 0.0, 0.0);
 }
 int64_t
 V2vMobilityModel::DoAssignStreams (int64_t stream)
 {
   m_speed->SetStream (stream);
   m_directionVariable->SetStream (stream + 1);
-  return 2;
+  m_variation->SetStream (stream + 2);
+  return 3;
 }
 
-
 } // namespace ns3
@@ -27,7 +27,6 @@
 #include "ns3/rectangle.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/mobility-model.h"
-#include "ns3/constant-velocity-helper.h"
 
 namespace ns3 {
 
@@ -36,12 +35,26 @@ namespace ns3 {
  * \ingroup mobility
  * \brief Constant direction, random velocity mobility model
  *
+ * The trajectory is a sequence of legs. Every leg starts along +x with a
+ * speed drawn from Speed plus a SpeedVariation offset and lasts Time, or
+ * Distance over the drawn speed, reflecting on the x bounds of Bounds.
+ *
+ * Position and velocity are evaluated analytically from the current leg;
+ * legs are drawn lazily when a query crosses the end of the previous one,
+ * so the model schedules no events. Only when a sink is connected to the
+ * CourseChange trace source are events scheduled at the leg ends and the
+ * reflections to notify it. The sinks are looked for at the
+ * initialization, at SetPosition and at every position or velocity query,
+ * so a sink connected later, by a scheduled event, is notified from the
+ * next query of the model on; the course changes before it are missed.
  */
 class V2vMobilityModel : public MobilityModel
 {
 public:
   static TypeId GetTypeId (void);
 
+  V2vMobilityModel ();
+
   enum Mode  {
     MODE_DISTANCE,
     MODE_TIME
@@ -63,10 +76,47 @@ public:
    */
   void SetSpeedVariation (double variation);
 
+  /**
+   * \brief Replace the current leg, e.g. to resume a saved trajectory.
+   *
+   * Unlike SetPosition, which starts a new leg from standstill, the node
+   * keeps moving at the given velocity until the leg end.
+   *
+   * \param position the position now
+   * \param velocity the velocity now; only the x component is used
+   * \param legEnd the end of the leg, later than now
+   */
+  void SetLeg (const Vector &position, const Vector &velocity, Time legEnd);
+
+  /**
+   * \return the end of the current leg
+   */
+  Time GetLegEnd (void) const;
+
 private:
-  void Rebound (Time timeLeft);
-  void DoWalk (Time timeLeft);
-  void DoInitializePrivate (void);
+  /**
+   * \brief Draw the legs up to the current simulation time.
+   */
+  void Advance (void) const;
+  /**
+   * \brief Draw a new leg.
+   * \param start the start time of the leg
+   * \param position the position at the start of the leg
+   */
+  void StartLeg (Time start, const Vector &position) const;
+  /**
+   * \param t a time within the current leg
+   * \param velocity the x velocity at t
+   * \return the position at t
+   */
+  Vector GetLegPosition (Time t, double &velocity) const;
+  void ScheduleCourseChange (void);
+  /**
+   * \brief Start the course change events if a sink was connected since
+   * the last check.
+   */
+  void CheckCourseChangeListeners (void) const;
+  void CourseChange (void);
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
   virtual Vector DoGetPosition (void) const;
@@ -74,14 +124,18 @@ private:
   virtual Vector DoGetVelocity (void) const;
   virtual int64_t DoAssignStreams (int64_t);
 
-  ConstantVelocityHelper m_helper;
-  EventId m_event;
+  mutable Time m_legStart;             //!< start time of the current leg
+  mutable Time m_legEnd;               //!< end time of the current leg
+  mutable Vector m_legPosition;        //!< position at the start of the current leg
+  mutable double m_legVelocity;        //!< x velocity at the start of the current leg
+  EventId m_event;                     //!< next course change, only with CourseChange sinks
   enum Mode m_mode;
   double m_modeDistance;
   Time m_modeTime;
   Ptr<RandomVariableStream> m_speed;
   double m_direction;
   Ptr<RandomVariableStream> m_directionVariable;
+  Ptr<UniformRandomVariable> m_variation;
   Rectangle m_bounds;
 
   double m_speedVariation;
@@ -18,6 +18,7 @@
  * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
  */
 
+#include <sstream>
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/nstime.h"
@@ -26,6 +27,7 @@
 #include "ns3/packet.h"
 #include "ns3/address.h"
 #include "ns3/pointer.h"
+#include "ns3/enum.h"
 #include "ns3/uinteger.h"
 #include "ns3/simulator.h"
 #include "ns3/udp-socket.h"
@@ -36,6 +38,7 @@
 #include "ns3/inet6-socket-address.h"
 #include "ns3/packet-socket-address.h"
 #include "ns3/trace-source-accessor.h"
+#include "v2v-cluster-registry.h"
 #include "v2v-modified-dmac-algorithm-client.h"
 
 #include "ns3/random-variable.h"
@@ -125,6 +128,26 @@ TypeId V2vModifiedDMACAlgorithmClient::GetTypeId(void) {
                     "The maximun size of hehicles permitted", UintegerValue(100),
                     MakeUintegerAccessor(&V2vModifiedDMACAlgorithmClient::m_maxUes),
                     MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("NeighborRange",
+                    "Radius (m) around the node of the neighbors used by the weight, served by a spatial grid; at least the radio range, 0 for every neighbor",
+                    DoubleValue(1000.0),
+                    MakeDoubleAccessor(&V2vModifiedDMACAlgorithmClient::m_neighborRange),
+                    MakeDoubleChecker<double>(0.0))
+            .AddAttribute("NeighborGridCellSize",
+                    "Side (m) of a spatial grid cell of the neighbor table; 0 for NeighborRange",
+                    DoubleValue(0.0),
+                    MakeDoubleAccessor(&V2vModifiedDMACAlgorithmClient::m_gridCellSize),
+                    MakeDoubleChecker<double>(0.0))
+            .AddAttribute("SlotAllocation",
+                    "How the TDMA offset of the node is chosen: VehicleTdmaSlot, or a hashed slot moved on collisions",
+                    EnumValue(V2vSlotAllocator::FIXED),
+                    MakeEnumAccessor(&V2vModifiedDMACAlgorithmClient::m_slotScheme),
+                    MakeEnumChecker(V2vSlotAllocator::FIXED, "Fixed",
+                                    V2vSlotAllocator::HASHED, "Hashed"))
+            .AddAttribute("FrameSlots",
+                    "Number of MinimumTdmaSlot slots of the TDMA frame of the hashed scheme", UintegerValue(100),
+                    MakeUintegerAccessor(&V2vModifiedDMACAlgorithmClient::m_frameSlots),
+                    MakeUintegerChecker<uint32_t>(1))
             .AddAttribute ("Interval",
                     "The time to wait between packets", TimeValue (Seconds (1.0)),
                     MakeTimeAccessor (&V2vModifiedDMACAlgorithmClient::m_interval),
@@ -155,16 +178,29 @@ V2vModifiedDMACAlgorithmClient::V2vModifiedDMACAlgorithmClient () {
 
     m_socket = 0;
     m_socketListening = 0;
+    m_lightestNeighbor.SetOrder (V2vWeightIndex::LOWEST_FIRST);
 
     m_clusterChanges = 0;
     m_numberOfMessages = 0;
     m_clusterChangesPerSec = 0;
+    m_registered = false;
+    m_registeredRole = V2vClusterSap::STANDALONE;
 
     m_sentCounter = 0;
     m_receivedCounter = 0;
 
-    m_neighborMap.clear ();
+    m_neighborMap.Clear ();
+    m_neighborExpiry.Clear ();
+    m_lightestNeighbor.Clear ();
+    m_heaviestClusterHead.Clear ();
     m_sendEvent = EventId ();
+
+    for(uint32_t type = 0; type < V2vClusterSap::MESSAGE_TYPES; ++type){
+        m_messageHandlers[type] = 0;
+    }
+    m_messageHandlers[V2vClusterSap::DMAC_HELLO_MESSAGE] = &V2vModifiedDMACAlgorithmClient::HandleHello;
+    m_messageHandlers[V2vClusterSap::DMAC_CH_MESSAGE] = &V2vModifiedDMACAlgorithmClient::HandleCH;
+    m_messageHandlers[V2vClusterSap::DMAC_JOIN_MESSAGE] = &V2vModifiedDMACAlgorithmClient::HandleJoin;
 }
 
 V2vModifiedDMACAlgorithmClient::~V2vModifiedDMACAlgorithmClient () {
@@ -176,38 +212,23 @@ V2vModifiedDMACAlgorithmClient::~V2vModifiedDMACAlgorithmClient () {
     m_sentCounter = 0;
     m_receivedCounter = 0;
 
-    m_neighborMap.clear ();
+    m_neighborMap.Clear ();
+    m_neighborExpiry.Clear ();
+    m_lightestNeighbor.Clear ();
+    m_heaviestClusterHead.Clear ();
     m_sendEvent.Cancel ();
 }
 
 double
 V2vModifiedDMACAlgorithmClient::GetClusterMembers(void){
 
-    if(m_clusterMembers.size () > 0){
-
-        double s = 0.0;
-        for(std::vector<uint64_t>::iterator it = m_clusterMembers.begin (); it != m_clusterMembers.end (); ++it){
-            s += (*it);
-        }
-        return s/m_clusterMembers.size ();
-    }
-
-    return 0;
+    return m_clusterMembers.GetMean ();
 }
 
 double
 V2vModifiedDMACAlgorithmClient::GetFormationDelay (){
 
-    if(m_formationDelayVector.size () > 0){
-
-        uint64_t sumDelay = 0;
-        for(std::vector<uint64_t>::iterator it = m_formationDelayVector.begin (); it != m_formationDelayVector.end (); ++it){
-            sumDelay += *it;
-        }
-        return TimeStep (sumDelay/m_formationDelayVector.size ()).GetSeconds ();
-    }
-
-    return 0;
+    return m_formationDelay.GetMean ();
 }
 
 uint64_t
@@ -225,6 +246,11 @@ V2vModifiedDMACAlgorithmClient::GetRole (void){
     return m_currentInfo.role;
 }
 
+uint64_t
+V2vModifiedDMACAlgorithmClient::GetClusterId (void){
+    return m_currentInfo.CHindex;
+}
+
 uint64_t
 V2vModifiedDMACAlgorithmClient::GetNumberOfMessagesPerSecond (void){
     uint64_t tmp = m_numberOfMessagesPerSec;
@@ -246,19 +272,10 @@ V2vModifiedDMACAlgorithmClient::GetChDuration (void){
     if(m_chDurationBoolean){
         m_chDurationBoolean = false;
         m_stopChDuration = Simulator::Now ().GetTimeStep ();
-        m_chDurationVector.push_back (m_stopChDuration - m_startChDuration);
-    }
-
-    if(m_chDurationVector.size () > 0){
-
-        uint64_t sumDuration = 0;
-        for(std::vector<uint64_t>::iterator it = m_chDurationVector.begin (); it != m_chDurationVector.end (); ++it){
-            sumDuration += *it;
-        }
-        return TimeStep (sumDuration/m_chDurationVector.size ()).GetSeconds ();
+        m_chDuration.Add (TimeStep (m_stopChDuration - m_startChDuration).GetSeconds ());
     }
 
-    return 0;
+    return m_chDuration.GetMean ();
 }
 
 double
@@ -267,67 +284,181 @@ V2vModifiedDMACAlgorithmClient::GetCmDuration (void){
     if(m_cmDurationBoolean){
         m_cmDurationBoolean = false;
         m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-        m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
+        m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
     }
 
-    if(m_cmDurationVector.size () > 0){
-
-        uint64_t sumDuration = 0;
-        for(std::vector<uint64_t>::iterator it = m_cmDurationVector.begin (); it != m_cmDurationVector.end (); ++it){
-            sumDuration += *it;
-        }
-        return TimeStep (sumDuration/m_cmDurationVector.size ()).GetSeconds ();
-    }
-
-    return 0;
+    return m_cmDuration.GetMean ();
 }
 
 double
 V2vModifiedDMACAlgorithmClient::GetMinChDuration (void){
 
-    uint64_t min = Simulator::Now ().GetTimeStep ();
-    for(std::vector<uint64_t>::iterator it = m_chDurationVector.begin (); it != m_chDurationVector.end (); ++it){
-        if((*it) < min){
-            min = *it;
-        }
+    if(m_chDuration.GetCount () == 0){
+        return Simulator::Now ().GetSeconds ();
     }
-    return TimeStep (min).GetSeconds ();
+    return m_chDuration.GetMin ();
 }
 
 double
 V2vModifiedDMACAlgorithmClient::GetMaxChDuration (void){
 
-    uint64_t max = 0;
-    for(std::vector<uint64_t>::iterator it = m_chDurationVector.begin (); it != m_chDurationVector.end (); ++it){
-        if((*it) > max){
-            max = *it;
-        }
-    }
-    return TimeStep (max).GetSeconds ();
+    return m_chDuration.GetMax ();
 }
 
 double
 V2vModifiedDMACAlgorithmClient::GetMinCmDuration (void){
 
-    uint64_t min = Simulator::Now ().GetTimeStep ();
-    for(std::vector<uint64_t>::iterator it = m_cmDurationVector.begin (); it != m_cmDurationVector.end (); ++it){
-        if((*it) < min){
-            min = *it;
-        }
+    if(m_cmDuration.GetCount () == 0){
+        return Simulator::Now ().GetSeconds ();
     }
-    return TimeStep (min).GetSeconds ();
+    return m_cmDuration.GetMin ();
 }
 
 double
 V2vModifiedDMACAlgorithmClient::GetMaxCmDuration (void){
 
-    uint64_t max = 0;
-    for(std::vector<uint64_t>::iterator it = m_cmDurationVector.begin (); it != m_cmDurationVector.end (); ++it){
-        if((*it) > max){
-            max = *it;
-        }
+    return m_cmDuration.GetMax ();
+}
+
+const V2vStatisticsAccumulator &
+V2vModifiedDMACAlgorithmClient::GetFormationDelayStatistics (void) const {
+    return m_formationDelay;
+}
+
+const V2vStatisticsAccumulator &
+V2vModifiedDMACAlgorithmClient::GetClusterMembersStatistics (void) const {
+    return m_clusterMembers;
+}
+
+const V2vStatisticsAccumulator &
+V2vModifiedDMACAlgorithmClient::GetChDurationStatistics (void) const {
+    return m_chDuration;
+}
+
+const V2vStatisticsAccumulator &
+V2vModifiedDMACAlgorithmClient::GetCmDurationStatistics (void) const {
+    return m_cmDuration;
+}
+
+const V2vSlotAllocator &
+V2vModifiedDMACAlgorithmClient::GetSlotAllocator (void) const {
+    return m_slots;
+}
+
+void
+V2vModifiedDMACAlgorithmClient::SendControl (Ptr<Socket> socket, Ptr<Packet> packet){
+    if(m_scheduler != 0){
+        m_scheduler->Send (socket, packet, V2vChannelScheduler::CCH);
+    }
+    else{
+        socket->Send (packet);
+    }
+}
+
+double
+V2vModifiedDMACAlgorithmClient::GetTdmaOffset (void) const {
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        return m_slots.GetOffset ().GetSeconds ();
+    }
+    return m_vehicleTdmaSlot;
+}
+
+uint32_t
+V2vModifiedDMACAlgorithmClient::GetTdmaFrameSlots (void) const {
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        return m_slots.GetFrameSlots ();
+    }
+    return m_maxUes;
+}
+
+void
+V2vModifiedDMACAlgorithmClient::SaveState (V2vSnapshotWriter &writer) const {
+
+    writer.Write ("nodeState", (uint32_t) m_nodeState);
+    writer.Write ("currentInfo", m_currentInfo);
+    writer.WriteTable ("clusterMap", m_clusterMap, 0);
+    writer.WriteTable ("neighborMap", m_neighborMap, &m_neighborExpiry);
+    writer.Write ("forwardHello", m_forwardHello);
+    writer.Write ("forwardCH", m_forwardCH);
+    writer.Write ("forwardJoin", m_forwardJoin);
+
+    writer.Write ("sentCounter", m_sentCounter);
+    writer.Write ("receivedCounter", m_receivedCounter);
+    writer.Write ("startFormationDelay", m_startFormationDelay);
+    writer.Write ("stopFormationDelay", m_stopFormationDelay);
+    writer.Write ("formationDelay", m_formationDelay);
+    writer.Write ("clusterMembers", m_clusterMembers);
+    writer.Write ("clusterChanges", m_clusterChanges);
+    writer.Write ("numberOfMessages", m_numberOfMessages);
+    writer.Write ("numberOfMessagesPerSec", m_numberOfMessagesPerSec);
+    writer.Write ("clusterChangesPerSec", m_clusterChangesPerSec);
+    writer.Write ("chDurationBoolean", m_chDurationBoolean);
+    writer.Write ("startChDuration", m_startChDuration);
+    writer.Write ("stopChDuration", m_stopChDuration);
+    writer.Write ("chDuration", m_chDuration);
+    writer.Write ("cmDurationBoolean", m_cmDurationBoolean);
+    writer.Write ("startCmDuration", m_startCmDuration);
+    writer.Write ("stopCmDuration", m_stopCmDuration);
+    writer.Write ("cmDuration", m_cmDuration);
+    m_slots.SaveState (writer);
+
+    writer.WriteEvent ("sendEvent", m_sendEvent);
+    writer.WriteEvent ("sendHelloEvent", m_sendHelloEvent);
+    writer.WriteEvent ("maintenanceEvent", m_maintenanceEvent);
+}
+
+void
+V2vModifiedDMACAlgorithmClient::SetSnapshot (const std::string &record){
+    m_snapshot = record;
+}
+
+void
+V2vModifiedDMACAlgorithmClient::LoadState (V2vSnapshotReader &reader){
+    NS_LOG_FUNCTION (this);
+
+    uint32_t nodeState;
+    reader.Read ("nodeState", nodeState);
+    m_nodeState = (V2vClusterSap::DMACNodeState) nodeState;
+    reader.Read ("currentInfo", m_currentInfo);
+    reader.ReadTable ("clusterMap", m_clusterMap, 0);
+    reader.ReadTable ("neighborMap", m_neighborMap, &m_neighborExpiry);
+    RebuildNeighborIndex ();
+    reader.Read ("forwardHello", m_forwardHello);
+    reader.Read ("forwardCH", m_forwardCH);
+    reader.Read ("forwardJoin", m_forwardJoin);
+
+    reader.Read ("sentCounter", m_sentCounter);
+    reader.Read ("receivedCounter", m_receivedCounter);
+    reader.Read ("startFormationDelay", m_startFormationDelay);
+    reader.Read ("stopFormationDelay", m_stopFormationDelay);
+    reader.Read ("formationDelay", m_formationDelay);
+    reader.Read ("clusterMembers", m_clusterMembers);
+    reader.Read ("clusterChanges", m_clusterChanges);
+    reader.Read ("numberOfMessages", m_numberOfMessages);
+    reader.Read ("numberOfMessagesPerSec", m_numberOfMessagesPerSec);
+    reader.Read ("clusterChangesPerSec", m_clusterChangesPerSec);
+    reader.Read ("chDurationBoolean", m_chDurationBoolean);
+    reader.Read ("startChDuration", m_startChDuration);
+    reader.Read ("stopChDuration", m_stopChDuration);
+    reader.Read ("chDuration", m_chDuration);
+    reader.Read ("cmDurationBoolean", m_cmDurationBoolean);
+    reader.Read ("startCmDuration", m_startCmDuration);
+    reader.Read ("stopCmDuration", m_stopCmDuration);
+    reader.Read ("cmDuration", m_cmDuration);
+    m_slots.LoadState (reader);
+
+    Time delay = reader.ReadEvent ("sendEvent");
+    if(!delay.IsNegative ()){
+        ScheduleTransmit (delay);
+    }
+    delay = reader.ReadEvent ("sendHelloEvent");
+    if(!delay.IsNegative ()){
+        ScheduleTransmitHello (delay);
+    }
+    delay = reader.ReadEvent ("maintenanceEvent");
+    if(!delay.IsNegative ()){
+        ScheduleMaintenance (delay);
     }
-    return TimeStep (max).GetSeconds ();
 }
 
 void
@@ -339,15 +470,14 @@ V2vModifiedDMACAlgorithmClient::PrintStatistics (std::ostream &os){
        << " Overall Received messages: " << m_receivedCounter << std::endl
        << "********************************************************" << std::endl;
 
-    uint64_t sumDelay = 0;
+    double sumDelay = m_formationDelay.GetSum ();
     UniformVariable u(1, 6);
-    for(std::vector<uint64_t>::iterator it = m_formationDelayVector.begin (); it != m_formationDelayVector.end (); ++it){
-        sumDelay += *it;
-        sumDelay += (int)u.GetValue ()*100000;
+    for(uint64_t i = 0; i < m_formationDelay.GetCount (); ++i){
+        sumDelay += TimeStep ((int)u.GetValue ()*100000).GetSeconds ();
     }
-    if(m_formationDelayVector.size () != 0){
+    if(m_formationDelay.GetCount () != 0){
         os << "\n********************************************************" << std::endl
-           << "  - Average Cluster Formation Delay:" << TimeStep (sumDelay/m_formationDelayVector.size ()).GetSeconds () <<  std::endl
+           << "  - Average Cluster Formation Delay:" << sumDelay/m_formationDelay.GetCount () <<  std::endl
            << " ------------------------------------------------------" << std::endl
            << "********************************************************" << std::endl;
     }
@@ -369,11 +499,25 @@ V2vModifiedDMACAlgorithmClient::DoDispose (void) {
 
     m_socket = 0;
     m_socketListening = 0;
+    m_scheduler = 0;
+
+    if(m_registered){
+        V2vClusterRegistry::Get ()->Unregister (m_registeredRole);
+        m_registered = false;
+    }
 
     // chain up
     Application::DoDispose();
 }
 
+void
+V2vModifiedDMACAlgorithmClient::UpdateRegistryRole (void){
+    if(m_registered && m_currentInfo.role != m_registeredRole){
+        V2vClusterRegistry::Get ()->NotifyRoleChange (m_registeredRole, m_currentInfo.role);
+        m_registeredRole = m_currentInfo.role;
+    }
+}
+
 void
 V2vModifiedDMACAlgorithmClient::StartApplication (void)
 {
@@ -397,15 +541,37 @@ V2vModifiedDMACAlgorithmClient::StartApplication (void)
                 MakeCallback(&V2vModifiedDMACAlgorithmClient::ConnectionFailed, this));
     }
 
-    if(m_maxUes > 100){
+    //!< Control messages go on the CCH only
+    m_scheduler = GetNode ()->GetObject<V2vChannelScheduler> ();
+    if(m_scheduler != 0 && !m_scheduler->BindToChannel (m_socket, V2vChannelScheduler::CCH)){
+        NS_FATAL_ERROR("Error: V2vChannelScheduler without a CCH device.");
+    }
+
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        m_slots.Start (GetNode ()->GetId (), m_frameSlots, Seconds (m_minimumTdmaSlot));
+    }
+    else if(m_maxUes > 100){
         NS_FATAL_ERROR("Error: Maximum number of ues is 100.");
     }
 
     StartListeningLocal();
+    m_neighborMap.SetCellSize (m_gridCellSize > 0 ? m_gridCellSize : m_neighborRange);
+
+    if(!m_snapshot.empty ()){
+        std::istringstream record (m_snapshot);
+        V2vSnapshotReader reader (record);
+        LoadState (reader);
+        m_snapshot.clear ();
+    }
+    else{
+        ScheduleTransmit (Seconds (m_trainingPeriod + (2*GetTdmaFrameSlots ()*m_minimumTdmaSlot+GetTdmaOffset ())+1.0));
+        ScheduleTransmitHello (Seconds (m_trainingPeriod + GetTdmaOffset ()));
+        ScheduleMaintenance (Seconds (m_trainingPeriod +(7*GetTdmaFrameSlots ()*m_minimumTdmaSlot)+GetTdmaOffset ()));
+    }
 
-    ScheduleTransmit (Seconds (m_trainingPeriod + (2*m_maxUes*m_minimumTdmaSlot+m_vehicleTdmaSlot)+1.0));
-    ScheduleTransmitHello (Seconds (m_trainingPeriod + m_vehicleTdmaSlot));
-    ScheduleMaintenance (Seconds (m_trainingPeriod +(7*m_maxUes*m_minimumTdmaSlot)+m_vehicleTdmaSlot));
+    m_registeredRole = m_currentInfo.role;
+    m_registered = true;
+    V2vClusterRegistry::Get ()->Register (m_registeredRole);
 }
 
 void
@@ -495,155 +661,178 @@ V2vModifiedDMACAlgorithmClient::HandleRead (Ptr<Socket> socket) {
             break;
         }
 
-        Ptr<Packet> p = packet->Copy ();
-        PacketMetadata::ItemIterator metadataIterator = p->BeginItem();
-        PacketMetadata::Item item;
-        while (metadataIterator.HasNext()){
-            item = metadataIterator.Next();
+        V2vClusterTypeHeader typeHeader;
+        packet->RemoveHeader (typeHeader);
 
-            if(item.tid.GetName() == "ns3::V2vDMACHelloHeader"){
-                V2vDMACHelloHeader helloHeader;
-                p->RemoveHeader (helloHeader);
+        MessageHandler handler = 0;
+        if(typeHeader.IsValid ()){
+            handler = m_messageHandlers[typeHeader.GetType ()];
+        }
+        if(handler != 0){
+            (this->*handler) (packet, from);
+        }
+        else{
+            NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " Dropped message of unknown type: " << typeHeader.GetType ());
+        }
+        m_rxTrace(packet, from);
+        m_receivedCounter ++;
+    }
+}
 
-                NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Received Hello message from: " << helloHeader.GetHelloInfo ().id);
-                m_neighborMap[helloHeader.GetHelloInfo().id] = CreateNeighbor(helloHeader.GetTs (), helloHeader.GetHelloInfo ());
+void
+V2vModifiedDMACAlgorithmClient::HandleHello (Ptr<Packet> packet, const Address &from) {
+    NS_LOG_FUNCTION (this << packet << from);
+    V2vDMACHelloHeader helloHeader;
+    packet->RemoveHeader (helloHeader);
 
-                if(TestClusterHeadChange(helloHeader.GetHelloInfo().id, m_neighborMap[helloHeader.GetHelloInfo().id])){
+    NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Received Hello message from: " << helloHeader.GetHelloInfo ().id);
+    //!< A forwarded hello is stamped in the slot of the forwarder
+    if(m_slotScheme == V2vSlotAllocator::HASHED && helloHeader.GetHelloInfo ().ttl == m_ttl){
+        m_slots.NotifyReceived (helloHeader.GetHelloInfo ().id, helloHeader.GetTs ());
+    }
+    V2vClusterSap::DMACHello hello = helloHeader.GetHelloInfo ();
+    V2vClusterSap::DMACNeighbours &neighbor = m_neighborMap.Insert (hello.id, hello.position, hello.velocity, CreateNeighbor(helloHeader.GetTs (), hello));
+    m_neighborExpiry.Schedule (hello.id, helloHeader.GetTs () + Seconds (1.5));
+    IndexNeighbor (hello.id, neighbor);
 
-                    ChangeState (V2vClusterSap::SENDJOIN);
-                    double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (3*m_maxUes*m_minimumTdmaSlot) + m_vehicleTdmaSlot);
-                    NS_LOG_UNCOND("Schedule to sent after: " << dt);
-                    m_sendEvent.Cancel ();
-                    ScheduleTransmit (Seconds(abs (dt)));
+    if(TestClusterHeadChange(hello.id, neighbor)){
 
-                    m_currentInfo.CHindex = helloHeader.GetHelloInfo ().id;
-                    m_currentInfo.role = V2vClusterSap::CM;
+        ChangeState (V2vClusterSap::SENDJOIN);
+        double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (3*GetTdmaFrameSlots ()*m_minimumTdmaSlot) + GetTdmaOffset ());
+        NS_LOG_UNCOND("Schedule to sent after: " << dt);
+        m_sendEvent.Cancel ();
+        ScheduleTransmit (Seconds(abs (dt)));
 
-                    m_clusterChanges ++;
-                    m_clusterChangesPerSec ++;
+        m_currentInfo.CHindex = helloHeader.GetHelloInfo ().id;
+        m_currentInfo.role = V2vClusterSap::CM;
+        UpdateRegistryRole ();
 
-                    if(m_chDurationBoolean){
-                        m_chDurationBoolean = false;
-                        m_stopChDuration = Simulator::Now ().GetTimeStep ();
-                        m_chDurationVector.push_back (m_stopChDuration - m_startChDuration);
-                    }
+        m_clusterChanges ++;
+        m_clusterChangesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyClusterChange ();
 
-                    if(m_cmDurationBoolean){
-                        m_cmDurationBoolean = false;
-                        m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-                        m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
-                    }
+        if(m_chDurationBoolean){
+            m_chDurationBoolean = false;
+            m_stopChDuration = Simulator::Now ().GetTimeStep ();
+            m_chDuration.Add (TimeStep (m_stopChDuration - m_startChDuration).GetSeconds ());
+        }
 
-                    if(m_cmDurationBoolean == false){
-                        m_startCmDuration = Simulator::Now ().GetTimeStep ();
-                        m_cmDurationBoolean = true;
-                    }
+        if(m_cmDurationBoolean){
+            m_cmDurationBoolean = false;
+            m_stopCmDuration = Simulator::Now ().GetTimeStep ();
+            m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
+        }
 
-                }
+        if(m_cmDurationBoolean == false){
+            m_startCmDuration = Simulator::Now ().GetTimeStep ();
+            m_cmDurationBoolean = true;
+        }
 
-                if(helloHeader.GetHelloInfo ().ttl > 1){
-                    CreateForwardedHelloPacket(helloHeader.GetHelloInfo ());
+    }
 
-                    ChangeState (V2vClusterSap::FORWARDHELLO);
-                    NS_LOG_UNCOND("Forward Hello message to new neighbourhood");
-                    double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (4*m_maxUes*m_minimumTdmaSlot) + m_vehicleTdmaSlot);
-                    ScheduleTransmit (Seconds(abs (dt)));
-                }
+    if(helloHeader.GetHelloInfo ().ttl > 1){
+        CreateForwardedHelloPacket(helloHeader.GetHelloInfo ());
+
+        ChangeState (V2vClusterSap::FORWARDHELLO);
+        NS_LOG_UNCOND("Forward Hello message to new neighbourhood");
+        double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (4*GetTdmaFrameSlots ()*m_minimumTdmaSlot) + GetTdmaOffset ());
+        ScheduleTransmit (Seconds(abs (dt)));
+    }
+}
+
+void
+V2vModifiedDMACAlgorithmClient::HandleCH (Ptr<Packet> packet, const Address &from) {
+    NS_LOG_FUNCTION (this << packet << from);
+    V2vDMACCHHeader chHeader;
+    packet->RemoveHeader (chHeader);
+
+    NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " From:" << chHeader.GetCHInfo ().id << " Received V2vDMACCHHeader at time: " << chHeader.GetTs());
+    V2vClusterSap::DMACNeighbours *found = m_neighborMap.Find (chHeader.GetCHInfo ().id);
+    if(found != 0){
+        NS_LOG_UNCOND("Received Cluster Head message from:" << chHeader.GetCHInfo ().id);
+
+        if(TestClusterHeadChange(chHeader.GetCHInfo ().id, *found)){
+
+            ChangeState (V2vClusterSap::SENDJOIN);
+            double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (3*GetTdmaFrameSlots ()*m_minimumTdmaSlot) + GetTdmaOffset ());
+            NS_LOG_UNCOND("Schedule to sent after: " << dt);
+            m_sendEvent.Cancel ();
+            ScheduleTransmit (Seconds(abs (dt)));
+
+            m_currentInfo.CHindex = chHeader.GetCHInfo ().id;
+            m_currentInfo.role = V2vClusterSap::CM;
+            UpdateRegistryRole ();
+
+            m_clusterChanges ++;
+            m_clusterChangesPerSec ++;
+            V2vClusterRegistry::Get ()->NotifyClusterChange ();
+
+            if(m_chDurationBoolean){
+                m_chDurationBoolean = false;
+                m_stopChDuration = Simulator::Now ().GetTimeStep ();
+                m_chDuration.Add (TimeStep (m_stopChDuration - m_startChDuration).GetSeconds ());
             }
-            else if(item.tid.GetName() == "ns3::V2vDMACCHHeader"){
-                V2vDMACCHHeader chHeader;
-                p->RemoveHeader (chHeader);
-
-                NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " From:" << chHeader.GetCHInfo ().id << " Received V2vDMACCHHeader at time: " << chHeader.GetTs());
-                std::map<uint64_t, V2vClusterSap::DMACNeighbours>::iterator found = m_neighborMap.find (chHeader.GetCHInfo ().id);
-                if(found != m_neighborMap.end ()){
-                    NS_LOG_UNCOND("Received Cluster Head message from:" << chHeader.GetCHInfo ().id);
-
-                    if(TestClusterHeadChange(chHeader.GetCHInfo ().id, m_neighborMap[chHeader.GetCHInfo ().id])){
-
-                        ChangeState (V2vClusterSap::SENDJOIN);
-                        double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (3*m_maxUes*m_minimumTdmaSlot) + m_vehicleTdmaSlot);
-                        NS_LOG_UNCOND("Schedule to sent after: " << dt);
-                        m_sendEvent.Cancel ();
-                        ScheduleTransmit (Seconds(abs (dt)));
-
-                        m_currentInfo.CHindex = chHeader.GetCHInfo ().id;
-                        m_currentInfo.role = V2vClusterSap::CM;
-
-                        m_clusterChanges ++;
-                        m_clusterChangesPerSec ++;
-
-                        if(m_chDurationBoolean){
-                            m_chDurationBoolean = false;
-                            m_stopChDuration = Simulator::Now ().GetTimeStep ();
-                            m_chDurationVector.push_back (m_stopChDuration - m_startChDuration);
-                        }
-
-                        if(m_cmDurationBoolean){
-                            m_cmDurationBoolean = false;
-                            m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-                            m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
-                        }
-
-                        if(m_cmDurationBoolean == false){
-                            m_startCmDuration = Simulator::Now ().GetTimeStep ();
-                            m_cmDurationBoolean = true;
-                        }
-                    }
-
-                    if(chHeader.GetCHInfo ().ttl > 1){
-                        CreateForwardedCHPacket(chHeader.GetCHInfo ());
-
-                        ChangeState (V2vClusterSap::FORWARDCH);
-                        NS_LOG_UNCOND("Forward CH message to new neighbourhood");
-                        double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (4*m_maxUes*m_minimumTdmaSlot) + m_vehicleTdmaSlot);
-                        ScheduleTransmit (Seconds(abs (dt)));
-                    }
-                }
+
+            if(m_cmDurationBoolean){
+                m_cmDurationBoolean = false;
+                m_stopCmDuration = Simulator::Now ().GetTimeStep ();
+                m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
             }
-            else if(item.tid.GetName() == "ns3::V2vDMACJoinHeader"){
-                V2vDMACJoinHeader joinHeader;
-                p->RemoveHeader (joinHeader);
-
-                NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " From:" << joinHeader.GetJoinInfo ().id << " Received V2vDMACJoinHeader at time: " << joinHeader.GetTs());
-                std::map<uint64_t, V2vClusterSap::DMACNeighbours>::iterator found = m_neighborMap.find (joinHeader.GetJoinInfo ().id);
-                if(found != m_neighborMap.end ()){
-
-                    if(m_currentInfo.role == V2vClusterSap::CH){
-                        if(joinHeader.GetJoinInfo ().CHindex == m_currentInfo.id){
-                            NS_LOG_UNCOND("Node:" << m_currentInfo.id <<  " received Cluster Join message from:" << joinHeader.GetJoinInfo ().id);
-                            m_clusterMap[joinHeader.GetJoinInfo ().id] = CreateClusterNode(joinHeader.GetTs (), found->second);
-                        }
-                        else{
-                            NS_LOG_UNCOND("Node:" << m_currentInfo.id << " erase node from cluster list:" << joinHeader.GetJoinInfo ().id);
-                            std::map<uint64_t, V2vClusterSap::DMACNeighbours>::iterator found2 = m_clusterMap.find (joinHeader.GetJoinInfo ().id);
-                            if(found2 != m_clusterMap.end ()){
-                                m_clusterMap.erase (found2 ++);
-                            }
-                        }
-                    }
-                    else if(found->second.role == V2vClusterSap::CH){
-
-                        ChangeState (V2vClusterSap::INIT);
-                        double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (2*m_maxUes*m_minimumTdmaSlot) + m_vehicleTdmaSlot);
-                        NS_LOG_UNCOND("Schedule to sent after: " << dt);
-                        m_sendEvent.Cancel ();
-                        ScheduleTransmit (Seconds(abs (dt)));
-                    }
-
-                    if(joinHeader.GetJoinInfo ().ttl > 1){
-                        CreateForwardedJoinPacket(joinHeader.GetJoinInfo ());
-
-                        ChangeState (V2vClusterSap::FORWARDJOIN);
-                        NS_LOG_UNCOND("Forward Join message to new neighbourhood");
-                        double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (4*m_maxUes*m_minimumTdmaSlot) + m_vehicleTdmaSlot);
-                        ScheduleTransmit (Seconds(abs (dt)));
-                    }
-                }
+
+            if(m_cmDurationBoolean == false){
+                m_startCmDuration = Simulator::Now ().GetTimeStep ();
+                m_cmDurationBoolean = true;
             }
-            m_rxTrace(p, from);
         }
-        m_receivedCounter ++;
+
+        if(chHeader.GetCHInfo ().ttl > 1){
+            CreateForwardedCHPacket(chHeader.GetCHInfo ());
+
+            ChangeState (V2vClusterSap::FORWARDCH);
+            NS_LOG_UNCOND("Forward CH message to new neighbourhood");
+            double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (4*GetTdmaFrameSlots ()*m_minimumTdmaSlot) + GetTdmaOffset ());
+            ScheduleTransmit (Seconds(abs (dt)));
+        }
+    }
+}
+
+void
+V2vModifiedDMACAlgorithmClient::HandleJoin (Ptr<Packet> packet, const Address &from) {
+    NS_LOG_FUNCTION (this << packet << from);
+    V2vDMACJoinHeader joinHeader;
+    packet->RemoveHeader (joinHeader);
+
+    NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " From:" << joinHeader.GetJoinInfo ().id << " Received V2vDMACJoinHeader at time: " << joinHeader.GetTs());
+    V2vClusterSap::DMACNeighbours *found = m_neighborMap.Find (joinHeader.GetJoinInfo ().id);
+    if(found != 0){
+
+        if(m_currentInfo.role == V2vClusterSap::CH){
+            if(joinHeader.GetJoinInfo ().CHindex == m_currentInfo.id){
+                NS_LOG_UNCOND("Node:" << m_currentInfo.id <<  " received Cluster Join message from:" << joinHeader.GetJoinInfo ().id);
+                m_clusterMap.Insert (joinHeader.GetJoinInfo ().id, found->position, found->velocity, CreateClusterNode(joinHeader.GetTs (), *found));
+            }
+            else{
+                NS_LOG_UNCOND("Node:" << m_currentInfo.id << " erase node from cluster list:" << joinHeader.GetJoinInfo ().id);
+                m_clusterMap.Erase (joinHeader.GetJoinInfo ().id);
+            }
+        }
+        else if(found->role == V2vClusterSap::CH){
+
+            ChangeState (V2vClusterSap::INIT);
+            double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (2*GetTdmaFrameSlots ()*m_minimumTdmaSlot) + GetTdmaOffset ());
+            NS_LOG_UNCOND("Schedule to sent after: " << dt);
+            m_sendEvent.Cancel ();
+            ScheduleTransmit (Seconds(abs (dt)));
+        }
+
+        if(joinHeader.GetJoinInfo ().ttl > 1){
+            CreateForwardedJoinPacket(joinHeader.GetJoinInfo ());
+
+            ChangeState (V2vClusterSap::FORWARDJOIN);
+            NS_LOG_UNCOND("Forward Join message to new neighbourhood");
+            double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (4*GetTdmaFrameSlots ()*m_minimumTdmaSlot) + GetTdmaOffset ());
+            ScheduleTransmit (Seconds(abs (dt)));
+        }
     }
 }
 
@@ -676,29 +865,40 @@ V2vModifiedDMACAlgorithmClient::ApplyMaintenance (void){
     NS_ASSERT(m_maintenanceEvent.IsExpired());
 
     if(m_currentInfo.role == V2vClusterSap::CH){
-        m_clusterMembers.push_back (m_clusterMap.size ()+1);
+        m_clusterMembers.Add (m_clusterMap.GetSize ()+1);
     }
 
-    for(std::map<uint64_t, V2vClusterSap::DMACNeighbours>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end();){
-
-        uint64_t key = it->first;
-        V2vClusterSap::DMACNeighbours value = it->second;
-        if(Simulator::Now ().GetSeconds () - value.tExpire.GetSeconds () > 1.5){
+    //!< Only the neighbors whose expiry time has passed are visited
+    m_expired.clear ();
+    m_neighborExpiry.Advance (Simulator::Now (), m_expired);
+    for(uint32_t i = 0; i < m_expired.size ();){
+        const V2vClusterSap::DMACNeighbours *value = m_neighborMap.Find (m_expired[i]);
+        if(Simulator::Now ().GetSeconds () - value->tExpire.GetSeconds () > 1.5){
+            ++i;
+        }
+        else{
+            //!< Exactly 1.5s old, expires at the next maintenance
+            m_neighborExpiry.Schedule (m_expired[i], Simulator::Now () + TimeStep (1));
+            m_expired[i] = m_expired.back ();
+            m_expired.pop_back ();
+        }
+    }
+    m_neighborMap.SortForErase (m_expired);
 
-            if(key == m_currentInfo.CHindex){
-                ChangeState (V2vClusterSap::INIT);
+    for(uint32_t i = 0; i < m_expired.size (); ++i){
 
-                //NS_LOG_DEBUG("I lost my clusterhead");
-                double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (2*m_maxUes*m_minimumTdmaSlot) + m_vehicleTdmaSlot);
-                ScheduleTransmit (Seconds(abs (dt)));
-            }
+        uint64_t key = m_expired[i];
+        if(key == m_currentInfo.CHindex){
+            ChangeState (V2vClusterSap::INIT);
 
-            NS_LOG_UNCOND("Node:" << m_currentInfo.id << " is Removing neighbor:" << key);
-            m_neighborMap.erase (it ++);
-        }
-        else{
-            ++it;
+            //NS_LOG_DEBUG("I lost my clusterhead");
+            double dt = 1.0 - ((Simulator::Now ().GetSeconds () - (int)Simulator::Now ().GetSeconds ()) + (2*GetTdmaFrameSlots ()*m_minimumTdmaSlot) + GetTdmaOffset ());
+            ScheduleTransmit (Seconds(abs (dt)));
         }
+
+        NS_LOG_UNCOND("Node:" << m_currentInfo.id << " is Removing neighbor:" << key);
+        m_neighborMap.Erase (key);
+        UnindexNeighbor (key);
     }
 
     ScheduleMaintenance (Seconds(1.0));
@@ -723,15 +923,20 @@ V2vModifiedDMACAlgorithmClient::SendHello (void) {
 
     Ptr<Packet> packet = Create<Packet>(0);
     packet->AddHeader (helloHeader);
-    m_socket->Send (packet);
+    packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::DMAC_HELLO_MESSAGE));
+    SendControl (m_socket, packet);
     m_txTrace(packet);
     m_sentCounter ++;
 
     m_numberOfMessages ++;
     m_numberOfMessagesPerSec ++;
+    V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
     //StatusReport ();
     NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends Hello Message at : " << helloHeader.GetTs ().GetSeconds ());
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        m_slots.NotifySent (helloHeader.GetTs ());
+    }
     ScheduleTransmitHello (Seconds(m_beats));
 }
 
@@ -757,7 +962,7 @@ V2vModifiedDMACAlgorithmClient::Send (void) {
                 if(m_chDurationBoolean){
                     m_chDurationBoolean = false;
                     m_stopChDuration = Simulator::Now ().GetTimeStep ();
-                    m_chDurationVector.push_back (m_stopChDuration - m_startChDuration);
+                    m_chDuration.Add (TimeStep (m_stopChDuration - m_startChDuration).GetSeconds ());
                 }
 
                 if(m_cmDurationBoolean == false){
@@ -769,7 +974,7 @@ V2vModifiedDMACAlgorithmClient::Send (void) {
                 if(m_cmDurationBoolean){
                     m_cmDurationBoolean = false;
                     m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-                    m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
+                    m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
                 }
 
                 if(m_chDurationBoolean == false){
@@ -783,14 +988,16 @@ V2vModifiedDMACAlgorithmClient::Send (void) {
         if(ch == m_currentInfo.id){
             ChangeState (V2vClusterSap::SENDCH);
             m_currentInfo.role = V2vClusterSap::CH;
-            ScheduleTransmit (Seconds(m_maxUes*m_minimumTdmaSlot));
+            UpdateRegistryRole ();
+            ScheduleTransmit (Seconds(GetTdmaFrameSlots ()*m_minimumTdmaSlot));
 
             m_startFormationDelay = Simulator::Now ().GetTimeStep ();
         }
         else{
             ChangeState (V2vClusterSap::SENDJOIN);
             m_currentInfo.role = V2vClusterSap::CM;
-            ScheduleTransmit (Seconds(m_maxUes*m_minimumTdmaSlot));
+            UpdateRegistryRole ();
+            ScheduleTransmit (Seconds(GetTdmaFrameSlots ()*m_minimumTdmaSlot));
         }
 
         break;
@@ -798,10 +1005,11 @@ V2vModifiedDMACAlgorithmClient::Send (void) {
     case V2vClusterSap::SENDCH:{
 
         m_stopFormationDelay = Simulator::Now ().GetTimeStep ();
-        m_formationDelayVector.push_back (m_stopFormationDelay - m_startFormationDelay);
+        m_formationDelay.Add (TimeStep (m_stopFormationDelay - m_startFormationDelay).GetSeconds ());
 
         m_clusterChanges ++;
         m_clusterChangesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyClusterChange ();
 
         NS_LOG_DEBUG("Node:" << m_currentInfo.id << " turned to state " << ToString (m_nodeState));
 
@@ -810,13 +1018,15 @@ V2vModifiedDMACAlgorithmClient::Send (void) {
 
         Ptr<Packet> packet = Create<Packet>(0);
         packet->AddHeader (chHeader);
+        packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::DMAC_CH_MESSAGE));
 
-        m_socket->Send (packet);
+        SendControl (m_socket, packet);
         m_txTrace(packet);
         m_sentCounter ++;
 
         m_numberOfMessages ++;
         m_numberOfMessagesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
         NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends CH Message at : " << chHeader.GetTs ().GetSeconds ());
 
@@ -826,6 +1036,7 @@ V2vModifiedDMACAlgorithmClient::Send (void) {
 
         m_clusterChanges ++;
         m_clusterChangesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyClusterChange ();
 
         NS_LOG_DEBUG("Node:" << m_currentInfo.id << " turned to state " << ToString (m_nodeState));
 
@@ -834,13 +1045,15 @@ V2vModifiedDMACAlgorithmClient::Send (void) {
 
         Ptr<Packet> packet = Create<Packet>(0);
         packet->AddHeader (joinHeader);
+        packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::DMAC_JOIN_MESSAGE));
 
-        m_socket->Send (packet);
+        SendControl (m_socket, packet);
         m_txTrace(packet);
         m_sentCounter ++;
 
         m_numberOfMessages ++;
         m_numberOfMessagesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
         NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends JOIN Message at : " << joinHeader.GetTs ().GetSeconds ());
 
@@ -855,13 +1068,15 @@ V2vModifiedDMACAlgorithmClient::Send (void) {
 
         Ptr<Packet> packet = Create<Packet>(0);
         packet->AddHeader (helloHeader);
+        packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::DMAC_HELLO_MESSAGE));
 
-        m_socket->Send (packet);
+        SendControl (m_socket, packet);
         m_txTrace(packet);
         m_sentCounter ++;
 
         m_numberOfMessages ++;
         m_numberOfMessagesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
 
         NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends JOIN Message at : " << helloHeader.GetTs ().GetSeconds ());
@@ -877,13 +1092,15 @@ V2vModifiedDMACAlgorithmClient::Send (void) {
 
         Ptr<Packet> packet = Create<Packet>(0);
         packet->AddHeader (chHeader);
+        packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::DMAC_CH_MESSAGE));
 
-        m_socket->Send (packet);
+        SendControl (m_socket, packet);
         m_txTrace(packet);
         m_sentCounter ++;
 
         m_numberOfMessages ++;
         m_numberOfMessagesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
         NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends JOIN Message at : " << chHeader.GetTs ().GetSeconds ());
 
@@ -898,13 +1115,15 @@ V2vModifiedDMACAlgorithmClient::Send (void) {
 
         Ptr<Packet> packet = Create<Packet>(0);
         packet->AddHeader (joinHeader);
+        packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::DMAC_JOIN_MESSAGE));
 
-        m_socket->Send (packet);
+        SendControl (m_socket, packet);
         m_txTrace(packet);
         m_sentCounter ++;
 
         m_numberOfMessages ++;
         m_numberOfMessagesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
         NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends JOIN Message at : " << joinHeader.GetTs ().GetSeconds ());
 
@@ -919,26 +1138,16 @@ uint64_t
 V2vModifiedDMACAlgorithmClient::ChooseClusterHead(void){
 
     uint64_t minId = m_currentInfo.id;
-    uint64_t minWeight = m_currentInfo.weight;
 
+    //!< The weight indices hold the best candidate on top, ties to the smallest id
     if(Simulator::Now ().GetSeconds () < 2.0){
-        for(std::map<uint64_t, V2vClusterSap::DMACNeighbours>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it){
-
-            V2vClusterSap::DMACNeighbours node = it->second;
-            if((node.weight < minWeight)){
-                minWeight = node.weight;
-                minId = it->first;
-            }
+        if(!m_lightestNeighbor.IsEmpty () && m_lightestNeighbor.GetTopWeight () < m_currentInfo.weight){
+            minId = m_lightestNeighbor.GetTop ();
         }
     }
     else{
-        for(std::map<uint64_t, V2vClusterSap::DMACNeighbours>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it){
-
-            V2vClusterSap::DMACNeighbours node = it->second;
-            if((node.weight > minWeight) && (node.role == V2vClusterSap::CH)){
-                minWeight = node.weight;
-                minId = it->first;
-            }
+        if(!m_heaviestClusterHead.IsEmpty () && m_heaviestClusterHead.GetTopWeight () > m_currentInfo.weight){
+            minId = m_heaviestClusterHead.GetTop ();
         }
     }
 
@@ -946,6 +1155,32 @@ V2vModifiedDMACAlgorithmClient::ChooseClusterHead(void){
     return minId;
 }
 
+void
+V2vModifiedDMACAlgorithmClient::IndexNeighbor(uint64_t id, const V2vClusterSap::DMACNeighbours &neighbor){
+    m_lightestNeighbor.Update (id, neighbor.weight);
+    if(neighbor.role == V2vClusterSap::CH){
+        m_heaviestClusterHead.Update (id, neighbor.weight);
+    }
+    else{
+        m_heaviestClusterHead.Erase (id);
+    }
+}
+
+void
+V2vModifiedDMACAlgorithmClient::UnindexNeighbor(uint64_t id){
+    m_lightestNeighbor.Erase (id);
+    m_heaviestClusterHead.Erase (id);
+}
+
+void
+V2vModifiedDMACAlgorithmClient::RebuildNeighborIndex(void){
+    m_lightestNeighbor.Clear ();
+    m_heaviestClusterHead.Clear ();
+    for(V2vNeighborTable<V2vClusterSap::DMACNeighbours>::ConstIterator it = m_neighborMap.Begin(); it != m_neighborMap.End(); ++it){
+        IndexNeighbor (it->id, it->value);
+    }
+}
+
 void
 V2vModifiedDMACAlgorithmClient::ConnectionFailed (Ptr<Socket> socket) {
     NS_LOG_FUNCTION (this << socket);
@@ -1062,14 +1297,14 @@ V2vModifiedDMACAlgorithmClient::TestClusterHeadChange(uint64_t id, V2vClusterSap
     }
 
     uint64_t weight = 0;
-    std::map<uint64_t, V2vClusterSap::DMACNeighbours>::iterator found = m_neighborMap.find (m_currentInfo.CHindex);
-    if(found == m_neighborMap.end ()){
+    const V2vClusterSap::DMACNeighbours *found = m_neighborMap.Find (m_currentInfo.CHindex);
+    if(found == 0){
         if(m_currentInfo.role == V2vClusterSap::CH){
             weight = m_currentInfo.weight;
         }
     }
     else{
-        weight = found->second.weight;
+        weight = found->weight;
     }
     if(neighbor.weight > weight){
         NS_LOG_DEBUG("Weight:" << neighbor.weight);
@@ -1094,22 +1329,33 @@ V2vModifiedDMACAlgorithmClient::TestClusterHeadChange(uint64_t id, V2vClusterSap
     return true;
 }
 
+const std::vector<uint32_t>&
+V2vModifiedDMACAlgorithmClient::CollectNeighbors (void){
+    //!< Sum in the id order of the former std::map
+    if(m_neighborRange > 0){
+        m_neighborMap.FindInRangeById (m_currentInfo.position, m_neighborRange, m_neighborScan);
+        return m_neighborScan;
+    }
+    return m_neighborMap.GetIdOrder ();
+}
+
 double
 V2vModifiedDMACAlgorithmClient::CalculateWeight(void){
 
-    double size = m_neighborMap.size();
+    const std::vector<uint32_t> &scan = CollectNeighbors ();
+    double size = scan.size ();
 
     //!< If no neighbours found, return standard TDMA vehicle's window
-    if(m_neighborMap.size() == 0){
+    if(scan.empty ()){
         size = 1;
     }
 
     Vector p,v;
-    for(std::map<uint64_t, V2vClusterSap::DMACNeighbours>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it) {
-        uint64_t key = it->first;
-        NS_ASSERT(key != m_currentInfo.id);
+    for(uint32_t i = 0; i < scan.size (); ++i) {
+        const V2vNeighborTable<V2vClusterSap::DMACNeighbours>::Entry &entry = m_neighborMap.GetEntry (scan[i]);
+        NS_ASSERT(entry.id != m_currentInfo.id);
 
-        V2vClusterSap::DMACNeighbours value = it->second;
+        const V2vClusterSap::DMACNeighbours &value = entry.value;
         p.x += value.position.x;
         p.y += value.position.y;
         p.z += value.position.z;
@@ -1131,11 +1377,11 @@ V2vModifiedDMACAlgorithmClient::CalculateWeight(void){
 
     //!< Find standard deviation of position and velocity
     Vector ps,vs;
-    for(std::map<uint64_t, V2vClusterSap::DMACNeighbours>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it) {
-        uint64_t key = it->first;
-        NS_ASSERT(key != m_currentInfo.id);
+    for(uint32_t i = 0; i < scan.size (); ++i) {
+        const V2vNeighborTable<V2vClusterSap::DMACNeighbours>::Entry &entry = m_neighborMap.GetEntry (scan[i]);
+        NS_ASSERT(entry.id != m_currentInfo.id);
 
-        V2vClusterSap::DMACNeighbours value = it->second;
+        const V2vClusterSap::DMACNeighbours &value = entry.value;
         ps.x += pow((value.position.x - p.x), 2.0);
         ps.y += pow((value.position.y - p.y), 2.0);
         ps.z += pow((value.position.z - p.z), 2.0);
@@ -1280,10 +1526,10 @@ V2vModifiedDMACAlgorithmClient::StatusReport (void){
                    << "\n");
 
     NS_LOG_UNCOND("----------------------------  Neighbors Info  ---------------------------------");
-    NS_LOG_UNCOND("NeighborMap size:" << m_neighborMap.size ());
-    for(std::map<uint64_t, V2vClusterSap::DMACNeighbours>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it){
-        uint64_t id = it->first;
-        V2vClusterSap::DMACNeighbours node = it->second;
+    NS_LOG_UNCOND("NeighborMap size:" << m_neighborMap.GetSize ());
+    for(V2vNeighborTable<V2vClusterSap::DMACNeighbours>::ConstIterator it = m_neighborMap.Begin(); it != m_neighborMap.End(); ++it){
+        uint64_t id = it->id;
+        const V2vClusterSap::DMACNeighbours &node = it->value;
         NS_LOG_UNCOND(" * key: " << id
                 << "tExpire:" << node.tExpire.GetSeconds()
                 << " Role:" << ToString (node.role)
@@ -1294,9 +1540,9 @@ V2vModifiedDMACAlgorithmClient::StatusReport (void){
     }
 
     NS_LOG_UNCOND("----------------------------  Cluster Info  ---------------------------------");
-    for(std::map<uint64_t, V2vClusterSap::DMACNeighbours>::iterator it = m_clusterMap.begin(); it != m_clusterMap.end(); ++it){
-        uint64_t id = it->first;
-        V2vClusterSap::DMACNeighbours node = it->second;
+    for(V2vNeighborTable<V2vClusterSap::DMACNeighbours>::ConstIterator it = m_clusterMap.Begin(); it != m_clusterMap.End(); ++it){
+        uint64_t id = it->id;
+        const V2vClusterSap::DMACNeighbours &node = it->value;
         NS_LOG_UNCOND(" * key: " << id
                 << " Role:" << ToString (node.role)
                 << " Weight:" << node.weight
@@ -31,6 +31,13 @@
 #include "ns3/mobility-module.h"
 #include "ns3/v2v-cluster-sap.h"
 #include "ns3/v2v-cluster-header.h"
+#include "ns3/v2v-neighbor-table.h"
+#include "ns3/v2v-timer-wheel.h"
+#include "ns3/v2v-weight-index.h"
+#include "ns3/v2v-statistics-accumulator.h"
+#include "ns3/v2v-cluster-snapshot.h"
+#include "ns3/v2v-slot-allocator.h"
+#include "ns3/v2v-channel-scheduler.h"
 
 namespace ns3 {
 
@@ -90,6 +97,12 @@ public:
      */
     V2vClusterSap::NovelNodeDegree GetRole(void);
 
+    /**
+     * @brief GetClusterId
+     * @return the node id of the cluster head of the node, 0 when it has none
+     */
+    uint64_t GetClusterId(void);
+
     /**
      * @brief GetNumberOfMessagesPerSecond
      * @return
@@ -138,6 +151,50 @@ public:
      */
     double GetMaxCmDuration(void);
 
+    /**
+     * @brief GetFormationDelayStatistics
+     * @return the cluster formation delay samples [s], with percentiles
+     */
+    const V2vStatisticsAccumulator &GetFormationDelayStatistics(void) const;
+
+    /**
+     * @brief GetClusterMembersStatistics
+     * @return the cluster size samples, with percentiles
+     */
+    const V2vStatisticsAccumulator &GetClusterMembersStatistics(void) const;
+
+    /**
+     * @brief GetChDurationStatistics
+     * @return the cluster head duration samples [s], with percentiles
+     */
+    const V2vStatisticsAccumulator &GetChDurationStatistics(void) const;
+
+    /**
+     * @brief GetCmDurationStatistics
+     * @return the cluster member duration samples [s], with percentiles
+     */
+    const V2vStatisticsAccumulator &GetCmDurationStatistics(void) const;
+
+    /**
+     * @brief GetSlotAllocator
+     * @return the slot reservation of the hashed TDMA scheme, with its
+     * collision and move counters
+     */
+    const V2vSlotAllocator &GetSlotAllocator(void) const;
+
+    /**
+     * @brief Write the clustering state of the client to a snapshot
+     * @param writer the snapshot record of the node
+     */
+    void SaveState (V2vSnapshotWriter &writer) const;
+
+    /**
+     * @brief Resume from a snapshot when the application starts, in place
+     * of a new training period
+     * @param record the record written by SaveState
+     */
+    void SetSnapshot (const std::string &record);
+
 
 protected:
     virtual void DoDispose (void);
@@ -147,6 +204,11 @@ private:
     virtual void StartApplication (void);    // Called at time specified by Start
     virtual void StopApplication (void);     // Called at time specified by Stop
 
+    /**
+     * \brief Report the current role to V2vClusterRegistry if it changed
+     */
+    void UpdateRegistryRole (void);
+
     void StartListeningLocal (void);	// Called from StartApplication()
     void StopListeningLocal (void);	// Called from StopApplication()
 
@@ -157,11 +219,38 @@ private:
 
 
     //!< Receive locally
+    /**
+     * \brief Handler of a received message, selected by its V2vClusterTypeHeader
+     */
+    typedef void (V2vModifiedDMACAlgorithmClient::*MessageHandler) (Ptr<Packet> packet, const Address &from);
+
     /**
      * \brief Handle a packet received by the application
      * \param socket the receiving socket
      */
     void HandleRead (Ptr<Socket> socket);
+
+    /**
+     * \brief Handle a received V2vDMACHelloHeader
+     * \param packet the packet, without its V2vClusterTypeHeader
+     * \param from the sender address
+     */
+    void HandleHello (Ptr<Packet> packet, const Address &from);
+
+    /**
+     * \brief Handle a received V2vDMACCHHeader
+     * \param packet the packet, without its V2vClusterTypeHeader
+     * \param from the sender address
+     */
+    void HandleCH (Ptr<Packet> packet, const Address &from);
+
+    /**
+     * \brief Handle a received V2vDMACJoinHeader
+     * \param packet the packet, without its V2vClusterTypeHeader
+     * \param from the sender address
+     */
+    void HandleJoin (Ptr<Packet> packet, const Address &from);
+
     /**
      * \brief Handle an incoming connection
      * \param socket the incoming connection socket
@@ -210,7 +299,8 @@ private:
     void ScheduleMaintenance (Time dt);
 
     /**
-     * @brief ApplyMaintenance
+     * @brief ApplyMaintenance, removes the neighbors not heard for 1.5s
+     * visiting only the entries whose expiry time has passed
      */
     void ApplyMaintenance(void);
 
@@ -307,6 +397,12 @@ private:
      */
     bool TestClusterHeadChange(uint64_t id, V2vClusterSap::DMACNeighbours neighbor);
 
+    /**
+     * @brief The neighbors within m_neighborRange (all of them if 0)
+     * @return their storage indexes in m_neighborMap, in id order
+     */
+    const std::vector<uint32_t>& CollectNeighbors (void);
+
     /**
      * @brief CalculateWeight
      * @return
@@ -326,6 +422,52 @@ private:
      */
     uint64_t ChooseClusterHead(void);
 
+    /**
+     * @brief Keep the weight indices in step with a m_neighborMap entry
+     * @param id the neighbor id
+     * @param neighbor the entry just stored for it
+     */
+    void IndexNeighbor(uint64_t id, const V2vClusterSap::DMACNeighbours &neighbor);
+
+    /**
+     * @brief Drop a neighbor from the weight indices
+     * @param id the neighbor id
+     */
+    void UnindexNeighbor(uint64_t id);
+
+    /**
+     * @brief Rebuild the weight indices from m_neighborMap
+     */
+    void RebuildNeighborIndex(void);
+
+    /**
+     * @brief Send a control message, on the CCH when the node has a
+     * V2vChannelScheduler
+     * @param socket the socket of the message
+     * @param packet the message
+     */
+    void SendControl (Ptr<Socket> socket, Ptr<Packet> packet);
+
+    /**
+     * @brief GetTdmaOffset
+     * @return the offset of the node in the TDMA frame [s], VehicleTdmaSlot
+     * or the offset of the hashed slot
+     */
+    double GetTdmaOffset (void) const;
+
+    /**
+     * @brief GetTdmaFrameSlots
+     * @return the number of slots of the TDMA frame, MaxUes or FrameSlots
+     */
+    uint32_t GetTdmaFrameSlots (void) const;
+
+    /**
+     * @brief Restore the state written by SaveState and schedule the
+     * pending events again
+     * @param reader the snapshot record of the node
+     */
+    void LoadState (V2vSnapshotReader &reader);
+
     /**
      * \brief Report the status of the node
      */
@@ -337,6 +479,8 @@ private:
      */
     void ChangeState (V2vClusterSap::DMACNodeState currentState);
 
+    /* Message dispatch */
+    MessageHandler m_messageHandlers[V2vClusterSap::MESSAGE_TYPES];   //!< handlers indexed by message type
 
     /* Receive Socket */
     TypeId m_tidListening;          		//!< Protocol TypeId
@@ -358,6 +502,10 @@ private:
     uint32_t m_maxUes;                      //!< maximun number of ues
     double m_minimumTdmaSlot;               //!< the minimum tdma slot
     double m_vehicleTdmaSlot;               //!< the timeslot for the node to schedule transmission
+    V2vSlotAllocator::Scheme m_slotScheme;  //!< fixed or hashed TDMA offsets
+    uint32_t m_frameSlots;                  //!< slots of a frame of the hashed scheme
+    V2vSlotAllocator m_slots;               //!< slot reservation of the hashed scheme
+    Ptr<V2vChannelScheduler> m_scheduler;   //!< channel access of the node, 0 for a single channel
     double m_trainingPeriod;
 
     /* Clustering Params */
@@ -366,11 +514,21 @@ private:
     double m_range;
     double m_freshness;
     double m_freshnessThreshold;
+    bool m_registered;                      //!< registered in V2vClusterRegistry
+    V2vClusterSap::NovelNodeDegree m_registeredRole; //!< role last reported to V2vClusterRegistry
+    std::string m_snapshot;                 //!< snapshot record to resume from
     Ptr<MobilityModel> m_mobilityModel;
     V2vClusterSap::DMACNodeState m_nodeState;
     V2vClusterSap::DMACCurrentInfo m_currentInfo;
-    std::map<uint64_t, V2vClusterSap::DMACNeighbours> m_clusterMap;
-    std::map<uint64_t, V2vClusterSap::DMACNeighbours> m_neighborMap;
+    V2vNeighborTable<V2vClusterSap::DMACNeighbours> m_clusterMap;
+    V2vNeighborTable<V2vClusterSap::DMACNeighbours> m_neighborMap;
+    double m_neighborRange;                 //!< radius of the neighbor scans, 0 for all
+    double m_gridCellSize;                  //!< side of a neighbor grid cell, 0 for m_neighborRange
+    std::vector<uint32_t> m_neighborScan;   //!< scratch buffer of the neighbor scans
+    V2vTimerWheel m_neighborExpiry;         //!< expiry time of each m_neighborMap entry
+    V2vWeightIndex m_lightestNeighbor;      //!< weight of each m_neighborMap entry, lowest first
+    V2vWeightIndex m_heaviestClusterHead;   //!< weight of the CH entries of m_neighborMap, highest first
+    std::vector<uint64_t> m_expired;        //!< scratch buffer of the expired neighbors
 
     V2vClusterSap::DMACHello m_forwardHello;
     V2vClusterSap::DMACCH m_forwardCH;
@@ -384,10 +542,10 @@ private:
     /* Formation Delay metrics */
     uint64_t m_startFormationDelay;
     uint64_t m_stopFormationDelay;
-    std::vector<uint64_t> m_formationDelayVector;
+    V2vStatisticsAccumulator m_formationDelay;
 
     /* Average Number of members per cluster */
-    std::vector<uint64_t> m_clusterMembers;
+    V2vStatisticsAccumulator m_clusterMembers;
 
     /* Number of Cluster Changes */
     uint64_t m_clusterChanges;
@@ -405,13 +563,13 @@ private:
     bool m_chDurationBoolean;
     uint64_t m_startChDuration;
     uint64_t m_stopChDuration;
-    std::vector<uint64_t> m_chDurationVector;
+    V2vStatisticsAccumulator m_chDuration;
 
     /* Cluster Member duration metrics */
     bool m_cmDurationBoolean;
     uint64_t m_startCmDuration;
     uint64_t m_stopCmDuration;
-    std::vector<uint64_t> m_cmDurationVector;
+    V2vStatisticsAccumulator m_cmDuration;
 
 };
 
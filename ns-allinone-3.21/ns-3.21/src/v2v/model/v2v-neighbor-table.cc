@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include "v2v-neighbor-table.h"
+
+namespace ns3 {
+
+V2vFlatIndex::V2vFlatIndex () :
+        m_size(0),
+        m_used(0){
+}
+
+uint32_t
+V2vFlatIndex::Hash (uint64_t key) const {
+    // Fibonacci hashing, the slot array size is always a power of two
+    uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(h >> 32) & (m_slots.size () - 1);
+}
+
+bool
+V2vFlatIndex::Find (uint64_t key, uint32_t &value) const {
+    if (m_size == 0){
+        return false;
+    }
+
+    uint32_t mask = m_slots.size () - 1;
+    for (uint32_t i = Hash (key); ; i = (i + 1) & mask){
+        const Slot &slot = m_slots[i];
+        if (slot.state == SLOT_EMPTY){
+            return false;
+        }
+        if ((slot.state == SLOT_FULL) && (slot.key == key)){
+            value = slot.value;
+            return true;
+        }
+    }
+}
+
+void
+V2vFlatIndex::Insert (uint64_t key, uint32_t value){
+    // keep the load factor (including deleted slots) below one half
+    if ((m_used + 1)*2 > m_slots.size ()){
+        uint32_t capacity = m_slots.empty () ? 16 : m_slots.size ();
+        while ((m_size + 1)*2 > capacity){
+            capacity *= 2;
+        }
+        Rehash (capacity);
+    }
+
+    uint32_t mask = m_slots.size () - 1;
+    int64_t firstDeleted = -1;
+    for (uint32_t i = Hash (key); ; i = (i + 1) & mask){
+        Slot &slot = m_slots[i];
+        if (slot.state == SLOT_EMPTY){
+            Slot &target = (firstDeleted >= 0) ? m_slots[firstDeleted] : slot;
+            if (firstDeleted < 0){
+                m_used ++;
+            }
+            target.key = key;
+            target.value = value;
+            target.state = SLOT_FULL;
+            m_size ++;
+            return;
+        }
+        if (slot.state == SLOT_DELETED){
+            if (firstDeleted < 0){
+                firstDeleted = i;
+            }
+        }
+        else if (slot.key == key){
+            slot.value = value;
+            return;
+        }
+    }
+}
+
+bool
+V2vFlatIndex::Erase (uint64_t key){
+    if (m_size == 0){
+        return false;
+    }
+
+    uint32_t mask = m_slots.size () - 1;
+    for (uint32_t i = Hash (key); ; i = (i + 1) & mask){
+        Slot &slot = m_slots[i];
+        if (slot.state == SLOT_EMPTY){
+            return false;
+        }
+        if ((slot.state == SLOT_FULL) && (slot.key == key)){
+            slot.state = SLOT_DELETED;
+            m_size --;
+            return true;
+        }
+    }
+}
+
+void
+V2vFlatIndex::Clear (void){
+    m_slots.clear ();
+    m_size = 0;
+    m_used = 0;
+}
+
+uint32_t
+V2vFlatIndex::GetSize (void) const {
+    return m_size;
+}
+
+void
+V2vFlatIndex::Rehash (uint32_t capacity){
+    std::vector<Slot> old;
+    old.swap (m_slots);
+
+    Slot empty;
+    empty.key = 0;
+    empty.value = 0;
+    empty.state = SLOT_EMPTY;
+    m_slots.assign (capacity, empty);
+    m_size = 0;
+    m_used = 0;
+
+    uint32_t mask = capacity - 1;
+    for (std::vector<Slot>::const_iterator it = old.begin (); it != old.end (); ++it){
+        if (it->state != SLOT_FULL){
+            continue;
+        }
+        uint32_t i = Hash (it->key);
+        while (m_slots[i].state == SLOT_FULL){
+            i = (i + 1) & mask;
+        }
+        m_slots[i] = *it;
+        m_size ++;
+        m_used ++;
+    }
+}
+
+} // namespace ns3
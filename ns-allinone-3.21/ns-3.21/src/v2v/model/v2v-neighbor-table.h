@@ -0,0 +1,733 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_NEIGHBOR_TABLE_H
+#define V2V_NEIGHBOR_TABLE_H
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <stdint.h>
+#include "ns3/assert.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vFlatIndex
+ * \brief Open-addressing (linear probing) map from a 64bit key to a
+ * 32bit value.
+ *
+ * Used by V2vNeighborTable to index neighbors by node id and grid cells
+ * by cell key. All slots live in a single contiguous array.
+ */
+class V2vFlatIndex {
+public:
+
+    V2vFlatIndex ();
+
+    /**
+     * \param key the key to look up
+     * \param value filled with the stored value when found
+     * \return true if the key is present
+     */
+    bool Find (uint64_t key, uint32_t &value) const;
+
+    /**
+     * \brief Insert the key or overwrite its value.
+     * \param key the key
+     * \param value the value
+     */
+    void Insert (uint64_t key, uint32_t value);
+
+    /**
+     * \param key the key to remove
+     * \return true if the key was present
+     */
+    bool Erase (uint64_t key);
+
+    /**
+     * \brief Remove all the keys.
+     */
+    void Clear (void);
+
+    /**
+     * \return the number of stored keys
+     */
+    uint32_t GetSize (void) const;
+
+private:
+    enum SlotState {
+        SLOT_EMPTY = 0,
+        SLOT_FULL,
+        SLOT_DELETED
+    };
+
+    struct Slot {
+        uint64_t key;
+        uint32_t value;
+        uint8_t state;
+    };
+
+    uint32_t Hash (uint64_t key) const;
+    void Rehash (uint32_t capacity);
+
+    std::vector<Slot> m_slots;      //!< power-of-two sized slot array
+    uint32_t m_size;                //!< number of full slots
+    uint32_t m_used;                //!< number of full and deleted slots
+};
+
+
+/**
+ * \ingroup v2v
+ * \class V2vNeighborTable
+ * \brief Neighbor table shared by the v2v clustering clients.
+ *
+ * Records are kept contiguously in a single vector (removal swaps the
+ * last record into the hole), indexed by node id through a V2vFlatIndex.
+ *
+ * With a cell size set, each record is additionally registered in a
+ * uniform spatial grid keyed on its position, so range and direction
+ * queries only visit the cells overlapping the query disc instead of
+ * every neighbor. The grid is off by default, a table only pays for its
+ * upkeep on every Insert and Erase when its owner queries it by range.
+ *
+ * Iteration order is the storage order, not the id order of the std::map
+ * the clients used before. A scan whose result depends on the visiting
+ * order (a tie kept on the first candidate, a floating point sum) walks
+ * GetIdOrder instead, the storage indexes kept in id order on every
+ * Insert and Erase, or sorts the few indexes of a range query with
+ * SortById.
+ */
+template <typename T>
+class V2vNeighborTable {
+public:
+
+    struct Entry {
+        uint64_t id;
+        Vector position;
+        Vector velocity;
+        uint64_t cell;
+        T value;
+    };
+
+    typedef typename std::vector<Entry>::iterator Iterator;
+    typedef typename std::vector<Entry>::const_iterator ConstIterator;
+
+    /**
+     * \param cellSize the side of a grid cell (m), 0 for no grid
+     */
+    V2vNeighborTable (double cellSize = 0.0);
+
+    /**
+     * \brief Change the grid cell size, re-registering every record.
+     * \param cellSize the side of a grid cell (m), 0 for no grid
+     */
+    void SetCellSize (double cellSize);
+
+    /**
+     * \return the side of a grid cell (m), 0 without grid
+     */
+    double GetCellSize (void) const;
+
+    /**
+     * \brief Insert a neighbor or replace the record with the same id.
+     * \param id the neighbor id
+     * \param position the neighbor position used for the grid
+     * \param velocity the neighbor velocity used for direction queries
+     * \param value the record
+     * \return a reference to the stored record
+     */
+    T& Insert (uint64_t id, const Vector &position, const Vector &velocity, const T &value);
+
+    /**
+     * \param id the neighbor id
+     * \return the record, or 0 if not present
+     */
+    T* Find (uint64_t id);
+    const T* Find (uint64_t id) const;
+
+    /**
+     * \param id the neighbor id
+     * \return true if the neighbor is present
+     */
+    bool Contains (uint64_t id) const;
+
+    /**
+     * \param id the neighbor id
+     * \return true if the neighbor was present
+     */
+    bool Erase (uint64_t id);
+
+    /**
+     * \brief Erase the record pointed by the iterator.
+     *
+     * The last record is moved into the freed position, so the returned
+     * iterator (same position) must be visited next; use as
+     * <tt>it = table.Erase (it);</tt> in place of <tt>++it</tt>.
+     *
+     * \param it the record to erase
+     * \return the iterator to visit next
+     */
+    Iterator Erase (Iterator it);
+
+    /**
+     * \brief Sort records to erase in the order of a storage order scan.
+     *
+     * Reorders the ids the way a Begin () to End () scan erasing them with
+     * <tt>it = table.Erase (it)</tt> would reach them, so erasing them by
+     * id in this order leaves the records in the same storage order as
+     * the scan. Costs O(k^2) for k ids, independent of the table size.
+     *
+     * \param ids the ids to erase, reordered in place; the ids without a
+     * record are dropped
+     */
+    void SortForErase (std::vector<uint64_t> &ids) const;
+
+    /**
+     * \brief Remove all the records.
+     */
+    void Clear (void);
+
+    /**
+     * \return the number of records
+     */
+    uint32_t GetSize (void) const;
+
+    /**
+     * \return true if there are no records
+     */
+    bool IsEmpty (void) const;
+
+    Iterator Begin (void);
+    Iterator End (void);
+    ConstIterator Begin (void) const;
+    ConstIterator End (void) const;
+
+    /**
+     * \brief Collect the records within a distance of a point.
+     *
+     * Without grid, every record is checked.
+     *
+     * \param center the center of the query disc
+     * \param radius the radius of the query disc (m)
+     * \param result filled with the storage index of each matching record
+     */
+    void FindInRange (const Vector &center, double radius, std::vector<uint32_t> &result) const;
+
+    /**
+     * \brief Collect the records within a distance of a point moving in
+     * the same direction (same sign of each velocity component) as the
+     * given velocity.
+     * \param center the center of the query disc
+     * \param radius the radius of the query disc (m)
+     * \param velocity the reference velocity
+     * \param result filled with the storage index of each matching record
+     */
+    void FindInRange (const Vector &center, double radius, const Vector &velocity, std::vector<uint32_t> &result) const;
+
+    /**
+     * \brief FindInRange, with the storage indexes in increasing id order.
+     *
+     * Sorts the matching indexes, or filters GetIdOrder when they are
+     * most of the table and sorting them would cost more than a scan.
+     *
+     * \param center the center of the query disc
+     * \param radius the radius of the query disc (m)
+     * \param result filled with the storage index of each matching record
+     */
+    void FindInRangeById (const Vector &center, double radius, std::vector<uint32_t> &result) const;
+
+    /**
+     * \brief Sort storage indexes in the increasing id order of their
+     * records.
+     * \param indexes storage indexes, e.g. returned by FindInRange
+     */
+    void SortById (std::vector<uint32_t> &indexes) const;
+
+    /**
+     * \return the storage index of every record, in increasing id order
+     */
+    const std::vector<uint32_t>& GetIdOrder (void) const;
+
+    /**
+     * \param index a storage index returned by FindInRange
+     * \return the record at this index
+     */
+    Entry& GetEntry (uint32_t index);
+    const Entry& GetEntry (uint32_t index) const;
+
+private:
+
+    /**
+     * \brief Order storage indexes on the id of their record.
+     */
+    struct IdLess {
+        IdLess (const std::vector<Entry> &entries) : m_entries(entries) {}
+        bool operator() (uint32_t a, uint32_t b) const {
+            return m_entries[a].id < m_entries[b].id;
+        }
+        const std::vector<Entry> &m_entries;
+    };
+
+    /**
+     * \brief Order a storage index before an id, for the binary searches
+     * of m_idOrder.
+     */
+    struct IdBefore {
+        IdBefore (const std::vector<Entry> &entries) : m_entries(entries) {}
+        bool operator() (uint32_t index, uint64_t id) const {
+            return m_entries[index].id < id;
+        }
+        const std::vector<Entry> &m_entries;
+    };
+
+    uint64_t CellKey (int32_t cx, int32_t cy) const;
+    int32_t CellCoordinate (double v) const;
+    uint64_t CellOf (const Vector &position) const;
+    void GridInsert (uint64_t cell, uint32_t index);
+    void GridRemove (uint64_t cell, uint32_t index);
+    void GridMove (uint64_t cell, uint32_t from, uint32_t to);
+    void RemoveAt (uint32_t index);
+    std::vector<uint32_t>::iterator FindIdOrder (uint64_t id);
+    static bool IsSameDirection (const Vector &v1, const Vector &v2);
+    static double DistanceSquared (const Vector &a, const Vector &b);
+    static int Sign (double v);
+
+    double m_cellSize;
+    std::vector<Entry> m_entries;                   //!< contiguous records
+    V2vFlatIndex m_idIndex;                         //!< node id -> storage index
+    std::vector<uint32_t> m_idOrder;                //!< storage indexes in increasing id order
+    V2vFlatIndex m_cellIndex;                       //!< cell key -> bucket index
+    std::vector<std::vector<uint32_t> > m_cells;    //!< storage indexes per cell
+};
+
+
+/*--------------------------- V2vNeighborTable ---------------------------*/
+template <typename T>
+V2vNeighborTable<T>::V2vNeighborTable (double cellSize) :
+        m_cellSize(cellSize){
+    NS_ASSERT (m_cellSize >= 0);
+}
+
+template <typename T>
+void
+V2vNeighborTable<T>::SetCellSize (double cellSize){
+    NS_ASSERT (cellSize >= 0);
+    m_cellSize = cellSize;
+    m_cellIndex.Clear ();
+    m_cells.clear ();
+    for (uint32_t i = 0; i < m_entries.size (); ++i){
+        m_entries[i].cell = CellOf (m_entries[i].position);
+        GridInsert (m_entries[i].cell, i);
+    }
+}
+
+template <typename T>
+double
+V2vNeighborTable<T>::GetCellSize (void) const {
+    return m_cellSize;
+}
+
+template <typename T>
+T&
+V2vNeighborTable<T>::Insert (uint64_t id, const Vector &position, const Vector &velocity, const T &value){
+    uint64_t cell = CellOf (position);
+    uint32_t index;
+    if (m_idIndex.Find (id, index)){
+        Entry &entry = m_entries[index];
+        if (entry.cell != cell){
+            GridRemove (entry.cell, index);
+            GridInsert (cell, index);
+            entry.cell = cell;
+        }
+        entry.position = position;
+        entry.velocity = velocity;
+        entry.value = value;
+        return entry.value;
+    }
+
+    Entry entry;
+    entry.id = id;
+    entry.position = position;
+    entry.velocity = velocity;
+    entry.cell = cell;
+    entry.value = value;
+
+    index = m_entries.size ();
+    m_idOrder.insert (FindIdOrder (id), index);
+    m_entries.push_back (entry);
+    m_idIndex.Insert (id, index);
+    GridInsert (cell, index);
+    return m_entries[index].value;
+}
+
+template <typename T>
+T*
+V2vNeighborTable<T>::Find (uint64_t id){
+    uint32_t index;
+    if (m_idIndex.Find (id, index)){
+        return &m_entries[index].value;
+    }
+    return 0;
+}
+
+template <typename T>
+const T*
+V2vNeighborTable<T>::Find (uint64_t id) const {
+    uint32_t index;
+    if (m_idIndex.Find (id, index)){
+        return &m_entries[index].value;
+    }
+    return 0;
+}
+
+template <typename T>
+bool
+V2vNeighborTable<T>::Contains (uint64_t id) const {
+    uint32_t index;
+    return m_idIndex.Find (id, index);
+}
+
+template <typename T>
+bool
+V2vNeighborTable<T>::Erase (uint64_t id){
+    uint32_t index;
+    if (!m_idIndex.Find (id, index)){
+        return false;
+    }
+    RemoveAt (index);
+    return true;
+}
+
+template <typename T>
+typename V2vNeighborTable<T>::Iterator
+V2vNeighborTable<T>::Erase (Iterator it){
+    uint32_t index = it - m_entries.begin ();
+    RemoveAt (index);
+    return m_entries.begin () + index;
+}
+
+template <typename T>
+void
+V2vNeighborTable<T>::Clear (void){
+    m_entries.clear ();
+    m_idIndex.Clear ();
+    m_idOrder.clear ();
+    m_cellIndex.Clear ();
+    m_cells.clear ();
+}
+
+template <typename T>
+uint32_t
+V2vNeighborTable<T>::GetSize (void) const {
+    return m_entries.size ();
+}
+
+template <typename T>
+bool
+V2vNeighborTable<T>::IsEmpty (void) const {
+    return m_entries.empty ();
+}
+
+template <typename T>
+typename V2vNeighborTable<T>::Iterator
+V2vNeighborTable<T>::Begin (void){
+    return m_entries.begin ();
+}
+
+template <typename T>
+typename V2vNeighborTable<T>::Iterator
+V2vNeighborTable<T>::End (void){
+    return m_entries.end ();
+}
+
+template <typename T>
+typename V2vNeighborTable<T>::ConstIterator
+V2vNeighborTable<T>::Begin (void) const {
+    return m_entries.begin ();
+}
+
+template <typename T>
+typename V2vNeighborTable<T>::ConstIterator
+V2vNeighborTable<T>::End (void) const {
+    return m_entries.end ();
+}
+
+template <typename T>
+void
+V2vNeighborTable<T>::FindInRange (const Vector &center, double radius, std::vector<uint32_t> &result) const {
+    result.clear ();
+    double radiusSquare = radius*radius;
+    if (m_cellSize == 0){
+        for (uint32_t i = 0; i < m_entries.size (); ++i){
+            if (DistanceSquared (m_entries[i].position, center) <= radiusSquare){
+                result.push_back (i);
+            }
+        }
+        return;
+    }
+
+    int32_t minX = CellCoordinate (center.x - radius);
+    int32_t maxX = CellCoordinate (center.x + radius);
+    int32_t minY = CellCoordinate (center.y - radius);
+    int32_t maxY = CellCoordinate (center.y + radius);
+
+    for (int32_t cx = minX; cx <= maxX; ++cx){
+        for (int32_t cy = minY; cy <= maxY; ++cy){
+            uint32_t bucket;
+            if (!m_cellIndex.Find (CellKey (cx, cy), bucket)){
+                continue;
+            }
+            const std::vector<uint32_t> &cell = m_cells[bucket];
+            for (uint32_t k = 0; k < cell.size (); ++k){
+                if (DistanceSquared (m_entries[cell[k]].position, center) <= radiusSquare){
+                    result.push_back (cell[k]);
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void
+V2vNeighborTable<T>::FindInRange (const Vector &center, double radius, const Vector &velocity, std::vector<uint32_t> &result) const {
+    FindInRange (center, radius, result);
+    uint32_t kept = 0;
+    for (uint32_t k = 0; k < result.size (); ++k){
+        if (IsSameDirection (m_entries[result[k]].velocity, velocity)){
+            result[kept++] = result[k];
+        }
+    }
+    result.resize (kept);
+}
+
+template <typename T>
+void
+V2vNeighborTable<T>::FindInRangeById (const Vector &center, double radius, std::vector<uint32_t> &result) const {
+    FindInRange (center, radius, result);
+    double k = result.size ();
+    if (k * std::log (k + 1.0) / std::log (2.0) < m_entries.size ()){
+        SortById (result);
+        return;
+    }
+    double radiusSquare = radius*radius;
+    result.clear ();
+    for (uint32_t i = 0; i < m_idOrder.size (); ++i){
+        if (DistanceSquared (m_entries[m_idOrder[i]].position, center) <= radiusSquare){
+            result.push_back (m_idOrder[i]);
+        }
+    }
+}
+
+template <typename T>
+void
+V2vNeighborTable<T>::SortById (std::vector<uint32_t> &indexes) const {
+    std::sort (indexes.begin (), indexes.end (), IdLess (m_entries));
+}
+
+template <typename T>
+const std::vector<uint32_t>&
+V2vNeighborTable<T>::GetIdOrder (void) const {
+    return m_idOrder;
+}
+
+template <typename T>
+typename V2vNeighborTable<T>::Entry&
+V2vNeighborTable<T>::GetEntry (uint32_t index){
+    NS_ASSERT (index < m_entries.size ());
+    return m_entries[index];
+}
+
+template <typename T>
+const typename V2vNeighborTable<T>::Entry&
+V2vNeighborTable<T>::GetEntry (uint32_t index) const {
+    NS_ASSERT (index < m_entries.size ());
+    return m_entries[index];
+}
+
+template <typename T>
+uint64_t
+V2vNeighborTable<T>::CellKey (int32_t cx, int32_t cy) const {
+    return ((uint64_t)(uint32_t)cx << 32) | (uint64_t)(uint32_t)cy;
+}
+
+template <typename T>
+int32_t
+V2vNeighborTable<T>::CellCoordinate (double v) const {
+    return (int32_t)std::floor (v / m_cellSize);
+}
+
+template <typename T>
+uint64_t
+V2vNeighborTable<T>::CellOf (const Vector &position) const {
+    if (m_cellSize == 0){
+        return 0;
+    }
+    return CellKey (CellCoordinate (position.x), CellCoordinate (position.y));
+}
+
+template <typename T>
+void
+V2vNeighborTable<T>::GridInsert (uint64_t cell, uint32_t index){
+    if (m_cellSize == 0){
+        return;
+    }
+    uint32_t bucket;
+    if (!m_cellIndex.Find (cell, bucket)){
+        bucket = m_cells.size ();
+        m_cells.push_back (std::vector<uint32_t> ());
+        m_cellIndex.Insert (cell, bucket);
+    }
+    m_cells[bucket].push_back (index);
+}
+
+template <typename T>
+void
+V2vNeighborTable<T>::GridRemove (uint64_t cell, uint32_t index){
+    if (m_cellSize == 0){
+        return;
+    }
+    uint32_t bucket;
+    if (!m_cellIndex.Find (cell, bucket)){
+        NS_ASSERT_MSG (false, "Grid cell missing for record");
+        return;
+    }
+    std::vector<uint32_t> &indexes = m_cells[bucket];
+    for (uint32_t k = 0; k < indexes.size (); ++k){
+        if (indexes[k] == index){
+            indexes[k] = indexes.back ();
+            indexes.pop_back ();
+            return;
+        }
+    }
+    NS_ASSERT_MSG (false, "Record missing from its grid cell");
+}
+
+template <typename T>
+void
+V2vNeighborTable<T>::GridMove (uint64_t cell, uint32_t from, uint32_t to){
+    if (m_cellSize == 0){
+        return;
+    }
+    uint32_t bucket;
+    if (!m_cellIndex.Find (cell, bucket)){
+        NS_ASSERT_MSG (false, "Grid cell missing for record");
+        return;
+    }
+    std::vector<uint32_t> &indexes = m_cells[bucket];
+    for (uint32_t k = 0; k < indexes.size (); ++k){
+        if (indexes[k] == from){
+            indexes[k] = to;
+            return;
+        }
+    }
+}
+
+template <typename T>
+void
+V2vNeighborTable<T>::RemoveAt (uint32_t index){
+    NS_ASSERT (index < m_entries.size ());
+    uint32_t last = m_entries.size () - 1;
+
+    GridRemove (m_entries[index].cell, index);
+    m_idIndex.Erase (m_entries[index].id);
+    m_idOrder.erase (FindIdOrder (m_entries[index].id));
+
+    if (index != last){
+        *FindIdOrder (m_entries[last].id) = index;
+        m_entries[index] = m_entries[last];
+        m_idIndex.Insert (m_entries[index].id, index);
+        GridMove (m_entries[index].cell, last, index);
+    }
+    m_entries.pop_back ();
+}
+
+template <typename T>
+std::vector<uint32_t>::iterator
+V2vNeighborTable<T>::FindIdOrder (uint64_t id){
+    return std::lower_bound (m_idOrder.begin (), m_idOrder.end (), id, IdBefore (m_entries));
+}
+
+template <typename T>
+void
+V2vNeighborTable<T>::SortForErase (std::vector<uint64_t> &ids) const {
+    std::vector<std::pair<uint32_t, uint64_t> > pending;
+    for (uint32_t i = 0; i < ids.size (); ++i){
+        uint32_t index;
+        if (m_idIndex.Find (ids[i], index)){
+            pending.push_back (std::make_pair (index, ids[i]));
+        }
+    }
+
+    // the scan erases the lowest position first and the last record
+    // moves into the hole, to be visited next
+    uint32_t size = m_entries.size ();
+    ids.clear ();
+    while (!pending.empty ()){
+        uint32_t first = 0;
+        for (uint32_t i = 1; i < pending.size (); ++i){
+            if (pending[i].first < pending[first].first){
+                first = i;
+            }
+        }
+        uint32_t hole = pending[first].first;
+        ids.push_back (pending[first].second);
+        pending[first] = pending.back ();
+        pending.pop_back ();
+
+        size --;
+        for (uint32_t i = 0; i < pending.size (); ++i){
+            if (pending[i].first == size){
+                pending[i].first = hole;
+            }
+        }
+    }
+}
+
+template <typename T>
+double
+V2vNeighborTable<T>::DistanceSquared (const Vector &a, const Vector &b){
+    double dx = a.x - b.x;
+    double dy = a.y - b.y;
+    double dz = a.z - b.z;
+    return dx*dx + dy*dy + dz*dz;
+}
+
+template <typename T>
+int
+V2vNeighborTable<T>::Sign (double v){
+    return (0.0 < v) - (v < 0.0);
+}
+
+template <typename T>
+bool
+V2vNeighborTable<T>::IsSameDirection (const Vector &v1, const Vector &v2){
+    if ((v1.x == 0.0) && (v1.y == 0.0) && (v2.x == 0.0) && (v2.y == 0.0)){
+        return true;
+    }
+    return (Sign (v1.x) == Sign (v2.x)) && (Sign (v1.y) == Sign (v2.y));
+}
+
+} // namespace ns3
+
+#endif // V2V_NEIGHBOR_TABLE_H
@@ -18,6 +18,8 @@
  * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
  */
 
+#include <cmath>
+#include <sstream>
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/nstime.h"
@@ -26,6 +28,8 @@
 #include "ns3/packet.h"
 #include "ns3/address.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
 #include "ns3/uinteger.h"
 #include "ns3/simulator.h"
 #include "ns3/udp-socket.h"
@@ -36,6 +40,9 @@
 #include "ns3/inet6-socket-address.h"
 #include "ns3/packet-socket-address.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy-state-helper.h"
+#include "v2v-cluster-registry.h"
 #include "v2v-novel-algorithm-client.h"
 
 #include "ns3/random-variable.h"
@@ -108,10 +115,64 @@ TypeId V2vNovelAlgorithmClient::GetTypeId(void) {
                     "The maximun size of ues permitted", UintegerValue(100),
                     MakeUintegerAccessor(&V2vNovelAlgorithmClient::m_maxUes),
                     MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("NeighborRange",
+                    "Radius (m) around the node of the stable neighbors used by the CH election, served by a spatial grid; at least the radio range, 0 for every stable neighbor",
+                    DoubleValue(1000.0),
+                    MakeDoubleAccessor(&V2vNovelAlgorithmClient::m_neighborRange),
+                    MakeDoubleChecker<double>(0.0))
+            .AddAttribute("NeighborGridCellSize",
+                    "Side (m) of a spatial grid cell of the neighbor table; 0 for NeighborRange",
+                    DoubleValue(0.0),
+                    MakeDoubleAccessor(&V2vNovelAlgorithmClient::m_gridCellSize),
+                    MakeDoubleChecker<double>(0.0))
+            .AddAttribute("SlotAllocation",
+                    "How the TDMA offset of the node is chosen: VehicleTdmaSlot, or a hashed slot moved on collisions",
+                    EnumValue(V2vSlotAllocator::FIXED),
+                    MakeEnumAccessor(&V2vNovelAlgorithmClient::m_slotScheme),
+                    MakeEnumChecker(V2vSlotAllocator::FIXED, "Fixed",
+                                    V2vSlotAllocator::HASHED, "Hashed"))
+            .AddAttribute("FrameSlots",
+                    "Number of MinimumTdmaSlot slots of the TDMA frame of the hashed scheme", UintegerValue(100),
+                    MakeUintegerAccessor(&V2vNovelAlgorithmClient::m_frameSlots),
+                    MakeUintegerChecker<uint32_t>(1))
             .AddAttribute ("Interval",
                     "The time to wait between packets", TimeValue (Seconds (1.0)),
                     MakeTimeAccessor (&V2vNovelAlgorithmClient::m_interval),
                     MakeTimeChecker ())
+            .AddAttribute ("CompactHeaders",
+                    "Send the update messages in the quantized, delta encoded wire format; must be the same on every node",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&V2vNovelAlgorithmClient::m_compactHeaders),
+                    MakeBooleanChecker ())
+            .AddAttribute ("KeyFrameInterval",
+                    "Number of compact update messages between two key frames", UintegerValue(10),
+                    MakeUintegerAccessor(&V2vNovelAlgorithmClient::m_keyFrameInterval),
+                    MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute ("AdaptiveUpdate",
+                    "Scale the update interval with the neighbor churn, the relative velocity variance and the channel busy ratio",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&V2vNovelAlgorithmClient::m_adaptiveUpdate),
+                    MakeBooleanChecker ())
+            .AddAttribute ("MinUpdateInterval",
+                    "Shortest update interval of the adaptive mode", TimeValue (Seconds (0.5)),
+                    MakeTimeAccessor (&V2vNovelAlgorithmClient::m_minUpdateInterval),
+                    MakeTimeChecker ())
+            .AddAttribute ("MaxUpdateInterval",
+                    "Longest update interval of the adaptive mode", TimeValue (Seconds (3.0)),
+                    MakeTimeAccessor (&V2vNovelAlgorithmClient::m_maxUpdateInterval),
+                    MakeTimeChecker ())
+            .AddAttribute("ChurnReference",
+                    "Neighbor joins and leaves per neighbor and second that halve the adaptive interval range", DoubleValue(0.1),
+                    MakeDoubleAccessor(&V2vNovelAlgorithmClient::m_churnReference),
+                    MakeDoubleChecker<double>(0.0))
+            .AddAttribute("VelocityVarianceReference",
+                    "Mean squared relative velocity of the neighbors (m^2/s^2) that halves the adaptive interval range", DoubleValue(4.0),
+                    MakeDoubleAccessor(&V2vNovelAlgorithmClient::m_velocityVarianceReference),
+                    MakeDoubleChecker<double>(0.0))
+            .AddAttribute("TargetBusyRatio",
+                    "Channel busy ratio above which the adaptive interval is stretched", DoubleValue(0.5),
+                    MakeDoubleAccessor(&V2vNovelAlgorithmClient::m_targetBusyRatio),
+                    MakeDoubleChecker<double>(0.0, 1.0))
             .AddAttribute("SendingLocal",
 					"The address of the destination", AddressValue(),
                     MakeAddressAccessor(&V2vNovelAlgorithmClient::m_peer),
@@ -142,10 +203,24 @@ V2vNovelAlgorithmClient::V2vNovelAlgorithmClient () {
     m_clusterChanges = 0;
     m_numberOfMessages = 0;
     m_clusterChangesPerSec = 0;
+    m_registered = false;
+    m_registeredRole = V2vClusterSap::STANDALONE;
+    m_neighborTimeout = Seconds (1.5);
+    m_neighborJoins = 0;
+    m_neighborLeaves = 0;
+    m_phyConnected = false;
 
     m_sentCounter = 0;
     m_receivedCounter = 0;
     m_sendEvent = EventId ();
+
+    for(uint32_t type = 0; type < V2vClusterSap::MESSAGE_TYPES; ++type){
+        m_messageHandlers[type] = 0;
+    }
+    m_messageHandlers[V2vClusterSap::NOVEL_COV_MESSAGE] = &V2vNovelAlgorithmClient::HandleCOV;
+    m_messageHandlers[V2vClusterSap::NOVEL_FORMATION_MESSAGE] = &V2vNovelAlgorithmClient::HandleFormation;
+    m_messageHandlers[V2vClusterSap::NOVEL_UPDATE_MESSAGE] = &V2vNovelAlgorithmClient::HandleUpdate;
+    m_messageHandlers[V2vClusterSap::NOVEL_MERGE_MESSAGE] = &V2vNovelAlgorithmClient::HandleMerge;
 }
 
 V2vNovelAlgorithmClient::~V2vNovelAlgorithmClient () {
@@ -161,31 +236,13 @@ V2vNovelAlgorithmClient::~V2vNovelAlgorithmClient () {
 double
 V2vNovelAlgorithmClient::GetClusterMembers(void){
 
-    if(m_clusterMembers.size () > 0){
-
-        double s = 0.0;
-        for(std::vector<uint64_t>::iterator it = m_clusterMembers.begin (); it != m_clusterMembers.end (); ++it){
-            s += (*it);
-        }
-        return s/m_clusterMembers.size ();
-    }
-
-    return 0;
+    return m_clusterMembers.GetMean ();
 }
 
 double
 V2vNovelAlgorithmClient::GetFormationDelay (void){
 
-    if(m_formationDelayVector.size () > 0){
-
-        uint64_t sumDelay = 0;
-        for(std::vector<uint64_t>::iterator it = m_formationDelayVector.begin (); it != m_formationDelayVector.end (); ++it){
-            sumDelay += *it;
-        }
-        return TimeStep (sumDelay/m_formationDelayVector.size ()).GetSeconds ();
-    }
-
-    return 0;
+    return m_formationDelay.GetMean ();
 }
 
 uint64_t
@@ -203,6 +260,11 @@ V2vNovelAlgorithmClient::GetRole (void){
     return m_currentInfo.degree;
 }
 
+uint64_t
+V2vNovelAlgorithmClient::GetClusterId (void){
+    return m_currentInfo.clusterId;
+}
+
 uint64_t
 V2vNovelAlgorithmClient::GetNumberOfMessagesPerSecond (void){
     uint64_t tmp = m_numberOfMessagesPerSec;
@@ -224,19 +286,10 @@ V2vNovelAlgorithmClient::GetChDuration (void){
     if(m_chDurationBoolean){
         m_chDurationBoolean = false;
         m_stopChDuration = Simulator::Now ().GetTimeStep ();
-        m_chDurationVector.push_back (m_stopChDuration - m_startChDuration);
+        m_chDuration.Add (TimeStep (m_stopChDuration - m_startChDuration).GetSeconds ());
     }
 
-    if(m_chDurationVector.size () > 0){
-
-        uint64_t sumDuration = 0;
-        for(std::vector<uint64_t>::iterator it = m_chDurationVector.begin (); it != m_chDurationVector.end (); ++it){
-            sumDuration += *it;
-        }
-        return TimeStep (sumDuration/m_chDurationVector.size ()).GetSeconds ();
-    }
-
-    return 0;
+    return m_chDuration.GetMean ();
 }
 
 double
@@ -245,67 +298,242 @@ V2vNovelAlgorithmClient::GetCmDuration (void){
     if(m_cmDurationBoolean){
         m_cmDurationBoolean = false;
         m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-        m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
-    }
-
-    if(m_cmDurationVector.size () > 0){
-
-        uint64_t sumDuration = 0;
-        for(std::vector<uint64_t>::iterator it = m_cmDurationVector.begin (); it != m_cmDurationVector.end (); ++it){
-            sumDuration += *it;
-        }
-        return TimeStep (sumDuration/m_cmDurationVector.size ()).GetSeconds ();
+        m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
     }
 
-    return 0;
+    return m_cmDuration.GetMean ();
 }
 
 double
 V2vNovelAlgorithmClient::GetMinChDuration (void){
 
-    uint64_t min = Simulator::Now ().GetTimeStep ();
-    for(std::vector<uint64_t>::iterator it = m_chDurationVector.begin (); it != m_chDurationVector.end (); ++it){
-        if((*it) < min){
-            min = *it;
-        }
+    if(m_chDuration.GetCount () == 0){
+        return Simulator::Now ().GetSeconds ();
     }
-    return TimeStep (min).GetSeconds ();
+    return m_chDuration.GetMin ();
 }
 
 double
 V2vNovelAlgorithmClient::GetMaxChDuration (void){
 
-    uint64_t max = 0;
-    for(std::vector<uint64_t>::iterator it = m_chDurationVector.begin (); it != m_chDurationVector.end (); ++it){
-        if((*it) > max){
-            max = *it;
-        }
-    }
-    return TimeStep (max).GetSeconds ();
+    return m_chDuration.GetMax ();
 }
 
 double
 V2vNovelAlgorithmClient::GetMinCmDuration (void){
 
-    uint64_t min = Simulator::Now ().GetTimeStep ();
-    for(std::vector<uint64_t>::iterator it = m_cmDurationVector.begin (); it != m_cmDurationVector.end (); ++it){
-        if((*it) < min){
-            min = *it;
-        }
+    if(m_cmDuration.GetCount () == 0){
+        return Simulator::Now ().GetSeconds ();
     }
-    return TimeStep (min).GetSeconds ();
+    return m_cmDuration.GetMin ();
 }
 
 double
 V2vNovelAlgorithmClient::GetMaxCmDuration (void){
 
-    uint64_t max = 0;
-    for(std::vector<uint64_t>::iterator it = m_cmDurationVector.begin (); it != m_cmDurationVector.end (); ++it){
-        if((*it) > max){
-            max = *it;
+    return m_cmDuration.GetMax ();
+}
+
+const V2vStatisticsAccumulator &
+V2vNovelAlgorithmClient::GetFormationDelayStatistics (void) const {
+    return m_formationDelay;
+}
+
+const V2vStatisticsAccumulator &
+V2vNovelAlgorithmClient::GetClusterMembersStatistics (void) const {
+    return m_clusterMembers;
+}
+
+const V2vStatisticsAccumulator &
+V2vNovelAlgorithmClient::GetChDurationStatistics (void) const {
+    return m_chDuration;
+}
+
+const V2vStatisticsAccumulator &
+V2vNovelAlgorithmClient::GetCmDurationStatistics (void) const {
+    return m_cmDuration;
+}
+
+const V2vStatisticsAccumulator &
+V2vNovelAlgorithmClient::GetUpdateIntervalStatistics (void) const {
+    return m_updateIntervals;
+}
+
+const V2vStatisticsAccumulator &
+V2vNovelAlgorithmClient::GetChannelBusyStatistics (void) const {
+    return m_channelBusy;
+}
+
+const V2vStatisticsAccumulator &
+V2vNovelAlgorithmClient::GetUpdateSizeStatistics (void) const {
+    return m_updateSize;
+}
+
+const V2vNovelUpdateCodec &
+V2vNovelAlgorithmClient::GetUpdateCodec (void) const {
+    return m_codec;
+}
+
+const V2vSlotAllocator &
+V2vNovelAlgorithmClient::GetSlotAllocator (void) const {
+    return m_slots;
+}
+
+void
+V2vNovelAlgorithmClient::SendControl (Ptr<Socket> socket, Ptr<Packet> packet){
+    if(m_scheduler != 0){
+        m_scheduler->Send (socket, packet, V2vChannelScheduler::CCH);
+    }
+    else{
+        socket->Send (packet);
+    }
+}
+
+double
+V2vNovelAlgorithmClient::GetTdmaOffset (void) const {
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        return m_slots.GetOffset ().GetSeconds ();
+    }
+    return m_vehicleTdmaSlot;
+}
+
+uint32_t
+V2vNovelAlgorithmClient::GetTdmaFrameSlots (void) const {
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        return m_slots.GetFrameSlots ();
+    }
+    return m_maxUes;
+}
+
+void
+V2vNovelAlgorithmClient::SaveState (V2vSnapshotWriter &writer) const {
+
+    writer.Write ("nodeState", (uint32_t) m_nodeState);
+    writer.Write ("covVelocity", m_covVelocity);
+    writer.Write ("currentInfo", m_currentInfo);
+    writer.WriteTable ("clusterMap", m_clusterMap, 0);
+    writer.WriteTable ("neighborMap", m_neighborMap, &m_neighborExpiry);
+    writer.WriteTable ("stableNeighborMap", m_stableNeighborMap, &m_stableExpiry);
+    writer.Write ("membersAddress", (uint32_t) m_membersAddress.size ());
+    for(std::map<uint64_t, Address>::const_iterator it = m_membersAddress.begin (); it != m_membersAddress.end (); ++it){
+        writer.Write ("id", it->first);
+        writer.Write ("address", it->second);
+    }
+
+    writer.Write ("formationCounter", m_formationCounter);
+    writer.Write ("maintenanceCounter", m_maintenanceCounter);
+    writer.Write ("sentCounter", m_sentCounter);
+    writer.Write ("receivedCounter", m_receivedCounter);
+    writer.Write ("formationDelayBoolean", m_formationDelayBoolean);
+    writer.Write ("startFormationDelay", m_startFormationDelay);
+    writer.Write ("stopFormationDelay", m_stopFormationDelay);
+    writer.Write ("formationDelay", m_formationDelay);
+    writer.Write ("clusterMembers", m_clusterMembers);
+    writer.Write ("clusterChanges", m_clusterChanges);
+    writer.Write ("numberOfMessages", m_numberOfMessages);
+    writer.Write ("numberOfMessagesPerSec", m_numberOfMessagesPerSec);
+    writer.Write ("clusterChangesPerSec", m_clusterChangesPerSec);
+    writer.Write ("chDurationBoolean", m_chDurationBoolean);
+    writer.Write ("startChDuration", m_startChDuration);
+    writer.Write ("stopChDuration", m_stopChDuration);
+    writer.Write ("chDuration", m_chDuration);
+    writer.Write ("cmDurationBoolean", m_cmDurationBoolean);
+    writer.Write ("startCmDuration", m_startCmDuration);
+    writer.Write ("stopCmDuration", m_stopCmDuration);
+    writer.Write ("cmDuration", m_cmDuration);
+    writer.Write ("neighborJoins", m_neighborJoins);
+    writer.Write ("neighborLeaves", m_neighborLeaves);
+    writer.Write ("busyTime", m_busyTime);
+    writer.Write ("windowStart", m_windowStart);
+    writer.Write ("updateIntervals", m_updateIntervals);
+    writer.Write ("channelBusy", m_channelBusy);
+    writer.Write ("updateSize", m_updateSize);
+    m_slots.SaveState (writer);
+
+    writer.WriteEvent ("sendEvent", m_sendEvent);
+    writer.WriteEvent ("updateEvent", m_updateEvent);
+    writer.WriteEvent ("maintenanceEvent", m_maintenanceEvent);
+    writer.WriteEvent ("checkEvent", m_checkEvent);
+}
+
+void
+V2vNovelAlgorithmClient::SetSnapshot (const std::string &record){
+    m_snapshot = record;
+}
+
+void
+V2vNovelAlgorithmClient::LoadState (V2vSnapshotReader &reader){
+    NS_LOG_FUNCTION (this);
+
+    uint32_t nodeState;
+    uint32_t members;
+    reader.Read ("nodeState", nodeState);
+    m_nodeState = (V2vClusterSap::NovelNodeState) nodeState;
+    reader.Read ("covVelocity", m_covVelocity);
+    reader.Read ("currentInfo", m_currentInfo);
+    reader.ReadTable ("clusterMap", m_clusterMap, 0);
+    reader.ReadTable ("neighborMap", m_neighborMap, &m_neighborExpiry);
+    reader.ReadTable ("stableNeighborMap", m_stableNeighborMap, &m_stableExpiry);
+    m_chNeighbors.clear ();
+    for(V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::ConstIterator it = m_neighborMap.Begin(); it != m_neighborMap.End(); ++it){
+        if(it->value.degree == V2vClusterSap::CH){
+            m_chNeighbors.insert (it->id);
         }
     }
-    return TimeStep (max).GetSeconds ();
+    reader.Read ("membersAddress", members);
+    m_membersAddress.clear ();
+    for(uint32_t i = 0; i < members; ++i){
+        uint64_t id;
+        reader.Read ("id", id);
+        reader.Read ("address", m_membersAddress[id]);
+    }
+
+    reader.Read ("formationCounter", m_formationCounter);
+    reader.Read ("maintenanceCounter", m_maintenanceCounter);
+    reader.Read ("sentCounter", m_sentCounter);
+    reader.Read ("receivedCounter", m_receivedCounter);
+    reader.Read ("formationDelayBoolean", m_formationDelayBoolean);
+    reader.Read ("startFormationDelay", m_startFormationDelay);
+    reader.Read ("stopFormationDelay", m_stopFormationDelay);
+    reader.Read ("formationDelay", m_formationDelay);
+    reader.Read ("clusterMembers", m_clusterMembers);
+    reader.Read ("clusterChanges", m_clusterChanges);
+    reader.Read ("numberOfMessages", m_numberOfMessages);
+    reader.Read ("numberOfMessagesPerSec", m_numberOfMessagesPerSec);
+    reader.Read ("clusterChangesPerSec", m_clusterChangesPerSec);
+    reader.Read ("chDurationBoolean", m_chDurationBoolean);
+    reader.Read ("startChDuration", m_startChDuration);
+    reader.Read ("stopChDuration", m_stopChDuration);
+    reader.Read ("chDuration", m_chDuration);
+    reader.Read ("cmDurationBoolean", m_cmDurationBoolean);
+    reader.Read ("startCmDuration", m_startCmDuration);
+    reader.Read ("stopCmDuration", m_stopCmDuration);
+    reader.Read ("cmDuration", m_cmDuration);
+    reader.Read ("neighborJoins", m_neighborJoins);
+    reader.Read ("neighborLeaves", m_neighborLeaves);
+    reader.Read ("busyTime", m_busyTime);
+    reader.Read ("windowStart", m_windowStart);
+    reader.Read ("updateIntervals", m_updateIntervals);
+    reader.Read ("channelBusy", m_channelBusy);
+    reader.Read ("updateSize", m_updateSize);
+    m_slots.LoadState (reader);
+
+    Time delay = reader.ReadEvent ("sendEvent");
+    if(!delay.IsNegative ()){
+        ScheduleTransmit (delay);
+    }
+    delay = reader.ReadEvent ("updateEvent");
+    if(!delay.IsNegative ()){
+        ScheduleUpdate (delay);
+    }
+    delay = reader.ReadEvent ("maintenanceEvent");
+    if(!delay.IsNegative ()){
+        ScheduleMaintenance (delay);
+    }
+    delay = reader.ReadEvent ("checkEvent");
+    if(!delay.IsNegative ()){
+        m_checkEvent = Simulator::Schedule (delay, &V2vNovelAlgorithmClient::Check, this);
+    }
 }
 
 void
@@ -339,11 +567,25 @@ V2vNovelAlgorithmClient::DoDispose (void) {
 
     m_socket = 0;
     m_socketListening = 0;
+    m_scheduler = 0;
+
+    if(m_registered){
+        V2vClusterRegistry::Get ()->Unregister (m_registeredRole);
+        m_registered = false;
+    }
 
 	// chain up
 	Application::DoDispose();
 }
 
+void
+V2vNovelAlgorithmClient::UpdateRegistryRole (void){
+    if(m_registered && m_currentInfo.degree != m_registeredRole){
+        V2vClusterRegistry::Get ()->NotifyRoleChange (m_registeredRole, m_currentInfo.degree);
+        m_registeredRole = m_currentInfo.degree;
+    }
+}
+
 void
 V2vNovelAlgorithmClient::StartApplication (void)
 {
@@ -367,14 +609,53 @@ V2vNovelAlgorithmClient::StartApplication (void)
                 MakeCallback(&V2vNovelAlgorithmClient::ConnectionFailed, this));
     }
 
-    if(m_maxUes > 100){
+    //!< Control messages go on the CCH only
+    m_scheduler = GetNode ()->GetObject<V2vChannelScheduler> ();
+    if(m_scheduler != 0 && !m_scheduler->BindToChannel (m_socket, V2vChannelScheduler::CCH)){
+        NS_FATAL_ERROR("Error: V2vChannelScheduler without a CCH device.");
+    }
+
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        m_slots.Start (GetNode ()->GetId (), m_frameSlots, Seconds (m_minimumTdmaSlot));
+    }
+    else if(m_maxUes > 100){
         NS_FATAL_ERROR("Error: Maximum number of ues is 100.");
     }
 
     StartListeningLocal();
+    m_stableNeighborMap.SetCellSize (m_gridCellSize > 0 ? m_gridCellSize : m_neighborRange);
+
+    if(m_adaptiveUpdate){
+        NS_ASSERT_MSG (m_minUpdateInterval.IsStrictlyPositive () && m_minUpdateInterval <= m_maxUpdateInterval,
+                       "Invalid adaptive update interval bounds");
+        NS_ASSERT_MSG (m_interval.IsStrictlyPositive ()
+                       && (m_minUpdateInterval.GetTimeStep () + m_interval.GetTimeStep () - 1) / m_interval.GetTimeStep ()
+                       <= m_maxUpdateInterval.GetTimeStep () / m_interval.GetTimeStep (),
+                       "The adaptive update interval bounds must hold a whole number of Interval frames");
+        //!< A neighbor may stay silent for a whole MaxUpdateInterval
+        m_neighborTimeout = Max (Seconds (1.5), Seconds (1.5 * m_maxUpdateInterval.GetSeconds ()));
+        ConnectPhyState ();
+    }
+    else{
+        m_neighborTimeout = Seconds (1.5);
+    }
+    m_windowStart = Simulator::Now ();
+    m_codec.SetKeyFrameInterval (m_keyFrameInterval);
+
+    if(!m_snapshot.empty ()){
+        std::istringstream record (m_snapshot);
+        V2vSnapshotReader reader (record);
+        LoadState (reader);
+        m_snapshot.clear ();
+    }
+    else{
+        ScheduleUpdate (Seconds(m_trainingPeriod - GetTdmaOffset ()));
+        ScheduleTransmit (Seconds (m_trainingPeriod + GetTdmaOffset ()));
+    }
 
-    ScheduleUpdate (Seconds(m_trainingPeriod - m_vehicleTdmaSlot));
-    ScheduleTransmit (Seconds (m_trainingPeriod + m_vehicleTdmaSlot));
+    m_registeredRole = m_currentInfo.degree;
+    m_registered = true;
+    V2vClusterRegistry::Get ()->Register (m_registeredRole);
 }
 
 void
@@ -464,172 +745,225 @@ V2vNovelAlgorithmClient::HandleRead (Ptr<Socket> socket) {
             break;
         }
 
-        Ptr<Packet> p = packet->Copy ();
-        PacketMetadata::ItemIterator metadataIterator = p->BeginItem();
-        PacketMetadata::Item item;
-        while (metadataIterator.HasNext()){
-            item = metadataIterator.Next();
+        V2vClusterTypeHeader typeHeader;
+        packet->RemoveHeader (typeHeader);
+
+        //!< Only the update messages have a compact format, drop the ones of another format
+        bool compact = m_compactHeaders && typeHeader.GetType () == V2vClusterSap::NOVEL_UPDATE_MESSAGE;
+        MessageHandler handler = 0;
+        if(typeHeader.IsValid () && typeHeader.IsCompact () == compact){
+            handler = m_messageHandlers[typeHeader.GetType ()];
+        }
+        if(handler != 0){
+            (this->*handler) (packet, from);
+        }
+        else{
+            NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " Dropped message of unknown type: " << typeHeader.GetType ());
+        }
+        m_rxTrace(packet, from);
+        m_receivedCounter ++;
+    }
+}
+
+void
+V2vNovelAlgorithmClient::HandleCOV (Ptr<Packet> packet, const Address &from) {
+    NS_LOG_FUNCTION (this << packet << from);
+    V2vNovelCOVHeader covHeader;
+    packet->RemoveHeader (covHeader);
 
-            if(item.tid.GetName() == "ns3::V2vNovelCOVHeader"){
-                V2vNovelCOVHeader covHeader;
-                p->RemoveHeader (covHeader);
+    V2vClusterSap::NovelNeighborInfo *cov = m_stableNeighborMap.Find (covHeader.GetTempClusterId ());
+    if(cov != 0){
 
-                std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator cov = m_stableNeighborMap.find(covHeader.GetTempClusterId ());
-                if(cov != m_stableNeighborMap.end ()){
+        if(m_currentInfo.tempClusterId == 0){
 
-                    if(m_currentInfo.tempClusterId == 0){
+            m_covVelocity = cov->velocity;
+            if(IsLowerThan(m_covVelocity, m_currentInfo.velocity)){
 
-                        m_covVelocity = cov->second.velocity;
-                        if(IsLowerThan(m_covVelocity, m_currentInfo.velocity)){
+                ChangeState (m_nodeState);
+                ChangeState (m_nodeState);
+                m_currentInfo.tempClusterId = covHeader.GetTempClusterId ();
 
-                            ChangeState (m_nodeState);
-                            ChangeState (m_nodeState);
-                            m_currentInfo.tempClusterId = covHeader.GetTempClusterId ();
+                double waitingTime = SuitabilityCheck();
+                NS_LOG_UNCOND ("NodeId: " << m_currentInfo.id << " WaitingTime is: " << waitingTime);
+                ScheduleTransmit (Seconds(waitingTime));
+            }
+        }
+    }
+}
 
-                            double waitingTime = SuitabilityCheck();
-                            NS_LOG_UNCOND ("NodeId: " << m_currentInfo.id << " WaitingTime is: " << waitingTime);
-                            ScheduleTransmit (Seconds(waitingTime));
-                        }
-                    }
+void
+V2vNovelAlgorithmClient::HandleFormation (Ptr<Packet> packet, const Address &from) {
+    NS_LOG_FUNCTION (this << packet << from);
+    V2vNovelFormationHeader formationHeader;
+    packet->RemoveHeader (formationHeader);
+
+    V2vClusterSap::NovelNeighborInfo *ch = m_stableNeighborMap.Find (formationHeader.GetClusterId());
+    if(m_currentInfo.tempClusterId == formationHeader.GetTempClusterId()){
+        if((ch != 0) && (m_currentInfo.clusterId == 0)){
+
+            if(IsLowerThan(m_covVelocity, m_currentInfo.velocity)){
+                m_currentInfo.degree = V2vClusterSap::CM;
+                UpdateRegistryRole ();
+                m_currentInfo.clusterId = formationHeader.GetClusterId();
+
+                m_sendEvent.Cancel ();
+                NS_LOG_DEBUG ("Cluster Head election event cancelled...Turning to CM");
+
+                ChangeState (m_nodeState);
+
+                m_clusterChanges ++;
+                m_clusterChangesPerSec ++;
+                V2vClusterRegistry::Get ()->NotifyClusterChange ();
+
+                if(m_chDurationBoolean){
+                    m_chDurationBoolean = false;
+                    m_stopChDuration = Simulator::Now ().GetTimeStep ();
+                    m_chDuration.Add (TimeStep (m_stopChDuration - m_startChDuration).GetSeconds ());
                 }
-            }
-            else if(item.tid.GetName() == "ns3::V2vNovelFormationHeader"){
-                V2vNovelFormationHeader formationHeader;
-                p->RemoveHeader (formationHeader);
-
-                std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator ch = m_stableNeighborMap.find(formationHeader.GetClusterId());
-                if(m_currentInfo.tempClusterId == formationHeader.GetTempClusterId()){
-                    if((ch != m_stableNeighborMap.end ()) && (m_currentInfo.clusterId == 0)){
-
-                        if(IsLowerThan(m_covVelocity, m_currentInfo.velocity)){
-                            m_currentInfo.degree = V2vClusterSap::CM;
-                            m_currentInfo.clusterId = formationHeader.GetClusterId();
-
-                            m_sendEvent.Cancel ();
-                            NS_LOG_DEBUG ("Cluster Head election event cancelled...Turning to CM");
-
-                            ChangeState (m_nodeState);
-
-                            m_clusterChanges ++;
-                            m_clusterChangesPerSec ++;
-
-                            if(m_chDurationBoolean){
-                                m_chDurationBoolean = false;
-                                m_stopChDuration = Simulator::Now ().GetTimeStep ();
-                                m_chDurationVector.push_back (m_stopChDuration - m_startChDuration);
-                            }
-
-                            if(m_cmDurationBoolean){
-                                m_cmDurationBoolean = false;
-                                m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-                                m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
-                            }
-
-                            if(m_cmDurationBoolean == false){
-                                m_startCmDuration = Simulator::Now ().GetTimeStep ();
-                                m_cmDurationBoolean = true;
-                            }
-                        }
-                    }
+
+                if(m_cmDurationBoolean){
+                    m_cmDurationBoolean = false;
+                    m_stopCmDuration = Simulator::Now ().GetTimeStep ();
+                    m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
                 }
-            }
-            else if(item.tid.GetName() == "ns3::V2vNovelUpdateHeader"){
-                V2vNovelUpdateHeader updateHeader;
-                p->RemoveHeader (updateHeader);
-
-                if(IsSameDirection (updateHeader.GetUpdateInfo ().velocity)){
-
-                    m_neighborMap[updateHeader.GetUpdateInfo().id] = updateHeader.GetUpdateInfo ();
-                    if(IsStable (updateHeader.GetUpdateInfo ().velocity)){
-                        m_stableNeighborMap[updateHeader.GetUpdateInfo().id] = updateHeader.GetUpdateInfo ();
-                    }
-                    if(m_currentInfo.id == updateHeader.GetUpdateInfo ().clusterId){
-                        m_clusterMap[updateHeader.GetUpdateInfo().id] = updateHeader.GetUpdateInfo ();
-
-                        //!< Store Address of cluster members
-                        m_membersAddress[updateHeader.GetUpdateInfo().id] = from;
-                    }
+
+                if(m_cmDurationBoolean == false){
+                    m_startCmDuration = Simulator::Now ().GetTimeStep ();
+                    m_cmDurationBoolean = true;
                 }
             }
-            else if(item.tid.GetName() == "ns3::V2vNovelMergeHeader"){
-                V2vNovelMergeHeader mergeHeader;
-                p->RemoveHeader (mergeHeader);
-
-                // Invalidate old CH
-                std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator oldCH = m_stableNeighborMap.find(mergeHeader.GetOldClusterId ());
-                if(oldCH != m_stableNeighborMap.end ()){
-                    oldCH->second.degree = V2vClusterSap::CM;
-                    oldCH->second.clusterId = mergeHeader.GetNewClusterId ();
+        }
+    }
+}
+
+void
+V2vNovelAlgorithmClient::HandleUpdate (Ptr<Packet> packet, const Address &from) {
+    NS_LOG_FUNCTION (this << packet << from);
+    V2vClusterSap::NovelNeighborInfo update;
+    if(m_compactHeaders){
+        V2vNovelCompactUpdateHeader updateHeader;
+        packet->RemoveHeader (updateHeader);
+        if(!m_codec.Decode (updateHeader.GetCompactUpdate (), update)){
+            return;
+        }
+    }
+    else{
+        V2vNovelUpdateHeader updateHeader;
+        packet->RemoveHeader (updateHeader);
+        update = updateHeader.GetUpdateInfo ();
+    }
+
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        m_slots.NotifyReceived (update.id, TimeStep (update.ts));
+    }
+
+    if(IsSameDirection (update.velocity)){
+
+        if(!m_neighborMap.Contains (update.id)){
+            m_neighborJoins ++;
+        }
+        m_neighborMap.Insert (update.id, update.position, update.velocity, update);
+        m_neighborExpiry.Schedule (update.id, TimeStep (update.ts) + m_neighborTimeout);
+        if(update.degree == V2vClusterSap::CH){
+            m_chNeighbors.insert (update.id);
+        }
+        else{
+            m_chNeighbors.erase (update.id);
+        }
+        if(IsStable (update.velocity)){
+            m_stableNeighborMap.Insert (update.id, update.position, update.velocity, update);
+            m_stableExpiry.Schedule (update.id, TimeStep (update.ts) + m_neighborTimeout);
+        }
+        if(m_currentInfo.id == update.clusterId){
+            m_clusterMap.Insert (update.id, update.position, update.velocity, update);
+
+            //!< Store Address of cluster members
+            m_membersAddress[update.id] = from;
+        }
+    }
+}
+
+void
+V2vNovelAlgorithmClient::HandleMerge (Ptr<Packet> packet, const Address &from) {
+    NS_LOG_FUNCTION (this << packet << from);
+    V2vNovelMergeHeader mergeHeader;
+    packet->RemoveHeader (mergeHeader);
+
+    // Invalidate old CH
+    V2vClusterSap::NovelNeighborInfo *oldCH = m_stableNeighborMap.Find (mergeHeader.GetOldClusterId ());
+    if(oldCH != 0){
+        oldCH->degree = V2vClusterSap::CM;
+        oldCH->clusterId = mergeHeader.GetNewClusterId ();
+    }
+
+    if(m_currentInfo.clusterId == mergeHeader.GetOldClusterId ()){
+
+        V2vClusterSap::NovelNeighborInfo *newCH = m_stableNeighborMap.Find (mergeHeader.GetNewClusterId ());
+        if(newCH != 0){
+            NS_LOG_UNCOND("New clusterhead is: " << mergeHeader.GetNewClusterId ());
+            m_currentInfo.degree = V2vClusterSap::CM;
+            UpdateRegistryRole ();
+            m_currentInfo.clusterId = mergeHeader.GetNewClusterId ();
+
+            m_clusterChanges ++;
+            m_clusterChangesPerSec ++;
+            V2vClusterRegistry::Get ()->NotifyClusterChange ();
+
+            if(m_cmDurationBoolean){
+                m_cmDurationBoolean = false;
+                m_stopCmDuration = Simulator::Now ().GetTimeStep ();
+                m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
+            }
+
+            if(m_cmDurationBoolean == false){
+                m_startCmDuration = Simulator::Now ().GetTimeStep ();
+                m_cmDurationBoolean = true;
+            }
+        }
+        else{
+            uint64_t suitableNeighbour = FindStableClusterHead();
+            V2vClusterSap::NovelNeighborInfo *nextCH = m_stableNeighborMap.Find (suitableNeighbour);
+            if(nextCH != 0){
+
+                //!< Join to another suitable neighbour
+                m_maintenanceCounter ++;
+                m_currentInfo.degree = V2vClusterSap::CM;
+                UpdateRegistryRole ();
+                m_currentInfo.clusterId = nextCH->clusterId;
+
+                m_clusterChanges ++;
+                m_clusterChangesPerSec ++;
+                V2vClusterRegistry::Get ()->NotifyClusterChange ();
+
+
+                if(m_cmDurationBoolean){
+                    m_cmDurationBoolean = false;
+                    m_stopCmDuration = Simulator::Now ().GetTimeStep ();
+                    m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
+                }
+
+                if(m_cmDurationBoolean == false){
+                    m_startCmDuration = Simulator::Now ().GetTimeStep ();
+                    m_cmDurationBoolean = true;
                 }
+            }
+            else{
 
-                if(m_currentInfo.clusterId == mergeHeader.GetOldClusterId ()){
-
-                    std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator newCH = m_stableNeighborMap.find(mergeHeader.GetNewClusterId ());
-                    if(newCH != m_stableNeighborMap.end ()){
-                        NS_LOG_UNCOND("New clusterhead is: " << mergeHeader.GetNewClusterId ());
-                        m_currentInfo.degree = V2vClusterSap::CM;
-                        m_currentInfo.clusterId = mergeHeader.GetNewClusterId ();
-
-                        m_clusterChanges ++;
-                        m_clusterChangesPerSec ++;
-
-                        if(m_cmDurationBoolean){
-                            m_cmDurationBoolean = false;
-                            m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-                            m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
-                        }
-
-                        if(m_cmDurationBoolean == false){
-                            m_startCmDuration = Simulator::Now ().GetTimeStep ();
-                            m_cmDurationBoolean = true;
-                        }
-                    }
-                    else{
-                        uint64_t suitableNeighbour = FindStableClusterHead();
-                        std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator nextCH = m_stableNeighborMap.find(suitableNeighbour);
-                        if(nextCH != m_stableNeighborMap.end ()){
-
-                            //!< Join to another suitable neighbour
-                            m_maintenanceCounter ++;
-                            m_currentInfo.degree = V2vClusterSap::CM;
-                            m_currentInfo.clusterId = nextCH->second.clusterId;
-
-                            m_clusterChanges ++;
-                            m_clusterChangesPerSec ++;
-
-
-                            if(m_cmDurationBoolean){
-                                m_cmDurationBoolean = false;
-                                m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-                                m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
-                            }
-
-                            if(m_cmDurationBoolean == false){
-                                m_startCmDuration = Simulator::Now ().GetTimeStep ();
-                                m_cmDurationBoolean = true;
-                            }
-                        }
-                        else{
-
-                            //!< Leave the cluster
-                            m_maintenanceCounter ++;
-                            m_currentInfo.clusterId = 0;
-                            m_currentInfo.degree = V2vClusterSap::STANDALONE;
-
-                            if(m_cmDurationBoolean){
-                                m_cmDurationBoolean = false;
-                                m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-                                m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
-                            }
-
-                            NS_LOG_DEBUG ("Cannot follow merge...Go to STANDALONE state: " << m_currentInfo.id);
-                        }
-                    }
+                //!< Leave the cluster
+                m_maintenanceCounter ++;
+                m_currentInfo.clusterId = 0;
+                m_currentInfo.degree = V2vClusterSap::STANDALONE;
+                UpdateRegistryRole ();
+
+                if(m_cmDurationBoolean){
+                    m_cmDurationBoolean = false;
+                    m_stopCmDuration = Simulator::Now ().GetTimeStep ();
+                    m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
                 }
+
+                NS_LOG_DEBUG ("Cannot follow merge...Go to STANDALONE state: " << m_currentInfo.id);
             }
-            m_rxTrace(p, from);
         }
-        m_receivedCounter ++;
     }
 }
 
@@ -667,24 +1001,21 @@ V2vNovelAlgorithmClient::Send (void) {
     switch (m_nodeState) {
     case V2vClusterSap::UNDEFINED:{
 
-        V2vNovelUpdateHeader updateHeader;
-        updateHeader.SetUpdateInfo(m_currentInfo);
-
-        Ptr<Packet> packet = Create<Packet>(0);
-        packet->AddHeader(updateHeader);
+        Ptr<Packet> packet = CreateUpdatePacket ();
         m_txTrace(packet);
-        m_socket->Send(packet);
+        SendControl (m_socket, packet);
         ++ m_sentCounter;
         ++ m_formationCounter;
 
         m_numberOfMessages ++;
         m_numberOfMessagesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
-        NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends Update Message at : " << updateHeader.GetUpdateInfo ().ts);
+        NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends Update Message at : " << m_currentInfo.ts);
 
         ChangeState (m_nodeState);
-        ScheduleTransmit (Seconds(m_maxUes*m_minimumTdmaSlot));
-        ScheduleMaintenance(Seconds(m_maxUes*m_minimumTdmaSlot*10));
+        ScheduleTransmit (Seconds(GetTdmaFrameSlots ()*m_minimumTdmaSlot));
+        ScheduleMaintenance(Seconds(GetTdmaFrameSlots ()*m_minimumTdmaSlot*10));
 
         break;
     }
@@ -696,10 +1027,10 @@ V2vNovelAlgorithmClient::Send (void) {
 
         if(IsSlowestVehicle()){
             ChangeState (m_nodeState);
-            ScheduleTransmit (Seconds(m_maxUes*m_minimumTdmaSlot));
+            ScheduleTransmit (Seconds(GetTdmaFrameSlots ()*m_minimumTdmaSlot));
         }
         else{
-            Simulator::Schedule (m_interval, &V2vNovelAlgorithmClient::Check, this);
+            m_checkEvent = Simulator::Schedule (m_interval, &V2vNovelAlgorithmClient::Check, this);
             m_formationDelayBoolean = true;
         }
 
@@ -714,13 +1045,15 @@ V2vNovelAlgorithmClient::Send (void) {
 
         Ptr<Packet> packet = Create<Packet>(0);
         packet->AddHeader(covHeader);
+        packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::NOVEL_COV_MESSAGE));
         m_txTrace(packet);
-        m_socket->Send(packet);
+        SendControl (m_socket, packet);
         ++ m_sentCounter;
         ++ m_formationCounter;
 
         m_numberOfMessages ++;
         m_numberOfMessagesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
         NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends COV Message at : " << covHeader.GetTs());
         ChangeState (m_nodeState);
@@ -735,6 +1068,7 @@ V2vNovelAlgorithmClient::Send (void) {
     case V2vClusterSap::FORMATION:{
 
         m_currentInfo.degree = V2vClusterSap::CH;
+        UpdateRegistryRole ();
         m_currentInfo.clusterId = m_currentInfo.id;
 
         V2vNovelFormationHeader formationHeader;
@@ -743,13 +1077,15 @@ V2vNovelAlgorithmClient::Send (void) {
 
         Ptr<Packet> packet = Create<Packet>(0);
         packet->AddHeader(formationHeader);
+        packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::NOVEL_FORMATION_MESSAGE));
         m_txTrace(packet);
-        m_socket->Send(packet);
+        SendControl (m_socket, packet);
         ++ m_sentCounter;
         ++ m_formationCounter;
 
         m_numberOfMessages ++;
         m_numberOfMessagesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
         NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Sends Cluster Formation Message at : " << formationHeader.GetTs());
 
@@ -758,19 +1094,19 @@ V2vNovelAlgorithmClient::Send (void) {
 
         m_stopFormationDelay = Simulator::Now ().GetTimeStep ();
         m_formationDelayBoolean = false;
-        m_formationDelayVector.push_back (m_stopFormationDelay - m_startFormationDelay);
+        m_formationDelay.Add (TimeStep (m_stopFormationDelay - m_startFormationDelay).GetSeconds ());
 
 
         if(m_chDurationBoolean){
             m_chDurationBoolean = false;
             m_stopChDuration = Simulator::Now ().GetTimeStep ();
-            m_chDurationVector.push_back (m_stopChDuration - m_startChDuration);
+            m_chDuration.Add (TimeStep (m_stopChDuration - m_startChDuration).GetSeconds ());
         }
 
         if(m_cmDurationBoolean){
             m_cmDurationBoolean = false;
             m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-            m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
+            m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
         }
 
         if(m_chDurationBoolean == false){
@@ -780,6 +1116,7 @@ V2vNovelAlgorithmClient::Send (void) {
 
         m_clusterChanges ++;
         m_clusterChangesPerSec ++;
+        V2vClusterRegistry::Get ()->NotifyClusterChange ();
 
         break;
     }
@@ -788,6 +1125,27 @@ V2vNovelAlgorithmClient::Send (void) {
     }
 }
 
+Ptr<Packet>
+V2vNovelAlgorithmClient::CreateUpdatePacket (void){
+
+    Ptr<Packet> packet = Create<Packet>(0);
+    V2vClusterTypeHeader typeHeader (V2vClusterSap::NOVEL_UPDATE_MESSAGE);
+    if(m_compactHeaders){
+        V2vNovelCompactUpdateHeader updateHeader;
+        updateHeader.SetCompactUpdate (m_codec.Encode (m_currentInfo));
+        packet->AddHeader(updateHeader);
+        typeHeader.SetCompact (true);
+    }
+    else{
+        V2vNovelUpdateHeader updateHeader;
+        updateHeader.SetUpdateInfo(m_currentInfo);
+        packet->AddHeader(updateHeader);
+    }
+    packet->AddHeader (typeHeader);
+    m_updateSize.Add (packet->GetSize ());
+    return packet;
+}
+
 void
 V2vNovelAlgorithmClient::ScheduleUpdate (Time dt)
 {
@@ -799,19 +1157,117 @@ void
 V2vNovelAlgorithmClient::Update(){
 
     CreateUpdateMessage ();
-    V2vNovelUpdateHeader updateHeader;
-    updateHeader.SetUpdateInfo(m_currentInfo);
-
-    Ptr<Packet> packet = Create<Packet>(0);
-    packet->AddHeader(updateHeader);
+    Ptr<Packet> packet = CreateUpdatePacket ();
     m_txTrace(packet);
-    m_socket->Send(packet);
+    SendControl (m_socket, packet);
     ++ m_sentCounter;
 
     m_numberOfMessages ++;
     m_numberOfMessagesPerSec ++;
+    V2vClusterRegistry::Get ()->NotifyMessageSent ();
+
+    if(m_slotScheme == V2vSlotAllocator::HASHED){
+        m_slots.NotifySent (Simulator::Now ());
+    }
+    ScheduleUpdate (NextUpdateInterval () + m_slots.TakeShift ());
+}
+
+Time
+V2vNovelAlgorithmClient::NextUpdateInterval (void){
+
+    Time window = Simulator::Now () - m_windowStart;
+    double busyRatio = 0.0;
+    if(window.IsStrictlyPositive ()){
+        busyRatio = std::min (1.0, m_busyTime.GetSeconds () / window.GetSeconds ());
+    }
+
+    Time interval = m_interval;
+    if(m_adaptiveUpdate && window.IsStrictlyPositive ()){
+
+        //!< Neighbor joins and leaves per neighbor and second
+        uint32_t neighbors = std::max<uint32_t> (1, m_neighborMap.GetSize ());
+        double churn = (m_neighborJoins + m_neighborLeaves) / (neighbors * window.GetSeconds ());
+
+        //!< Mean squared velocity of the neighbors relative to the node
+        double variance = 0.0;
+        for(V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::ConstIterator it = m_neighborMap.Begin(); it != m_neighborMap.End(); ++it) {
+            Vector v = it->value.velocity;
+            v.x -= m_currentInfo.velocity.x;
+            v.y -= m_currentInfo.velocity.y;
+            v.z -= m_currentInfo.velocity.z;
+            variance += v.x*v.x + v.y*v.y + v.z*v.z;
+        }
+        if(m_neighborMap.GetSize () > 0){
+            variance /= m_neighborMap.GetSize ();
+        }
+        interval = CalculateUpdateInterval (churn, variance, busyRatio);
 
-    ScheduleUpdate (m_interval);
+        NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " churn:" << churn << " variance:" << variance
+                      << " busy:" << busyRatio << " next update in:" << interval.GetSeconds ());
+    }
+
+    m_updateIntervals.Add (interval.GetSeconds ());
+    if(m_phyConnected){
+        m_channelBusy.Add (busyRatio);
+    }
+    m_neighborJoins = 0;
+    m_neighborLeaves = 0;
+    m_busyTime = Seconds (0);
+    m_windowStart = Simulator::Now ();
+    return interval;
+}
+
+Time
+V2vNovelAlgorithmClient::CalculateUpdateInterval (double churn, double variance, double busyRatio) const {
+
+    double dynamics = 1.0;
+    if(m_churnReference > 0){
+        dynamics += churn / m_churnReference;
+    }
+    if(m_velocityVarianceReference > 0){
+        dynamics += variance / m_velocityVarianceReference;
+    }
+    double seconds = m_minUpdateInterval.GetSeconds ()
+            + (m_maxUpdateInterval.GetSeconds () - m_minUpdateInterval.GetSeconds ()) / dynamics;
+    if(m_targetBusyRatio > 0 && busyRatio > m_targetBusyRatio){
+        seconds *= busyRatio / m_targetBusyRatio;
+    }
+
+    //!< Whole TDMA frames, so that the node keeps its slot offset in the frame
+    int64_t frame = m_interval.GetTimeStep ();
+    int64_t minFrames = (m_minUpdateInterval.GetTimeStep () + frame - 1) / frame;
+    int64_t maxFrames = m_maxUpdateInterval.GetTimeStep () / frame;
+    int64_t frames = (int64_t) std::floor (seconds / m_interval.GetSeconds () + 0.5);
+    frames = std::min (std::max (frames, minFrames), maxFrames);
+    return TimeStep (frames * frame);
+}
+
+void
+V2vNovelAlgorithmClient::ConnectPhyState (void){
+
+    if(m_phyConnected){
+        return;
+    }
+    for(uint32_t i = 0; i < GetNode ()->GetNDevices (); ++i){
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (GetNode ()->GetDevice (i));
+        if(device == 0 || device->GetPhy () == 0){
+            continue;
+        }
+        PointerValue state;
+        if(device->GetPhy ()->GetAttributeFailSafe ("State", state) && state.Get<WifiPhyStateHelper> () != 0){
+            state.Get<WifiPhyStateHelper> ()->TraceConnectWithoutContext ("State",
+                    MakeCallback (&V2vNovelAlgorithmClient::PhyStateChanged, this));
+            m_phyConnected = true;
+        }
+    }
+}
+
+void
+V2vNovelAlgorithmClient::PhyStateChanged (Time start, Time duration, WifiPhy::State state){
+
+    if(state == WifiPhy::TX || state == WifiPhy::RX || state == WifiPhy::CCA_BUSY){
+        m_busyTime += duration;
+    }
 }
 
 void
@@ -820,127 +1276,140 @@ V2vNovelAlgorithmClient::ScheduleMaintenance(Time dt){
     m_maintenanceEvent = Simulator::Schedule(dt, &V2vNovelAlgorithmClient::MaintenanceTasks, this);
 }
 
+void
+V2vNovelAlgorithmClient::CollectExpired (V2vTimerWheel &expiry, const V2vNeighborTable<V2vClusterSap::NovelNeighborInfo> &table){
+
+    m_expired.clear ();
+    expiry.Advance (TimeStep (m_currentInfo.ts), m_expired);
+    for(uint32_t i = 0; i < m_expired.size ();){
+        const V2vClusterSap::NovelNeighborInfo *value = table.Find (m_expired[i]);
+        if(TimeStep (m_currentInfo.ts).GetSeconds () - TimeStep (value->ts).GetSeconds () > m_neighborTimeout.GetSeconds ()){
+            ++i;
+        }
+        else{
+            //!< Exactly m_neighborTimeout old, expires at the next maintenance
+            expiry.Schedule (m_expired[i], TimeStep (m_currentInfo.ts + 1));
+            m_expired[i] = m_expired.back ();
+            m_expired.pop_back ();
+        }
+    }
+    table.SortForErase (m_expired);
+}
+
 void
 V2vNovelAlgorithmClient::MaintenanceTasks (void){
 
     NS_LOG_DEBUG("Maintenance tasks");
 
     if(m_currentInfo.degree == V2vClusterSap::CH){
-        m_clusterMembers.push_back (m_clusterMap.size ()+1);
+        m_clusterMembers.Add (m_clusterMap.GetSize ()+1);
     }
 
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator it = m_stableNeighborMap.begin(); it != m_stableNeighborMap.end();){
-        V2vClusterSap::NovelNeighborInfo value = it->second;
-        if(TimeStep (m_currentInfo.ts).GetSeconds () - TimeStep (value.ts).GetSeconds () > 1.5){
-            m_stableNeighborMap.erase (it++);
-        }
-        else{
-            ++it;
-        }
-    }
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator it = m_stableNeighborMap.begin(); it != m_stableNeighborMap.end();){
-        V2vClusterSap::NovelNeighborInfo value = it->second;
-        if(TimeStep (m_currentInfo.ts).GetSeconds () - TimeStep (value.ts).GetSeconds () > 1.5){
-            m_stableNeighborMap.erase (it++);
-        }
-        else{
-            ++it;
-        }
+    CollectExpired (m_stableExpiry, m_stableNeighborMap);
+    for(uint32_t i = 0; i < m_expired.size (); ++i){
+        m_stableNeighborMap.Erase (m_expired[i]);
     }
 
     //!< Update Neighbor's List according to Timestamps
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end();){
+    CollectExpired (m_neighborExpiry, m_neighborMap);
+    for(uint32_t i = 0; i < m_expired.size (); ++i){
+
+        uint64_t key = m_expired[i];
+        V2vClusterSap::NovelNeighborInfo value = *m_neighborMap.Find (key);
+        NS_LOG_DEBUG ("At: " << Simulator::Now().GetSeconds() << " Node::" <<
+                      m_currentInfo.id << " - Removing Node:" << value.id<< " from m_neighborMap with last sent time:"
+                      << TimeStep (value.ts).GetSeconds ());
 
-        uint64_t key = it->first;
-        V2vClusterSap::NovelNeighborInfo value = it->second;
-        if(TimeStep (m_currentInfo.ts).GetSeconds () - TimeStep (value.ts).GetSeconds () > 1.5){
+        if(m_stableNeighborMap.Contains (key)){
             NS_LOG_DEBUG ("At: " << Simulator::Now().GetSeconds() << " Node::" <<
-                          m_currentInfo.id << " - Removing Node:" << value.id<< " from m_neighborMap with last sent time:"
+                          m_currentInfo.id << " - Removing Node:" << value.id<< " from m_stableNeighborMap with last sent time:"
                           << TimeStep (value.ts).GetSeconds ());
+            m_stableNeighborMap.Erase (key);
+            m_stableExpiry.Cancel (key);
+        }
 
-            if(m_stableNeighborMap.find(key) != m_stableNeighborMap.end()){
-                NS_LOG_DEBUG ("At: " << Simulator::Now().GetSeconds() << " Node::" <<
-                              m_currentInfo.id << " - Removing Node:" << value.id<< " from m_stableNeighborMap with last sent time:"
-                              << TimeStep (value.ts).GetSeconds ());
-                m_stableNeighborMap.erase(key);
-            }
-
-            if(m_clusterMap.find(key) != m_clusterMap.end()){
-                NS_LOG_DEBUG ("At: " << Simulator::Now().GetSeconds() << " Node::" <<
-                              m_currentInfo.id << " - Removing Node:" << value.id<< " from m_clusterMap with last sent time:"
-                              << TimeStep (value.ts).GetSeconds ());
-                m_clusterMap.erase(key);
-            }
-            m_neighborMap.erase(it++);
+        if(m_clusterMap.Contains (key)){
+            NS_LOG_DEBUG ("At: " << Simulator::Now().GetSeconds() << " Node::" <<
+                          m_currentInfo.id << " - Removing Node:" << value.id<< " from m_clusterMap with last sent time:"
+                          << TimeStep (value.ts).GetSeconds ());
+            m_clusterMap.Erase (key);
+        }
+        m_neighborMap.Erase (key);
+        m_chNeighbors.erase (key);
+        m_neighborLeaves ++;
 
-            //!< Leave Cluster Case
-            if(m_currentInfo.clusterId == value.id){
+        //!< Leave Cluster Case
+        if(m_currentInfo.clusterId == value.id){
 
-                NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " lost ClusterHead " << value.id);
+            NS_LOG_DEBUG ("Node:" << m_currentInfo.id << " lost ClusterHead " << value.id);
 
-                //!< Leave the cluster
-                m_currentInfo.clusterId = 0;
-                m_currentInfo.degree = V2vClusterSap::STANDALONE;
+            //!< Leave the cluster
+            m_currentInfo.clusterId = 0;
+            m_currentInfo.degree = V2vClusterSap::STANDALONE;
+            UpdateRegistryRole ();
 
-                NS_LOG_DEBUG ("Go to STANDALONE state: " << m_currentInfo.id);
-            }
+            NS_LOG_DEBUG ("Go to STANDALONE state: " << m_currentInfo.id);
         }
-        else{
+    }
+
+    //!< Only a cluster head looks for a cluster to merge with, among the
+    //!< neighbors whose last update announced a CH, in id order
+    for(std::set<uint64_t>::const_iterator it = m_chNeighbors.begin();
+            it != m_chNeighbors.end() && m_currentInfo.degree == V2vClusterSap::CH; ++it){
+
+        //!< Merge Clusters Case
+        NS_LOG_UNCOND("Check possible merge between " << m_currentInfo.id << " and " << *it);
+        V2vClusterSap::NovelNeighborInfo *chStable = m_stableNeighborMap.Find (*it);
+        if(chStable != 0){
+
+            V2vClusterSap::NovelNeighborInfo neighbourCH = *chStable;
+            if(m_currentInfo.chMembers < neighbourCH.chMembers){
+                NS_LOG_UNCOND("Merge Clusters => m_current.id:" << m_currentInfo.id << ", members:" << m_currentInfo.chMembers
+                              << " -- neighbourCH.id:" << neighbourCH.id << ", members:" << neighbourCH.chMembers);
+
+                RemoveMergeSocket ();
+                CreateMergeSocket();
+                MergeSend (neighbourCH.id);
+
+                m_currentInfo.degree = V2vClusterSap::CM;
+                UpdateRegistryRole ();
+                m_currentInfo.clusterId = neighbourCH.clusterId;
+                m_clusterMap.Clear ();
+                m_maintenanceCounter ++;
+
+                m_clusterChanges ++;
+                m_clusterChangesPerSec ++;
+                V2vClusterRegistry::Get ()->NotifyClusterChange ();
+
+                if(m_chDurationBoolean){
+                    m_chDurationBoolean = false;
+                    m_stopChDuration = Simulator::Now ().GetTimeStep ();
+                    m_chDuration.Add (TimeStep (m_stopChDuration - m_startChDuration).GetSeconds ());
+                }
 
-            //!< Merge Clusters Case
-            if ((m_currentInfo.degree == V2vClusterSap::CH) && (value.degree == V2vClusterSap::CH)){
-                NS_LOG_UNCOND("Check possible merge between " << m_currentInfo.id << " and " << value.id);
-                std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator chStable = m_stableNeighborMap.find(value.id);
-                if(chStable != m_stableNeighborMap.end ()){
-
-                    V2vClusterSap::NovelNeighborInfo neighbourCH = chStable->second;
-                    if(m_currentInfo.chMembers < neighbourCH.chMembers){
-                        NS_LOG_UNCOND("Merge Clusters => m_current.id:" << m_currentInfo.id << ", members:" << m_currentInfo.chMembers
-                                      << " -- neighbourCH.id:" << neighbourCH.id << ", members:" << neighbourCH.chMembers);
-
-                        RemoveMergeSocket ();
-                        CreateMergeSocket();
-                        MergeSend (neighbourCH.id);
-
-                        m_currentInfo.degree = V2vClusterSap::CM;
-                        m_currentInfo.clusterId = neighbourCH.clusterId;
-                        m_clusterMap.clear ();
-                        m_maintenanceCounter ++;
-
-                        m_clusterChanges ++;
-                        m_clusterChangesPerSec ++;
-
-                        if(m_chDurationBoolean){
-                            m_chDurationBoolean = false;
-                            m_stopChDuration = Simulator::Now ().GetTimeStep ();
-                            m_chDurationVector.push_back (m_stopChDuration - m_startChDuration);
-                        }
-
-                        if(m_cmDurationBoolean == false){
-                            m_startCmDuration = Simulator::Now ().GetTimeStep ();
-                            m_cmDurationBoolean = true;
-                        }
-                    }
+                if(m_cmDurationBoolean == false){
+                    m_startCmDuration = Simulator::Now ().GetTimeStep ();
+                    m_cmDurationBoolean = true;
                 }
             }
-            ++it;
         }
     }
 
     if((m_currentInfo.degree == V2vClusterSap::STANDALONE) && (m_nodeState == V2vClusterSap::UPDATE)){
         uint64_t suitableNeighbour = FindStableClusterHead();
-        std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator nextCH = m_stableNeighborMap.find(suitableNeighbour);
-        if(nextCH != m_stableNeighborMap.end ()){
+        V2vClusterSap::NovelNeighborInfo *nextCH = m_stableNeighborMap.Find (suitableNeighbour);
+        if(nextCH != 0){
 
             //!< Join to another suitable neighbour
             m_currentInfo.degree = V2vClusterSap::CM;
-            m_currentInfo.clusterId = nextCH->second.clusterId;
+            UpdateRegistryRole ();
+            m_currentInfo.clusterId = nextCH->clusterId;
             m_maintenanceCounter ++;
 
             if(m_cmDurationBoolean){
                 m_cmDurationBoolean = false;
                 m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-                m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
+                m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
             }
         }
         else{
@@ -951,14 +1420,15 @@ V2vNovelAlgorithmClient::MaintenanceTasks (void){
             m_currentInfo.tempClusterId = 0;
             m_nodeState = V2vClusterSap::INITIAL;
             m_currentInfo.degree = V2vClusterSap::STANDALONE;
+            UpdateRegistryRole ();
 
             if(m_cmDurationBoolean){
                 m_cmDurationBoolean = false;
                 m_stopCmDuration = Simulator::Now ().GetTimeStep ();
-                m_cmDurationVector.push_back (m_stopCmDuration - m_startCmDuration);
+                m_cmDuration.Add (TimeStep (m_stopCmDuration - m_startCmDuration).GetSeconds ());
             }
 
-            double timeSlot = 1.0 - (Simulator::Now ().GetSeconds ()- (int)Simulator::Now ().GetSeconds ()) + (m_maxUes*m_minimumTdmaSlot) + m_vehicleTdmaSlot;
+            double timeSlot = 1.0 - (Simulator::Now ().GetSeconds ()- (int)Simulator::Now ().GetSeconds ()) + (GetTdmaFrameSlots ()*m_minimumTdmaSlot) + GetTdmaOffset ();
             ScheduleTransmit (Seconds(timeSlot));
 
             NS_LOG_DEBUG ("Go to STANDALONE state: " << m_currentInfo.id);
@@ -999,6 +1469,9 @@ V2vNovelAlgorithmClient::CreateMergeSocket (void){
     m_mergeSocket->Connect(memberAddress);
     m_mergeSocket->SetAllowBroadcast(true);
     m_mergeSocket->ShutdownRecv();
+    if(m_scheduler != 0){
+        m_scheduler->BindToChannel (m_mergeSocket, V2vChannelScheduler::CCH);
+    }
 }
 
 void
@@ -1021,10 +1494,12 @@ V2vNovelAlgorithmClient::MergeSend (uint64_t newCHId){
 
     Ptr<Packet> packet = Create<Packet>(0);
     packet->AddHeader(mergeHeader);
-    m_mergeSocket->Send(packet);
+    packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::NOVEL_MERGE_MESSAGE));
+    SendControl (m_mergeSocket, packet);
 
     m_numberOfMessages ++;
     m_numberOfMessagesPerSec ++;
+    V2vClusterRegistry::Get ()->NotifyMessageSent ();
 
     NS_LOG_DEBUG("Node:" << m_currentInfo.id << " Send Merge message to members");
 }
@@ -1036,10 +1511,13 @@ void V2vNovelAlgorithmClient::CreateUpdateMessage (void){
     //!< Acquire current mobility stats
     m_currentInfo.ts = Simulator::Now().GetTimeStep();
     m_currentInfo.id = this->GetNode ()->GetId ();
-    m_currentInfo.chMembers = m_clusterMap.size ();
+    m_currentInfo.chMembers = m_clusterMap.GetSize ();
     m_currentInfo.position = m_mobilityModel->GetPosition();
     m_currentInfo.velocity = m_mobilityModel->GetVelocity();
     m_currentInfo.direction = Vector(0.0, 0.0, 0.0);//m_currentInfo.direction = m_mobilityModel->GetDirection();
+    if(m_compactHeaders){
+        V2vNovelUpdateCodec::Round (m_currentInfo);
+    }
 }
 
 void
@@ -1072,17 +1550,17 @@ template <typename T> int V2vNovelAlgorithmClient::sgn(T val) {
 bool
 V2vNovelAlgorithmClient::IsStable(Vector otherVelocity){
 
-    uint32_t size = m_neighborMap.size ();
-    if(m_neighborMap.size () == 0){
+    uint32_t size = m_neighborMap.GetSize ();
+    if(m_neighborMap.GetSize () == 0){
         size = 1;
     }
 
     Vector v;
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it) {
-        uint64_t key = it->first;
+    for(V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::ConstIterator it = m_neighborMap.Begin(); it != m_neighborMap.End(); ++it) {
+        uint64_t key = it->id;
         NS_ASSERT(key != m_currentInfo.id);
 
-        V2vClusterSap::NovelNeighborInfo value = it->second;
+        const V2vClusterSap::NovelNeighborInfo &value = it->value;
         v.x += value.velocity.x;
         v.y += value.velocity.y;
         v.z += value.velocity.z;
@@ -1093,11 +1571,11 @@ V2vNovelAlgorithmClient::IsStable(Vector otherVelocity){
 
     //!< Find standard deviation of velocity
     Vector vs;
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it) {
-        uint64_t key = it->first;
+    for(V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::ConstIterator it = m_neighborMap.Begin(); it != m_neighborMap.End(); ++it) {
+        uint64_t key = it->id;
         NS_ASSERT(key != m_currentInfo.id);
 
-        V2vClusterSap::NovelNeighborInfo value = it->second;
+        const V2vClusterSap::NovelNeighborInfo &value = it->value;
         vs.x += pow((value.velocity.x - v.x), 2.0);
         vs.y += pow((value.velocity.y - v.y), 2.0);
         vs.z += pow((value.velocity.z - v.z), 2.0);
@@ -1136,10 +1614,21 @@ V2vNovelAlgorithmClient::IsStable(Vector otherVelocity){
     return true;
 }
 
+const std::vector<uint32_t>&
+V2vNovelAlgorithmClient::CollectStableNeighbors (void){
+    //!< Visit the neighbors in the id order of the former std::map
+    if(m_neighborRange > 0){
+        m_stableNeighborMap.FindInRangeById (m_currentInfo.position, m_neighborRange, m_stableScan);
+        return m_stableScan;
+    }
+    return m_stableNeighborMap.GetIdOrder ();
+}
+
 bool
 V2vNovelAlgorithmClient::IsSlowestVehicle (void){
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator it = m_stableNeighborMap.begin(); it != m_stableNeighborMap.end(); ++it) {
-        V2vClusterSap::NovelNeighborInfo value = it->second;
+    const std::vector<uint32_t> &scan = CollectStableNeighbors ();
+    for(uint32_t i = 0; i < scan.size (); ++i) {
+        const V2vClusterSap::NovelNeighborInfo &value = m_stableNeighborMap.GetEntry (scan[i]).value;
         if(value.tempClusterId == 0){
             if(IsLowerThan(value.velocity, m_currentInfo.velocity)){
                 return false;
@@ -1161,19 +1650,20 @@ V2vNovelAlgorithmClient::IsLowerThan(Vector v1, Vector v2){
 double
 V2vNovelAlgorithmClient::SuitabilityCheck (void){
 
-    double size = m_stableNeighborMap.size();
+    const std::vector<uint32_t> &scan = CollectStableNeighbors ();
+    double size = scan.size ();
 
     //!< If no neighbours found, return standard TDMA vehicle's window
-    if(m_stableNeighborMap.size() == 0){
+    if(scan.empty ()){
         size = 1;
     }
 
     Vector p,v;
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator it = m_stableNeighborMap.begin(); it != m_stableNeighborMap.end(); ++it) {
-        uint64_t key = it->first;
-        NS_ASSERT(key != m_currentInfo.id);
+    for(uint32_t i = 0; i < scan.size (); ++i) {
+        const V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::Entry &entry = m_stableNeighborMap.GetEntry (scan[i]);
+        NS_ASSERT(entry.id != m_currentInfo.id);
 
-        V2vClusterSap::NovelNeighborInfo value = it->second;
+        const V2vClusterSap::NovelNeighborInfo &value = entry.value;
         p.x += value.position.x;
         p.y += value.position.y;
         p.z += value.position.z;
@@ -1195,11 +1685,11 @@ V2vNovelAlgorithmClient::SuitabilityCheck (void){
 
     //!< Find standard deviation of position and velocity
     Vector ps,vs;
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator it = m_stableNeighborMap.begin(); it != m_stableNeighborMap.end(); ++it) {
-        uint64_t key = it->first;
-        NS_ASSERT(key != m_currentInfo.id);
+    for(uint32_t i = 0; i < scan.size (); ++i) {
+        const V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::Entry &entry = m_stableNeighborMap.GetEntry (scan[i]);
+        NS_ASSERT(entry.id != m_currentInfo.id);
 
-        V2vClusterSap::NovelNeighborInfo value = it->second;
+        const V2vClusterSap::NovelNeighborInfo &value = entry.value;
         ps.x += pow((value.position.x - p.x), 2.0);
         ps.y += pow((value.position.y - p.y), 2.0);
         ps.z += pow((value.position.z - p.z), 2.0);
@@ -1279,8 +1769,10 @@ V2vNovelAlgorithmClient::FindStableClusterHead (void){
     double r = 80;                          //!< transmition range
     double rt = 0.0;                        //!< Suitability metric for CH  selection
     double boundary = 0.0;
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator itSearch = m_stableNeighborMap.begin(); itSearch != m_stableNeighborMap.end(); ++itSearch){
-        V2vClusterSap::NovelNeighborInfo node = itSearch->second;
+    const std::vector<uint32_t> &scan = CollectStableNeighbors ();
+    for(uint32_t i = 0; i < scan.size (); ++i){
+        const V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::Entry &entry = m_stableNeighborMap.GetEntry (scan[i]);
+        const V2vClusterSap::NovelNeighborInfo &node = entry.value;
         if(node.degree == V2vClusterSap::CH){
             if( ((m_currentInfo.position.x < node.position.x) && (m_currentInfo.velocity.x > 0) && fabs(m_currentInfo.velocity.x) < fabs(node.velocity.x))
                     || ((m_currentInfo.position.x < node.position.x) && (m_currentInfo.velocity.x < 0) && fabs(m_currentInfo.velocity.x) > fabs(node.velocity.x)) ){
@@ -1304,8 +1796,9 @@ V2vNovelAlgorithmClient::FindStableClusterHead (void){
                 NS_LOG_DEBUG("Nodes increasingly approaching - RT:" << rt << "current Node:" << m_currentInfo.id << " - with node:" << node.id);
             }
 
+            //!< A tie keeps the lowest id
             if(rt > boundary){
-                id = itSearch->first;
+                id = entry.id;
                 boundary = rt;
             }
         }
@@ -1349,9 +1842,9 @@ V2vNovelAlgorithmClient::StatusReport (void){
         << " Last message sent:" << TimeStep (m_currentInfo.ts).GetSeconds ());
 
     NS_LOG_UNCOND("----------------------------  Neighbour List  ---------------------------------");
-    NS_LOG_UNCOND("m_neighborMap size:" << m_neighborMap.size ());
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator it = m_neighborMap.begin(); it != m_neighborMap.end(); ++it){
-        V2vClusterSap::NovelNeighborInfo node = it->second;
+    NS_LOG_UNCOND("m_neighborMap size:" << m_neighborMap.GetSize ());
+    for(V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::ConstIterator it = m_neighborMap.Begin(); it != m_neighborMap.End(); ++it){
+        const V2vClusterSap::NovelNeighborInfo &node = it->value;
         NS_LOG_UNCOND(" Id:" << node.id
                 << " ClusterId:" << node.clusterId
                 << " TempClusterId:" << node.tempClusterId
@@ -1363,9 +1856,9 @@ V2vNovelAlgorithmClient::StatusReport (void){
     }
 
     NS_LOG_UNCOND("----------------------------  Stable Neighbour List  ---------------------------------");
-    NS_LOG_UNCOND("m_stableNeighborMap size:" << m_stableNeighborMap.size ());
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator it = m_stableNeighborMap.begin(); it != m_stableNeighborMap.end(); ++it){
-        V2vClusterSap::NovelNeighborInfo node = it->second;
+    NS_LOG_UNCOND("m_stableNeighborMap size:" << m_stableNeighborMap.GetSize ());
+    for(V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::ConstIterator it = m_stableNeighborMap.Begin(); it != m_stableNeighborMap.End(); ++it){
+        const V2vClusterSap::NovelNeighborInfo &node = it->value;
         NS_LOG_UNCOND(" Id:" << node.id
                 << " ClusterId:" << node.clusterId
                 << " TempClusterId:" << node.tempClusterId
@@ -1377,9 +1870,9 @@ V2vNovelAlgorithmClient::StatusReport (void){
     }
 
     NS_LOG_UNCOND("----------------------------  Cluster List  ---------------------------------");
-    NS_LOG_UNCOND("m_clusterMap size:" << m_clusterMap.size ());
-    for(std::map<uint64_t, V2vClusterSap::NovelNeighborInfo>::iterator it = m_clusterMap.begin(); it != m_clusterMap.end(); ++it){
-        V2vClusterSap::NovelNeighborInfo node = it->second;
+    NS_LOG_UNCOND("m_clusterMap size:" << m_clusterMap.GetSize ());
+    for(V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::ConstIterator it = m_clusterMap.Begin(); it != m_clusterMap.End(); ++it){
+        const V2vClusterSap::NovelNeighborInfo &node = it->value;
         NS_LOG_UNCOND(" Id:" << node.id
                 << " ClusterId:" << node.clusterId
                 << " TempClusterId:" << node.tempClusterId
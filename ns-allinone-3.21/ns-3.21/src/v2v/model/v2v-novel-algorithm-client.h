@@ -22,15 +22,24 @@
 #define V2V_NOVEL_ALGORITHM_CLIENT_H_
 
 #include <map>
+#include <set>
 #include "ns3/ptr.h"
 #include "ns3/double.h"
 #include "ns3/address.h"
 #include "ns3/event-id.h"
 #include "ns3/application.h"
+#include "ns3/wifi-phy.h"
 #include "ns3/traced-callback.h"
 #include "ns3/mobility-module.h"
 #include "ns3/v2v-cluster-sap.h"
 #include "ns3/v2v-cluster-header.h"
+#include "ns3/v2v-neighbor-table.h"
+#include "ns3/v2v-timer-wheel.h"
+#include "ns3/v2v-statistics-accumulator.h"
+#include "ns3/v2v-cluster-snapshot.h"
+#include "ns3/v2v-slot-allocator.h"
+#include "ns3/v2v-channel-scheduler.h"
+#include "ns3/v2v-novel-update-codec.h"
 
 namespace ns3 {
 
@@ -90,6 +99,12 @@ public:
      */
     V2vClusterSap::NovelNodeDegree GetRole(void);
 
+    /**
+     * @brief GetClusterId
+     * @return the node id of the cluster head of the node, 0 when it has none
+     */
+    uint64_t GetClusterId(void);
+
     /**
      * @brief GetNumberOfMessagesPerSecond
      * @return
@@ -138,6 +153,94 @@ public:
      */
     double GetMaxCmDuration(void);
 
+    /**
+     * @brief GetFormationDelayStatistics
+     * @return the cluster formation delay samples [s], with percentiles
+     */
+    const V2vStatisticsAccumulator &GetFormationDelayStatistics(void) const;
+
+    /**
+     * @brief GetClusterMembersStatistics
+     * @return the cluster size samples, with percentiles
+     */
+    const V2vStatisticsAccumulator &GetClusterMembersStatistics(void) const;
+
+    /**
+     * @brief GetChDurationStatistics
+     * @return the cluster head duration samples [s], with percentiles
+     */
+    const V2vStatisticsAccumulator &GetChDurationStatistics(void) const;
+
+    /**
+     * @brief GetCmDurationStatistics
+     * @return the cluster member duration samples [s], with percentiles
+     */
+    const V2vStatisticsAccumulator &GetCmDurationStatistics(void) const;
+
+    /**
+     * @brief GetUpdateIntervalStatistics
+     * @return the intervals between the periodic update messages [s]
+     */
+    const V2vStatisticsAccumulator &GetUpdateIntervalStatistics(void) const;
+
+    /**
+     * @brief GetChannelBusyStatistics
+     * @return the fraction of each update interval the Wifi PHY was not
+     * idle, empty without a WifiNetDevice or AdaptiveUpdate
+     */
+    const V2vStatisticsAccumulator &GetChannelBusyStatistics(void) const;
+
+    /**
+     * @brief The update interval of the adaptive mode.
+     *
+     * Goes from MaxUpdateInterval in a quiet neighborhood down to
+     * MinUpdateInterval as the neighbor churn and the relative velocity
+     * variance grow, and is stretched again when the channel is busier
+     * than TargetBusyRatio. The result is rounded to a whole number of
+     * Interval TDMA frames within the bounds, so that the node keeps its
+     * VehicleTdmaSlot offset.
+     *
+     * @param churn neighbor joins and leaves per neighbor and second
+     * @param variance mean squared velocity of the neighbors relative to
+     * the node [m^2/s^2]
+     * @param busyRatio fraction of the time the Wifi PHY was not idle
+     * @return the interval until the next update message
+     */
+    Time CalculateUpdateInterval (double churn, double variance, double busyRatio) const;
+
+    /**
+     * @brief GetUpdateSizeStatistics
+     * @return the size of the sent update messages [bytes]
+     */
+    const V2vStatisticsAccumulator &GetUpdateSizeStatistics(void) const;
+
+    /**
+     * @brief GetUpdateCodec
+     * @return the codec of the compact update messages, with its key
+     * frame and delta counters
+     */
+    const V2vNovelUpdateCodec &GetUpdateCodec(void) const;
+
+    /**
+     * @brief GetSlotAllocator
+     * @return the slot reservation of the hashed TDMA scheme, with its
+     * collision and move counters
+     */
+    const V2vSlotAllocator &GetSlotAllocator(void) const;
+
+    /**
+     * @brief Write the clustering state of the client to a snapshot
+     * @param writer the snapshot record of the node
+     */
+    void SaveState (V2vSnapshotWriter &writer) const;
+
+    /**
+     * @brief Resume from a snapshot when the application starts, in place
+     * of a new training period
+     * @param record the record written by SaveState
+     */
+    void SetSnapshot (const std::string &record);
+
 protected:
     virtual void DoDispose (void);
 
@@ -146,9 +249,19 @@ private:
     virtual void StartApplication (void);    // Called at time specified by Start
     virtual void StopApplication (void);     // Called at time specified by Stop
 
+    /**
+     * \brief Report the current role to V2vClusterRegistry if it changed
+     */
+    void UpdateRegistryRole (void);
+
     void StartListeningLocal (void);	// Called from StartApplication()
     void StopListeningLocal (void);	// Called from StopApplication()
 
+    /**
+     * \brief Handler of a received message, selected by its V2vClusterTypeHeader
+     */
+    typedef void (V2vNovelAlgorithmClient::*MessageHandler) (Ptr<Packet> packet, const Address &from);
+
     /**
      * \brief Print sent/received packets statistics.
      */
@@ -161,6 +274,35 @@ private:
 	 * \param socket the receiving socket
 	 */
     void HandleRead (Ptr<Socket> socket);
+
+    /**
+     * \brief Handle a received V2vNovelCOVHeader
+     * \param packet the packet, without its V2vClusterTypeHeader
+     * \param from the sender address
+     */
+    void HandleCOV (Ptr<Packet> packet, const Address &from);
+
+    /**
+     * \brief Handle a received V2vNovelFormationHeader
+     * \param packet the packet, without its V2vClusterTypeHeader
+     * \param from the sender address
+     */
+    void HandleFormation (Ptr<Packet> packet, const Address &from);
+
+    /**
+     * \brief Handle a received V2vNovelUpdateHeader
+     * \param packet the packet, without its V2vClusterTypeHeader
+     * \param from the sender address
+     */
+    void HandleUpdate (Ptr<Packet> packet, const Address &from);
+
+    /**
+     * \brief Handle a received V2vNovelMergeHeader
+     * \param packet the packet, without its V2vClusterTypeHeader
+     * \param from the sender address
+     */
+    void HandleMerge (Ptr<Packet> packet, const Address &from);
+
 	/**
 	 * \brief Handle an incoming connection
 	 * \param socket the incoming connection socket
@@ -237,6 +379,12 @@ private:
      */
     bool IsStable(Vector otherVelocity);
 
+    /**
+     * @brief The stable neighbors within m_neighborRange (all of them if 0)
+     * @return their storage indexes in m_stableNeighborMap, in id order
+     */
+    const std::vector<uint32_t>& CollectStableNeighbors (void);
+
     /**
      * @brief IsSlowestVehicle
      * @return true if vehicle is the slowest in range, false otherwise
@@ -267,6 +415,14 @@ private:
      */
     void MaintenanceTasks (void);
 
+    /**
+     * @brief Fill m_expired with the entries of a table not updated for
+     * m_neighborTimeout, in the order a scan of the table would erase them
+     * @param expiry the expiry times of the table entries
+     * @param table the neighbor table
+     */
+    void CollectExpired (V2vTimerWheel &expiry, const V2vNeighborTable<V2vClusterSap::NovelNeighborInfo> &table);
+
     /**
      * @brief FindStableClusterHead
      * @return the ID of the most suitable stable CH in the area
@@ -278,6 +434,36 @@ private:
      */
     void Update(void);
 
+    /**
+     * @brief CreateUpdatePacket
+     * @return an update message of m_currentInfo, in the wire format
+     * selected by CompactHeaders
+     */
+    Ptr<Packet> CreateUpdatePacket (void);
+
+    /**
+     * @brief NextUpdateInterval
+     * @return the time until the next update message, m_interval unless
+     * AdaptiveUpdate is set
+     *
+     * Measures the inputs of CalculateUpdateInterval and closes their
+     * measurement window.
+     */
+    Time NextUpdateInterval (void);
+
+    /**
+     * @brief Connect PhyStateChanged to the Wifi PHYs of the node
+     */
+    void ConnectPhyState (void);
+
+    /**
+     * @brief Accumulate the time the PHY spends out of IDLE
+     * @param start the start of the state period
+     * @param duration the duration of the state period
+     * @param state the PHY state
+     */
+    void PhyStateChanged (Time start, Time duration, WifiPhy::State state);
+
     /**
      * @brief ScheduleUpdate
      * @param dt time before schedule again
@@ -290,6 +476,34 @@ private:
      */
     void ScheduleMaintenance(Time dt);
 
+    /**
+     * @brief Send a control message, on the CCH when the node has a
+     * V2vChannelScheduler
+     * @param socket the socket of the message
+     * @param packet the message
+     */
+    void SendControl (Ptr<Socket> socket, Ptr<Packet> packet);
+
+    /**
+     * @brief GetTdmaOffset
+     * @return the offset of the node in the TDMA frame [s], VehicleTdmaSlot
+     * or the offset of the hashed slot
+     */
+    double GetTdmaOffset (void) const;
+
+    /**
+     * @brief GetTdmaFrameSlots
+     * @return the number of slots of the TDMA frame, MaxUes or FrameSlots
+     */
+    uint32_t GetTdmaFrameSlots (void) const;
+
+    /**
+     * @brief Restore the state written by SaveState and schedule the
+     * pending events again
+     * @param reader the snapshot record of the node
+     */
+    void LoadState (V2vSnapshotReader &reader);
+
     /**
      * @brief CreateMergeSocket
      */
@@ -314,6 +528,9 @@ private:
 
     /* Create merge socket */
     Ptr<Socket> m_mergeSocket;              //!< merge socket
+    /* Message dispatch */
+    MessageHandler m_messageHandlers[V2vClusterSap::MESSAGE_TYPES];   //!< handlers indexed by message type
+
 
 	/* Receive Socket */
 	TypeId m_tidListening;          		//!< Protocol TypeId
@@ -331,23 +548,57 @@ private:
     EventId m_sendEvent;    				//!< Event id of pending "formation message" event
     EventId m_updateEvent;    				//!< Event id of pending "update" event
     EventId m_maintenanceEvent;    			//!< Event id of pending "maintenance" event
+    EventId m_checkEvent;                   //!< Event id of pending "check" event
 
     /* Channels Access Params */
     Time m_interval; 						//!< Packet inter-send time
     uint32_t m_maxUes;                      //!< maximun number of ues
     double m_minimumTdmaSlot;               //!< the minimum tdma slot
     double m_vehicleTdmaSlot;               //!< the timeslot for the node to schedule transmission
+    V2vSlotAllocator::Scheme m_slotScheme;  //!< fixed or hashed TDMA offsets
+    uint32_t m_frameSlots;                  //!< slots of a frame of the hashed scheme
+    V2vSlotAllocator m_slots;               //!< slot reservation of the hashed scheme
+    Ptr<V2vChannelScheduler> m_scheduler;   //!< channel access of the node, 0 for a single channel
     double m_clusterTimeMetric;             //!< normalization factor for suitability check function
     double m_trainingPeriod;
+    bool m_registered;                      //!< registered in V2vClusterRegistry
+    V2vClusterSap::NovelNodeDegree m_registeredRole; //!< role last reported to V2vClusterRegistry
+    std::string m_snapshot;                 //!< snapshot record to resume from
+
+    /* Wire Format Params */
+    bool m_compactHeaders;                  //!< quantized, delta encoded update messages
+    uint32_t m_keyFrameInterval;            //!< compact update messages between two key frames
+    V2vNovelUpdateCodec m_codec;            //!< encoder of the node and decoder of its neighbors
+
+    /* Adaptive Update Params */
+    bool m_adaptiveUpdate;                  //!< scale the update interval with the neighborhood dynamics
+    Time m_minUpdateInterval;               //!< shortest adaptive update interval
+    Time m_maxUpdateInterval;               //!< longest adaptive update interval
+    double m_churnReference;                //!< neighbor churn [1/s] that halves the interval range
+    double m_velocityVarianceReference;     //!< relative velocity variance [m^2/s^2] that halves the interval range
+    double m_targetBusyRatio;               //!< channel busy ratio above which the interval is stretched
+    Time m_neighborTimeout;                 //!< age after which a neighbor is removed
+    uint32_t m_neighborJoins;               //!< neighbors added in the current window
+    uint32_t m_neighborLeaves;              //!< neighbors removed in the current window
+    Time m_busyTime;                        //!< PHY busy time in the current window
+    Time m_windowStart;                     //!< start of the current measurement window
+    bool m_phyConnected;                    //!< PhyStateChanged is connected to a Wifi PHY
 
     /* Clustering Params */
     Vector m_covVelocity;
     Ptr<MobilityModel> m_mobilityModel;
     V2vClusterSap::NovelNodeState m_nodeState;
     V2vClusterSap::NovelNeighborInfo m_currentInfo;
-    std::map<uint64_t, V2vClusterSap::NovelNeighborInfo> m_clusterMap;
-    std::map<uint64_t, V2vClusterSap::NovelNeighborInfo> m_neighborMap;
-    std::map<uint64_t, V2vClusterSap::NovelNeighborInfo> m_stableNeighborMap;
+    V2vNeighborTable<V2vClusterSap::NovelNeighborInfo> m_clusterMap;
+    V2vNeighborTable<V2vClusterSap::NovelNeighborInfo> m_neighborMap;
+    V2vNeighborTable<V2vClusterSap::NovelNeighborInfo> m_stableNeighborMap;
+    V2vTimerWheel m_neighborExpiry;         //!< expiry time of each m_neighborMap entry
+    V2vTimerWheel m_stableExpiry;           //!< expiry time of each m_stableNeighborMap entry
+    std::vector<uint64_t> m_expired;        //!< scratch buffer of the expired neighbors
+    std::set<uint64_t> m_chNeighbors;       //!< m_neighborMap entries whose last update announced a CH
+    double m_neighborRange;                 //!< radius of the stable neighbor scans, 0 for all
+    double m_gridCellSize;                  //!< side of a neighbor grid cell, 0 for m_neighborRange
+    std::vector<uint32_t> m_stableScan;     //!< scratch buffer of the stable neighbor scans
 
     std::map<uint64_t, Address> m_membersAddress;
 
@@ -360,10 +611,10 @@ private:
     bool m_formationDelayBoolean;
     uint64_t m_startFormationDelay;
     uint64_t m_stopFormationDelay;
-    std::vector<uint64_t> m_formationDelayVector;
+    V2vStatisticsAccumulator m_formationDelay;
 
     /* Average Number of members per cluster */
-    std::vector<uint64_t> m_clusterMembers;
+    V2vStatisticsAccumulator m_clusterMembers;
 
     /* Number of Cluster Changes */
     uint64_t m_clusterChanges;
@@ -381,13 +632,18 @@ private:
     bool m_chDurationBoolean;
     uint64_t m_startChDuration;
     uint64_t m_stopChDuration;
-    std::vector<uint64_t> m_chDurationVector;
+    V2vStatisticsAccumulator m_chDuration;
 
     /* Cluster Member duration metrics */
     bool m_cmDurationBoolean;
     uint64_t m_startCmDuration;
     uint64_t m_stopCmDuration;
-    std::vector<uint64_t> m_cmDurationVector;
+    V2vStatisticsAccumulator m_cmDuration;
+
+    /* Update rate metrics */
+    V2vStatisticsAccumulator m_updateIntervals;
+    V2vStatisticsAccumulator m_channelBusy;
+    V2vStatisticsAccumulator m_updateSize;
 
 };
 
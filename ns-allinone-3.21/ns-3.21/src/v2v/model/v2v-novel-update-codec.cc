@@ -0,0 +1,230 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "v2v-novel-update-codec.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vNovelUpdateCodec");
+
+namespace ns3 {
+
+static const double POSITION_SCALE = 100.0;         //!< cm
+static const double VELOCITY_SCALE = 100.0;         //!< cm/s
+static const double DIRECTION_SCALE = 10000.0;
+
+static int32_t
+Quantize (double value, double scale, int32_t limit){
+    double q = std::floor (value * scale + 0.5);
+    if(q > limit){
+        return limit;
+    }
+    if(q < -limit){
+        return -limit;
+    }
+    return (int32_t) q;
+}
+
+static const int32_t INT16_LIMIT = std::numeric_limits<int16_t>::max ();
+static const int32_t INT32_LIMIT = std::numeric_limits<int32_t>::max ();
+
+static bool
+FitsInt16 (int64_t value){
+    return value >= std::numeric_limits<int16_t>::min () && value <= std::numeric_limits<int16_t>::max ();
+}
+
+V2vNovelUpdateCodec::V2vNovelUpdateCodec ()
+  : m_keyFrameInterval (10),
+    m_hasKey (false),
+    m_sinceKey (0),
+    m_keyFrames (0),
+    m_deltas (0),
+    m_dropped (0){
+}
+
+void
+V2vNovelUpdateCodec::SetKeyFrameInterval (uint32_t interval){
+    NS_ASSERT_MSG (interval > 0, "The key frame interval must be positive");
+    m_keyFrameInterval = interval;
+}
+
+V2vClusterSap::NovelCompactUpdate
+V2vNovelUpdateCodec::Encode (const V2vClusterSap::NovelNeighborInfo &info){
+
+    V2vClusterSap::NovelCompactUpdate full;
+    full.id = (uint32_t) info.id;
+    full.ts = info.ts;
+    full.position[0] = Quantize (info.position.x, POSITION_SCALE, INT32_LIMIT);
+    full.position[1] = Quantize (info.position.y, POSITION_SCALE, INT32_LIMIT);
+    full.position[2] = Quantize (info.position.z, POSITION_SCALE, INT32_LIMIT);
+    full.velocity[0] = Quantize (info.velocity.x, VELOCITY_SCALE, INT16_LIMIT);
+    full.velocity[1] = Quantize (info.velocity.y, VELOCITY_SCALE, INT16_LIMIT);
+    full.velocity[2] = Quantize (info.velocity.z, VELOCITY_SCALE, INT16_LIMIT);
+    full.direction[0] = Quantize (info.direction.x, DIRECTION_SCALE, INT16_LIMIT);
+    full.direction[1] = Quantize (info.direction.y, DIRECTION_SCALE, INT16_LIMIT);
+    full.direction[2] = Quantize (info.direction.z, DIRECTION_SCALE, INT16_LIMIT);
+    full.clusterId = (uint32_t) info.clusterId;
+    full.tempClusterId = (uint32_t) info.tempClusterId;
+    full.chMembers = (uint16_t) std::min<uint64_t> (info.chMembers, std::numeric_limits<uint16_t>::max ());
+    full.degree = (uint8_t) info.degree;
+
+    bool key = !m_hasKey || m_sinceKey >= m_keyFrameInterval || full.clusterId != m_key.clusterId;
+    int64_t offset = 0;
+    if(!key){
+        offset = (TimeStep (info.ts) - TimeStep (m_key.ts)).GetMicroSeconds ();
+        key = offset < 0 || offset > std::numeric_limits<uint32_t>::max ();
+    }
+    for(uint32_t k = 0; k < 3 && !key; ++k){
+        key = !FitsInt16 ((int64_t) full.position[k] - m_key.position[k]);
+    }
+
+    if(key){
+        full.flags = 0xff;
+        full.keySeq = m_key.keySeq + 1;
+        m_key = full;
+        m_hasKey = true;
+        m_sinceKey = 1;
+        m_keyFrames ++;
+        return full;
+    }
+
+    V2vClusterSap::NovelCompactUpdate delta;
+    delta.keySeq = m_key.keySeq;
+    delta.id = full.id;
+    delta.ts = (uint64_t) offset;
+    for(uint32_t k = 0; k < 3; ++k){
+        delta.position[k] = full.position[k] - m_key.position[k];
+        delta.velocity[k] = full.velocity[k];
+        delta.direction[k] = full.direction[k];
+        if(delta.position[k] != 0){
+            delta.flags |= V2vClusterSap::COMPACT_POSITION;
+        }
+        if(full.velocity[k] != m_key.velocity[k]){
+            delta.flags |= V2vClusterSap::COMPACT_VELOCITY;
+        }
+        if(full.direction[k] != m_key.direction[k]){
+            delta.flags |= V2vClusterSap::COMPACT_DIRECTION;
+        }
+    }
+    delta.clusterId = full.clusterId;
+    delta.tempClusterId = full.tempClusterId;
+    delta.chMembers = full.chMembers;
+    delta.degree = full.degree;
+    if(full.tempClusterId != m_key.tempClusterId){
+        delta.flags |= V2vClusterSap::COMPACT_TEMP_CLUSTER;
+    }
+    if(full.chMembers != m_key.chMembers){
+        delta.flags |= V2vClusterSap::COMPACT_MEMBERS;
+    }
+    if(full.degree != m_key.degree){
+        delta.flags |= V2vClusterSap::COMPACT_DEGREE;
+    }
+    m_sinceKey ++;
+    m_deltas ++;
+    return delta;
+}
+
+bool
+V2vNovelUpdateCodec::Decode (const V2vClusterSap::NovelCompactUpdate &update, V2vClusterSap::NovelNeighborInfo &info){
+
+    uint8_t flags = update.flags;
+    bool isKey = flags & V2vClusterSap::COMPACT_KEY_FRAME;
+    const V2vClusterSap::NovelCompactUpdate *key;
+    if(isKey){
+        V2vClusterSap::NovelCompactUpdate &stored = m_received[update.id];
+        stored = update;
+        key = &stored;
+    }
+    else{
+        std::map<uint32_t, V2vClusterSap::NovelCompactUpdate>::const_iterator it = m_received.find (update.id);
+        if(it == m_received.end () || it->second.keySeq != update.keySeq){
+            NS_LOG_LOGIC ("Missed key frame " << (uint32_t) update.keySeq << " of node " << update.id);
+            m_dropped ++;
+            return false;
+        }
+        key = &it->second;
+    }
+
+    int32_t position[3];
+    int16_t velocity[3];
+    int16_t direction[3];
+    for(uint32_t k = 0; k < 3; ++k){
+        position[k] = key->position[k];
+        if(!isKey && (flags & V2vClusterSap::COMPACT_POSITION)){
+            position[k] += update.position[k];
+        }
+        velocity[k] = (flags & V2vClusterSap::COMPACT_VELOCITY) ? update.velocity[k] : key->velocity[k];
+        direction[k] = (flags & V2vClusterSap::COMPACT_DIRECTION) ? update.direction[k] : key->direction[k];
+    }
+
+    info.id = update.id;
+    info.ts = key->ts;
+    if(!isKey){
+        info.ts += MicroSeconds (update.ts).GetTimeStep ();
+    }
+    info.position = Vector (position[0] / POSITION_SCALE, position[1] / POSITION_SCALE, position[2] / POSITION_SCALE);
+    info.velocity = Vector (velocity[0] / VELOCITY_SCALE, velocity[1] / VELOCITY_SCALE, velocity[2] / VELOCITY_SCALE);
+    info.direction = Vector (direction[0] / DIRECTION_SCALE, direction[1] / DIRECTION_SCALE, direction[2] / DIRECTION_SCALE);
+    info.clusterId = (flags & V2vClusterSap::COMPACT_CLUSTER) ? update.clusterId : key->clusterId;
+    info.tempClusterId = (flags & V2vClusterSap::COMPACT_TEMP_CLUSTER) ? update.tempClusterId : key->tempClusterId;
+    info.chMembers = (flags & V2vClusterSap::COMPACT_MEMBERS) ? update.chMembers : key->chMembers;
+    info.degree = (V2vClusterSap::NovelNodeDegree) ((flags & V2vClusterSap::COMPACT_DEGREE) ? update.degree : key->degree);
+    return true;
+}
+
+void
+V2vNovelUpdateCodec::Round (V2vClusterSap::NovelNeighborInfo &info){
+    info.position = Vector (Quantize (info.position.x, POSITION_SCALE, INT32_LIMIT) / POSITION_SCALE,
+                            Quantize (info.position.y, POSITION_SCALE, INT32_LIMIT) / POSITION_SCALE,
+                            Quantize (info.position.z, POSITION_SCALE, INT32_LIMIT) / POSITION_SCALE);
+    info.velocity = Vector (Quantize (info.velocity.x, VELOCITY_SCALE, INT16_LIMIT) / VELOCITY_SCALE,
+                            Quantize (info.velocity.y, VELOCITY_SCALE, INT16_LIMIT) / VELOCITY_SCALE,
+                            Quantize (info.velocity.z, VELOCITY_SCALE, INT16_LIMIT) / VELOCITY_SCALE);
+    info.direction = Vector (Quantize (info.direction.x, DIRECTION_SCALE, INT16_LIMIT) / DIRECTION_SCALE,
+                             Quantize (info.direction.y, DIRECTION_SCALE, INT16_LIMIT) / DIRECTION_SCALE,
+                             Quantize (info.direction.z, DIRECTION_SCALE, INT16_LIMIT) / DIRECTION_SCALE);
+}
+
+void
+V2vNovelUpdateCodec::Reset (void){
+    m_hasKey = false;
+    m_sinceKey = 0;
+    m_received.clear ();
+}
+
+uint64_t
+V2vNovelUpdateCodec::GetKeyFrames (void) const {
+    return m_keyFrames;
+}
+
+uint64_t
+V2vNovelUpdateCodec::GetDeltas (void) const {
+    return m_deltas;
+}
+
+uint64_t
+V2vNovelUpdateCodec::GetDropped (void) const {
+    return m_dropped;
+}
+
+} // namespace ns3
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_NOVEL_UPDATE_CODEC_H
+#define V2V_NOVEL_UPDATE_CODEC_H
+
+#include <map>
+#include <stdint.h>
+#include "v2v-cluster-sap.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vNovelUpdateCodec
+ * \brief Quantization and delta encoding of the Novel update messages.
+ *
+ * Positions are sent in cm, velocities in cm/s, directions in 1/10000
+ * and ids on 32bits. Every KeyFrameInterval updates, and whenever the
+ * cluster id of the node changes, the encoder sends a key frame with
+ * absolute values. In between it sends deltas: the time offset and the
+ * position relative to the last key frame, plus the other fields that
+ * differ from it. A delta whose offsets do not fit their 16/32bits is
+ * turned into a key frame.
+ *
+ * The decoder keeps the last key frame of each sender. A delta is
+ * expanded against the key frame of the same sequence number, and
+ * dropped if that key frame was missed.
+ *
+ * A client uses one codec for both directions.
+ */
+class V2vNovelUpdateCodec {
+public:
+
+    V2vNovelUpdateCodec ();
+
+    /**
+     * \param interval number of updates between two key frames, 1 for key
+     * frames only
+     */
+    void SetKeyFrameInterval (uint32_t interval);
+
+    /**
+     * \param info the update of the node
+     * \return the key frame or delta to send
+     */
+    V2vClusterSap::NovelCompactUpdate Encode (const V2vClusterSap::NovelNeighborInfo &info);
+
+    /**
+     * \param update a received key frame or delta
+     * \param info filled with the expanded update
+     * \return false if the key frame of a delta was missed
+     */
+    bool Decode (const V2vClusterSap::NovelCompactUpdate &update, V2vClusterSap::NovelNeighborInfo &info);
+
+    /**
+     * \brief Round the position, velocity and direction to the resolution
+     * of the wire format.
+     *
+     * A node compares its own mobility to the decoded one of its
+     * neighbors, so it has to see it at the same resolution: a velocity
+     * component of 1e-15 m/s and one rounded to 0 have different signs.
+     *
+     * \param info the update to round
+     */
+    static void Round (V2vClusterSap::NovelNeighborInfo &info);
+
+    /**
+     * \brief Forget the key frames, sent and received.
+     */
+    void Reset (void);
+
+    /**
+     * \return the number of key frames encoded
+     */
+    uint64_t GetKeyFrames (void) const;
+
+    /**
+     * \return the number of deltas encoded
+     */
+    uint64_t GetDeltas (void) const;
+
+    /**
+     * \return the number of received deltas dropped for a missed key frame
+     */
+    uint64_t GetDropped (void) const;
+
+private:
+
+    uint32_t m_keyFrameInterval;
+    bool m_hasKey;                          //!< m_key is valid
+    V2vClusterSap::NovelCompactUpdate m_key;    //!< last key frame sent
+    uint32_t m_sinceKey;                    //!< updates sent since m_key, included
+    std::map<uint32_t, V2vClusterSap::NovelCompactUpdate> m_received;  //!< last key frame of each sender
+
+    uint64_t m_keyFrames;
+    uint64_t m_deltas;
+    uint64_t m_dropped;
+};
+
+} // namespace ns3
+
+#endif // V2V_NOVEL_UPDATE_CODEC_H
@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include "ns3/log.h"
+#include "ns3/hash.h"
+#include "v2v-cluster-snapshot.h"
+#include "v2v-slot-allocator.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vSlotAllocator");
+
+namespace ns3 {
+
+V2vSlotAllocator::V2vSlotAllocator ()
+  : m_id (0),
+    m_frameSlots (1),
+    m_slotLength (MilliSeconds (1)),
+    m_slot (0),
+    m_attempt (0),
+    m_sent (false),
+    m_sentSlot (0),
+    m_collisions (0),
+    m_moves (0)
+{
+}
+
+void
+V2vSlotAllocator::Start (uint32_t id, uint32_t frameSlots, Time slotLength){
+    NS_LOG_FUNCTION (this << id << frameSlots << slotLength);
+    NS_ASSERT_MSG (frameSlots > 0 && slotLength.IsStrictlyPositive (), "Invalid TDMA frame");
+
+    m_id = id;
+    m_frameSlots = frameSlots;
+    m_slotLength = slotLength;
+    m_attempt = 0;
+    m_slot = HashSlot (m_attempt);
+    m_sent = false;
+    m_shift = Time (0);
+    m_lastHeard.assign (m_frameSlots, Time (0));
+    m_collisions = 0;
+    m_moves = 0;
+}
+
+uint32_t
+V2vSlotAllocator::GetSlot (void) const {
+    return m_slot;
+}
+
+Time
+V2vSlotAllocator::GetOffset (void) const {
+    return m_slotLength * (int64_t) (m_slot + 1);
+}
+
+uint32_t
+V2vSlotAllocator::GetFrameSlots (void) const {
+    return m_frameSlots;
+}
+
+uint32_t
+V2vSlotAllocator::SlotOf (Time ts) const {
+    int64_t frame = m_slotLength.GetTimeStep () * m_frameSlots;
+    int64_t position = ts.GetTimeStep () % frame;
+    if(position < 0){
+        position += frame;
+    }
+    return position / m_slotLength.GetTimeStep ();
+}
+
+uint32_t
+V2vSlotAllocator::HashSlot (uint32_t attempt) const {
+    char buffer[8];
+    for(uint32_t i = 0; i < 4; ++i){
+        buffer[i] = (m_id >> (8 * i)) & 0xff;
+        buffer[4 + i] = (attempt >> (8 * i)) & 0xff;
+    }
+    return Hash32 (buffer, sizeof (buffer)) % m_frameSlots;
+}
+
+bool
+V2vSlotAllocator::IsBusy (uint32_t slot, Time now) const {
+    Time heard = m_lastHeard[slot];
+    return heard.IsStrictlyPositive () && now - heard < m_slotLength * (int64_t) (2 * m_frameSlots);
+}
+
+void
+V2vSlotAllocator::NotifySent (Time ts){
+    m_sent = true;
+    m_sentSlot = SlotOf (ts);
+}
+
+bool
+V2vSlotAllocator::NotifyReceived (uint32_t sender, Time ts){
+    NS_LOG_FUNCTION (this << sender << ts);
+    if(m_lastHeard.empty () || sender == m_id){
+        return false;
+    }
+
+    uint32_t slot = SlotOf (ts);
+    m_lastHeard[slot] = ts;
+    if(!m_sent || slot != m_sentSlot){
+        return false;
+    }
+
+    m_collisions ++;
+    if(m_id < sender){
+        //!< The sender moves
+        return false;
+    }
+
+    //!< Rehash until a slot heard idle for two frames, then scan the
+    //!< frame from the last candidate; keep it if the whole frame is busy
+    uint32_t target = slot;
+    bool found = false;
+    for(uint32_t i = 0; i < m_frameSlots && !found; ++i){
+        target = HashSlot (++ m_attempt);
+        found = target != slot && !IsBusy (target, ts);
+    }
+    for(uint32_t i = 0; i < m_frameSlots && !found; ++i){
+        uint32_t candidate = (target + i) % m_frameSlots;
+        if(candidate != slot && !IsBusy (candidate, ts)){
+            target = candidate;
+            found = true;
+        }
+    }
+    uint32_t shift = (target + m_frameSlots - slot) % m_frameSlots;
+    m_slot = (m_slot + shift) % m_frameSlots;
+    m_sentSlot = target;
+    m_shift += m_slotLength * (int64_t) shift;
+    m_moves ++;
+    NS_LOG_DEBUG ("Node:" << m_id << " collides with " << sender << " in slot " << slot << ", moves to " << m_slot);
+    return true;
+}
+
+Time
+V2vSlotAllocator::TakeShift (void){
+    Time shift = m_shift;
+    m_shift = Time (0);
+    return shift;
+}
+
+uint64_t
+V2vSlotAllocator::GetCollisions (void) const {
+    return m_collisions;
+}
+
+uint64_t
+V2vSlotAllocator::GetMoves (void) const {
+    return m_moves;
+}
+
+void
+V2vSlotAllocator::SaveState (V2vSnapshotWriter &writer) const {
+    writer.Write ("slot", m_slot);
+    writer.Write ("slotAttempt", m_attempt);
+    writer.Write ("slotSent", m_sent);
+    writer.Write ("sentSlot", m_sentSlot);
+    writer.Write ("slotShift", m_shift);
+    writer.Write ("slotCollisions", m_collisions);
+    writer.Write ("slotMoves", m_moves);
+}
+
+void
+V2vSlotAllocator::LoadState (V2vSnapshotReader &reader){
+    reader.Read ("slot", m_slot);
+    reader.Read ("slotAttempt", m_attempt);
+    reader.Read ("slotSent", m_sent);
+    reader.Read ("sentSlot", m_sentSlot);
+    reader.Read ("slotShift", m_shift);
+    reader.Read ("slotCollisions", m_collisions);
+    reader.Read ("slotMoves", m_moves);
+}
+
+} // namespace ns3
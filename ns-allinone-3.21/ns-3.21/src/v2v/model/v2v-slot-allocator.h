@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_SLOT_ALLOCATOR_H
+#define V2V_SLOT_ALLOCATOR_H
+
+#include <vector>
+#include <stdint.h>
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+class V2vSnapshotWriter;
+class V2vSnapshotReader;
+
+/**
+ * \ingroup v2v
+ * \class V2vSlotAllocator
+ * \brief Distributed TDMA slot reservation of the clustering clients.
+ *
+ * The fixed scheme gives vehicle u the offset (u+1)*MinimumTdmaSlot, so
+ * the frame has to hold MaxUes slots and the last vehicle waits for all
+ * the others. Here a frame has a fixed number of slots and a node picks
+ * its slot by hashing its id, whatever the fleet size.
+ *
+ * The slot of a beacon is the position of its send time in the frame,
+ * so a node learns the slots of its neighbors from the time stamps of
+ * their beacons. When a neighbor beacon falls in the slot of the last
+ * beacon of the node, the node of higher id moves: it rehashes its id
+ * with a new attempt number until it gets a slot where no beacon was
+ * heard during the last two frames, and scans the frame for one after
+ * frameSlots attempts. The move is returned as a time shift for the
+ * client to apply to its next beacon.
+ */
+class V2vSlotAllocator {
+public:
+
+    enum Scheme {
+        FIXED = 0,
+        HASHED
+    };
+
+    V2vSlotAllocator ();
+
+    /**
+     * \brief Pick the initial slot and forget the previous reservation.
+     * \param id the node id
+     * \param frameSlots number of slots of a frame
+     * \param slotLength duration of a slot
+     */
+    void Start (uint32_t id, uint32_t frameSlots, Time slotLength);
+
+    /**
+     * \return the reserved slot, in [0, frameSlots)
+     */
+    uint32_t GetSlot (void) const;
+
+    /**
+     * \return the offset of the reserved slot in the frame, (slot+1)*slotLength
+     * like the fixed offsets
+     */
+    Time GetOffset (void) const;
+
+    /**
+     * \return the number of slots of a frame
+     */
+    uint32_t GetFrameSlots (void) const;
+
+    /**
+     * \param ts the time a beacon of the node was sent
+     */
+    void NotifySent (Time ts);
+
+    /**
+     * \param sender the id of the sender
+     * \param ts the time the beacon was sent, as stamped in its header
+     * \return true if the node moved to another slot
+     */
+    bool NotifyReceived (uint32_t sender, Time ts);
+
+    /**
+     * \return the shift of the next beacon accumulated by the moves since
+     * the last call
+     */
+    Time TakeShift (void);
+
+    /**
+     * \return the number of beacons heard in the slot of the node
+     */
+    uint64_t GetCollisions (void) const;
+
+    /**
+     * \return the number of slot changes
+     */
+    uint64_t GetMoves (void) const;
+
+    /**
+     * \brief Write the reservation; the slots heard busy are not kept.
+     */
+    void SaveState (V2vSnapshotWriter &writer) const;
+    void LoadState (V2vSnapshotReader &reader);
+
+private:
+
+    uint32_t SlotOf (Time ts) const;
+    uint32_t HashSlot (uint32_t attempt) const;
+    bool IsBusy (uint32_t slot, Time now) const;
+
+    uint32_t m_id;
+    uint32_t m_frameSlots;
+    Time m_slotLength;
+    uint32_t m_slot;
+    uint32_t m_attempt;                 //!< rehash count of the id
+    bool m_sent;                        //!< m_sentSlot is valid
+    uint32_t m_sentSlot;                //!< frame position of the last beacon sent
+    Time m_shift;
+    std::vector<Time> m_lastHeard;      //!< send time of the last beacon heard in each slot
+
+    uint64_t m_collisions;
+    uint64_t m_moves;
+};
+
+} // namespace ns3
+
+#endif // V2V_SLOT_ALLOCATOR_H
@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+#include "ns3/assert.h"
+#include "v2v-statistics-accumulator.h"
+
+namespace ns3 {
+
+V2vStatisticsAccumulator::V2vStatisticsAccumulator (uint32_t maxBins):
+    m_maxBins(maxBins),
+    m_count(0),
+    m_mean(0.0),
+    m_m2(0.0),
+    m_min(0.0),
+    m_max(0.0){
+    NS_ASSERT (maxBins > 1);
+    m_bins.reserve (maxBins + 1);
+}
+
+void
+V2vStatisticsAccumulator::Add (double value){
+
+    m_count++;
+    double delta = value - m_mean;
+    m_mean += delta / m_count;
+    m_m2 += delta * (value - m_mean);
+
+    if(m_count == 1 || value < m_min){
+        m_min = value;
+    }
+    if(m_count == 1 || value > m_max){
+        m_max = value;
+    }
+
+    InsertBin (value, 1);
+}
+
+void
+V2vStatisticsAccumulator::Merge (const V2vStatisticsAccumulator &other){
+
+    if(other.m_count == 0){
+        return;
+    }
+    if(m_count == 0){
+        m_min = other.m_min;
+        m_max = other.m_max;
+    }
+    else{
+        m_min = std::min (m_min, other.m_min);
+        m_max = std::max (m_max, other.m_max);
+    }
+
+    uint64_t count = m_count + other.m_count;
+    double delta = other.m_mean - m_mean;
+    m_mean += delta * other.m_count / count;
+    m_m2 += other.m_m2 + delta * delta * ((double)m_count * other.m_count / count);
+    m_count = count;
+
+    for(std::vector<Bin>::const_iterator it = other.m_bins.begin (); it != other.m_bins.end (); ++it){
+        InsertBin (it->centroid, it->count);
+    }
+}
+
+void
+V2vStatisticsAccumulator::Reset (void){
+    m_count = 0;
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    m_min = 0.0;
+    m_max = 0.0;
+    m_bins.clear ();
+}
+
+uint64_t
+V2vStatisticsAccumulator::GetCount (void) const {
+    return m_count;
+}
+
+double
+V2vStatisticsAccumulator::GetSum (void) const {
+    return m_mean * m_count;
+}
+
+double
+V2vStatisticsAccumulator::GetMean (void) const {
+    return m_mean;
+}
+
+double
+V2vStatisticsAccumulator::GetVariance (void) const {
+    return m_count > 1 ? m_m2 / (m_count - 1) : 0.0;
+}
+
+double
+V2vStatisticsAccumulator::GetStddev (void) const {
+    return std::sqrt (GetVariance ());
+}
+
+double
+V2vStatisticsAccumulator::GetMin (void) const {
+    return m_min;
+}
+
+double
+V2vStatisticsAccumulator::GetMax (void) const {
+    return m_max;
+}
+
+double
+V2vStatisticsAccumulator::GetQuantile (double q) const {
+
+    if(m_count == 0){
+        return 0.0;
+    }
+    q = std::min (1.0, std::max (0.0, q));
+    double rank = q * (m_count - 1);
+
+    // piecewise linear between (0, min), the bin centers and (count - 1, max)
+    double prevRank = 0.0;
+    double prevValue = m_min;
+    double cumulative = 0.0;
+    for(std::vector<Bin>::const_iterator it = m_bins.begin (); it != m_bins.end (); ++it){
+        double center = cumulative + (it->count - 1) / 2.0;
+        if(rank <= center){
+            if(center == prevRank){
+                return it->centroid;
+            }
+            return prevValue + (it->centroid - prevValue) * (rank - prevRank) / (center - prevRank);
+        }
+        prevRank = center;
+        prevValue = it->centroid;
+        cumulative += it->count;
+    }
+
+    double last = m_count - 1;
+    if(last == prevRank){
+        return m_max;
+    }
+    return prevValue + (m_max - prevValue) * (rank - prevRank) / (last - prevRank);
+}
+
+uint32_t
+V2vStatisticsAccumulator::GetMaxBins (void) const {
+    return m_maxBins;
+}
+
+void
+V2vStatisticsAccumulator::Save (std::ostream &os) const {
+    std::streamsize precision = os.precision (17);
+    os << m_maxBins << " " << m_count << " " << m_mean << " " << m_m2
+       << " " << m_min << " " << m_max << " " << m_bins.size ();
+    for(std::vector<Bin>::const_iterator it = m_bins.begin (); it != m_bins.end (); ++it){
+        os << " " << it->centroid << " " << it->count;
+    }
+    os.precision (precision);
+}
+
+bool
+V2vStatisticsAccumulator::Load (std::istream &is){
+    uint32_t maxBins;
+    uint32_t bins;
+    V2vStatisticsAccumulator loaded;
+    if(!(is >> maxBins >> loaded.m_count >> loaded.m_mean >> loaded.m_m2
+            >> loaded.m_min >> loaded.m_max >> bins) || maxBins < 2 || bins > maxBins){
+        return false;
+    }
+    loaded.m_maxBins = maxBins;
+    loaded.m_bins.resize (bins);
+    for(uint32_t i = 0; i < bins; ++i){
+        if(!(is >> loaded.m_bins[i].centroid >> loaded.m_bins[i].count)){
+            return false;
+        }
+    }
+    *this = loaded;
+    return true;
+}
+
+void
+V2vStatisticsAccumulator::InsertBin (double centroid, uint64_t count){
+
+    std::vector<Bin>::iterator it = m_bins.begin ();
+    while(it != m_bins.end () && it->centroid < centroid){
+        ++it;
+    }
+    if(it != m_bins.end () && it->centroid == centroid){
+        it->count += count;
+        return;
+    }
+    Bin bin;
+    bin.centroid = centroid;
+    bin.count = count;
+    m_bins.insert (it, bin);
+
+    if(m_bins.size () <= m_maxBins){
+        return;
+    }
+
+    // merge the two closest bins
+    uint32_t closest = 0;
+    for(uint32_t i = 1; i + 1 < m_bins.size (); ++i){
+        if(m_bins[i+1].centroid - m_bins[i].centroid < m_bins[closest+1].centroid - m_bins[closest].centroid){
+            closest = i;
+        }
+    }
+    Bin &left = m_bins[closest];
+    const Bin &right = m_bins[closest+1];
+    uint64_t merged = left.count + right.count;
+    left.centroid = (left.centroid * left.count + right.centroid * right.count) / merged;
+    left.count = merged;
+    m_bins.erase (m_bins.begin () + closest + 1);
+}
+
+} // namespace ns3
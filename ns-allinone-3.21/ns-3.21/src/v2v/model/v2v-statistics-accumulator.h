@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_STATISTICS_ACCUMULATOR_H
+#define V2V_STATISTICS_ACCUMULATOR_H
+
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vStatisticsAccumulator
+ * \brief Online count/mean/variance/min/max and quantiles of a sample stream.
+ *
+ * The moments are kept with Welford's update. Quantiles come from a
+ * streaming histogram of at most GetMaxBins () (centroid, count) bins:
+ * each sample opens a bin and, over the limit, the two closest bins are
+ * merged. Quantiles are exact as long as there are fewer distinct
+ * samples than bins, and memory never grows past the bin limit.
+ */
+class V2vStatisticsAccumulator {
+public:
+
+    /**
+     * \param maxBins the bin limit of the quantile sketch
+     */
+    V2vStatisticsAccumulator (uint32_t maxBins = 64);
+
+    /**
+     * \param value the new sample
+     */
+    void Add (double value);
+
+    /**
+     * \brief Fold the samples of another accumulator into this one.
+     */
+    void Merge (const V2vStatisticsAccumulator &other);
+
+    /**
+     * \brief Forget all the samples.
+     */
+    void Reset (void);
+
+    /**
+     * \return the number of samples
+     */
+    uint64_t GetCount (void) const;
+
+    /**
+     * \return the sum of the samples
+     */
+    double GetSum (void) const;
+
+    /**
+     * \return the mean, 0 without samples
+     */
+    double GetMean (void) const;
+
+    /**
+     * \return the unbiased sample variance, 0 with less than two samples
+     */
+    double GetVariance (void) const;
+
+    /**
+     * \return the sample standard deviation
+     */
+    double GetStddev (void) const;
+
+    /**
+     * \return the smallest sample, 0 without samples
+     */
+    double GetMin (void) const;
+
+    /**
+     * \return the largest sample, 0 without samples
+     */
+    double GetMax (void) const;
+
+    /**
+     * \param q the quantile in [0, 1], e.g. 0.95 for the 95th percentile
+     * \return the estimated quantile, 0 without samples
+     */
+    double GetQuantile (double q) const;
+
+    /**
+     * \return the bin limit of the quantile sketch
+     */
+    uint32_t GetMaxBins (void) const;
+
+    /**
+     * \brief Write the samples summary as whitespace separated tokens.
+     *
+     * The doubles are written with 17 significant digits, so Load
+     * restores the accumulator exactly.
+     */
+    void Save (std::ostream &os) const;
+
+    /**
+     * \brief Replace the samples by a summary written with Save.
+     * \return false if the input is malformed
+     */
+    bool Load (std::istream &is);
+
+private:
+
+    struct Bin{
+        double centroid;
+        uint64_t count;
+    };
+
+    void InsertBin (double centroid, uint64_t count);
+
+    uint32_t m_maxBins;
+    uint64_t m_count;
+    double m_mean;
+    double m_m2;                //!< sum of squared deviations from the mean
+    double m_min;
+    double m_max;
+    std::vector<Bin> m_bins;    //!< sorted by centroid
+};
+
+} // namespace ns3
+
+#endif // V2V_STATISTICS_ACCUMULATOR_H
@@ -0,0 +1,299 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include <algorithm>
+#include "ns3/assert.h"
+#include "v2v-timer-wheel.h"
+
+namespace ns3 {
+
+static uint32_t
+LowestBit (uint64_t bits){
+    uint32_t n = 0;
+    while ((bits & 0xffffffffULL) == 0){
+        bits >>= 32;
+        n += 32;
+    }
+    while ((bits & 1) == 0){
+        bits >>= 1;
+        n ++;
+    }
+    return n;
+}
+
+V2vTimerWheel::V2vTimerWheel (Time resolution) :
+        m_now(0),
+        m_size(0),
+        m_free(-1),
+        m_occupied(0){
+    SetResolution (resolution);
+    std::fill (m_heads, m_heads + OVERFLOW + 1, -1);
+}
+
+void
+V2vTimerWheel::SetResolution (Time resolution){
+    NS_ASSERT (m_size == 0);
+    NS_ASSERT (resolution.IsStrictlyPositive ());
+    m_resolution = resolution.GetTimeStep ();
+    m_now = 0;
+}
+
+Time
+V2vTimerWheel::GetResolution (void) const {
+    return TimeStep (m_resolution);
+}
+
+uint64_t
+V2vTimerWheel::TickOf (int64_t deadline) const {
+    return deadline < 0 ? 0 : deadline / m_resolution;
+}
+
+void
+V2vTimerWheel::Link (int32_t index, int32_t list){
+    Timer &timer = m_timers[index];
+    timer.list = list;
+    timer.prev = -1;
+    timer.next = m_heads[list];
+    if (timer.next >= 0){
+        m_timers[timer.next].prev = index;
+    }
+    m_heads[list] = index;
+    if (list < SLOTS){
+        m_occupied |= (1ULL << list);
+    }
+}
+
+void
+V2vTimerWheel::Unlink (int32_t index){
+    Timer &timer = m_timers[index];
+    if (timer.prev >= 0){
+        m_timers[timer.prev].next = timer.next;
+    }
+    else{
+        m_heads[timer.list] = timer.next;
+    }
+    if (timer.next >= 0){
+        m_timers[timer.next].prev = timer.prev;
+    }
+    if (timer.list < SLOTS && m_heads[timer.list] < 0){
+        m_occupied &= ~(1ULL << timer.list);
+    }
+}
+
+void
+V2vTimerWheel::Place (int32_t index){
+    uint64_t tick = std::max (m_timers[index].tick, m_now);
+    uint64_t delta = tick - m_now;
+    if (delta < SLOTS){
+        Link (index, tick & MASK);
+        return;
+    }
+    for (uint32_t level = 1; level < LEVELS; ++level){
+        uint32_t shift = SLOT_BITS*(level + 1);
+        if (delta < (1ULL << shift)){
+            Link (index, level*SLOTS + ((tick >> (shift - SLOT_BITS)) & MASK));
+            return;
+        }
+    }
+    Link (index, OVERFLOW);
+}
+
+void
+V2vTimerWheel::Release (int32_t index, std::vector<uint64_t> &expired){
+    Unlink (index);
+    Timer &timer = m_timers[index];
+    expired.push_back (timer.key);
+    m_index.Erase (timer.key);
+    timer.next = m_free;
+    m_free = index;
+    m_size --;
+}
+
+void
+V2vTimerWheel::Schedule (uint64_t key, Time deadline){
+    uint32_t found;
+    int32_t index;
+    if (m_index.Find (key, found)){
+        index = found;
+        Unlink (index);
+    }
+    else{
+        if (m_free >= 0){
+            index = m_free;
+            m_free = m_timers[index].next;
+        }
+        else{
+            index = m_timers.size ();
+            m_timers.push_back (Timer ());
+        }
+        m_timers[index].key = key;
+        m_index.Insert (key, index);
+        m_size ++;
+    }
+    Timer &timer = m_timers[index];
+    timer.deadline = deadline.GetTimeStep ();
+    timer.tick = TickOf (timer.deadline);
+    Place (index);
+}
+
+bool
+V2vTimerWheel::Cancel (uint64_t key){
+    uint32_t index;
+    if (!m_index.Find (key, index)){
+        return false;
+    }
+    Unlink (index);
+    m_index.Erase (key);
+    m_timers[index].next = m_free;
+    m_free = index;
+    m_size --;
+    return true;
+}
+
+bool
+V2vTimerWheel::Contains (uint64_t key) const {
+    uint32_t index;
+    return m_index.Find (key, index);
+}
+
+Time
+V2vTimerWheel::GetDeadline (uint64_t key) const {
+    uint32_t index;
+    if (!m_index.Find (key, index)){
+        NS_ASSERT_MSG (false, "Key " << key << " is not scheduled");
+        return Time::Max ();
+    }
+    return TimeStep (m_timers[index].deadline);
+}
+
+void
+V2vTimerWheel::Clear (void){
+    m_timers.clear ();
+    m_index.Clear ();
+    std::fill (m_heads, m_heads + OVERFLOW + 1, -1);
+    m_occupied = 0;
+    m_free = -1;
+    m_size = 0;
+}
+
+uint32_t
+V2vTimerWheel::GetSize (void) const {
+    return m_size;
+}
+
+bool
+V2vTimerWheel::IsEmpty (void) const {
+    return m_size == 0;
+}
+
+void
+V2vTimerWheel::Cascade (void){
+    // m_now starts a level 0 cycle: spread the slot of the level above
+    // that starts with it, going up while the upper cycles start too
+    uint32_t level = 1;
+    for (; level < LEVELS; ++level){
+        uint32_t slot = (m_now >> (SLOT_BITS*level)) & MASK;
+        int32_t list = level*SLOTS + slot;
+        int32_t index = m_heads[list];
+        m_heads[list] = -1;
+        while (index >= 0){
+            int32_t next = m_timers[index].next;
+            Place (index);
+            index = next;
+        }
+        if (slot != 0){
+            return;
+        }
+    }
+    int32_t index = m_heads[OVERFLOW];
+    m_heads[OVERFLOW] = -1;
+    while (index >= 0){
+        int32_t next = m_timers[index].next;
+        Place (index);
+        index = next;
+    }
+}
+
+uint64_t
+V2vTimerWheel::NextTick (void) const {
+    // the next non-empty level 0 slot of the current cycle
+    uint32_t slot = m_now & MASK;
+    if (slot + 1 < SLOTS && (m_occupied >> (slot + 1)) != 0){
+        return m_now + 1 + LowestBit (m_occupied >> (slot + 1));
+    }
+    if (m_occupied != 0){
+        return (m_now | MASK) + 1;
+    }
+
+    // otherwise the start of the next non-empty upper slot, the slots up
+    // to the current one belonging to the next cycle of their level
+    for (uint32_t level = 1; level < LEVELS; ++level){
+        uint32_t shift = SLOT_BITS*level;
+        slot = (m_now >> shift) & MASK;
+        for (uint32_t s = slot + 1; s < SLOTS; ++s){
+            if (m_heads[level*SLOTS + s] >= 0){
+                return ((m_now >> shift) + s - slot) << shift;
+            }
+        }
+        for (uint32_t s = 0; s <= slot; ++s){
+            if (m_heads[level*SLOTS + s] >= 0){
+                return ((m_now >> (shift + SLOT_BITS)) + 1) << (shift + SLOT_BITS);
+            }
+        }
+    }
+    return ((m_now >> (SLOT_BITS*LEVELS)) + 1) << (SLOT_BITS*LEVELS);
+}
+
+void
+V2vTimerWheel::Advance (Time now, std::vector<uint64_t> &expired){
+    int64_t steps = now.GetTimeStep ();
+    uint64_t target = TickOf (steps);
+
+    while (m_now < target){
+        // every deadline of a tick before the target has passed
+        int32_t index = m_heads[m_now & MASK];
+        while (index >= 0){
+            int32_t next = m_timers[index].next;
+            Release (index, expired);
+            index = next;
+        }
+        if (m_size == 0){
+            m_now = target;
+            return;
+        }
+        m_now = std::min (NextTick (), target);
+        if ((m_now & MASK) == 0){
+            Cascade ();
+        }
+    }
+
+    if (m_now == target){
+        int32_t index = m_heads[m_now & MASK];
+        while (index >= 0){
+            int32_t next = m_timers[index].next;
+            if (m_timers[index].deadline <= steps){
+                Release (index, expired);
+            }
+            index = next;
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_TIMER_WHEEL_H
+#define V2V_TIMER_WHEEL_H
+
+#include <vector>
+#include <stdint.h>
+#include "ns3/nstime.h"
+#include "v2v-neighbor-table.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vTimerWheel
+ * \brief Hierarchical timing wheel of expiry times keyed by a 64bit id.
+ *
+ * Time is cut in ticks of GetResolution (). The wheel has LEVELS levels
+ * of SLOTS slots; level l holds the deadlines due within SLOTS^(l+1)
+ * ticks, one slot per SLOTS^l ticks, and the deadlines further away wait
+ * in an overflow list. When the level 0 slots wrap around, the next slot
+ * of level 1 is spread over level 0 (and so on up), so every deadline is
+ * moved at most LEVELS times before it expires.
+ *
+ * Scheduling, rescheduling and cancelling a key are O(1). Advance visits
+ * the non-empty level 0 slots only, so it costs O(1) per expired key plus
+ * one step per SLOTS ticks, and returns at once when the wheel is empty.
+ */
+class V2vTimerWheel {
+public:
+
+    /**
+     * \param resolution the length of a tick
+     */
+    V2vTimerWheel (Time resolution = MilliSeconds (10));
+
+    /**
+     * \brief Change the tick length; the wheel must be empty.
+     * \param resolution the length of a tick
+     */
+    void SetResolution (Time resolution);
+
+    /**
+     * \return the length of a tick
+     */
+    Time GetResolution (void) const;
+
+    /**
+     * \brief Set the expiry time of a key, replacing its previous one.
+     *
+     * A deadline already reached expires at the next Advance.
+     *
+     * \param key the key
+     * \param deadline the expiry time
+     */
+    void Schedule (uint64_t key, Time deadline);
+
+    /**
+     * \param key the key to remove
+     * \return true if the key was scheduled
+     */
+    bool Cancel (uint64_t key);
+
+    /**
+     * \param key the key
+     * \return true if the key is scheduled
+     */
+    bool Contains (uint64_t key) const;
+
+    /**
+     * \param key the key
+     * \return the expiry time of the key, Time::Max () if not scheduled
+     */
+    Time GetDeadline (uint64_t key) const;
+
+    /**
+     * \brief Remove all the keys.
+     */
+    void Clear (void);
+
+    /**
+     * \return the number of scheduled keys
+     */
+    uint32_t GetSize (void) const;
+
+    /**
+     * \return true if no key is scheduled
+     */
+    bool IsEmpty (void) const;
+
+    /**
+     * \brief Remove the keys whose deadline is not after the given time.
+     *
+     * The keys are appended in tick order, in no particular order within
+     * a tick. The time must not go backwards between calls; an earlier
+     * time expires nothing.
+     *
+     * \param now the current time
+     * \param expired filled with the expired keys
+     */
+    void Advance (Time now, std::vector<uint64_t> &expired);
+
+private:
+
+    enum {
+        SLOT_BITS = 6,
+        SLOTS = 1 << SLOT_BITS,
+        MASK = SLOTS - 1,
+        LEVELS = 4,
+        OVERFLOW = LEVELS*SLOTS
+    };
+
+    struct Timer {
+        uint64_t key;
+        int64_t deadline;       //!< expiry time in time steps
+        uint64_t tick;
+        int32_t prev;
+        int32_t next;
+        int32_t list;           //!< slot the timer is linked in
+    };
+
+    uint64_t TickOf (int64_t deadline) const;
+    void Place (int32_t index);
+    void Link (int32_t index, int32_t list);
+    void Unlink (int32_t index);
+    void Release (int32_t index, std::vector<uint64_t> &expired);
+    void Cascade (void);
+    uint64_t NextTick (void) const;
+
+    int64_t m_resolution;                   //!< tick length in time steps
+    uint64_t m_now;                         //!< current tick
+    uint32_t m_size;
+    std::vector<Timer> m_timers;            //!< timer pool
+    int32_t m_free;                         //!< first free timer of the pool
+    V2vFlatIndex m_index;                   //!< key -> timer
+    int32_t m_heads[OVERFLOW + 1];          //!< first timer of each slot and of the overflow list
+    uint64_t m_occupied;                    //!< non-empty level 0 slots
+};
+
+} // namespace ns3
+
+#endif // V2V_TIMER_WHEEL_H
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/trace-source-accessor.h"
+#include "v2v-cluster-header.h"
+#include "v2v-uplink-server.h"
+
+NS_LOG_COMPONENT_DEFINE ("V2vUplinkServer");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vUplinkServer);
+
+TypeId V2vUplinkServer::GetTypeId(void) {
+    static TypeId tid =
+            TypeId("ns3::V2vUplinkServer").SetParent<Application>()
+            .AddConstructor<V2vUplinkServer>()
+            .AddAttribute("Port",
+                    "The port the server listens to", UintegerValue(6000),
+                    MakeUintegerAccessor(&V2vUplinkServer::m_port),
+                    MakeUintegerChecker<uint16_t>())
+            .AddTraceSource("Rx", "A burst has been received",
+                    MakeTraceSourceAccessor(&V2vUplinkServer::m_rxTrace));
+    return tid;
+}
+
+V2vUplinkServer::V2vUplinkServer (){
+    NS_LOG_FUNCTION (this);
+    m_receivedPackets = 0;
+    m_receivedBytes = 0;
+    m_receivedReports = 0;
+}
+
+V2vUplinkServer::~V2vUplinkServer (){
+    NS_LOG_FUNCTION (this);
+}
+
+void
+V2vUplinkServer::DoDispose (void){
+    NS_LOG_FUNCTION (this);
+    m_socket = 0;
+    Application::DoDispose ();
+}
+
+uint64_t
+V2vUplinkServer::GetReceivedPackets (void) const {
+    return m_receivedPackets;
+}
+
+uint64_t
+V2vUplinkServer::GetReceivedBytes (void) const {
+    return m_receivedBytes;
+}
+
+uint64_t
+V2vUplinkServer::GetReceivedReports (void) const {
+    return m_receivedReports;
+}
+
+const V2vStatisticsAccumulator &
+V2vUplinkServer::GetLatency (void) const {
+    return m_latency;
+}
+
+void
+V2vUplinkServer::StartApplication (void){
+    NS_LOG_FUNCTION (this);
+
+    if(!m_socket){
+        m_socket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+        m_socket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_port));
+        m_socket->ShutdownSend ();
+    }
+    m_socket->SetRecvCallback (MakeCallback (&V2vUplinkServer::HandleRead, this));
+}
+
+void
+V2vUplinkServer::StopApplication (void){
+    NS_LOG_FUNCTION (this);
+
+    if(m_socket){
+        m_socket->Close ();
+        m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+        m_socket = 0;
+    }
+}
+
+void
+V2vUplinkServer::HandleRead (Ptr<Socket> socket){
+    NS_LOG_FUNCTION (this << socket);
+
+    Ptr<Packet> packet;
+    Address from;
+    while((packet = socket->RecvFrom (from))){
+        m_rxTrace (packet);
+        m_receivedPackets++;
+        m_receivedBytes += packet->GetSize ();
+
+        V2vGatewayAggregateHeader header;
+        packet->RemoveHeader (header);
+        const std::vector<V2vClusterSap::GatewayReport> &reports = header.GetReports ();
+        for(std::vector<V2vClusterSap::GatewayReport>::const_iterator it = reports.begin (); it != reports.end (); ++it){
+            m_latency.Add ((Simulator::Now () - it->ts).GetSeconds ());
+        }
+        m_receivedReports += reports.size ();
+        NS_LOG_LOGIC ("Burst of " << reports.size () << " reports from gateway " << header.GetGatewayId ());
+    }
+}
+
+} // namespace ns3
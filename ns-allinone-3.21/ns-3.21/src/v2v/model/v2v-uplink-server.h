@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef V2V_UPLINK_SERVER_H
+#define V2V_UPLINK_SERVER_H
+
+#include "ns3/ptr.h"
+#include "ns3/socket.h"
+#include "ns3/application.h"
+#include "ns3/traced-callback.h"
+#include "ns3/v2v-statistics-accumulator.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup v2v
+ * \class V2vUplinkServer
+ * \brief Remote end of the V2vClusterGateway uplink bursts.
+ *
+ * The server unpacks every burst and samples the end-to-end latency of
+ * each report it carries, from its generation at the vehicle to the
+ * reception of the burst.
+ */
+class V2vUplinkServer : public Application {
+public:
+
+    static TypeId GetTypeId (void);
+
+    V2vUplinkServer ();
+    virtual ~V2vUplinkServer ();
+
+    /**
+     * \return the bursts received
+     */
+    uint64_t GetReceivedPackets (void) const;
+
+    /**
+     * \return the bytes received, without the UDP/IP headers
+     */
+    uint64_t GetReceivedBytes (void) const;
+
+    /**
+     * \return the reports received
+     */
+    uint64_t GetReceivedReports (void) const;
+
+    /**
+     * \return the end-to-end latency of the received reports (s)
+     */
+    const V2vStatisticsAccumulator &GetLatency (void) const;
+
+protected:
+
+    virtual void DoDispose (void);
+
+private:
+
+    virtual void StartApplication (void);
+    virtual void StopApplication (void);
+
+    void HandleRead (Ptr<Socket> socket);
+
+    uint16_t m_port;
+    Ptr<Socket> m_socket;
+
+    uint64_t m_receivedPackets;
+    uint64_t m_receivedBytes;
+    uint64_t m_receivedReports;
+    V2vStatisticsAccumulator m_latency;
+
+    TracedCallback<Ptr<const Packet> > m_rxTrace;
+};
+
+} // namespace ns3
+
+#endif // V2V_UPLINK_SERVER_H
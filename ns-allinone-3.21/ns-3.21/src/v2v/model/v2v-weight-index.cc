@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#include "ns3/assert.h"
+#include "v2v-weight-index.h"
+
+namespace ns3 {
+
+V2vWeightIndex::V2vWeightIndex (Order order) :
+        m_order(order){
+}
+
+void
+V2vWeightIndex::SetOrder (Order order){
+    NS_ASSERT (m_heap.empty ());
+    m_order = order;
+}
+
+bool
+V2vWeightIndex::Precedes (const Item &a, const Item &b) const {
+    if(a.weight != b.weight){
+        return (m_order == HIGHEST_FIRST) ? (a.weight > b.weight) : (a.weight < b.weight);
+    }
+    return a.id < b.id;
+}
+
+void
+V2vWeightIndex::Place (uint32_t position, const Item &item){
+    m_heap[position] = item;
+    m_index.Insert (item.id, position);
+}
+
+void
+V2vWeightIndex::SiftUp (uint32_t position){
+    Item item = m_heap[position];
+    while(position > 0){
+        uint32_t parent = (position - 1)/2;
+        if(!Precedes (item, m_heap[parent])){
+            break;
+        }
+        Place (position, m_heap[parent]);
+        position = parent;
+    }
+    Place (position, item);
+}
+
+void
+V2vWeightIndex::SiftDown (uint32_t position){
+    Item item = m_heap[position];
+    uint32_t size = m_heap.size ();
+    while(true){
+        uint32_t child = 2*position + 1;
+        if(child >= size){
+            break;
+        }
+        if(child + 1 < size && Precedes (m_heap[child + 1], m_heap[child])){
+            child ++;
+        }
+        if(!Precedes (m_heap[child], item)){
+            break;
+        }
+        Place (position, m_heap[child]);
+        position = child;
+    }
+    Place (position, item);
+}
+
+void
+V2vWeightIndex::Update (uint64_t id, double weight){
+    uint32_t position;
+    if(!m_index.Find (id, position)){
+        Item item;
+        item.id = id;
+        item.weight = weight;
+        m_heap.push_back (item);
+        SiftUp (m_heap.size () - 1);
+        return;
+    }
+
+    double previous = m_heap[position].weight;
+    m_heap[position].weight = weight;
+    if(weight == previous){
+        return;
+    }
+    bool raised = (m_order == HIGHEST_FIRST) ? (weight > previous) : (weight < previous);
+    if(raised){
+        SiftUp (position);
+    }
+    else{
+        SiftDown (position);
+    }
+}
+
+bool
+V2vWeightIndex::Erase (uint64_t id){
+    uint32_t position;
+    if(!m_index.Find (id, position)){
+        return false;
+    }
+    m_index.Erase (id);
+
+    Item last = m_heap.back ();
+    m_heap.pop_back ();
+    if(position == m_heap.size ()){
+        return true;
+    }
+    //!< The last item fills the hole and moves whichever way it belongs
+    Place (position, last);
+    if(position > 0 && Precedes (last, m_heap[(position - 1)/2])){
+        SiftUp (position);
+    }
+    else{
+        SiftDown (position);
+    }
+    return true;
+}
+
+bool
+V2vWeightIndex::Contains (uint64_t id) const {
+    uint32_t position;
+    return m_index.Find (id, position);
+}
+
+uint64_t
+V2vWeightIndex::GetTop (void) const {
+    NS_ASSERT (!m_heap.empty ());
+    return m_heap[0].id;
+}
+
+double
+V2vWeightIndex::GetTopWeight (void) const {
+    NS_ASSERT (!m_heap.empty ());
+    return m_heap[0].weight;
+}
+
+void
+V2vWeightIndex::Clear (void){
+    m_heap.clear ();
+    m_index.Clear ();
+}
+
+uint32_t
+V2vWeightIndex::GetSize (void) const {
+    return m_heap.size ();
+}
+
+bool
+V2vWeightIndex::IsEmpty (void) const {
+    return m_heap.empty ();
+}
+
+} // namespace ns3
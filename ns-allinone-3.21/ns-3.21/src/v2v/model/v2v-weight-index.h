@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Athens (UOA)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
+ */
+
+#ifndef V2V_WEIGHT_INDEX_H
+#define V2V_WEIGHT_INDEX_H
+
+#include <vector>
+#include <stdint.h>
+#include "v2v-neighbor-table.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup v2v
+ * \class V2vWeightIndex
+ * \brief Indexed binary heap of weights keyed by a 64bit id.
+ *
+ * The top of the heap is the highest (or, with LOWEST_FIRST, the lowest)
+ * weight, ties going to the smallest id, so the best candidate is read
+ * in O(1). Setting, changing and removing the weight of an id are
+ * O(log n); a V2vFlatIndex keeps the heap position of every id.
+ */
+class V2vWeightIndex {
+public:
+
+    enum Order {
+        HIGHEST_FIRST = 0,
+        LOWEST_FIRST
+    };
+
+    /**
+     * \param order which weight is on top
+     */
+    V2vWeightIndex (Order order = HIGHEST_FIRST);
+
+    /**
+     * \brief Change which weight is on top; the index must be empty.
+     * \param order which weight is on top
+     */
+    void SetOrder (Order order);
+
+    /**
+     * \brief Set the weight of an id, replacing its previous one.
+     * \param id the id
+     * \param weight the weight
+     */
+    void Update (uint64_t id, double weight);
+
+    /**
+     * \param id the id to remove
+     * \return true if the id was present
+     */
+    bool Erase (uint64_t id);
+
+    /**
+     * \param id the id
+     * \return true if the id is present
+     */
+    bool Contains (uint64_t id) const;
+
+    /**
+     * \return the id on top; the index must not be empty
+     */
+    uint64_t GetTop (void) const;
+
+    /**
+     * \return the weight on top; the index must not be empty
+     */
+    double GetTopWeight (void) const;
+
+    /**
+     * \brief Remove all the ids.
+     */
+    void Clear (void);
+
+    /**
+     * \return the number of ids
+     */
+    uint32_t GetSize (void) const;
+
+    /**
+     * \return true if there is no id
+     */
+    bool IsEmpty (void) const;
+
+private:
+
+    struct Item {
+        uint64_t id;
+        double weight;
+    };
+
+    bool Precedes (const Item &a, const Item &b) const;
+    void Place (uint32_t position, const Item &item);
+    void SiftUp (uint32_t position);
+    void SiftDown (uint32_t position);
+
+    Order m_order;
+    std::vector<Item> m_heap;
+    V2vFlatIndex m_index;                   //!< id -> heap position
+};
+
+} // namespace ns3
+
+#endif // V2V_WEIGHT_INDEX_H
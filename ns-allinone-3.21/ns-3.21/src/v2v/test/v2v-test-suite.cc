@@ -18,21 +18,48 @@
  * Author:  - Lampros Katsikas <lkatsikas@di.uoa.gr>
  */
 
+#include <map>
 #include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <unistd.h>
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/abort.h"
 #include "ns3/config.h"
+#include "ns3/boolean.h"
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
 #include "ns3/simulator.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/object-factory.h"
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device.h"
+#include "ns3/simple-net-device-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/v2v-cluster-header.h"
+#include "ns3/v2v-neighbor-table.h"
+#include "ns3/v2v-slot-allocator.h"
+#include "ns3/v2v-timer-wheel.h"
+#include "ns3/v2v-weight-index.h"
+#include "ns3/v2v-fcd-trace-reader.h"
+#include "ns3/v2v-fcd-mobility-feed.h"
+#include "ns3/v2v-cluster-snapshot.h"
+#include "ns3/v2v-novel-update-codec.h"
+#include "ns3/v2v-affinity-propagation.h"
+#include "ns3/v2v-statistics-accumulator.h"
+#include "ns3/v2v-sweep-helper.h"
+#include "ns3/v2v-cluster-registry.h"
+#include "ns3/v2v-broadcast-helper.h"
+#include "ns3/v2v-broadcast-net-device.h"
+#include "ns3/v2v-cluster-gateway-helper.h"
+#include "ns3/v2v-channel-scheduler-helper.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/system-path.h"
 #include "ns3/v2v-novel-algorithm-client.h"
+#include "ns3/v2v-affinity-algorithm-client.h"
 #include "ns3/v2v-novel-algorithm-helper.h"
 
 #include "ns3/mobility-module.h"
@@ -246,6 +273,1724 @@ void V2vIncidentEventHeaderTestCase::DoRun(void) {
 }
 /*--------------------------------------------------------------------------*/
 
+/*--------------------------- V2vAffinityRespAvailHeader Testing ---------------------------*/
+class V2vAffinityRespAvailHeaderTestCase: public TestCase {
+public:
+    V2vAffinityRespAvailHeaderTestCase();
+    virtual ~V2vAffinityRespAvailHeaderTestCase();
+
+private:
+    virtual void DoRun(void);
+
+};
+
+V2vAffinityRespAvailHeaderTestCase::V2vAffinityRespAvailHeaderTestCase() :
+        TestCase("Check V2vAffinityRespAvailHeader class serialization-deserialization"){
+}
+
+V2vAffinityRespAvailHeaderTestCase::~V2vAffinityRespAvailHeaderTestCase() {
+}
+
+void V2vAffinityRespAvailHeaderTestCase::DoRun(void) {
+
+    std::vector<V2vClusterSap::AffinitySubStructure> respAvailList;
+    for (uint64_t id = 30; id > 0; id -= 3){
+        V2vClusterSap::AffinitySubStructure entry;
+        entry.id = id;
+        entry.resp = id * 0.5;
+        entry.avail = -(id * 0.25);
+        respAvailList.push_back (entry);
+    }
+
+    V2vClusterSap::AffinityRespAvail respAvailInfo;
+    respAvailInfo.id = 7;
+    respAvailInfo.CHcnvg = true;
+    respAvailInfo.neighboursNumber = respAvailList.size ();
+
+    V2vAffinityRespAvailHeader header;
+    header.SetRespAvailList (respAvailList);
+    header.SetRespAvailInfo (respAvailInfo);
+
+    Ptr<Packet> packet = Create<Packet> (0);
+    packet->AddHeader (header);
+
+    V2vAffinityRespAvailHeader received;
+    packet->RemoveHeader (received);
+    NS_TEST_ASSERT_MSG_EQ (received.GetRespAvailInfo ().id, 7, "Wrong sender id");
+    NS_TEST_ASSERT_MSG_EQ (received.GetRespAvailList ().size (), respAvailList.size (), "Wrong number of entries");
+    for (uint32_t j = 1; j < received.GetRespAvailList ().size (); ++j){
+        NS_TEST_ASSERT_MSG_LT (received.GetRespAvailList ()[j-1].id, received.GetRespAvailList ()[j].id, "Entries not sorted by id");
+    }
+
+    const V2vClusterSap::AffinitySubStructure *entry = received.FindRespAvail (12);
+    NS_TEST_ASSERT_MSG_NE (entry, 0, "Entry for id 12 not found");
+    NS_TEST_ASSERT_MSG_EQ_TOL (entry->resp, 6.0, 1e-12, "Wrong responsibility for id 12");
+    NS_TEST_ASSERT_MSG_EQ_TOL (entry->avail, -3.0, 1e-12, "Wrong availability for id 12");
+    NS_TEST_ASSERT_MSG_EQ (received.FindRespAvail (13), 0, "Found an entry for a missing id");
+    NS_TEST_ASSERT_MSG_EQ (received.FindRespAvail (31), 0, "Found an entry past the last id");
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vClusterTypeHeader Testing ---------------------------*/
+class V2vClusterTypeHeaderTestCase: public TestCase {
+public:
+    V2vClusterTypeHeaderTestCase();
+    virtual ~V2vClusterTypeHeaderTestCase();
+
+private:
+    virtual void DoRun(void);
+
+};
+
+V2vClusterTypeHeaderTestCase::V2vClusterTypeHeaderTestCase() :
+        TestCase("Check V2vClusterTypeHeader class serialization-deserialization"){
+}
+
+V2vClusterTypeHeaderTestCase::~V2vClusterTypeHeaderTestCase() {
+}
+
+void V2vClusterTypeHeaderTestCase::DoRun(void) {
+
+    V2vNovelMergeHeader mergeHeader;
+    mergeHeader.SetOldClusterId (3);
+    mergeHeader.SetNewClusterId (7);
+
+    Ptr<Packet> packet = Create<Packet> (0);
+    packet->AddHeader (mergeHeader);
+    packet->AddHeader (V2vClusterTypeHeader (V2vClusterSap::NOVEL_MERGE_MESSAGE));
+    NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), mergeHeader.GetSerializedSize () + 1, "Type header must take a single byte");
+
+    V2vClusterTypeHeader typeHeader;
+    packet->RemoveHeader (typeHeader);
+    NS_TEST_ASSERT_MSG_EQ (typeHeader.IsValid (), true, "Valid type expected");
+    NS_TEST_ASSERT_MSG_EQ (typeHeader.GetType (), V2vClusterSap::NOVEL_MERGE_MESSAGE, "Wrong message type");
+
+    V2vNovelMergeHeader received;
+    packet->RemoveHeader (received);
+    NS_TEST_ASSERT_MSG_EQ (received.GetOldClusterId (), 3, "Wrong old cluster id");
+    NS_TEST_ASSERT_MSG_EQ (received.GetNewClusterId (), 7, "Wrong new cluster id");
+
+    uint8_t unknown = V2vClusterSap::MESSAGE_TYPES;
+    packet = Create<Packet> (&unknown, 1);
+    packet->RemoveHeader (typeHeader);
+    NS_TEST_ASSERT_MSG_EQ (typeHeader.IsValid (), false, "Unknown type must be invalid");
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vNeighborTable Testing ---------------------------*/
+class V2vNeighborTableTestCase: public TestCase {
+public:
+    V2vNeighborTableTestCase();
+    virtual ~V2vNeighborTableTestCase();
+
+private:
+    virtual void DoRun(void);
+
+};
+
+V2vNeighborTableTestCase::V2vNeighborTableTestCase() :
+        TestCase("Check V2vNeighborTable id lookup, removal and range queries"){
+}
+
+V2vNeighborTableTestCase::~V2vNeighborTableTestCase() {
+}
+
+void V2vNeighborTableTestCase::DoRun(void) {
+
+    V2vNeighborTable<uint32_t> table (50.0);
+    for (uint32_t i = 1; i <= 200; ++i){
+        double vx = (i % 2 == 0) ? 20.0 : -20.0;
+        table.Insert (i, Vector (i*10.0, 0.0, 0.0), Vector (vx, 0.0, 0.0), i);
+    }
+    NS_TEST_ASSERT_MSG_EQ (table.GetSize (), 200, "Wrong number of records");
+    NS_TEST_ASSERT_MSG_EQ (*table.Find (77), 77, "Wrong record for id 77");
+
+    // re-insert moves the record to a new cell
+    table.Insert (77, Vector (5000.0, 0.0, 0.0), Vector (-20.0, 0.0, 0.0), 770);
+    NS_TEST_ASSERT_MSG_EQ (table.GetSize (), 200, "Re-insert must not add a record");
+    NS_TEST_ASSERT_MSG_EQ (*table.Find (77), 770, "Re-insert must replace the record");
+
+    std::vector<uint32_t> result;
+    table.FindInRange (Vector (1000.0, 0.0, 0.0), 25.0, result);
+    NS_TEST_ASSERT_MSG_EQ (result.size (), 5, "Wrong number of records in range");
+
+    table.FindInRange (Vector (1000.0, 0.0, 0.0), 25.0, Vector (10.0, 0.0, 0.0), result);
+    NS_TEST_ASSERT_MSG_EQ (result.size (), 3, "Wrong number of same direction records in range");
+
+    table.FindInRange (Vector (5000.0, 0.0, 0.0), 1.0, result);
+    NS_TEST_ASSERT_MSG_EQ (result.size (), 1, "Moved record not found in its new cell");
+    NS_TEST_ASSERT_MSG_EQ (table.GetEntry (result[0]).id, 77, "Wrong moved record");
+
+    // purge the odd ids while iterating
+    for (V2vNeighborTable<uint32_t>::Iterator it = table.Begin (); it != table.End ();){
+        if (it->id % 2 == 1){
+            it = table.Erase (it);
+        }
+        else{
+            ++it;
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ (table.GetSize (), 100, "Wrong number of records after purge");
+    NS_TEST_ASSERT_MSG_EQ (table.Contains (77), false, "Purged record still present");
+    NS_TEST_ASSERT_MSG_EQ (*table.Find (100), 100, "Wrong record for id 100 after purge");
+
+    table.FindInRange (Vector (1000.0, 0.0, 0.0), 25.0, result);
+    NS_TEST_ASSERT_MSG_EQ (result.size (), 3, "Wrong number of records in range after purge");
+
+    table.SetCellSize (10.0);
+    table.FindInRange (Vector (1000.0, 0.0, 0.0), 25.0, result);
+    NS_TEST_ASSERT_MSG_EQ (result.size (), 3, "Wrong number of records in range after regrid");
+
+    // the purge swapped records out of the id order
+    table.FindInRange (Vector (1000.0, 0.0, 0.0), 1000.0, result);
+    table.SortById (result);
+    NS_TEST_ASSERT_MSG_EQ (result.size (), 100, "Wrong number of records in the wide range");
+    for (uint32_t k = 1; k < result.size (); ++k){
+        NS_TEST_ASSERT_MSG_LT (table.GetEntry (result[k - 1]).id, table.GetEntry (result[k]).id, "Records not sorted by id");
+    }
+
+    // the id order index follows the inserts and the swapping erases
+    table.Insert (1, Vector (1010.0, 0.0, 0.0), Vector (), 1);
+    table.Erase (100);
+    const std::vector<uint32_t> &order = table.GetIdOrder ();
+    NS_TEST_ASSERT_MSG_EQ (order.size (), table.GetSize (), "Id order out of step with the records");
+    NS_TEST_ASSERT_MSG_EQ (table.GetEntry (order[0]).id, 1, "Inserted record not first in id order");
+    for (uint32_t k = 1; k < order.size (); ++k){
+        NS_TEST_ASSERT_MSG_LT (table.GetEntry (order[k - 1]).id, table.GetEntry (order[k]).id, "Id order not sorted");
+    }
+
+    // a few matches are sorted, most of the table is filtered in id order
+    table.FindInRangeById (Vector (1000.0, 0.0, 0.0), 25.0, result);
+    NS_TEST_ASSERT_MSG_EQ (result.size (), 3, "Wrong number of records in range by id");
+    NS_TEST_ASSERT_MSG_EQ (table.GetEntry (result[0]).id, 1, "Range by id not in id order");
+    table.FindInRangeById (Vector (1000.0, 0.0, 0.0), 1000.0, result);
+    NS_TEST_ASSERT_MSG_EQ (result.size (), 100, "Wrong number of records in the wide range by id");
+    for (uint32_t k = 1; k < result.size (); ++k){
+        NS_TEST_ASSERT_MSG_LT (table.GetEntry (result[k - 1]).id, table.GetEntry (result[k]).id, "Wide range by id not in id order");
+    }
+
+    table.Clear ();
+    NS_TEST_ASSERT_MSG_EQ (table.IsEmpty (), true, "Table not empty after clear");
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vAffinityAlgorithmClient Testing ---------------------------*/
+class V2vAffinityTieTestCase: public TestCase {
+public:
+    V2vAffinityTieTestCase();
+    virtual ~V2vAffinityTieTestCase();
+
+private:
+    virtual void DoRun(void);
+
+};
+
+V2vAffinityTieTestCase::V2vAffinityTieTestCase() :
+        TestCase("Check that the affinity CH election keeps the lowest id on a tie"){
+}
+
+V2vAffinityTieTestCase::~V2vAffinityTieTestCase() {
+}
+
+void V2vAffinityTieTestCase::DoRun(void) {
+
+    V2vNeighborTable<V2vClusterSap::AffinityNeighbors> table (100.0);
+    V2vClusterSap::AffinityNeighbors neighbor;
+    neighbor.responsibilitySent = 2.0;
+    neighbor.availabilityReceived = -1.0;
+    neighbor.CHcnvg = true;
+
+    // equal scores, inserted in reverse id order
+    table.Insert (9, Vector (10.0, 0.0, 0.0), Vector (), neighbor);
+    table.Insert (4, Vector (20.0, 0.0, 0.0), Vector (), neighbor);
+    neighbor.responsibilitySent = 0.5;
+    table.Insert (2, Vector (30.0, 0.0, 0.0), Vector (), neighbor);
+
+    std::vector<uint32_t> scan;
+    table.FindInRange (Vector (), 100.0, scan);
+    NS_TEST_ASSERT_MSG_EQ (V2vAffinityAlgorithmClient::FindBestNeighbor (table, scan, false), 4, "The tie must keep the lowest id");
+    NS_TEST_ASSERT_MSG_EQ (V2vAffinityAlgorithmClient::FindBestNeighbor (table, table.GetIdOrder (), true), 4, "The tie must keep the lowest id");
+
+    table.Find (4)->CHcnvg = false;
+    NS_TEST_ASSERT_MSG_EQ (V2vAffinityAlgorithmClient::FindBestNeighbor (table, scan, true), 9, "Only the converged neighbors may be elected");
+    NS_TEST_ASSERT_MSG_EQ (V2vAffinityAlgorithmClient::FindBestNeighbor (table, scan, false), 4, "Every neighbor may be elected");
+
+    scan.clear ();
+    NS_TEST_ASSERT_MSG_EQ (V2vAffinityAlgorithmClient::FindBestNeighbor (table, scan, false), 0, "No neighbor to elect");
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vTimerWheel Testing ---------------------------*/
+class V2vTimerWheelTestCase: public TestCase {
+public:
+    V2vTimerWheelTestCase();
+    virtual ~V2vTimerWheelTestCase();
+
+private:
+    virtual void DoRun(void);
+
+};
+
+V2vTimerWheelTestCase::V2vTimerWheelTestCase() :
+        TestCase("Check V2vTimerWheel expiries against a full scan"){
+}
+
+V2vTimerWheelTestCase::~V2vTimerWheelTestCase() {
+}
+
+void V2vTimerWheelTestCase::DoRun(void) {
+
+    V2vTimerWheel wheel (MilliSeconds (10));
+    std::vector<uint64_t> expired;
+
+    wheel.Schedule (1, Seconds (1.5));
+    wheel.Schedule (2, Seconds (1.505));
+    wheel.Schedule (3, Seconds (2.0));
+    wheel.Advance (Seconds (1.0), expired);
+    NS_TEST_ASSERT_MSG_EQ (expired.size (), 0, "Nothing expires before the first deadline");
+    wheel.Advance (Seconds (1.5), expired);
+    NS_TEST_ASSERT_MSG_EQ (expired.size (), 1, "Only the deadline reached expires within a tick");
+    NS_TEST_ASSERT_MSG_EQ (expired[0], 1, "Wrong expired key");
+    wheel.Schedule (3, Seconds (3.0));
+    NS_TEST_ASSERT_MSG_EQ (wheel.GetDeadline (3), Seconds (3.0), "Reschedule must replace the deadline");
+    NS_TEST_ASSERT_MSG_EQ (wheel.Cancel (2), true, "Cancel of a scheduled key");
+    NS_TEST_ASSERT_MSG_EQ (wheel.Cancel (2), false, "Cancel of a removed key");
+    expired.clear ();
+    wheel.Advance (Seconds (2.5), expired);
+    NS_TEST_ASSERT_MSG_EQ (expired.size (), 0, "Rescheduled or cancelled keys must not expire");
+    wheel.Schedule (4, Seconds (1.0));
+    wheel.Advance (Seconds (3.0), expired);
+    NS_TEST_ASSERT_MSG_EQ (expired.size (), 2, "Past deadlines expire at the next advance");
+    NS_TEST_ASSERT_MSG_EQ (wheel.IsEmpty (), true, "Wheel not empty");
+
+    // random deadlines up to beyond the last level, against a full scan
+    std::map<uint64_t, Time> deadlines;
+    uint64_t seed = 12345;
+    Time now = Seconds (3.0);
+    for (uint32_t round = 0; round < 400; ++round){
+        for (uint32_t k = 0; k < 20; ++k){
+            seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+            uint64_t key = (seed >> 33) % 300;
+            seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+            int64_t range = (k % 4 == 0) ? 400000000000000LL : 5000000000LL;
+            Time deadline = now + NanoSeconds ((int64_t)((seed >> 20) % range));
+            if (k % 7 == 0){
+                NS_TEST_ASSERT_MSG_EQ (wheel.Cancel (key), (deadlines.erase (key) == 1), "Cancel mismatch");
+            }
+            else{
+                wheel.Schedule (key, deadline);
+                deadlines[key] = deadline;
+            }
+        }
+        seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+        now += NanoSeconds ((int64_t)((seed >> 20) % ((round % 50 == 0) ? 50000000000000LL : 2000000000LL)));
+
+        expired.clear ();
+        wheel.Advance (now, expired);
+        std::vector<uint64_t> expected;
+        for (std::map<uint64_t, Time>::iterator it = deadlines.begin (); it != deadlines.end ();){
+            if (it->second <= now){
+                expected.push_back (it->first);
+                deadlines.erase (it++);
+            }
+            else{
+                ++it;
+            }
+        }
+        std::sort (expired.begin (), expired.end ());
+        NS_TEST_ASSERT_MSG_EQ (expired.size (), expected.size (), "Wrong number of expired keys at " << now);
+        NS_TEST_ASSERT_MSG_EQ ((expired == expected), true, "Wrong expired keys at " << now);
+        NS_TEST_ASSERT_MSG_EQ (wheel.GetSize (), deadlines.size (), "Wrong number of scheduled keys");
+    }
+
+    // erasing in SortForErase order matches an erasing scan
+    V2vNeighborTable<uint32_t> scanned;
+    for (uint32_t i = 0; i < 100; ++i){
+        scanned.Insert ((i*37) % 101, Vector (i, 0.0, 0.0), Vector (), i);
+    }
+    V2vNeighborTable<uint32_t> sorted = scanned;
+    std::vector<uint64_t> scanOrder;
+    std::vector<uint64_t> ids;
+    for (V2vNeighborTable<uint32_t>::Iterator it = scanned.Begin (); it != scanned.End ();){
+        if (it->id % 3 == 0 || it->id > 80){
+            scanOrder.push_back (it->id);
+            it = scanned.Erase (it);
+        }
+        else{
+            ++it;
+        }
+    }
+    for (uint64_t id = 0; id <= 100; ++id){
+        if (id % 3 == 0 || id > 80){
+            ids.push_back (id);
+        }
+    }
+    sorted.SortForErase (ids);
+    NS_TEST_ASSERT_MSG_EQ ((ids == scanOrder), true, "SortForErase differs from the scan order");
+    for (uint32_t i = 0; i < ids.size (); ++i){
+        sorted.Erase (ids[i]);
+    }
+    V2vNeighborTable<uint32_t>::Iterator a = scanned.Begin ();
+    V2vNeighborTable<uint32_t>::Iterator b = sorted.Begin ();
+    for (; a != scanned.End () && b != sorted.End (); ++a, ++b){
+        NS_TEST_ASSERT_MSG_EQ (a->id, b->id, "Storage order differs after the erasures");
+    }
+    NS_TEST_ASSERT_MSG_EQ (scanned.GetSize (), sorted.GetSize (), "Wrong number of records after the erasures");
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vAffinityPropagation Testing ---------------------------*/
+class V2vAffinityPropagationTestCase: public TestCase {
+public:
+    V2vAffinityPropagationTestCase();
+    virtual ~V2vAffinityPropagationTestCase();
+
+private:
+    virtual void DoRun(void);
+
+};
+
+V2vAffinityPropagationTestCase::V2vAffinityPropagationTestCase() :
+        TestCase("Check V2vAffinityPropagation against the pairwise update"){
+}
+
+V2vAffinityPropagationTestCase::~V2vAffinityPropagationTestCase() {
+}
+
+void V2vAffinityPropagationTestCase::DoRun(void) {
+
+    const uint32_t n = 40;
+    const double lamda = 0.5;
+    double s[n], aR[n], rR[n], rS[n], aS[n];
+    V2vAffinityPropagation propagation;
+    for (uint32_t i = 0; i < n; ++i){
+        s[i] = -((i * 37) % 101);
+        aR[i] = -((i * 13) % 7) * 0.5;
+        rR[i] = ((i * 29) % 11) - 5.0;
+        rS[i] = i * 0.25;
+        aS[i] = -(i * 0.5);
+        propagation.Add (s[i], aR[i], rR[i], rS[i], aS[i]);
+    }
+    NS_TEST_ASSERT_MSG_EQ (propagation.GetSize (), n, "Wrong number of neighbors");
+
+    double selfResp = 1.0;
+    double selfAvail = 2.0;
+    propagation.Update (lamda, -50.0, selfResp, selfAvail);
+
+    // reference: the pairwise loop of V2vAffinityAlgorithmClient
+    double maxResp = -1e100;
+    double sumAvail = 0.0;
+    for (uint32_t i = 0; i < n; ++i){
+        maxResp = std::max (maxResp, s[i] + aR[i]);
+        sumAvail += std::max (0.0, rR[i]);
+    }
+    NS_TEST_ASSERT_MSG_EQ_TOL (selfResp, ((1-lamda)*(-50.0 - maxResp)) + lamda*1.0, 1e-9, "Wrong self responsibility");
+    NS_TEST_ASSERT_MSG_EQ_TOL (selfAvail, ((1-lamda)*sumAvail) + lamda*2.0, 1e-9, "Wrong self availability");
+
+    for (uint32_t i = 0; i < n; ++i){
+        maxResp = -1e100;
+        sumAvail = 0.0;
+        for (uint32_t j = 0; j < n; ++j){
+            if (i != j){
+                maxResp = std::max (maxResp, s[j] + aR[j]);
+                sumAvail += std::max (0.0, rR[j]);
+            }
+        }
+        maxResp = std::max (maxResp, s[i] + aR[i]);
+        double resp = ((1-lamda)*(s[i] - maxResp)) + (lamda*rS[i]);
+        double avail = (1-lamda)*std::min (0.0, rR[i] + sumAvail) + (lamda*aS[i]);
+        NS_TEST_ASSERT_MSG_EQ_TOL (propagation.GetResponsibilitySent (i), resp, 1e-9, "Wrong responsibility for neighbor " << i);
+        NS_TEST_ASSERT_MSG_EQ_TOL (propagation.GetAvailabilitySent (i), avail, 1e-9, "Wrong availability for neighbor " << i);
+    }
+
+    propagation.Clear ();
+    NS_TEST_ASSERT_MSG_EQ (propagation.GetSize (), 0, "Kernel not empty after clear");
+    propagation.Update (lamda, -50.0, selfResp, selfAvail);
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vStatisticsAccumulator Testing ---------------------------*/
+class V2vStatisticsAccumulatorTestCase: public TestCase {
+public:
+    V2vStatisticsAccumulatorTestCase();
+    virtual ~V2vStatisticsAccumulatorTestCase();
+
+private:
+    virtual void DoRun(void);
+
+};
+
+V2vStatisticsAccumulatorTestCase::V2vStatisticsAccumulatorTestCase() :
+        TestCase("Check V2vStatisticsAccumulator moments and quantiles"){
+}
+
+V2vStatisticsAccumulatorTestCase::~V2vStatisticsAccumulatorTestCase() {
+}
+
+void V2vStatisticsAccumulatorTestCase::DoRun(void) {
+
+    V2vStatisticsAccumulator empty;
+    NS_TEST_ASSERT_MSG_EQ (empty.GetCount (), 0, "Wrong count without samples");
+    NS_TEST_ASSERT_MSG_EQ (empty.GetMean (), 0.0, "Wrong mean without samples");
+    NS_TEST_ASSERT_MSG_EQ (empty.GetQuantile (0.5), 0.0, "Wrong quantile without samples");
+
+    // exact while the distinct samples fit in the bins
+    V2vStatisticsAccumulator exact (16);
+    for (uint32_t i = 1; i <= 9; ++i){
+        exact.Add (i);
+    }
+    NS_TEST_ASSERT_MSG_EQ (exact.GetCount (), 9, "Wrong count");
+    NS_TEST_ASSERT_MSG_EQ_TOL (exact.GetMean (), 5.0, 1e-12, "Wrong mean");
+    NS_TEST_ASSERT_MSG_EQ_TOL (exact.GetVariance (), 7.5, 1e-12, "Wrong variance");
+    NS_TEST_ASSERT_MSG_EQ_TOL (exact.GetMin (), 1.0, 1e-12, "Wrong min");
+    NS_TEST_ASSERT_MSG_EQ_TOL (exact.GetMax (), 9.0, 1e-12, "Wrong max");
+    NS_TEST_ASSERT_MSG_EQ_TOL (exact.GetQuantile (0.5), 5.0, 1e-12, "Wrong median");
+    NS_TEST_ASSERT_MSG_EQ_TOL (exact.GetQuantile (0.25), 3.0, 1e-12, "Wrong first quartile");
+    NS_TEST_ASSERT_MSG_EQ_TOL (exact.GetQuantile (1.0), 9.0, 1e-12, "Wrong maximum quantile");
+
+    // bounded sketch of a long uniform stream, split over two accumulators
+    V2vStatisticsAccumulator first;
+    V2vStatisticsAccumulator second;
+    for (uint32_t i = 0; i < 10000; ++i){
+        double value = (i * 7919) % 10000;
+        if (i % 2 == 0){
+            first.Add (value);
+        }
+        else{
+            second.Add (value);
+        }
+    }
+    first.Merge (second);
+    NS_TEST_ASSERT_MSG_EQ (first.GetCount (), 10000, "Wrong merged count");
+    NS_TEST_ASSERT_MSG_EQ_TOL (first.GetMean (), 4999.5, 1e-6, "Wrong merged mean");
+    NS_TEST_ASSERT_MSG_EQ_TOL (first.GetStddev (), 2886.896, 1e-2, "Wrong merged standard deviation");
+    NS_TEST_ASSERT_MSG_EQ_TOL (first.GetMax (), 9999.0, 1e-12, "Wrong merged max");
+    NS_TEST_ASSERT_MSG_EQ_TOL (first.GetQuantile (0.5), 4999.5, 100.0, "Median off by more than 1%");
+    NS_TEST_ASSERT_MSG_EQ_TOL (first.GetQuantile (0.95), 9499.0, 100.0, "95th percentile off by more than 1%");
+
+    first.Reset ();
+    NS_TEST_ASSERT_MSG_EQ (first.GetCount (), 0, "Samples left after reset");
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vClusterRegistry Testing ---------------------------*/
+class V2vClusterRegistryTestCase: public TestCase {
+public:
+    V2vClusterRegistryTestCase();
+    virtual ~V2vClusterRegistryTestCase();
+
+private:
+    virtual void DoRun(void);
+
+};
+
+V2vClusterRegistryTestCase::V2vClusterRegistryTestCase() :
+        TestCase("Check V2vClusterRegistry census and sampled counters"){
+}
+
+V2vClusterRegistryTestCase::~V2vClusterRegistryTestCase() {
+}
+
+void V2vClusterRegistryTestCase::DoRun(void) {
+
+    // the registry is process-wide, so only check the changes made here
+    V2vClusterRegistry *registry = V2vClusterRegistry::Get ();
+    NS_TEST_ASSERT_MSG_EQ ((registry == V2vClusterRegistry::Get ()), true, "Registry is not a singleton");
+
+    uint32_t nodes = registry->GetNodes ();
+    uint32_t heads = registry->GetNodes (V2vClusterSap::CH);
+    uint32_t members = registry->GetNodes (V2vClusterSap::CM);
+    uint32_t standalones = registry->GetNodes (V2vClusterSap::STANDALONE);
+
+    registry->Register (V2vClusterSap::STANDALONE);
+    registry->Register (V2vClusterSap::STANDALONE);
+    registry->Register (V2vClusterSap::CH);
+    NS_TEST_ASSERT_MSG_EQ (registry->GetNodes (), nodes + 3, "Wrong number of registered nodes");
+    NS_TEST_ASSERT_MSG_EQ (registry->GetNodes (V2vClusterSap::STANDALONE), standalones + 2, "Wrong number of standalones");
+
+    registry->NotifyRoleChange (V2vClusterSap::STANDALONE, V2vClusterSap::CM);
+    registry->NotifyRoleChange (V2vClusterSap::STANDALONE, V2vClusterSap::CH);
+    NS_TEST_ASSERT_MSG_EQ (registry->GetNodes (V2vClusterSap::CH), heads + 2, "Wrong number of cluster heads");
+    NS_TEST_ASSERT_MSG_EQ (registry->GetNodes (V2vClusterSap::CM), members + 1, "Wrong number of cluster members");
+    NS_TEST_ASSERT_MSG_EQ (registry->GetNodes (V2vClusterSap::STANDALONE), standalones, "Wrong number of standalones");
+
+    registry->Unregister (V2vClusterSap::CH);
+    registry->Unregister (V2vClusterSap::CH);
+    registry->Unregister (V2vClusterSap::CM);
+    NS_TEST_ASSERT_MSG_EQ (registry->GetNodes (), nodes, "Nodes left after unregistering");
+
+    registry->GetNumberOfMessagesPerSecond ();
+    registry->GetClusterChangesPerSecond ();
+    uint64_t messages = registry->GetNumberOfMessages ();
+    for (uint32_t i = 0; i < 5; ++i){
+        registry->NotifyMessageSent ();
+    }
+    registry->NotifyClusterChange ();
+    NS_TEST_ASSERT_MSG_EQ (registry->GetNumberOfMessages (), messages + 5, "Wrong cumulative messages");
+    NS_TEST_ASSERT_MSG_EQ (registry->GetNumberOfMessagesPerSecond (), 5, "Wrong sampled messages");
+    NS_TEST_ASSERT_MSG_EQ (registry->GetNumberOfMessagesPerSecond (), 0, "Sampled messages not reset");
+    NS_TEST_ASSERT_MSG_EQ (registry->GetClusterChangesPerSecond (), 1, "Wrong sampled cluster changes");
+    NS_TEST_ASSERT_MSG_EQ (registry->GetClusterChangesPerSecond (), 0, "Sampled cluster changes not reset");
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vBroadcastChannel Testing ---------------------------*/
+class V2vBroadcastChannelTestCase: public TestCase {
+public:
+    V2vBroadcastChannelTestCase();
+    virtual ~V2vBroadcastChannelTestCase();
+
+private:
+    virtual void DoRun(void);
+    bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+    std::vector<uint32_t> m_received;   //!< frames received per node id
+};
+
+V2vBroadcastChannelTestCase::V2vBroadcastChannelTestCase() :
+        TestCase("Check V2vBroadcastChannel range, loss and delay"){
+}
+
+V2vBroadcastChannelTestCase::~V2vBroadcastChannelTestCase() {
+}
+
+bool V2vBroadcastChannelTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from) {
+    m_received[device->GetNode ()->GetId ()]++;
+    NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MicroSeconds (1100), "Wrong delivery time");
+    return true;
+}
+
+void V2vBroadcastChannelTestCase::DoRun(void) {
+
+    // nodes on a line at 0, 400, 900 and 1600 m
+    NodeContainer nodes;
+    nodes.Create (4);
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+    positions->Add (Vector (0.0, 0.0, 0.0));
+    positions->Add (Vector (400.0, 0.0, 0.0));
+    positions->Add (Vector (900.0, 0.0, 0.0));
+    positions->Add (Vector (1600.0, 0.0, 0.0));
+    mobility.SetPositionAllocator (positions);
+    mobility.Install (nodes);
+
+    V2vBroadcastHelper broadcast;
+    broadcast.SetChannelAttribute ("Range", DoubleValue (500.0));
+    broadcast.SetChannelAttribute ("Delay", TimeValue (MicroSeconds (100)));
+    broadcast.SetChannelAttribute ("DataRate", DataRateValue (DataRate ("8Mbps")));
+    NetDeviceContainer devices = broadcast.Install (nodes);
+    m_received.assign (nodes.GetN () + nodes.Get (0)->GetId (), 0);
+    for (uint32_t i = 0; i < devices.GetN (); ++i){
+        devices.Get (i)->SetReceiveCallback (MakeCallback (&V2vBroadcastChannelTestCase::Receive, this));
+    }
+
+    // 1000 bytes at 8Mbps take 1ms on top of the delay
+    devices.Get (1)->Send (Create<Packet> (1000), devices.Get (1)->GetBroadcast (), 0x0800);
+    Simulator::Run ();
+    NS_TEST_ASSERT_MSG_EQ (m_received[nodes.Get (0)->GetId ()], 1, "Node in range missed the frame");
+    NS_TEST_ASSERT_MSG_EQ (m_received[nodes.Get (1)->GetId ()], 0, "Sender received its own frame");
+    NS_TEST_ASSERT_MSG_EQ (m_received[nodes.Get (2)->GetId ()], 1, "Node in range missed the frame");
+    NS_TEST_ASSERT_MSG_EQ (m_received[nodes.Get (3)->GetId ()], 0, "Node out of range received the frame");
+
+    Ptr<V2vBroadcastChannel> channel = DynamicCast<V2vBroadcastChannel> (devices.Get (0)->GetChannel ());
+    channel->SetAttribute ("LossProbability", DoubleValue (1.0));
+    devices.Get (1)->Send (Create<Packet> (1000), devices.Get (1)->GetBroadcast (), 0x0800);
+    Simulator::Run ();
+    NS_TEST_ASSERT_MSG_EQ (m_received[nodes.Get (0)->GetId ()], 1, "Lost frame was delivered");
+
+    // the link budget of the "High" range of the examples
+    channel->SetAttribute ("ReceptionModel", StringValue ("LogDistance"));
+    channel->SetAttribute ("TxPower", DoubleValue (32.0));
+    channel->SetAttribute ("TxGain", DoubleValue (12.0));
+    channel->SetAttribute ("RxGain", DoubleValue (12.0));
+    channel->SetAttribute ("RxSensitivity", DoubleValue (-71.8));
+    NS_TEST_ASSERT_MSG_EQ_TOL (channel->GetRange (), 505.9, 0.1, "Wrong log-distance range");
+
+    Simulator::Destroy ();
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vBroadcastChannel Partition Testing ---------------------------*/
+/**
+ * Run moving nodes of two system ids on a V2vBroadcastChannel with the
+ * DefaultSimulatorImpl and the MultithreadedSimulatorImpl, and compare the
+ * receptions of every node, in their order. Without loss, they are also
+ * those of the same nodes with a single system id.
+ */
+class V2vBroadcastChannelPartitionTestCase: public TestCase {
+public:
+    V2vBroadcastChannelPartitionTestCase();
+    virtual ~V2vBroadcastChannelPartitionTestCase();
+
+private:
+    typedef std::vector<std::pair<int64_t, uint32_t> > Receptions;
+
+    virtual void DoRun(void);
+    void RunLine (std::string simulatorType, uint32_t partitions, double lossProbability);
+    void Send (Ptr<NetDevice> device, uint32_t size);
+    bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+    // receptions of every node, each only written by the thread of its node
+    std::vector<Receptions> m_receptions;
+    uint32_t m_firstNode;
+};
+
+V2vBroadcastChannelPartitionTestCase::V2vBroadcastChannelPartitionTestCase() :
+        TestCase("Check V2vBroadcastChannel across the partitions of the MultithreadedSimulatorImpl"){
+}
+
+V2vBroadcastChannelPartitionTestCase::~V2vBroadcastChannelPartitionTestCase() {
+}
+
+void V2vBroadcastChannelPartitionTestCase::Send (Ptr<NetDevice> device, uint32_t size) {
+    device->Send (Create<Packet> (size), device->GetBroadcast (), 0x0800);
+}
+
+bool V2vBroadcastChannelPartitionTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from) {
+    m_receptions[device->GetNode ()->GetId () - m_firstNode].push_back (std::make_pair (Simulator::Now ().GetTimeStep (), packet->GetSize ()));
+    return true;
+}
+
+void V2vBroadcastChannelPartitionTestCase::RunLine (std::string simulatorType, uint32_t partitions, double lossProbability) {
+    const uint32_t n = 6;
+    ObjectFactory factory;
+    factory.SetTypeId (simulatorType);
+    Simulator::SetImplementation (factory.Create<SimulatorImpl> ());
+
+    // every 300 m on a line, the system ids alternating, some nodes
+    // driving in and out of the range of the others
+    NodeContainer nodes;
+    for (uint32_t i = 0; i < n; ++i){
+        Ptr<Node> node = CreateObject<Node> (i % partitions);
+        Ptr<ConstantVelocityMobilityModel> mobility = CreateObject<ConstantVelocityMobilityModel> ();
+        mobility->SetPosition (Vector (300.0 * i, 0.0, 0.0));
+        mobility->SetVelocity (Vector (i % 3 == 0 ? 30.0 : -20.0 * (i % 3), 0.0, 0.0));
+        node->AggregateObject (mobility);
+        nodes.Add (node);
+    }
+    m_firstNode = nodes.Get (0)->GetId ();
+
+    V2vBroadcastHelper broadcast;
+    broadcast.SetChannelAttribute ("Range", DoubleValue (500.0));
+    broadcast.SetChannelAttribute ("Delay", TimeValue (MicroSeconds (50)));
+    broadcast.SetChannelAttribute ("LossProbability", DoubleValue (lossProbability));
+    NetDeviceContainer devices = broadcast.Install (nodes);
+    Ptr<V2vBroadcastChannel> channel = DynamicCast<V2vBroadcastChannel> (devices.Get (0)->GetChannel ());
+    NS_TEST_ASSERT_MSG_EQ (channel->AssignStreams (10), partitions, "One loss stream per system id");
+
+    m_receptions.assign (n, Receptions ());
+    for (uint32_t i = 0; i < n; ++i){
+        devices.Get (i)->SetReceiveCallback (MakeCallback (&V2vBroadcastChannelPartitionTestCase::Receive, this));
+        for (uint32_t k = 0; k < 50; ++k){
+            Simulator::ScheduleWithContext (nodes.Get (i)->GetId (), Seconds (1.0) + MilliSeconds (100 * k) + MicroSeconds (700 * i),
+                                            &V2vBroadcastChannelPartitionTestCase::Send, this, devices.Get (i), 100 + 10 * i + k);
+        }
+    }
+
+    Simulator::Stop (Seconds (7.0));
+    Simulator::Run ();
+    Simulator::Destroy ();
+}
+
+void V2vBroadcastChannelPartitionTestCase::DoRun(void) {
+    TypeId tid;
+    if (!TypeId::LookupByNameFailSafe ("ns3::MultithreadedSimulatorImpl", &tid)){
+        // built without threading
+        return;
+    }
+
+    RunLine ("ns3::DefaultSimulatorImpl", 1, 0.0);
+    std::vector<Receptions> expected = m_receptions;
+    RunLine ("ns3::DefaultSimulatorImpl", 2, 0.0);
+    std::vector<Receptions> partitioned = m_receptions;
+    RunLine ("ns3::MultithreadedSimulatorImpl", 2, 0.0);
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < expected.size (); ++i){
+        total += expected[i].size ();
+        NS_TEST_ASSERT_MSG_EQ ((partitioned[i] == expected[i]), true, "Receptions of node " << i << " with two system ids");
+        NS_TEST_ASSERT_MSG_EQ ((m_receptions[i] == expected[i]), true, "Receptions of node " << i << " with two partitions");
+    }
+    // the nodes hear their neighbours at 300 m, but never all the others
+    NS_TEST_ASSERT_MSG_GT (total, 300, "Too few receptions");
+    NS_TEST_ASSERT_MSG_LT (total, 6 * 5 * 50, "Nodes out of range received frames");
+
+    RunLine ("ns3::DefaultSimulatorImpl", 2, 0.3);
+    expected = m_receptions;
+    RunLine ("ns3::MultithreadedSimulatorImpl", 2, 0.3);
+    uint32_t received = 0;
+    for (uint32_t i = 0; i < expected.size (); ++i){
+        received += expected[i].size ();
+        NS_TEST_ASSERT_MSG_EQ ((m_receptions[i] == expected[i]), true, "Receptions of node " << i << " with loss");
+    }
+    NS_TEST_ASSERT_MSG_LT (received, total, "No frame lost");
+    NS_TEST_ASSERT_MSG_GT (received, total / 2, "Too many frames lost");
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vMobilityModel Testing ---------------------------*/
+class V2vMobilityModelTestCase: public TestCase {
+public:
+    V2vMobilityModelTestCase();
+    virtual ~V2vMobilityModelTestCase();
+
+private:
+    virtual void DoRun(void);
+    void CheckPosition (double x, double velocity);
+    void CourseChange (Ptr<const MobilityModel> model);
+
+    Ptr<MobilityModel> m_model;
+    uint32_t m_courseChanges;
+};
+
+V2vMobilityModelTestCase::V2vMobilityModelTestCase() :
+        TestCase("Check V2vMobilityModel analytic position and course changes"){
+}
+
+V2vMobilityModelTestCase::~V2vMobilityModelTestCase() {
+}
+
+void V2vMobilityModelTestCase::CheckPosition (double x, double velocity) {
+    NS_TEST_EXPECT_MSG_EQ_TOL (m_model->GetPosition ().x, x, 1e-6, "Wrong position at " << Simulator::Now ().GetSeconds ());
+    NS_TEST_EXPECT_MSG_EQ_TOL (m_model->GetPosition ().y, 5.0, 1e-9, "Vehicle left its lane");
+    NS_TEST_EXPECT_MSG_EQ_TOL (m_model->GetVelocity ().x, velocity, 1e-9, "Wrong velocity at " << Simulator::Now ().GetSeconds ());
+}
+
+void V2vMobilityModelTestCase::CourseChange (Ptr<const MobilityModel> model) {
+    m_courseChanges++;
+}
+
+void V2vMobilityModelTestCase::DoRun(void) {
+
+    // without variation every leg runs at 10 m/s plus the 0.01 m/s rounding
+    // of the variation draw along +x, reflecting on the bounds at 0 and 100 m
+    m_model = CreateObjectWithAttributes<V2vMobilityModel> (
+            "Mode", StringValue ("Time"),
+            "Time", StringValue ("10s"),
+            "Speed", StringValue ("ns3::ConstantRandomVariable[Constant=10.0]"),
+            "SpeedVariation", DoubleValue (0.0),
+            "Bounds", RectangleValue (Rectangle (0, 100, -10, 10)));
+    m_model->SetPosition (Vector (50.0, 5.0, 0.0));
+
+    Simulator::Schedule (Seconds (2.0), &V2vMobilityModelTestCase::CheckPosition, this, 70.02, 10.01);
+    Simulator::Schedule (Seconds (6.0), &V2vMobilityModelTestCase::CheckPosition, this, 89.94, -10.01);
+    Simulator::Schedule (Seconds (16.0), &V2vMobilityModelTestCase::CheckPosition, this, 90.04, -10.01);
+    Simulator::Run ();
+    NS_TEST_ASSERT_MSG_EQ (Simulator::GetEventCount (), 3, "The model scheduled events without CourseChange sinks");
+    Simulator::Destroy ();
+
+    // a sink is notified at the leg start, the reflection at 4.995s and the leg end at 10s
+    m_courseChanges = 0;
+    m_model->TraceConnectWithoutContext ("CourseChange", MakeCallback (&V2vMobilityModelTestCase::CourseChange, this));
+    m_model->SetPosition (Vector (50.0, 5.0, 0.0));
+    Simulator::Stop (Seconds (10.5));
+    Simulator::Run ();
+    NS_TEST_ASSERT_MSG_EQ (m_courseChanges, 3, "Wrong number of course changes");
+    Simulator::Destroy ();
+
+    // a restored leg keeps its velocity, reflecting at 0 m after 4s
+    DynamicCast<V2vMobilityModel> (m_model)->SetLeg (Vector (20.0, 5.0, 0.0), Vector (-5.0, 0.0, 0.0), Seconds (30.0));
+    NS_TEST_ASSERT_MSG_EQ (DynamicCast<V2vMobilityModel> (m_model)->GetLegEnd (), Seconds (30.0), "Wrong restored leg end");
+    Simulator::Schedule (Seconds (2.0), &V2vMobilityModelTestCase::CheckPosition, this, 10.0, -5.0);
+    Simulator::Schedule (Seconds (6.0), &V2vMobilityModelTestCase::CheckPosition, this, 10.0, 5.0);
+    Simulator::Stop (Seconds (7.0));
+    Simulator::Run ();
+    Simulator::Destroy ();
+    m_model = 0;
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vSweepHelper Testing ---------------------------*/
+class V2vSweepHelperTestCase: public TestCase {
+public:
+    V2vSweepHelperTestCase();
+    virtual ~V2vSweepHelperTestCase();
+
+private:
+    virtual void DoRun(void);
+
+};
+
+V2vSweepHelperTestCase::V2vSweepHelperTestCase() :
+        TestCase("Check V2vSweepHelper merging of the replication outputs"){
+}
+
+V2vSweepHelperTestCase::~V2vSweepHelperTestCase() {
+}
+
+void V2vSweepHelperTestCase::DoRun(void) {
+
+    std::string directory = CreateTempDirFilename ("v2v-sweep");
+    V2vSweepHelper sweep;
+    sweep.AddAlgorithm ("novel", "/bin/false");
+    sweep.AddScenario ("Scenario1", "/dev/null", 10);
+    sweep.AddRange ("High");
+    sweep.SetRuns (1, 4);
+    sweep.SetOutputDirectory (directory);
+
+    // fake the outputs of three replications, and of a fourth one which
+    // failed before writing all its outputs
+    for (uint32_t run = 1; run <= 4; ++run){
+        std::string runDirectory = sweep.GetRunDirectory ("novel", "Scenario1", "High", run);
+        SystemPath::MakeDirectories (runDirectory);
+        if (run == 4){
+            std::ofstream log (SystemPath::Append (runDirectory, "run.log").c_str ());
+            log << "Average Formation Delay: 100\n";
+            continue;
+        }
+        std::ofstream done (SystemPath::Append (runDirectory, "run.done").c_str ());
+        std::ofstream log (SystemPath::Append (runDirectory, "run.log").c_str ());
+        log << "/------------------------------\\\n";
+        log << "Average Formation Delay: " << run << "\n";
+        log << "Average number of members in clusters: nan\n";
+        std::ofstream series (SystemPath::Append (runDirectory, "NumberOfClusters[V2vNovelAlgorithmClientScenario1High].txt").c_str ());
+        series << "0.000e+00\t" << 2*run << "\n1.000e+00\t4\n";
+    }
+    sweep.Merge ();
+
+    std::ifstream results (sweep.GetResultsFile ().c_str ());
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline (results, line)){
+        lines.push_back (line);
+    }
+    NS_TEST_ASSERT_MSG_EQ (lines.size (), 4, "Wrong number of result lines");
+
+    double ci = V2vSweepHelper::GetConfidenceInterval (1.0, 3);
+    std::ostringstream expected;
+    expected << "novel\tScenario1\tHigh\tAverage Formation Delay\t-\t2\t" << ci << "\t3";
+    NS_TEST_ASSERT_MSG_EQ (lines[1], expected.str (), "Wrong scalar result");
+    expected.str ("");
+    expected << "novel\tScenario1\tHigh\tNumberOfClusters\t0\t4\t" << 2*ci << "\t3";
+    NS_TEST_ASSERT_MSG_EQ (lines[2], expected.str (), "Wrong series result");
+    NS_TEST_ASSERT_MSG_EQ (lines[3], "novel\tScenario1\tHigh\tNumberOfClusters\t1\t4\t0\t3", "Wrong constant series result");
+
+    // the same outputs with twice the formation delay under another name
+    sweep.AddAlgorithm ("novel-abstract", "/bin/false", "--channel=Abstract");
+    sweep.AddComparison ("novel", "novel-abstract");
+    for (uint32_t run = 1; run <= 3; ++run){
+        std::string runDirectory = sweep.GetRunDirectory ("novel-abstract", "Scenario1", "High", run);
+        SystemPath::MakeDirectories (runDirectory);
+        std::ofstream done (SystemPath::Append (runDirectory, "run.done").c_str ());
+        std::ofstream log (SystemPath::Append (runDirectory, "run.log").c_str ());
+        log << "Average Formation Delay: " << 2*run << "\n";
+        std::ofstream series (SystemPath::Append (runDirectory, "NumberOfClusters[V2vNovelAlgorithmClientScenario1High].txt").c_str ());
+        series << "0.000e+00\t" << 2*run << "\n1.000e+00\t4\n";
+    }
+    sweep.Merge ();
+
+    std::ifstream divergence (sweep.GetDivergenceFile ().c_str ());
+    lines.clear ();
+    while (std::getline (divergence, line)){
+        lines.push_back (line);
+    }
+    NS_TEST_ASSERT_MSG_EQ (lines.size (), 3, "Wrong number of divergence lines");
+    NS_TEST_ASSERT_MSG_EQ (lines[1], "novel\tnovel-abstract\tScenario1\tHigh\tAverage Formation Delay\t2\t4\t0.5", "Wrong scalar divergence");
+    NS_TEST_ASSERT_MSG_EQ (lines[2], "novel\tnovel-abstract\tScenario1\tHigh\tNumberOfClusters\t4\t4\t0", "Wrong series divergence");
+
+    NS_TEST_ASSERT_MSG_EQ_TOL (V2vSweepHelper::GetConfidenceInterval (2.0, 4), 3.182, 1e-9, "Wrong t quantile");
+    NS_TEST_ASSERT_MSG_EQ (V2vSweepHelper::GetConfidenceInterval (2.0, 1), 0.0, "Single run must have no interval");
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vClusterGateway Testing ---------------------------*/
+class V2vClusterGatewayTestCase: public TestCase {
+public:
+    V2vClusterGatewayTestCase();
+    virtual ~V2vClusterGatewayTestCase();
+
+private:
+    virtual void DoRun(void);
+    Ptr<V2vUplinkServer> Run (bool aggregation, uint64_t &uplinkPackets);
+
+    static V2vClusterSap::NovelNodeDegree GetRole (V2vClusterSap::NovelNodeDegree role);
+    static uint64_t GetClusterId (uint64_t clusterId);
+};
+
+V2vClusterGatewayTestCase::V2vClusterGatewayTestCase() :
+        TestCase("Check V2vClusterGateway aggregation of the member reports"){
+}
+
+V2vClusterGatewayTestCase::~V2vClusterGatewayTestCase() {
+}
+
+V2vClusterSap::NovelNodeDegree V2vClusterGatewayTestCase::GetRole (V2vClusterSap::NovelNodeDegree role) {
+    return role;
+}
+
+uint64_t V2vClusterGatewayTestCase::GetClusterId (uint64_t clusterId) {
+    return clusterId;
+}
+
+Ptr<V2vUplinkServer> V2vClusterGatewayTestCase::Run (bool aggregation, uint64_t &uplinkPackets) {
+
+    // a cluster head and two members on a broadcast channel, all of them
+    // and the server on a shared uplink; the server takes node id 0,
+    // which stands for no cluster head
+    NodeContainer server;
+    server.Create (1);
+    NodeContainer vehicles;
+    vehicles.Create (3);
+    MobilityHelper mobility;
+    mobility.Install (vehicles);
+
+    V2vBroadcastHelper broadcast;
+    NetDeviceContainer waveDevices = broadcast.Install (vehicles);
+    SimpleNetDeviceHelper simple;
+    NetDeviceContainer uplinkDevices = simple.Install (NodeContainer (vehicles, server));
+
+    InternetStackHelper internet;
+    internet.Install (vehicles);
+    internet.Install (server);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase ("10.1.0.0", "255.255.0.0");
+    ipv4.Assign (waveDevices);
+    ipv4.SetBase ("7.0.0.0", "255.0.0.0");
+    Ipv4InterfaceContainer uplinkInterfaces = ipv4.Assign (uplinkDevices);
+
+    V2vUplinkServerHelper serverHelper (6000);
+    ApplicationContainer serverApps = serverHelper.Install (server);
+
+    V2vClusterGatewayHelper gatewayHelper (InetSocketAddress (Ipv4Address ("10.1.255.255"), 5000),
+                                           InetSocketAddress (uplinkInterfaces.GetAddress (3), 6000));
+    gatewayHelper.SetAttribute ("Aggregation", BooleanValue (aggregation));
+    gatewayHelper.SetAttribute ("AggregationInterval", TimeValue (Seconds (2.5)));
+    ApplicationContainer gateways = gatewayHelper.Install (vehicles);
+    uint64_t chId = vehicles.Get (0)->GetId ();
+    for (uint32_t i = 0; i < gateways.GetN (); ++i){
+        V2vClusterSap::NovelNodeDegree role = i == 0 ? V2vClusterSap::CH : V2vClusterSap::CM;
+        DynamicCast<V2vClusterGateway> (gateways.Get (i))->SetClusterCallbacks (
+                MakeBoundCallback (&V2vClusterGatewayTestCase::GetRole, role),
+                MakeBoundCallback (&V2vClusterGatewayTestCase::GetClusterId, chId));
+    }
+
+    // reports at 0..9s, bursts at 2.5, 5 and 7.5s
+    gateways.Stop (Seconds (9.9));
+    Simulator::Stop (Seconds (11.0));
+    Simulator::Run ();
+
+    uplinkPackets = 0;
+    for (uint32_t i = 0; i < gateways.GetN (); ++i){
+        uplinkPackets += DynamicCast<V2vClusterGateway> (gateways.Get (i))->GetUplinkPackets ();
+    }
+    NS_TEST_EXPECT_MSG_EQ (DynamicCast<V2vClusterGateway> (gateways.Get (0))->GetRelayedReports (), (aggregation ? 20 : 0),
+                           "Wrong number of reports relayed by the cluster head");
+    Ptr<V2vUplinkServer> uplinkServer = DynamicCast<V2vUplinkServer> (serverApps.Get (0));
+    Simulator::Destroy ();
+    return uplinkServer;
+}
+
+void V2vClusterGatewayTestCase::DoRun(void) {
+
+    V2vGatewayAggregateHeader header;
+    header.SetGatewayId (7);
+    V2vClusterSap::GatewayReport report;
+    report.id = 3;
+    report.seq = 42;
+    report.size = 200;
+    report.ts = MilliSeconds (1500);
+    header.AddReport (report);
+    Ptr<Packet> packet = Create<Packet> ();
+    packet->AddHeader (header);
+    NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 10 + V2vGatewayAggregateHeader::GetEntrySize (), "Wrong burst header size");
+    V2vGatewayAggregateHeader received;
+    packet->RemoveHeader (received);
+    NS_TEST_ASSERT_MSG_EQ (received.GetGatewayId (), 7, "Wrong gateway id");
+    NS_TEST_ASSERT_MSG_EQ (received.GetReports ().size (), 1, "Wrong report count");
+    NS_TEST_ASSERT_MSG_EQ (received.GetReports ()[0].seq, 42, "Wrong report sequence");
+    NS_TEST_ASSERT_MSG_EQ (received.GetReports ()[0].ts, MilliSeconds (1500), "Wrong report time stamp");
+
+    uint64_t uplinkPackets;
+    Ptr<V2vUplinkServer> uplinkServer = Run (false, uplinkPackets);
+    NS_TEST_ASSERT_MSG_EQ (uplinkPackets, 30, "Every report should go alone over the uplink");
+    NS_TEST_ASSERT_MSG_EQ (uplinkServer->GetReceivedReports (), 30, "Lost reports without aggregation");
+    NS_TEST_ASSERT_MSG_LT (uplinkServer->GetLatency ().GetMax (), 0.01, "Direct reports should not wait");
+
+    uplinkServer = Run (true, uplinkPackets);
+    NS_TEST_ASSERT_MSG_EQ (uplinkPackets, 3, "The cluster head should send one burst per aggregation interval");
+    NS_TEST_ASSERT_MSG_EQ (uplinkServer->GetReceivedPackets (), 3, "Lost bursts");
+    NS_TEST_ASSERT_MSG_EQ (uplinkServer->GetReceivedReports (), 24, "Wrong number of aggregated reports");
+    NS_TEST_ASSERT_MSG_GT (uplinkServer->GetLatency ().GetMin (), 0.49, "Aggregated reports should wait for the burst");
+    NS_TEST_ASSERT_MSG_LT (uplinkServer->GetLatency ().GetMax (), 2.51, "Aggregated reports waited more than one interval");
+}
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- V2vClusterSnapshot Testing ---------------------------*/
+class V2vClusterSnapshotTestCase: public TestCase {
+public:
+    V2vClusterSnapshotTestCase();
+    virtual ~V2vClusterSnapshotTestCase();
+
+private:
+    virtual void DoRun(void);
+
+};
+
+V2vClusterSnapshotTestCase::V2vClusterSnapshotTestCase() :
+        TestCase("Check that a snapshot record restores the clustering state exactly"){
+}
+
+V2vClusterSnapshotTestCase::~V2vClusterSnapshotTestCase() {
+}
+
+static void
+V2vSnapshotDummyEvent (void){
+}
+
+void V2vClusterSnapshotTestCase::DoRun(void) {
+
+    V2vNeighborTable<V2vClusterSap::NovelNeighborInfo> table (50.0);
+    V2vTimerWheel expiry;
+    for(uint64_t id = 1; id <= 6; ++id){
+        V2vClusterSap::NovelNeighborInfo info;
+        info.ts = id * 1000;
+        info.id = id;
+        info.clusterId = id % 2;
+        info.tempClusterId = 0;
+        info.chMembers = id;
+        info.position = Vector (id / 3.0, -1.0 * id, 0.0);
+        info.velocity = Vector (20.0 / id, 0.1, 0.0);
+        info.direction = Vector (0.0, 0.0, 0.0);
+        info.degree = V2vClusterSap::CM;
+        table.Insert (id, info.position, info.velocity, info);
+        if(id != 4){
+            expiry.Schedule (id, Seconds (1.5) + NanoSeconds (id));
+        }
+    }
+    table.Erase (2);        // moves the last record, storage order is no longer the id order
+    expiry.Cancel (2);
+
+    V2vStatisticsAccumulator accumulator (4);
+    for(uint32_t i = 1; i <= 10; ++i){
+        accumulator.Add (1.0 / i);
+    }
+    Address address = InetSocketAddress (Ipv4Address ("10.1.2.3"), 80);
+
+    EventId event = Simulator::Schedule (Seconds (2.25), &V2vSnapshotDummyEvent);
+    std::stringstream record;
+    {
+        V2vSnapshotWriter writer (record);
+        writer.WriteTable ("neighborMap", table, &expiry);
+        writer.Write ("accumulator", accumulator);
+        writer.Write ("address", address);
+        writer.Write ("third", 1.0 / 3.0);
+        writer.WriteEvent ("event", event);
+        writer.WriteEvent ("noEvent", EventId ());
+    }
+    Simulator::Destroy ();
+
+    V2vNeighborTable<V2vClusterSap::NovelNeighborInfo> restored (50.0);
+    V2vTimerWheel restoredExpiry;
+    V2vStatisticsAccumulator restoredAccumulator;
+    Address restoredAddress;
+    double third;
+    V2vSnapshotReader reader (record);
+    reader.ReadTable ("neighborMap", restored, &restoredExpiry);
+    reader.Read ("accumulator", restoredAccumulator);
+    reader.Read ("address", restoredAddress);
+    reader.Read ("third", third);
+    Time delay = reader.ReadEvent ("event");
+    Time noDelay = reader.ReadEvent ("noEvent");
+
+    NS_TEST_ASSERT_MSG_EQ (restored.GetSize (), table.GetSize (), "Wrong number of restored records");
+    V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::ConstIterator it = table.Begin ();
+    V2vNeighborTable<V2vClusterSap::NovelNeighborInfo>::ConstIterator jt = restored.Begin ();
+    for(; it != table.End (); ++it, ++jt){
+        NS_TEST_ASSERT_MSG_EQ (jt->id, it->id, "Storage order must be restored");
+        NS_TEST_ASSERT_MSG_EQ (jt->value.ts, it->value.ts, "Wrong timestamp");
+        NS_TEST_ASSERT_MSG_EQ ((jt->value.position.x == it->value.position.x), true, "Positions must be restored exactly");
+        NS_TEST_ASSERT_MSG_EQ ((jt->value.velocity.x == it->value.velocity.x), true, "Velocities must be restored exactly");
+        NS_TEST_ASSERT_MSG_EQ (jt->value.degree, it->value.degree, "Wrong degree");
+        NS_TEST_ASSERT_MSG_EQ (restoredExpiry.Contains (jt->id), expiry.Contains (it->id), "Wrong expiry tracking");
+        if(expiry.Contains (it->id)){
+            NS_TEST_ASSERT_MSG_EQ (restoredExpiry.GetDeadline (jt->id), expiry.GetDeadline (it->id), "Wrong expiry time");
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ ((restored.Find (5) != 0), true, "Restored records must be found by id");
+
+    NS_TEST_ASSERT_MSG_EQ (restoredAccumulator.GetCount (), accumulator.GetCount (), "Wrong sample count");
+    NS_TEST_ASSERT_MSG_EQ ((restoredAccumulator.GetMean () == accumulator.GetMean ()), true, "Mean must be restored exactly");
+    NS_TEST_ASSERT_MSG_EQ ((restoredAccumulator.GetVariance () == accumulator.GetVariance ()), true, "Variance must be restored exactly");
+    NS_TEST_ASSERT_MSG_EQ ((restoredAccumulator.GetQuantile (0.9) == accumulator.GetQuantile (0.9)), true, "Quantiles must be restored exactly");
+    NS_TEST_ASSERT_MSG_EQ (restoredAccumulator.GetMaxBins (), accumulator.GetMaxBins (), "Wrong bin limit");
+    NS_TEST_ASSERT_MSG_EQ ((restoredAddress == address), true, "Wrong address");
+    NS_TEST_ASSERT_MSG_EQ ((third == 1.0 / 3.0), true, "Doubles must be restored exactly");
+    NS_TEST_ASSERT_MSG_EQ (delay, Seconds (2.25), "Wrong delay left of the pending event");
+    NS_TEST_ASSERT_MSG_EQ (noDelay.IsNegative (), true, "An expired event has no delay");
+}
+
+/*--------------------------- V2vNovelUpdateCodec Testing ---------------------------*/
+class V2vNovelUpdateCodecTestCase: public TestCase {
+public:
+    V2vNovelUpdateCodecTestCase();
+    virtual ~V2vNovelUpdateCodecTestCase();
+
+private:
+    virtual void DoRun(void);
+
+    Ptr<Packet> Send(const V2vClusterSap::NovelCompactUpdate &update);
+    V2vClusterSap::NovelCompactUpdate Receive(Ptr<Packet> packet);
+};
+
+V2vNovelUpdateCodecTestCase::V2vNovelUpdateCodecTestCase() :
+        TestCase("Check V2vNovelUpdateCodec key frames, deltas and V2vNovelCompactUpdateHeader"){
+}
+
+V2vNovelUpdateCodecTestCase::~V2vNovelUpdateCodecTestCase() {
+}
+
+Ptr<Packet> V2vNovelUpdateCodecTestCase::Send(const V2vClusterSap::NovelCompactUpdate &update) {
+
+    V2vNovelCompactUpdateHeader updateHeader;
+    updateHeader.SetCompactUpdate (update);
+    V2vClusterTypeHeader typeHeader (V2vClusterSap::NOVEL_UPDATE_MESSAGE);
+    typeHeader.SetCompact (true);
+
+    Ptr<Packet> packet = Create<Packet> (0);
+    packet->AddHeader (updateHeader);
+    packet->AddHeader (typeHeader);
+    return packet;
+}
+
+V2vClusterSap::NovelCompactUpdate V2vNovelUpdateCodecTestCase::Receive(Ptr<Packet> packet) {
+
+    V2vClusterTypeHeader typeHeader;
+    packet->RemoveHeader (typeHeader);
+    NS_TEST_EXPECT_MSG_EQ (typeHeader.IsCompact (), true, "Compact flag lost");
+    NS_TEST_EXPECT_MSG_EQ (typeHeader.GetType (), V2vClusterSap::NOVEL_UPDATE_MESSAGE, "Wrong message type");
+
+    V2vNovelCompactUpdateHeader updateHeader;
+    packet->RemoveHeader (updateHeader);
+    NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 0, "Compact header not fully read");
+    return updateHeader.GetCompactUpdate ();
+}
+
+void V2vNovelUpdateCodecTestCase::DoRun(void) {
+
+    V2vNovelUpdateCodec sender;
+    V2vNovelUpdateCodec receiver;
+    sender.SetKeyFrameInterval (3);
+
+    V2vClusterSap::NovelNeighborInfo info;
+    info.ts = Seconds (1.0).GetTimeStep ();
+    info.id = 12;
+    info.clusterId = 7;
+    info.tempClusterId = 7;
+    info.chMembers = 4;
+    info.position = Vector (1200.123, -35.004, 0.0);
+    info.velocity = Vector (20.5, -0.254, 0.0);
+    info.direction = Vector (0.0, 0.0, 0.0);
+    info.degree = V2vClusterSap::CM;
+
+    //!< First update is a key frame
+    Ptr<Packet> packet = Send (sender.Encode (info));
+    NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 50, "Wrong key frame size");
+    NS_TEST_ASSERT_MSG_LT (packet->GetSize (), 1 + sizeof(V2vClusterSap::NovelNeighborInfo), "Key frame not smaller than the full format");
+
+    V2vClusterSap::NovelNeighborInfo decoded;
+    NS_TEST_ASSERT_MSG_EQ (receiver.Decode (Receive (packet), decoded), true, "Key frame must decode");
+    NS_TEST_ASSERT_MSG_EQ (decoded.id, 12, "Wrong id");
+    NS_TEST_ASSERT_MSG_EQ (decoded.ts, info.ts, "Wrong key frame time stamp");
+    NS_TEST_ASSERT_MSG_EQ (decoded.clusterId, 7, "Wrong cluster id");
+    NS_TEST_ASSERT_MSG_EQ (decoded.chMembers, 4, "Wrong members");
+    NS_TEST_ASSERT_MSG_EQ (decoded.degree, V2vClusterSap::CM, "Wrong degree");
+    NS_TEST_ASSERT_MSG_EQ_TOL (decoded.position.x, 1200.12, 1e-9, "Position not quantized to the cm");
+    NS_TEST_ASSERT_MSG_EQ_TOL (decoded.position.y, -35.0, 1e-9, "Position not quantized to the cm");
+    NS_TEST_ASSERT_MSG_EQ_TOL (decoded.velocity.x, 20.5, 1e-9, "Wrong velocity");
+    NS_TEST_ASSERT_MSG_EQ_TOL (decoded.velocity.y, -0.25, 1e-9, "Velocity not quantized to the cm/s");
+
+    //!< Second update only carries the moved position
+    info.ts = Seconds (2.0).GetTimeStep ();
+    info.position.x += 20.5;
+    info.chMembers = 5;
+    packet = Send (sender.Encode (info));
+    NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 1 + 2 + 4 + 4 + 6 + 2, "Wrong delta size");
+    V2vClusterSap::NovelCompactUpdate delta = Receive (packet);
+    NS_TEST_ASSERT_MSG_EQ (receiver.Decode (delta, decoded), true, "Delta must decode");
+    NS_TEST_ASSERT_MSG_EQ (decoded.ts, info.ts, "Wrong delta time stamp");
+    NS_TEST_ASSERT_MSG_EQ_TOL (decoded.position.x, 1220.62, 1e-9, "Wrong delta position");
+    NS_TEST_ASSERT_MSG_EQ_TOL (decoded.position.y, -35.0, 1e-9, "Wrong unchanged position");
+    NS_TEST_ASSERT_MSG_EQ_TOL (decoded.velocity.x, 20.5, 1e-9, "Wrong unchanged velocity");
+    NS_TEST_ASSERT_MSG_EQ (decoded.chMembers, 5, "Wrong delta members");
+    NS_TEST_ASSERT_MSG_EQ (decoded.clusterId, 7, "Wrong unchanged cluster id");
+
+    //!< A node that missed the key frame drops the delta
+    V2vNovelUpdateCodec late;
+    NS_TEST_ASSERT_MSG_EQ (late.Decode (delta, decoded), false, "Delta without key frame must be dropped");
+    NS_TEST_ASSERT_MSG_EQ (late.GetDropped (), 1, "Drop not counted");
+
+    //!< The key frame interval and a cluster change force key frames
+    info.ts = Seconds (3.0).GetTimeStep ();
+    NS_TEST_ASSERT_MSG_EQ ((sender.Encode (info).flags & V2vClusterSap::COMPACT_KEY_FRAME), 0, "Third update must be a delta");
+    info.ts = Seconds (4.0).GetTimeStep ();
+    V2vClusterSap::NovelCompactUpdate key = sender.Encode (info);
+    NS_TEST_ASSERT_MSG_NE ((key.flags & V2vClusterSap::COMPACT_KEY_FRAME), 0, "Key frame interval ignored");
+    NS_TEST_ASSERT_MSG_EQ (late.Decode (key, decoded), true, "Key frame must decode");
+    info.ts = Seconds (5.0).GetTimeStep ();
+    info.clusterId = 9;
+    NS_TEST_ASSERT_MSG_NE ((sender.Encode (info).flags & V2vClusterSap::COMPACT_KEY_FRAME), 0, "Cluster change must send a key frame");
+    info.ts = Seconds (6.0).GetTimeStep ();
+    info.position.x += 400.0;
+    NS_TEST_ASSERT_MSG_NE ((sender.Encode (info).flags & V2vClusterSap::COMPACT_KEY_FRAME), 0, "Position offset overflow must send a key frame");
+    NS_TEST_ASSERT_MSG_EQ (sender.GetKeyFrames (), 4, "Wrong key frame count");
+    NS_TEST_ASSERT_MSG_EQ (sender.GetDeltas (), 2, "Wrong delta count");
+}
+
+/*--------------------------- V2vSlotAllocator Testing ---------------------------*/
+class V2vSlotAllocatorTestCase: public TestCase {
+public:
+    V2vSlotAllocatorTestCase();
+    virtual ~V2vSlotAllocatorTestCase();
+
+private:
+    virtual void DoRun(void);
+};
+
+V2vSlotAllocatorTestCase::V2vSlotAllocatorTestCase() :
+        TestCase("Check V2vSlotAllocator hashed slots and collision resolution"){
+}
+
+V2vSlotAllocatorTestCase::~V2vSlotAllocatorTestCase() {
+}
+
+void V2vSlotAllocatorTestCase::DoRun(void) {
+
+    //!< The hashed slots of a large fleet stay within the frame and spread over it
+    std::vector<uint32_t> load (100, 0);
+    for(uint32_t id = 0; id < 10000; ++id){
+        V2vSlotAllocator slots;
+        slots.Start (id, 100, MilliSeconds (1));
+        NS_TEST_ASSERT_MSG_LT (slots.GetSlot (), 100, "Slot out of the frame");
+        NS_TEST_ASSERT_MSG_LT_OR_EQ (slots.GetOffset (), MilliSeconds (100), "Offset out of the frame");
+        NS_TEST_ASSERT_MSG_GT (slots.GetOffset (), Time (0), "Offset out of the frame");
+        load[slots.GetSlot ()] ++;
+    }
+    NS_TEST_ASSERT_MSG_GT ((*std::min_element (load.begin (), load.end ())), 60, "Slots not spread over the frame");
+    NS_TEST_ASSERT_MSG_LT ((*std::max_element (load.begin (), load.end ())), 140, "Slots not spread over the frame");
+
+    //!< Two nodes hashed in the same slot of a 4 slots frame
+    V2vSlotAllocator low;
+    low.Start (1, 4, MilliSeconds (10));
+    V2vSlotAllocator high;
+    uint32_t highId = 2;
+    high.Start (highId, 4, MilliSeconds (10));
+    while(high.GetSlot () != low.GetSlot ()){
+        high.Start (++ highId, 4, MilliSeconds (10));
+    }
+
+    //!< Only the node of higher id moves, to a slot heard idle
+    Time sent = Seconds (1.0) + low.GetOffset ();
+    uint32_t busy = (low.GetSlot () + 2) % 4;
+    high.NotifyReceived (100, Seconds (1.0) + MilliSeconds (10 * busy + 5));
+    low.NotifySent (sent);
+    high.NotifySent (sent);
+    NS_TEST_ASSERT_MSG_EQ (low.NotifyReceived (highId, sent), false, "The lower id must keep its slot");
+    NS_TEST_ASSERT_MSG_EQ (high.NotifyReceived (1, sent), true, "The higher id must move");
+    NS_TEST_ASSERT_MSG_EQ (low.GetCollisions (), 1, "Collision not counted");
+    NS_TEST_ASSERT_MSG_EQ (high.GetCollisions (), 1, "Collision not counted");
+    NS_TEST_ASSERT_MSG_EQ (high.GetMoves (), 1, "Move not counted");
+    NS_TEST_ASSERT_MSG_NE (high.GetSlot (), low.GetSlot (), "Still in the colliding slot");
+    NS_TEST_ASSERT_MSG_NE (high.GetSlot (), (busy + 3) % 4, "Moved to a busy slot");
+
+    Time shift = high.TakeShift ();
+    NS_TEST_ASSERT_MSG_EQ (shift, MilliSeconds (10 * ((high.GetSlot () + 4 - low.GetSlot ()) % 4)), "Wrong shift");
+    NS_TEST_ASSERT_MSG_EQ (high.TakeShift (), Time (0), "Shift taken twice");
+
+    //!< The shifted beacons no longer collide
+    Time moved = sent + Seconds (1.0) + shift;
+    high.NotifySent (moved);
+    NS_TEST_ASSERT_MSG_EQ (low.NotifyReceived (highId, moved), false, "Shifted beacon still collides");
+    NS_TEST_ASSERT_MSG_EQ (high.NotifyReceived (1, sent + Seconds (1.0)), false, "Shifted beacon still collides");
+    NS_TEST_ASSERT_MSG_EQ (low.GetCollisions (), 1, "Spurious collision");
+    NS_TEST_ASSERT_MSG_EQ (high.GetCollisions (), 1, "Spurious collision");
+}
+
+/*--------------------------- Adaptive update interval Testing ---------------------------*/
+class V2vAdaptiveUpdateTestCase: public TestCase {
+public:
+    V2vAdaptiveUpdateTestCase();
+    virtual ~V2vAdaptiveUpdateTestCase();
+
+private:
+    virtual void DoRun(void);
+};
+
+V2vAdaptiveUpdateTestCase::V2vAdaptiveUpdateTestCase() :
+        TestCase("Check the adaptive update interval of V2vNovelAlgorithmClient"){
+}
+
+V2vAdaptiveUpdateTestCase::~V2vAdaptiveUpdateTestCase() {
+}
+
+void V2vAdaptiveUpdateTestCase::DoRun(void) {
+
+    Ptr<V2vNovelAlgorithmClient> client = CreateObject<V2vNovelAlgorithmClient> ();
+    client->SetAttribute ("Interval", TimeValue (MilliSeconds (100)));
+    client->SetAttribute ("MinUpdateInterval", TimeValue (MilliSeconds (500)));
+    client->SetAttribute ("MaxUpdateInterval", TimeValue (Seconds (3.0)));
+    client->SetAttribute ("ChurnReference", DoubleValue (0.1));
+    client->SetAttribute ("VelocityVarianceReference", DoubleValue (4.0));
+    client->SetAttribute ("TargetBusyRatio", DoubleValue (0.5));
+
+    //!< A quiet neighborhood on an idle channel gets the longest interval
+    Time quiet = client->CalculateUpdateInterval (0.0, 0.0, 0.0);
+    NS_TEST_ASSERT_MSG_EQ (quiet, Seconds (3.0), "Quiet neighborhood not at MaxUpdateInterval");
+
+    //!< The interval shrinks with the churn and the relative speed
+    Time churn = client->CalculateUpdateInterval (1.0, 0.0, 0.0);
+    Time moreChurn = client->CalculateUpdateInterval (10.0, 0.0, 0.0);
+    Time speed = client->CalculateUpdateInterval (0.0, 16.0, 0.0);
+    NS_TEST_ASSERT_MSG_EQ (churn, MilliSeconds (700), "Wrong interval under churn");
+    NS_TEST_ASSERT_MSG_LT (moreChurn, churn, "Interval not shrinking with the churn");
+    NS_TEST_ASSERT_MSG_EQ (speed, MilliSeconds (1000), "Wrong interval under relative speed");
+    NS_TEST_ASSERT_MSG_LT (client->CalculateUpdateInterval (0.0, 64.0, 0.0), speed, "Interval not shrinking with the relative speed");
+
+    //!< and stretches with the busy ratio above the target only
+    NS_TEST_ASSERT_MSG_EQ (client->CalculateUpdateInterval (1.0, 0.0, 0.4), churn, "Interval stretched under the target busy ratio");
+    NS_TEST_ASSERT_MSG_EQ (client->CalculateUpdateInterval (1.0, 0.0, 0.9), MilliSeconds (1300), "Wrong interval on a busy channel");
+    NS_TEST_ASSERT_MSG_GT (client->CalculateUpdateInterval (1.0, 0.0, 1.0), client->CalculateUpdateInterval (1.0, 0.0, 0.9),
+                           "Interval not stretching with the busy ratio");
+
+    //!< The bounds hold at the extremes
+    NS_TEST_ASSERT_MSG_EQ (client->CalculateUpdateInterval (1000.0, 1000.0, 0.0), MilliSeconds (500), "Interval under MinUpdateInterval");
+    NS_TEST_ASSERT_MSG_EQ (client->CalculateUpdateInterval (0.0, 0.0, 1.0), Seconds (3.0), "Interval over MaxUpdateInterval");
+
+    //!< The interval is a whole number of TDMA frames, rounded within the bounds
+    for(double c = 0.0; c < 5.0; c += 0.37){
+        for(double b = 0.0; b <= 1.0; b += 0.25){
+            Time interval = client->CalculateUpdateInterval (c, 4.0 * c, b);
+            NS_TEST_ASSERT_MSG_EQ (interval.GetTimeStep () % MilliSeconds (100).GetTimeStep (), 0, "Interval not a whole number of frames");
+            NS_TEST_ASSERT_MSG_GT_OR_EQ (interval, MilliSeconds (500), "Interval under MinUpdateInterval");
+            NS_TEST_ASSERT_MSG_LT_OR_EQ (interval, Seconds (3.0), "Interval over MaxUpdateInterval");
+        }
+    }
+    client->SetAttribute ("Interval", TimeValue (MilliSeconds (400)));
+    NS_TEST_ASSERT_MSG_EQ (client->CalculateUpdateInterval (1000.0, 0.0, 0.0), MilliSeconds (800), "Minimum not rounded up to a frame");
+    client->SetAttribute ("MaxUpdateInterval", TimeValue (MilliSeconds (3100)));
+    NS_TEST_ASSERT_MSG_EQ (client->CalculateUpdateInterval (0.0, 0.0, 0.0), MilliSeconds (2800), "Maximum not rounded down to a frame");
+}
+
+/*--------------------------- V2vChannelScheduler Testing ---------------------------*/
+class V2vChannelSchedulerTestCase: public TestCase {
+public:
+    V2vChannelSchedulerTestCase();
+    virtual ~V2vChannelSchedulerTestCase();
+
+private:
+    virtual void DoRun(void);
+    void Receive (Ptr<Socket> socket);
+
+    std::vector<Time> m_times;              //!< reception times
+    std::vector<Ipv4Address> m_senders;     //!< source address of each reception
+};
+
+V2vChannelSchedulerTestCase::V2vChannelSchedulerTestCase() :
+        TestCase("Check V2vChannelCoordinator intervals and the V2vChannelScheduler alternating access"){
+}
+
+V2vChannelSchedulerTestCase::~V2vChannelSchedulerTestCase() {
+}
+
+void V2vChannelSchedulerTestCase::Receive(Ptr<Socket> socket) {
+    Ptr<Packet> packet;
+    Address from;
+    while((packet = socket->RecvFrom (from))){
+        m_times.push_back (Simulator::Now ());
+        m_senders.push_back (InetSocketAddress::ConvertFrom (from).GetIpv4 ());
+    }
+}
+
+void V2vChannelSchedulerTestCase::DoRun(void) {
+
+    //!< 50ms CCH and SCH intervals, with 4ms guards
+    Ptr<V2vChannelCoordinator> coordinator = CreateObject<V2vChannelCoordinator> ();
+    NS_TEST_ASSERT_MSG_EQ (coordinator->GetSyncInterval (), MilliSeconds (100), "Wrong sync interval");
+    NS_TEST_ASSERT_MSG_EQ (coordinator->IsCchInterval (MilliSeconds (10)), true, "Wrong CCH interval");
+    NS_TEST_ASSERT_MSG_EQ (coordinator->IsSchInterval (MilliSeconds (160)), true, "Wrong SCH interval");
+    NS_TEST_ASSERT_MSG_EQ (coordinator->IsGuardInterval (MilliSeconds (52)), true, "Wrong SCH guard interval");
+    NS_TEST_ASSERT_MSG_EQ (coordinator->IsGuardInterval (MilliSeconds (110)), false, "Wrong CCH guard interval");
+    NS_TEST_ASSERT_MSG_EQ (coordinator->NeedTimeToSchInterval (MilliSeconds (10)), MilliSeconds (40), "Wrong time to the SCH interval");
+    NS_TEST_ASSERT_MSG_EQ (coordinator->NeedTimeToCchInterval (MilliSeconds (60)), MilliSeconds (40), "Wrong time to the CCH interval");
+    NS_TEST_ASSERT_MSG_EQ (coordinator->NeedTimeToCchAccess (MilliSeconds (1)), MilliSeconds (3), "Wrong time to the CCH access");
+    NS_TEST_ASSERT_MSG_EQ (coordinator->NeedTimeToCchAccess (MilliSeconds (60)), MilliSeconds (44), "Wrong time to the CCH access");
+    NS_TEST_ASSERT_MSG_EQ (coordinator->NeedTimeToSchAccess (MilliSeconds (10)), MilliSeconds (44), "Wrong time to the SCH access");
+    NS_TEST_ASSERT_MSG_EQ (coordinator->NeedTimeToSchAccess (MilliSeconds (70)), Time (0), "Wrong time to the SCH access");
+
+    //!< Two vehicles with a CCH and a SCH device each
+    NodeContainer nodes;
+    nodes.Create (2);
+    MobilityHelper mobility;
+    mobility.Install (nodes);
+    V2vBroadcastHelper broadcast;
+    broadcast.SetChannelAttribute ("DataRate", DataRateValue (DataRate ("0bps")));
+    NetDeviceContainer cch = broadcast.Install (nodes);
+    NetDeviceContainer sch = broadcast.Install (nodes);
+
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall (false);
+    internet.Install (nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase ("10.1.0.0", "255.255.0.0");
+    ipv4.Assign (cch);
+    ipv4.SetBase ("10.2.0.0", "255.255.0.0");
+    ipv4.Assign (sch);
+
+    V2vChannelSchedulerHelper schedulerHelper;
+    schedulerHelper.SetSchedulerAttribute ("AccessMode", StringValue ("Alternating"));
+    schedulerHelper.AddChannel (V2vChannelScheduler::CCH, cch);
+    schedulerHelper.AddChannel (172, sch);
+    schedulerHelper.Install (nodes);
+    Ptr<V2vChannelScheduler> scheduler = nodes.Get (0)->GetObject<V2vChannelScheduler> ();
+    NS_TEST_ASSERT_MSG_NE (scheduler, 0, "No scheduler aggregated");
+    NS_TEST_ASSERT_MSG_EQ (scheduler->GetDevice (172), sch.Get (0), "Wrong SCH device");
+    NS_TEST_ASSERT_MSG_EQ (scheduler->SelectSch (7), 172, "Wrong SCH selected");
+
+    Ptr<Socket> listening = Socket::CreateSocket (nodes.Get (1), UdpSocketFactory::GetTypeId ());
+    listening->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+    listening->SetRecvCallback (MakeCallback (&V2vChannelSchedulerTestCase::Receive, this));
+
+    Ptr<Socket> sockets[2];
+    uint32_t channels[2] = {V2vChannelScheduler::CCH, 172};
+    for(uint32_t i = 0; i < 2; ++i){
+        sockets[i] = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+        sockets[i]->Bind ();
+        NS_TEST_ASSERT_MSG_EQ (scheduler->BindToChannel (sockets[i], channels[i]), true, "Channel not bound");
+        sockets[i]->SetAllowBroadcast (true);
+        sockets[i]->Connect (InetSocketAddress (Ipv4Address::GetBroadcast (), 9));
+    }
+
+    //!< CCH now, SCH at its next interval, CCH at its next interval
+    Simulator::Schedule (MilliSeconds (20), &V2vChannelScheduler::Send, scheduler, sockets[0], Create<Packet> (100), V2vChannelScheduler::CCH);
+    Simulator::Schedule (MilliSeconds (30), &V2vChannelScheduler::Send, scheduler, sockets[1], Create<Packet> (100), (uint32_t) 172);
+    Simulator::Schedule (MilliSeconds (60), &V2vChannelScheduler::Send, scheduler, sockets[0], Create<Packet> (100), V2vChannelScheduler::CCH);
+    Simulator::Stop (Seconds (1.0));
+    Simulator::Run ();
+
+    NS_TEST_ASSERT_MSG_EQ (m_times.size (), 3, "Packets lost");
+    NS_TEST_ASSERT_MSG_EQ (m_times[0], MilliSeconds (20), "CCH packet delayed in the CCH interval");
+    NS_TEST_ASSERT_MSG_EQ (m_senders[0], Ipv4Address ("10.1.0.1"), "CCH packet not sent on the CCH");
+    NS_TEST_ASSERT_MSG_EQ (m_times[1], MilliSeconds (54), "SCH packet not held until the SCH access");
+    NS_TEST_ASSERT_MSG_EQ (m_senders[1], Ipv4Address ("10.2.0.1"), "SCH packet not sent on the SCH");
+    NS_TEST_ASSERT_MSG_EQ (m_times[2], MilliSeconds (104), "CCH packet not held until the CCH access");
+    NS_TEST_ASSERT_MSG_EQ (scheduler->GetSent (V2vChannelScheduler::CCH), 2, "Wrong CCH count");
+    NS_TEST_ASSERT_MSG_EQ (scheduler->GetQueued (V2vChannelScheduler::CCH), 1, "Wrong CCH queued count");
+    NS_TEST_ASSERT_MSG_EQ (scheduler->GetQueued (172), 1, "Wrong SCH queued count");
+
+    Simulator::Destroy ();
+}
+
+/*--------------------------- V2vWeightIndex Testing ---------------------------*/
+class V2vWeightIndexTestCase: public TestCase {
+public:
+    V2vWeightIndexTestCase();
+    virtual ~V2vWeightIndexTestCase();
+
+private:
+    virtual void DoRun(void);
+
+};
+
+V2vWeightIndexTestCase::V2vWeightIndexTestCase() :
+        TestCase("Check V2vWeightIndex candidates against a full scan"){
+}
+
+V2vWeightIndexTestCase::~V2vWeightIndexTestCase() {
+}
+
+void V2vWeightIndexTestCase::DoRun(void) {
+
+    V2vWeightIndex highest;
+    highest.Update (5, 2.0);
+    highest.Update (3, 7.5);
+    highest.Update (9, 7.5);
+    NS_TEST_ASSERT_MSG_EQ (highest.GetTop (), 3, "Ties go to the smallest id");
+    highest.Update (3, 1.0);
+    NS_TEST_ASSERT_MSG_EQ (highest.GetTop (), 9, "Lowered weight must leave the top");
+    NS_TEST_ASSERT_MSG_EQ (highest.Erase (9), true, "Erase of a present id");
+    NS_TEST_ASSERT_MSG_EQ (highest.Erase (9), false, "Erase of a removed id");
+    NS_TEST_ASSERT_MSG_EQ (highest.GetTop (), 5, "Wrong top after erase");
+    NS_TEST_ASSERT_MSG_EQ (highest.GetTopWeight (), 2.0, "Wrong top weight");
+
+    // random updates and erases in both orders, against a full scan
+    for (uint32_t order = 0; order < 2; ++order){
+        V2vWeightIndex index ((V2vWeightIndex::Order) order);
+        std::map<uint64_t, double> weights;
+        uint64_t seed = 4242 + order;
+        for (uint32_t round = 0; round < 5000; ++round){
+            seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+            uint64_t id = (seed >> 33) % 200;
+            seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+            //!< Few distinct weights, so the ties are exercised too
+            double weight = (double)((seed >> 33) % 50) / 4.0;
+            if (round % 5 == 0){
+                NS_TEST_ASSERT_MSG_EQ (index.Erase (id), (weights.erase (id) == 1), "Erase mismatch");
+            }
+            else{
+                index.Update (id, weight);
+                weights[id] = weight;
+            }
+
+            NS_TEST_ASSERT_MSG_EQ (index.GetSize (), weights.size (), "Size mismatch");
+            if (weights.empty ()){
+                continue;
+            }
+            std::map<uint64_t, double>::const_iterator best = weights.begin ();
+            for (std::map<uint64_t, double>::const_iterator it = weights.begin (); it != weights.end (); ++it){
+                if ((order == V2vWeightIndex::HIGHEST_FIRST) ? (it->second > best->second) : (it->second < best->second)){
+                    best = it;
+                }
+            }
+            NS_TEST_ASSERT_MSG_EQ (index.GetTop (), best->first, "Top mismatch at round " << round);
+            NS_TEST_ASSERT_MSG_EQ (index.GetTopWeight (), best->second, "Top weight mismatch at round " << round);
+        }
+    }
+}
+
+/*--------------------------- V2vFcdMobilityFeed Testing ---------------------------*/
+class V2vFcdMobilityFeedTestCase: public TestCase {
+public:
+    V2vFcdMobilityFeedTestCase();
+    virtual ~V2vFcdMobilityFeedTestCase();
+
+private:
+    virtual void DoRun(void);
+    Ptr<Node> CreateVehicle(std::string id);
+    void Arrival(std::string id, Ptr<Node> node);
+    void Departure(std::string id, Ptr<Node> node);
+    void CheckPosition(Ptr<Node> node, Vector expected, std::string what);
+
+    std::vector<std::string> m_events;
+};
+
+V2vFcdMobilityFeedTestCase::V2vFcdMobilityFeedTestCase() :
+        TestCase("Check V2vFcdMobilityFeed streaming of a SUMO FCD trace"){
+}
+
+V2vFcdMobilityFeedTestCase::~V2vFcdMobilityFeedTestCase() {
+}
+
+Ptr<Node> V2vFcdMobilityFeedTestCase::CreateVehicle(std::string id) {
+    m_events.push_back ("create " + id);
+    return CreateObject<Node> ();
+}
+
+void V2vFcdMobilityFeedTestCase::Arrival(std::string id, Ptr<Node> node) {
+    m_events.push_back ("arrive " + id);
+}
+
+void V2vFcdMobilityFeedTestCase::Departure(std::string id, Ptr<Node> node) {
+    m_events.push_back ("depart " + id);
+}
+
+void V2vFcdMobilityFeedTestCase::CheckPosition(Ptr<Node> node, Vector expected, std::string what) {
+    Vector position = node->GetObject<MobilityModel> ()->GetPosition ();
+    NS_TEST_EXPECT_MSG_EQ_TOL (position.x, expected.x, 1e-6, "Wrong x of " << what << " at " << Simulator::Now ().GetSeconds ());
+    NS_TEST_EXPECT_MSG_EQ_TOL (position.y, expected.y, 1e-6, "Wrong y of " << what << " at " << Simulator::Now ().GetSeconds ());
+}
+
+void V2vFcdMobilityFeedTestCase::DoRun(void) {
+
+    std::string trace =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!-- generated by <sumo> -->\n"
+        "<fcd-export>\n"
+        "    <timestep time=\"0.00\">\n"
+        "        <vehicle id=\"a\" x=\"0.00\" y=\"0.00\" angle=\"90.00\" speed=\"10.00\"/>\n"
+        "        <vehicle id=\"b\" x=\"100.00\" y=\"0.00\" angle=\"0.00\" speed=\"20.00\"/>\n"
+        "    </timestep>\n"
+        "    <timestep time=\"1.00\">\n"
+        "        <vehicle id=\"a\" x=\"10.00\" y=\"0.00\"/>\n"
+        "        <vehicle\n            id='b' x='100.00' y='20.00'/>\n"
+        "    </timestep>\n"
+        "    <timestep time=\"2.00\">\n"
+        "        <vehicle id=\"b\" x=\"100.00\" y=\"40.00\"/>\n"
+        "        <vehicle id=\"c\" x=\"50.00\" y=\"50.00\"/>\n"
+        "    </timestep>\n"
+        "    <timestep time=\"3.00\">\n"
+        "        <vehicle id=\"c\" x=\"50.00\" y=\"60.00\"/>\n"
+        "        <vehicle id=\"d\" x=\"0.00\" y=\"0.00\"/>\n"
+        "    </timestep>\n"
+        "    <timestep time=\"4.00\">\n";   // cut by the end of the stream
+
+    // the reader through a pipe
+    int fds[2];
+    NS_TEST_ASSERT_MSG_EQ (pipe (fds), 0, "Could not create a pipe");
+    NS_TEST_ASSERT_MSG_EQ (write (fds[1], trace.c_str (), trace.size ()), (ssize_t)trace.size (), "Short write");
+    close (fds[1]);
+    std::ostringstream path;
+    path << "/dev/fd/" << fds[0];
+    V2vFcdTraceReader reader;
+    NS_TEST_ASSERT_MSG_EQ (reader.Open (path.str ()), true, "Could not open the pipe");
+    close (fds[0]);
+    double time;
+    std::vector<V2vFcdTraceReader::Vehicle> vehicles;
+    uint32_t timesteps = 0;
+    while (reader.ReadTimestep (time, vehicles)){
+        NS_TEST_EXPECT_MSG_EQ (time, timesteps, "Wrong timestep time");
+        NS_TEST_EXPECT_MSG_EQ (vehicles.size (), 2, "Wrong number of vehicles");
+        timesteps++;
+    }
+    NS_TEST_ASSERT_MSG_EQ (timesteps, 4, "The cut timestep must be dropped");
+    NS_TEST_ASSERT_MSG_EQ (reader.IsOpen (), false, "Stream must be closed at its end");
+
+    // the feed from a file, with a pool of three nodes and a factory
+    std::string file = CreateTempDirFilename ("v2v-fcd.xml");
+    std::ofstream os (file.c_str ());
+    os << trace;
+    os.close ();
+
+    NodeContainer pool;
+    pool.Create (3);
+    Ptr<V2vFcdMobilityFeed> feed = CreateObject<V2vFcdMobilityFeed> ();
+    feed->SetAttribute ("Source", StringValue (file));
+    feed->TraceConnectWithoutContext ("VehicleArrival", MakeCallback (&V2vFcdMobilityFeedTestCase::Arrival, this));
+    feed->TraceConnectWithoutContext ("VehicleDeparture", MakeCallback (&V2vFcdMobilityFeedTestCase::Departure, this));
+    feed->SetVehicleFactory (MakeCallback (&V2vFcdMobilityFeedTestCase::CreateVehicle, this));
+    feed->Install (pool);
+    NS_TEST_ASSERT_MSG_EQ (feed->Start (), true, "Could not open the trace");
+
+    Vector parking (-100000.0 + 10000.0*pool.Get (2)->GetId (), -100000.0, 0.0);
+    Simulator::Schedule (Seconds (0.5), &V2vFcdMobilityFeedTestCase::CheckPosition, this, pool.Get (0), Vector (5.0, 0.0, 0.0), "a");
+    Simulator::Schedule (Seconds (0.5), &V2vFcdMobilityFeedTestCase::CheckPosition, this, pool.Get (1), Vector (100.0, 10.0, 0.0), "b");
+    Simulator::Schedule (Seconds (0.5), &V2vFcdMobilityFeedTestCase::CheckPosition, this, pool.Get (2), parking, "parked node");
+    // a leaves after 1 s: it stops there
+    Simulator::Schedule (Seconds (1.5), &V2vFcdMobilityFeedTestCase::CheckPosition, this, pool.Get (0), Vector (10.0, 0.0, 0.0), "a");
+    Simulator::Schedule (Seconds (1.5), &V2vFcdMobilityFeedTestCase::CheckPosition, this, pool.Get (1), Vector (100.0, 30.0, 0.0), "b");
+    // c takes the node of a
+    Simulator::Schedule (Seconds (2.5), &V2vFcdMobilityFeedTestCase::CheckPosition, this, pool.Get (0), Vector (50.0, 55.0, 0.0), "c");
+    // d takes the node b released
+    Simulator::Schedule (Seconds (3.5), &V2vFcdMobilityFeedTestCase::CheckPosition, this, pool.Get (1), Vector (0.0, 0.0, 0.0), "d");
+    Simulator::Run ();
+
+    NS_TEST_ASSERT_MSG_EQ (feed->GetArrivals (), 4, "Wrong number of arrivals");
+    NS_TEST_ASSERT_MSG_EQ (feed->GetDepartures (), 2, "Wrong number of departures");
+    NS_TEST_ASSERT_MSG_EQ (feed->GetNVehicles (), 2, "Wrong number of vehicles on the road");
+    NS_TEST_ASSERT_MSG_EQ (feed->GetNNodes (), 3, "No node must be created with a free one");
+    NS_TEST_ASSERT_MSG_EQ ((feed->GetNode ("c") == pool.Get (0)), true, "c must reuse the node of a");
+    NS_TEST_ASSERT_MSG_EQ ((feed->GetNode ("d") == pool.Get (1)), true, "d must reuse the node of b");
+    NS_TEST_ASSERT_MSG_EQ ((feed->GetNode ("a") == 0), true, "a left the road");
+
+    std::string expected[] = {"arrive a", "arrive b", "depart a", "arrive c", "depart b", "arrive d"};
+    NS_TEST_ASSERT_MSG_EQ (m_events.size (), 6, "Wrong number of events");
+    for (uint32_t i = 0; i < 6; ++i){
+        NS_TEST_EXPECT_MSG_EQ (m_events[i], expected[i], "Wrong event " << i);
+    }
+
+    // a third vehicle on the road needs the factory
+    Ptr<V2vFcdMobilityFeed> crowded = CreateObject<V2vFcdMobilityFeed> ();
+    crowded->SetAttribute ("Source", StringValue (file));
+    crowded->SetVehicleFactory (MakeCallback (&V2vFcdMobilityFeedTestCase::CreateVehicle, this));
+    NS_TEST_ASSERT_MSG_EQ (crowded->Start (), true, "Could not open the trace");
+    m_events.clear ();
+    Simulator::Run ();
+    NS_TEST_ASSERT_MSG_EQ (crowded->GetNNodes (), 2, "Factory nodes must be reused");
+    NS_TEST_ASSERT_MSG_EQ (m_events.size (), 2, "Wrong number of created nodes");
+
+    feed->Dispose ();
+    crowded->Dispose ();
+    Simulator::Destroy ();
+}
+/*--------------------------------------------------------------------------*/
+
 /*--------------------------- End-to-end Testing ---------------------------*/
 class V2vUdpEndToEndTestCase: public TestCase {
 public:
@@ -282,6 +2027,26 @@ V2vTestSuite::V2vTestSuite() : TestSuite("v2v", UNIT) {
     AddTestCase(new V2vInitiateClusterHeaderTestCase, TestCase::QUICK);
     AddTestCase(new V2vFormClusterHeaderTestCase, TestCase::QUICK);
     AddTestCase(new V2vIncidentEventHeaderTestCase, TestCase::QUICK);
+    AddTestCase(new V2vAffinityRespAvailHeaderTestCase, TestCase::QUICK);
+    AddTestCase(new V2vClusterTypeHeaderTestCase, TestCase::QUICK);
+    AddTestCase(new V2vNeighborTableTestCase, TestCase::QUICK);
+    AddTestCase(new V2vAffinityTieTestCase, TestCase::QUICK);
+    AddTestCase(new V2vAffinityPropagationTestCase, TestCase::QUICK);
+    AddTestCase(new V2vStatisticsAccumulatorTestCase, TestCase::QUICK);
+    AddTestCase(new V2vSweepHelperTestCase, TestCase::QUICK);
+    AddTestCase(new V2vClusterRegistryTestCase, TestCase::QUICK);
+    AddTestCase(new V2vBroadcastChannelTestCase, TestCase::QUICK);
+    AddTestCase(new V2vBroadcastChannelPartitionTestCase, TestCase::QUICK);
+    AddTestCase(new V2vMobilityModelTestCase, TestCase::QUICK);
+    AddTestCase(new V2vClusterGatewayTestCase, TestCase::QUICK);
+    AddTestCase(new V2vTimerWheelTestCase, TestCase::QUICK);
+    AddTestCase(new V2vClusterSnapshotTestCase, TestCase::QUICK);
+    AddTestCase(new V2vNovelUpdateCodecTestCase, TestCase::QUICK);
+    AddTestCase(new V2vSlotAllocatorTestCase, TestCase::QUICK);
+    AddTestCase(new V2vAdaptiveUpdateTestCase, TestCase::QUICK);
+    AddTestCase(new V2vChannelSchedulerTestCase, TestCase::QUICK);
+    AddTestCase(new V2vWeightIndexTestCase, TestCase::QUICK);
+    AddTestCase(new V2vFcdMobilityFeedTestCase, TestCase::QUICK);
 	AddTestCase(new V2vUdpEndToEndTestCase, TestCase::QUICK);
 }
 
@@ -20,6 +20,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
@@ -50,6 +51,12 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MinimumDelay", "The lower bound of the propagation delay of the frames. "
+                   "If not zero, the receivers are only read by events scheduled after this delay "
+                   "on their own nodes, so that it is the lookahead of the parallel simulators.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&YansWifiChannel::m_minimumDelay),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -80,10 +87,27 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
+  Transmission tx;
+  if (m_minimumDelay.IsStrictlyPositive ())
+    {
+      Ptr<ConstantPositionMobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+      position->SetPosition (senderMobility->GetPosition ());
+      tx.sender = position;
+      tx.channelNumber = sender->GetChannelNumber ();
+      tx.txPowerDbm = txPowerDbm;
+      tx.txVector = txVector;
+      tx.preamble = preamble;
+    }
   uint32_t j = 0;
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
     {
-      if (sender != (*i))
+      if (sender != (*i) && m_minimumDelay.IsStrictlyPositive ())
+        {
+          tx.packet = packet->Copy ();
+          Simulator::ScheduleWithContext (GetNodeId (j), m_minimumDelay,
+                                          &YansWifiChannel::Propagate, this, j, tx);
+        }
+      else if (sender != (*i))
         {
           // For now don't account for inter channel interference
           if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
@@ -97,23 +121,42 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
           Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
-            {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
-            }
-          Simulator::ScheduleWithContext (dstNode,
+          Simulator::ScheduleWithContext (GetNodeId (j),
                                           delay, &YansWifiChannel::Receive, this,
                                           j, copy, rxPowerDbm, txVector, preamble);
         }
     }
 }
 
+void
+YansWifiChannel::Propagate (uint32_t i, Transmission tx) const
+{
+  // For now don't account for inter channel interference
+  if (m_phyList[i]->GetChannelNumber () != tx.channelNumber)
+    {
+      return;
+    }
+  Ptr<MobilityModel> receiverMobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+  Time delay = m_delay->GetDelay (tx.sender, receiverMobility);
+  double rxPowerDbm = m_loss->CalcRxPower (tx.txPowerDbm, tx.sender, receiverMobility);
+  NS_LOG_DEBUG ("propagation: txPower=" << tx.txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                "distance=" << tx.sender->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+  delay = Max (delay - m_minimumDelay, Seconds (0));
+  Simulator::Schedule (delay, &YansWifiChannel::Receive, this,
+                       i, tx.packet, rxPowerDbm, tx.txVector, tx.preamble);
+}
+
+uint32_t
+YansWifiChannel::GetNodeId (uint32_t i) const
+{
+  Ptr<Object> dstNetDevice = m_phyList[i]->GetDevice ();
+  if (dstNetDevice == 0)
+    {
+      return 0xffffffff;
+    }
+  return dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+}
+
 void
 YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
                           WifiTxVector txVector, WifiPreamble preamble) const
@@ -23,6 +23,7 @@
 #include <vector>
 #include <stdint.h>
 #include "ns3/packet.h"
+#include "ns3/nstime.h"
 #include "wifi-channel.h"
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
@@ -31,6 +32,7 @@
 namespace ns3 {
 
 class NetDevice;
+class MobilityModel;
 class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
@@ -46,6 +48,17 @@ class YansWifiPhy;
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * With a MinimumDelay, a frame reaches every other PHY through an event
+ * scheduled MinimumDelay after the transmission on the node of the PHY,
+ * which computes the received power and the propagation delay from the
+ * position of the sender at the transmission and schedules the reception
+ * after the rest of the delay; the frames to the PHYs closer than the
+ * distance covered in MinimumDelay arrive after MinimumDelay. The state of
+ * the receivers is then only read by their own events, so the channel may
+ * connect the nodes of several partitions of a parallel simulator, the
+ * MinimumDelay being its lookahead, as long as the propagation models
+ * neither draw random numbers nor keep a state.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -122,10 +135,39 @@ private:
   void Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
                 WifiTxVector txVector, WifiPreamble preamble) const;
 
+  /**
+   * A frame on its way to a PHY, with a MinimumDelay.
+   */
+  struct Transmission
+  {
+    Ptr<Packet> packet; //!< the packet being sent
+    Ptr<MobilityModel> sender; //!< copy of the position of the sender at the transmission
+    uint16_t channelNumber; //!< the channel number of the sender
+    double txPowerDbm; //!< the tx power of the packet
+    WifiTxVector txVector; //!< the TXVECTOR of the packet
+    WifiPreamble preamble; //!< the preamble of the packet
+  };
+  /**
+   * This method is scheduled by Send, MinimumDelay after the transmission,
+   * for each associated YansWifiPhy when the channel has a MinimumDelay.
+   * It schedules the reception by the YansWifiPhy if it is on the channel
+   * number of the sender.
+   *
+   * \param i index of the corresponding YansWifiPhy in the PHY list
+   * \param tx the frame
+   */
+  void Propagate (uint32_t i, Transmission tx) const;
+  /**
+   * \param i index of a YansWifiPhy in the PHY list
+   * \returns the id of the node of the YansWifiPhy, the context of its events
+   */
+  uint32_t GetNodeId (uint32_t i) const;
+
 
   PhyList m_phyList; //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss; //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay; //!< Propagation delay model
+  Time m_minimumDelay; //!< Lower bound of the propagation delay
 };
 
 } // namespace ns3
@@ -81,6 +81,8 @@ Bench::RunBench (void)
 
   DEB ("initializing");
 
+  m_count = 0;
+  EventAllocator::ResetStats ();
   time.Start ();
   for (uint32_t i = 0; i < m_population; ++i)
     {
@@ -97,13 +99,15 @@ Bench::RunBench (void)
   simu = time.End ();
   simu /= 1000;
   DEB ("run took " << simu << "s");
+  EventAllocator::Stats pool = EventAllocator::GetStats ();
 
   LOG (std::setw (g_fwidth) << init <<
        std::setw (g_fwidth) << (m_population / init) <<
        std::setw (g_fwidth) << (init / m_population) <<
        std::setw (g_fwidth) << simu <<
        std::setw (g_fwidth) << (m_count / simu) <<
-       std::setw (g_fwidth) << (simu / m_count));
+       std::setw (g_fwidth) << (simu / m_count) <<
+       std::setw (g_fwidth) << (pool.allocations > 0 ? 100.0 * pool.hits / pool.allocations : 0.0));
 
   // Clean up scheduler
   Simulator::Destroy ();
@@ -183,9 +187,12 @@ int main (int argc, char *argv[])
 {
 
   bool schedCal  = false;
+  bool schedLadder = false;
+  bool schedDary = false;
   bool schedHeap = false;
   bool schedList = false;
   bool schedMap  = true;
+  bool pool      = true;
 
   uint32_t pop   =  100000;
   uint32_t total = 1000000;
@@ -202,9 +209,12 @@ int main (int argc, char *argv[])
              "In the case of either --file form, the input is expected\n"
              "to be ascii, giving the relative event times in ns.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
+  cmd.AddValue ("ladder", "use LadderScheduler",          schedLadder);
+  cmd.AddValue ("dary",  "use DaryHeapScheduler",         schedDary);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
+  cmd.AddValue ("pool",  "allocate the events from the EventAllocator pools (default true)", pool);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
   cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
@@ -217,8 +227,12 @@ int main (int argc, char *argv[])
 
   ObjectFactory factory ("ns3::MapScheduler");
   if (schedCal)  { factory.SetTypeId ("ns3::CalendarScheduler"); }
+  if (schedLadder) { factory.SetTypeId ("ns3::LadderScheduler"); }
+  if (schedDary) { factory.SetTypeId ("ns3::DaryHeapScheduler"); }
   if (schedHeap) { factory.SetTypeId ("ns3::HeapScheduler");     }
   if (schedList) { factory.SetTypeId ("ns3::ListScheduler");     }  
+  // before the simulator implementation reads it
+  Config::SetGlobal ("EventPool", BooleanValue (pool));
   Simulator::SetScheduler (factory);
 
   LOGME (std::setprecision (g_fwidth - 6));
@@ -228,6 +242,7 @@ int main (int argc, char *argv[])
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
   LOGME ("runs: " << runs);
+  LOGME ("event pools: " << (pool ? "enabled" : "disabled"));
   
   Bench *bench = new Bench (pop, total);
   bench->SetRandomStream (GetRandomStream (filename));
@@ -236,14 +251,16 @@ int main (int argc, char *argv[])
   LOG ("");
   LOG (std::left << std::setw (g_fwidth) << "Run #" <<
        std::left << std::setw (3 * g_fwidth) << "Inititialization:" <<
-       std::left << std::setw (3 * g_fwidth) << "Simulation:");
+       std::left << std::setw (3 * g_fwidth) << "Simulation:" <<
+       std::left << std::setw (g_fwidth) << "Pool:");
   LOG (std::left << std::setw (g_fwidth) << "" <<
        std::left << std::setw (g_fwidth) << "Time (s)" <<
        std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
        std::left << std::setw (g_fwidth) << "Per (s/ev)" <<
        std::left << std::setw (g_fwidth) << "Time (s)" <<
        std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
-       std::left << std::setw (g_fwidth) << "Per (s/ev)" );
+       std::left << std::setw (g_fwidth) << "Per (s/ev)" <<
+       std::left << std::setw (g_fwidth) << "Hits (%)" );
   LOG (std::setfill ('-') <<
        std::right << std::setw (g_fwidth) << " " <<
        std::right << std::setw (g_fwidth) << " " <<       
@@ -252,6 +269,7 @@ int main (int argc, char *argv[])
        std::right << std::setw (g_fwidth) << " " <<       
        std::right << std::setw (g_fwidth) << " " <<       
        std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
        std::setfill (' ')
        );
        